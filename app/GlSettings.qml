@@ -193,6 +193,12 @@ SettingsPanel {
             ModelBinding on value { target: map; property: "shared_config.ssao_blur_kernel_size"}
         }
 
+        Label { text: "Resolution:" }
+        LabledSlider {
+            from: 0; to: 2; stepSize: 1; snapMode: Slider.SnapAlways;
+            ModelBinding on value { target: map; property: "shared_config.ssao_resolution"}
+        }
+
         CheckBox {
             text: "Range-Check"
             Layout.fillWidth: true;
@@ -200,6 +206,13 @@ SettingsPanel {
             ModelBinding on checked { target: map; property: "shared_config.ssao_range_check"}
         }
 
+        CheckBox {
+            text: "Temporal Accumulation"
+            Layout.fillWidth: true;
+            Layout.columnSpan: 2;
+            ModelBinding on checked { target: map; property: "shared_config.ssao_temporal_enabled"}
+        }
+
     }
 
     CheckGroup {
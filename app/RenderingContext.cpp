@@ -58,6 +58,7 @@ struct RenderingContext::Data {
 
     std::unique_ptr<QThread> scheduler_thread;
     // the ones below are on the scheduler thread.
+    std::shared_ptr<nucleus::tile::SlotBudget> tile_slot_budget;
     nucleus::tile::setup::GeometrySchedulerHolder geometry;
     nucleus::tile::setup::TextureSchedulerHolder ortho_texture;
     nucleus::tile::setup::TextureSchedulerHolder surfaceshaded_texture;
@@ -94,27 +95,33 @@ RenderingContext::RenderingContext(QObject* parent)
     //                                           {"", "1", "2", "3", "4"}));
     m->aabb_decorator = nucleus::tile::setup::aabb_decorator();
     {
+        // all layers share one slot budget. geometry comes first, without it nothing can be drawn.
+        // the bounds of the network adaption: slots are bounded by the budget, the request rate per layer (i.e., per server).
+        // they can be changed later with SlotBudget::set_controller_settings and Scheduler::set_network_settings.
+        m->tile_slot_budget = std::make_shared<nucleus::tile::SlotBudget>(nucleus::tile::SlotBudget::default_controller_settings());
+        const auto network_settings = nucleus::tile::ConcurrencyController::Settings { .min_rate = 20, .max_rate = 400 };
+        const auto texture_settings = nucleus::tile::setup::texture_scheduler_settings();
         // clang-format off
         auto geometry_service = std::make_unique<TileLoadService>("https://alpinemaps.cg.tuwien.ac.at/tiles/alpine_png/", TilePattern::ZXY, ".png");
-        m->geometry = nucleus::tile::setup::geometry_scheduler(std::move(geometry_service), m->aabb_decorator, m->scheduler_thread.get());
+        m->geometry = nucleus::tile::setup::geometry_scheduler(std::move(geometry_service), m->aabb_decorator, m->scheduler_thread.get(), { m->tile_slot_budget, 4.0f, network_settings });
         m->scheduler_director->check_in("geometry", m->geometry.scheduler);
         m->data_querier = std::make_shared<DataQuerier>(&m->geometry.scheduler->ram_cache());
         
         // auto ortho_service = std::make_unique<TileLoadService>("https://gataki.cg.tuwien.ac.at/raw/basemap/tiles/", TilePattern::ZYX_yPointingSouth, ".jpeg");
         auto ortho_service = std::make_unique<TileLoadService>("https://mapsneu.wien.gv.at/basemap/bmaporthofoto30cm/normal/google3857/", TilePattern::ZYX_yPointingSouth, ".jpeg");
-        m->ortho_texture = nucleus::tile::setup::texture_scheduler(std::move(ortho_service), m->aabb_decorator, m->scheduler_thread.get());
+        m->ortho_texture = nucleus::tile::setup::texture_scheduler(std::move(ortho_service), m->aabb_decorator, m->scheduler_thread.get(), texture_settings, { m->tile_slot_budget, 2.0f, network_settings });
         m->scheduler_director->check_in("ortho", m->ortho_texture.scheduler);
 
         auto surfaceshaded_service = std::make_unique<TileLoadService>("https://mapsneu.wien.gv.at/basemap/bmapoberflaeche/grau/google3857/", TilePattern::ZYX_yPointingSouth, ".jpeg");
-        m->surfaceshaded_texture = nucleus::tile::setup::texture_scheduler(std::move(surfaceshaded_service), m->aabb_decorator, m->scheduler_thread.get());
+        m->surfaceshaded_texture = nucleus::tile::setup::texture_scheduler(std::move(surfaceshaded_service), m->aabb_decorator, m->scheduler_thread.get(), texture_settings, { m->tile_slot_budget, 1.0f, network_settings });
         m->scheduler_director->check_in("surfaceshading", m->surfaceshaded_texture.scheduler);
 
         auto map_label_service = std::make_unique<TileLoadService>("https://osm.cg.tuwien.ac.at/vector_tiles/poi_v1/", TilePattern::ZXY_yPointingSouth, "");
-        m->map_label = nucleus::map_label::setup::scheduler(std::move(map_label_service), m->aabb_decorator, m->data_querier, m->scheduler_thread.get());
+        m->map_label = nucleus::map_label::setup::scheduler(std::move(map_label_service), m->aabb_decorator, m->data_querier, m->scheduler_thread.get(), { m->tile_slot_budget, 1.0f, network_settings });
         m->scheduler_director->check_in("map_label", m->map_label.scheduler);
 
         auto eaws_regions_service = std::make_unique<TileLoadService>("https://osm.cg.tuwien.ac.at/vector_tiles/eaws-regions/", TilePattern::ZXY_yPointingSouth, "");
-        m->eaws_texture = nucleus::avalanche::setup::eaws_texture_scheduler(std::move(eaws_regions_service), m->aabb_decorator, m->scheduler_thread.get());
+        m->eaws_texture = nucleus::avalanche::setup::eaws_texture_scheduler(std::move(eaws_regions_service), m->aabb_decorator, m->scheduler_thread.get(), { m->tile_slot_budget, 1.0f, network_settings });
         m->scheduler_director->check_in("eaws_regions", m->eaws_texture.scheduler);
         // clang-format on
 
@@ -207,6 +214,7 @@ void RenderingContext::initialise()
     connect(m->ortho_texture.scheduler.get(),         &nucleus::tile::TextureScheduler::gpu_tiles_updated,    m->engine_context->ortho_layer(),         &gl_engine::TextureLayer::update_gpu_tiles);
     connect(m->surfaceshaded_texture.scheduler.get(), &nucleus::tile::TextureScheduler::gpu_tiles_updated,    m->engine_context->surfaceshaded_layer(), &gl_engine::TextureLayer::update_gpu_tiles);
     connect(m->eaws_texture.scheduler.get(),          &nucleus::avalanche::Scheduler::gpu_tiles_updated,      m->engine_context->eaws_layer(),          &gl_engine::AvalancheWarningLayer::update_gpu_tiles);
+    connect(m->eaws_texture.scheduler.get(),          &nucleus::avalanche::Scheduler::id_remap_updated,       m->engine_context->eaws_layer(),          &gl_engine::AvalancheWarningLayer::update_id_remap);
 
     connect(QOpenGLContext::currentContext(), &QOpenGLContext::aboutToBeDestroyed, m->engine_context.get(), &nucleus::EngineContext::destroy);
     connect(QOpenGLContext::currentContext(), &QOpenGLContext::aboutToBeDestroyed, this,                    &RenderingContext::destroy);
@@ -231,13 +239,16 @@ void RenderingContext::destroy()
             m->map_label.scheduler.reset();
             m->ortho_texture.scheduler.reset();
             m->eaws_texture.scheduler.reset();
+            m->surfaceshaded_texture.scheduler.reset();
             m->scheduler_director.reset();
+            m->tile_slot_budget.reset();
         });
         nucleus::utils::thread::sync_call(m->geometry.tile_service.get(), [this]() {
             m->geometry.tile_service.reset();
             m->map_label.tile_service.reset();
             m->ortho_texture.tile_service.reset();
             m->eaws_texture.tile_service.reset();
+            m->surfaceshaded_texture.tile_service.reset();
         });
         m->scheduler_thread->quit();
         m->scheduler_thread->wait(500); // msec
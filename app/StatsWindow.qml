@@ -663,6 +663,71 @@ Rectangle {
                 text: "(" + map.tile_statistics.gpu.n_geometry_tiles_drawn + ")"
             }
 
+            Label {
+                text: qsTr("Occluded: ")
+            }
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1024
+                value: map.tile_statistics.gpu.n_geometry_tiles_occluded
+            }
+            Label {
+                text: "(" + map.tile_statistics.gpu.n_geometry_tiles_occluded + ")"
+            }
+
+            Label {
+                text: qsTr("Mesh 65: ")
+            }
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1024
+                value: map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_1
+            }
+            Label {
+                text: "(" + map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_1 + ")"
+            }
+
+            Label {
+                text: qsTr("Mesh 33: ")
+            }
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1024
+                value: map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_2
+            }
+            Label {
+                text: "(" + map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_2 + ")"
+            }
+
+            Label {
+                text: qsTr("Mesh 17: ")
+            }
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1024
+                value: map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_4
+            }
+            Label {
+                text: "(" + map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_4 + ")"
+            }
+
+            Label {
+                text: qsTr("Mesh 9: ")
+            }
+            ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 1024
+                value: map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_8
+            }
+            Label {
+                text: "(" + map.tile_statistics.gpu.n_geometry_tiles_drawn_stride_8 + ")"
+            }
+
             Label {
                 text: qsTr("Label: ")
             }
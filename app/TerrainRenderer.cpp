@@ -67,12 +67,18 @@ TerrainRenderer::TerrainRenderer()
     connect(m_camera_controller.get(), &CameraController::definition_changed, ctx->ortho_scheduler(),         &Scheduler::update_camera);
     connect(m_camera_controller.get(), &CameraController::definition_changed, ctx->surfaceshaded_scheduler(), &Scheduler::update_camera);
     connect(m_camera_controller.get(), &CameraController::definition_changed, ctx->eaws_scheduler(),          &Scheduler::update_camera);
+    connect(m_camera_controller.get(), &CameraController::camera_path_changed, ctx->geometry_scheduler(),      &Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &CameraController::camera_path_changed, ctx->map_label_scheduler(),     &Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &CameraController::camera_path_changed, ctx->ortho_scheduler(),         &Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &CameraController::camera_path_changed, ctx->surfaceshaded_scheduler(), &Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &CameraController::camera_path_changed, ctx->eaws_scheduler(),          &Scheduler::update_camera_path);
     connect(m_camera_controller.get(), &CameraController::definition_changed, m_glWindow.get(),               &gl_engine::Window::update_camera);
 
-    connect(ctx->geometry_scheduler(), &nucleus::tile::GeometryScheduler::gpu_tiles_updated,  gl_window_ptr, &gl_engine::Window::update_requested);
-    connect(ctx->ortho_scheduler(),    &nucleus::tile::TextureScheduler::gpu_tiles_updated,   gl_window_ptr, &gl_engine::Window::update_requested);
-    connect(ctx->eaws_scheduler(),     &nucleus::avalanche::Scheduler::gpu_tiles_updated, gl_window_ptr, &gl_engine::Window::update_requested);
-    connect(ctx->label_filter().get(), &Filter::filter_finished,                              gl_window_ptr, &gl_engine::Window::update_requested);
+    connect(ctx->geometry_scheduler(), &nucleus::tile::GeometryScheduler::gpu_tiles_updated,  gl_window_ptr, &gl_engine::Window::tile_update_requested);
+    connect(ctx->ortho_scheduler(),    &nucleus::tile::TextureScheduler::gpu_tiles_updated,   gl_window_ptr, &gl_engine::Window::tile_update_requested);
+    connect(ctx->eaws_scheduler(),     &nucleus::avalanche::Scheduler::gpu_tiles_updated, gl_window_ptr, &gl_engine::Window::tile_update_requested);
+    connect(ctx->eaws_scheduler(),     &nucleus::avalanche::Scheduler::id_remap_updated,  gl_window_ptr, &gl_engine::Window::tile_update_requested);
+    connect(ctx->label_filter().get(), &Filter::filter_finished,                              gl_window_ptr, &gl_engine::Window::tile_update_requested);
 
     connect(ctx->picker_manager().get(),   &PickerManager::pick_requested,     gl_window_ptr,                  &gl_engine::Window::pick_value);
     connect(gl_window_ptr,                 &gl_engine::Window::value_picked,   ctx->picker_manager().get(),    &PickerManager::eval_pick);
@@ -100,6 +106,8 @@ void TerrainRenderer::synchronize(QQuickFramebufferObject *item)
     m_camera_controller->set_pixel_error_threshold(1.0 / i->settings()->render_quality());
     m_camera_controller->set_viewport({ i->width(), i->height() });
     m_camera_controller->set_field_of_view(i->field_of_view());
+    // continuous updates are used for benchmarking, so all passes should be drawn in every frame.
+    m_glWindow->set_render_on_demand(!i->continuous_update());
 
     auto cameraFrontAxis = m_camera_controller->definition().z_axis();
     auto degFromNorth = glm::degrees(glm::acos(glm::dot(glm::normalize(glm::dvec3(cameraFrontAxis.x, cameraFrontAxis.y, 0)), glm::dvec3(0, -1, 0))));
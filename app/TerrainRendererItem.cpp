@@ -113,6 +113,7 @@ QQuickFramebufferObject::Renderer* TerrainRendererItem::createRenderer() const
 
     auto* r = new TerrainRenderer();
     connect(r->glWindow(), &nucleus::AbstractRenderWindow::update_requested, this, &TerrainRendererItem::schedule_update);
+    connect(r->glWindow(), &nucleus::AbstractRenderWindow::tile_update_requested, this, &TerrainRendererItem::schedule_tile_update);
     connect(r->glWindow(), &gl_engine::Window::tile_stats_ready, this->m_tile_statistics, &TileStatistics::set_gpu_stats);
     connect(ctx->geometry_scheduler(), &nucleus::tile::Scheduler::stats_ready, this->m_tile_statistics, &TileStatistics::update_scheduler_stats);
     connect(ctx->map_label_scheduler(), &nucleus::tile::Scheduler::stats_ready, this->m_tile_statistics, &TileStatistics::update_scheduler_stats);
@@ -155,6 +156,7 @@ QQuickFramebufferObject::Renderer* TerrainRendererItem::createRenderer() const
 
     connect(
         this, &TerrainRendererItem::eaws_report_date_changed, ctx->eaws_report_load_service().get(), &nucleus::avalanche::ReportLoadService::load_from_tu_wien);
+    connect(this, &TerrainRendererItem::eaws_report_date_changed, ctx->eaws_scheduler(), &nucleus::avalanche::Scheduler::set_reference_date);
 
 #ifdef ALP_ENABLE_DEV_TOOLS
     connect(r->glWindow(), &gl_engine::Window::timer_measurements_ready, TimerFrontendManager::instance(), &TimerFrontendManager::receive_measurements);
@@ -258,9 +260,17 @@ void TerrainRendererItem::set_gl_preset(const QString& preset_b64_string) {
 void TerrainRendererItem::schedule_update()
 {
     //    qDebug("void TerrainRendererItem::schedule_update()");
+    // a pending tile update is brought forward, so that interaction isn't delayed by the coalescing.
+    if (m_update_timer->isActive() && m_update_timer->remainingTime() <= m_redraw_delay)
+        return;
+    m_update_timer->start(m_redraw_delay);
+}
+
+void TerrainRendererItem::schedule_tile_update()
+{
     if (m_update_timer->isActive())
         return;
-    m_update_timer->start();
+    m_update_timer->start(std::max(m_redraw_delay, m_tile_redraw_delay));
 }
 
 int TerrainRendererItem::redraw_delay() const { return m_redraw_delay; }
@@ -480,7 +490,7 @@ void TerrainRendererItem::set_continuous_update(bool new_continuous_update)
         return;
     m_continuous_update = new_continuous_update;
     m_update_timer->setSingleShot(!m_continuous_update);
-    m_update_timer->start();
+    m_update_timer->start(m_redraw_delay);
     emit continuous_update_changed(m_continuous_update);
 }
 
@@ -135,6 +135,7 @@ public slots:
     void updateEawsReportDate(int day, int month, int year);
 private slots:
     void schedule_update();
+    void schedule_tile_update();
     void init_after_creation_slot();
     void datetime_changed(const QDateTime& new_datetime);
     void gl_sundir_date_link_changed(bool new_value);
@@ -203,6 +204,7 @@ private:
     float m_camera_operation_centre_distance = 1;
     float m_field_of_view = 60;
     int m_redraw_delay = 1;
+    int m_tile_redraw_delay = 30; // tiles arrive in bursts, they are collected for this long and drawn in one frame
     unsigned m_tile_cache_size = 12000;
     unsigned int m_selected_camera_position_index = 0;
     QDateTime m_selected_datetime = QDateTime::currentDateTime();
@@ -278,6 +278,9 @@ void App::start()
     connect(m_camera_controller.get(), &nucleus::camera::Controller::definition_changed, m_context->geometry_scheduler(), &nucleus::tile::Scheduler::update_camera);
     connect(m_camera_controller.get(), &nucleus::camera::Controller::definition_changed, m_context->ortho_scheduler(),    &nucleus::tile::Scheduler::update_camera);
     connect(m_camera_controller.get(), &nucleus::camera::Controller::definition_changed, m_context->cloud_scheduler(),    &nucleus::tile::Scheduler::update_camera);
+    connect(m_camera_controller.get(), &nucleus::camera::Controller::camera_path_changed, m_context->geometry_scheduler(), &nucleus::tile::Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &nucleus::camera::Controller::camera_path_changed, m_context->ortho_scheduler(),    &nucleus::tile::Scheduler::update_camera_path);
+    connect(m_camera_controller.get(), &nucleus::camera::Controller::camera_path_changed, m_context->cloud_scheduler(),    &nucleus::tile::Scheduler::update_camera_path);
     connect(m_camera_controller.get(), &nucleus::camera::Controller::definition_changed, m_webgpu_window.get(),           &webgpu_engine::Window::update_camera);
     
     connect(m_context->geometry_scheduler(), &nucleus::tile::GeometryScheduler::gpu_tiles_updated,  m_webgpu_window.get(), &webgpu_engine::Window::update_requested);
@@ -392,6 +395,10 @@ void App::start()
         m_gputimer = std::make_shared<webgpu::timing::WebGpuTimer>(m_device, 3, 120);
         m_timer_manager->add_timer(m_gputimer, "GPU Timer", "Renderer");
     }
+    if (auto* tile_mesh_renderer = m_context->engine_context()->tile_mesh_renderer())
+        m_timer_manager->add_timer(tile_mesh_renderer->instance_timer(), "Tile instances", "Renderer");
+    if (auto* cloud_renderer = m_context->engine_context()->cloud_renderer(); cloud_renderer && cloud_renderer->gpu_timer())
+        m_timer_manager->add_timer(cloud_renderer->gpu_timer(), "Clouds", "Renderer");
 
     this->on_window_resize(m_viewport_size.x, m_viewport_size.y);
     m_initialized = true;
@@ -598,8 +605,13 @@ void App::webgpu_create_context()
 
     std::vector<WGPUFeatureName> requiredFeatures;
     requiredFeatures.push_back(WGPUFeatureName_TimestampQuery);
-    requiredFeatures.push_back(WGPUFeatureName_TextureCompressionBC);
-    requiredFeatures.push_back(WGPUFeatureName_TextureCompressionBCSliced3D);
+    // ortho tiles use whichever block compression is available (see TileMeshRenderer::compression_algorithm)
+    if (wgpuAdapterHasFeature(m_adapter, WGPUFeatureName_TextureCompressionBC))
+        requiredFeatures.push_back(WGPUFeatureName_TextureCompressionBC);
+    if (wgpuAdapterHasFeature(m_adapter, WGPUFeatureName_TextureCompressionBCSliced3D))
+        requiredFeatures.push_back(WGPUFeatureName_TextureCompressionBCSliced3D); // clouds
+    if (wgpuAdapterHasFeature(m_adapter, WGPUFeatureName_TextureCompressionETC2))
+        requiredFeatures.push_back(WGPUFeatureName_TextureCompressionETC2);
 
     WGPUDeviceDescriptor device_desc {};
     device_desc.label = WGPUStringView { .data = "webigeo device", .length = WGPU_STRLEN };
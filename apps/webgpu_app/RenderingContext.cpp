@@ -64,9 +64,12 @@ RenderingContext::RenderingContext()
     //                                           {"", "1", "2", "3", "4"}));
     m_aabb_decorator = nucleus::tile::setup::aabb_decorator();
     {
+        // all layers share one slot budget. geometry comes first, without it nothing can be drawn.
+        m_tile_slot_budget = std::make_shared<nucleus::tile::SlotBudget>();
         auto geometry_service
             = std::make_unique<nucleus::tile::TileLoadService>("https://alpinemaps.cg.tuwien.ac.at/tiles/alpine_png/", TilePattern::ZXY, ".png");
-        m_geometry_scheduler_holder = nucleus::tile::setup::geometry_scheduler(std::move(geometry_service), m_aabb_decorator, m_scheduler_thread.get());
+        m_geometry_scheduler_holder = nucleus::tile::setup::geometry_scheduler(
+            std::move(geometry_service), m_aabb_decorator, m_scheduler_thread.get(), { m_tile_slot_budget, 4.0f });
         m_geometry_scheduler_holder.scheduler->set_gpu_quad_limit(256); // TODO
         m_scheduler_director->check_in("geometry", m_geometry_scheduler_holder.scheduler);
         m_data_querier = std::make_shared<nucleus::DataQuerier>(&m_geometry_scheduler_holder.scheduler->ram_cache());
@@ -76,7 +79,11 @@ RenderingContext::RenderingContext()
         // TilePattern::ZYX_yPointingSouth, ".jpeg"); auto ortho_service =
         // std::make_unique<nucleus::tile::TileLoadService>("https://mapsneu.wien.gv.at/basemap/bmapgelaende/grau/google3857/", TilePattern::ZYX_yPointingSouth,
         // ".jpeg");
-        m_ortho_scheduler_holder = nucleus::tile::setup::texture_scheduler(std::move(ortho_service), m_aabb_decorator, m_scheduler_thread.get());
+        m_ortho_scheduler_holder = nucleus::tile::setup::texture_scheduler(std::move(ortho_service),
+            m_aabb_decorator,
+            m_scheduler_thread.get(),
+            nucleus::tile::setup::texture_scheduler_settings(),
+            { m_tile_slot_budget, 2.0f });
         m_ortho_scheduler_holder.scheduler->set_gpu_quad_limit(256); // TODO
         m_scheduler_director->check_in("ortho", m_ortho_scheduler_holder.scheduler);
 
@@ -84,7 +91,8 @@ RenderingContext::RenderingContext()
         m_cloud_scheduler_holder = nucleus::tile::setup::texture_scheduler_3d(std::move(cloud_service),
             m_aabb_decorator,
             m_scheduler_thread.get(),
-            { .tile_resolution = webgpu_engine::clouds::TILE_RESOLUTION_XY, .max_zoom_level = 10, .gpu_quad_limit = 1024 });
+            { .tile_resolution = webgpu_engine::clouds::TILE_RESOLUTION_XY, .max_zoom_level = 10, .gpu_quad_limit = 1024 },
+            { m_tile_slot_budget, 1.0f });
         m_cloud_scheduler_holder.scheduler->set_gpu_quad_limit(webgpu_engine::clouds::LOADED_TILE_LIMIT);
         m_scheduler_director->check_in("cloud", m_cloud_scheduler_holder.scheduler);
     }
@@ -154,9 +162,9 @@ void RenderingContext::initialize(webgpu::Context& ctx)
         &webgpu_engine::CloudRenderer::update_gpu_tiles_cloud);
     nucleus::utils::thread::async_call(m_geometry_scheduler_holder.scheduler.get(), [this]() { m_geometry_scheduler_holder.scheduler->set_enabled(true); });
 
-    // TODO: texture compression
-    nucleus::utils::thread::async_call(m_ortho_scheduler_holder.scheduler.get(), [this]() {
-        m_ortho_scheduler_holder.scheduler->set_texture_compression_algorithm(nucleus::utils::ColourTexture::Format::Uncompressed_RGBA);
+    const auto texture_compression = webgpu_engine::TileMeshRenderer::compression_algorithm(ctx.device());
+    nucleus::utils::thread::async_call(m_ortho_scheduler_holder.scheduler.get(), [this, texture_compression]() {
+        m_ortho_scheduler_holder.scheduler->set_texture_compression_algorithm(texture_compression);
         m_ortho_scheduler_holder.scheduler->set_enabled(true);
     });
 
@@ -196,6 +204,7 @@ void RenderingContext::destroy()
             m_geometry_scheduler_holder.scheduler.reset();
             m_ortho_scheduler_holder.scheduler.reset();
             m_cloud_scheduler_holder.scheduler.reset();
+            m_tile_slot_budget.reset();
         });
         nucleus::utils::thread::sync_call(m_geometry_scheduler_holder.tile_service.get(), [this]() {
             m_geometry_scheduler_holder.tile_service.reset();
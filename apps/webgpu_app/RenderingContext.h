@@ -84,6 +84,7 @@ private:
 
     std::shared_ptr<nucleus::tile::utils::AabbDecorator> m_aabb_decorator;
     std::shared_ptr<nucleus::DataQuerier> m_data_querier;
+    std::shared_ptr<nucleus::tile::SlotBudget> m_tile_slot_budget;
     nucleus::tile::setup::GeometrySchedulerHolder m_geometry_scheduler_holder;
     nucleus::tile::setup::TextureSchedulerHolder m_ortho_scheduler_holder;
     nucleus::tile::setup::Texture3DSchedulerHolder m_cloud_scheduler_holder;
@@ -97,6 +97,24 @@ void CloudPanel::draw_panel()
                 ImGui::EndDisabled();
         }
 
+        ImGui::SeparatorText("Performance");
+        static int quality_preset = int(webgpu_engine::CloudRenderer::QualityPreset::High);
+        if (ImGui::Combo("Quality", &quality_preset, "Low\0Medium\0High\0Ultra\0")) {
+            m_cloud_renderer->quality = webgpu_engine::CloudRenderer::quality_preset(webgpu_engine::CloudRenderer::QualityPreset(quality_preset));
+            m_context->request_redraw();
+        }
+        auto& quality = m_cloud_renderer->quality;
+        int update_interval_index = quality.update_interval == 4 ? 2 : (quality.update_interval == 2 ? 1 : 0);
+        if (ImGui::Combo("Pixels per Frame", &update_interval_index, "All\0Checkerboard\0One in 4\0")) {
+            quality.update_interval = 1u << update_interval_index;
+            m_context->request_redraw();
+        }
+        ImGui::SliderFloat("Transmittance Cutoff", &quality.transmittance_cutoff, 0.001f, 0.1f, "%.3f");
+        ImGui::BeginDisabled(!m_cloud_renderer->gpu_timer());
+        ImGui::SliderFloat("Frame Budget (ms)", &quality.frame_budget_ms, 0.0f, 16.0f, "%.1f");
+        ImGui::EndDisabled();
+        ImGui::Text("Steps: %u (%u - %u)", m_cloud_renderer->step_count(), quality.min_steps, quality.max_steps);
+
         ImGui::SeparatorText("Shading");
         auto& shader_params = m_cloud_renderer->shader_params;
         ImGui::Text("Step Size");
@@ -19,6 +19,7 @@
 #include "TileDebugOverlayImGuiRenderer.h"
 
 #include <imgui.h>
+#include <webgpu/base/util/string_cast.h>
 
 namespace webgpu_app {
 
@@ -47,6 +48,11 @@ bool TileDebugOverlayImGuiRenderer::render_custom_settings()
         changed = true;
     }
 
+    ImGui::SeparatorText("VRAM");
+    for (const auto& memory : m_tile_debug_overlay->texture_memory()) {
+        ImGui::Text("%s (%s): %.1f MB", memory.name, webgpu::util::textureFormatToString(memory.format), double(memory.n_bytes) / (1024.0 * 1024.0));
+    }
+
     return changed;
 }
 
@@ -59,6 +59,16 @@ void AppPanel::draw_panel()
             m_terrain_renderer->get_camera_controller()->update();
         }
 
+        static bool gpu_culling = false;
+        if (ImGui::Checkbox("GPU tile selection", &gpu_culling)) {
+            m_terrain_renderer->get_webgpu_window()->set_gpu_culling_enabled(gpu_culling);
+        }
+
+        static bool compact_gbuffer = false;
+        if (ImGui::Checkbox("Compact G-buffer", &compact_gbuffer)) {
+            m_terrain_renderer->get_webgpu_window()->set_compact_gbuffer_enabled(compact_gbuffer);
+        }
+
         static int geometry_tile_source_index = 0; // 0 ... DSM, 1 ... DTM
         if (ImGui::Combo("Geometry Tiles", &geometry_tile_source_index, "AlpineMaps DSM\0AlpineMaps DTM\0")) {
             auto geometry_load_service = m_terrain_renderer->get_rendering_context()->geometry_tile_load_service();
@@ -24,6 +24,7 @@
 #include <QOpenGLExtraFunctions>
 #include <QtAssert>
 #include <TextureLayer.h>
+#include <nucleus/avalanche/UIntIdManager.h>
 
 namespace gl_engine {
 
@@ -46,6 +47,15 @@ void gl_engine::AvalancheWarningLayer::init(ShaderRegistry* shader_registry, std
 
     m_instanced_array_index = std::make_unique<Texture>(Texture::Target::_2d, Texture::Format::R16UI);
     m_instanced_array_index->setParams(Texture::Filter::Nearest, Texture::Filter::Nearest);
+
+    // identity until the scheduler sends the remap for the reference date
+    const auto remap_size = nucleus::avalanche::UIntIdManager::id_remap_size;
+    radix::Raster<uint16_t> identity_remap(glm::uvec2(remap_size));
+    for (unsigned i = 0; i < remap_size * remap_size; ++i)
+        identity_remap.pixel({ i % remap_size, i / remap_size }) = uint16_t(i);
+    m_id_remap = std::make_unique<Texture>(Texture::Target::_2d, Texture::Format::R16UI);
+    m_id_remap->setParams(Texture::Filter::Nearest, Texture::Filter::Nearest);
+    m_id_remap->upload(identity_remap);
     m_surfshaded_layer = surfaceshaded_layer;
 }
 
@@ -72,6 +82,9 @@ void AvalancheWarningLayer::draw(
     m_shader->set_uniform("instanced_texture_zoom_sampler", 8);
     m_instanced_zoom->upload(zoom_level_raster);
 
+    m_id_remap->bind(12);
+    m_shader->set_uniform("id_remap_sampler", 12);
+
     m_surfshaded_layer->m_texture_array->bind(9);
     m_shader->set_uniform("texture_sampler2", 9);
     for (unsigned i = 0; i < std::min(unsigned(draw_list.size()), 1024u); ++i) {
@@ -108,6 +121,17 @@ void AvalancheWarningLayer::update_gpu_tiles(const std::vector<nucleus::tile::Id
         const auto layer_index = m_gpu_array_helper.add_tile(tile.id);
         m_texture_array->upload(*tile.texture, layer_index);
     }
+    ++m_generation;
+}
+
+void AvalancheWarningLayer::update_id_remap(std::shared_ptr<const radix::Raster<glm::uint16>> id_remap)
+{
+    if (!QOpenGLContext::currentContext() || !m_id_remap) // can happen during shutdown.
+        return;
+    Q_ASSERT(id_remap);
+    Q_ASSERT(id_remap->size() == glm::uvec2(nucleus::avalanche::UIntIdManager::id_remap_size));
+    m_id_remap->upload(*id_remap);
+    ++m_generation;
 }
 
 void AvalancheWarningLayer::set_tile_limit(unsigned int new_limit)
@@ -47,10 +47,14 @@ public:
     void draw(const TileGeometry& tile_geometry, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_list) const;
 
     unsigned int tile_count() const;
+    /// incremented whenever the gpu tiles or the id remap change, Window compares it to decide whether a frame has to be redrawn.
+    [[nodiscard]] unsigned generation() const { return m_generation; }
 
 public slots:
     void update_gpu_tiles(const std::vector<nucleus::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuEawsTile>& new_tiles);
     void set_tile_limit(unsigned new_limit);
+    // Maps the raster ids in the tiles to internal region ids (i.e., indices into the reports), see nucleus::avalanche::UIntIdManager
+    void update_id_remap(std::shared_ptr<const radix::Raster<glm::uint16>> id_remap);
 
 private:
     const unsigned m_resolution = 512u;
@@ -59,7 +63,9 @@ private:
     std::unique_ptr<Texture> m_texture_array;
     std::unique_ptr<Texture> m_instanced_zoom;
     std::unique_ptr<Texture> m_instanced_array_index;
+    std::unique_ptr<Texture> m_id_remap;
     nucleus::tile::GpuArrayHelper m_gpu_array_helper;
     std::shared_ptr<gl_engine::TextureLayer> m_surfshaded_layer = nullptr;
+    unsigned m_generation = 0;
 };
 } // namespace gl_engine
@@ -271,6 +271,19 @@ QOpenGLTexture* Framebuffer::depth_texture()
     return m_depth_texture.get();
 }
 
+void Framebuffer::copy_depth_from(const Framebuffer& source)
+{
+    Q_ASSERT(source.m_size == m_size);
+    Q_ASSERT(source.m_depth_format == m_depth_format && m_depth_format != DepthFormat::None);
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    f->glBindFramebuffer(GL_READ_FRAMEBUFFER, source.m_frame_buffer);
+    f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_frame_buffer);
+    const auto w = GLint(m_size.x);
+    const auto h = GLint(m_size.y);
+    f->glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    bind();
+}
+
 QImage Framebuffer::read_colour_attachment(unsigned index)
 {
     Q_ASSERT(index < m_colour_textures.size());
@@ -82,6 +82,8 @@ public:
     void bind_depth_texture(unsigned location = 0);
 
     QOpenGLTexture* depth_texture();
+    // copies the depth of source (same size and depth format) into this framebuffer, which is bound afterwards.
+    void copy_depth_from(const Framebuffer& source);
 
     QImage read_colour_attachment(unsigned index);
 
@@ -35,6 +35,17 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace gl_engine {
 
+namespace {
+    namespace uniforms {
+        const UniformHandle<int> label_dist_scaling("label_dist_scaling");
+        const UniformHandle<int> texin_depth("texin_depth");
+        const UniformHandle<int> font_sampler("font_sampler");
+        const UniformHandle<int> icon_sampler("icon_sampler");
+        const UniformHandle<glm::vec3> reference_position("reference_position");
+        const UniformHandle<int> drawing_outline("drawing_outline");
+    } // namespace uniforms
+} // namespace
+
 MapLabels::MapLabels(const nucleus::tile::utils::AabbDecoratorPtr& aabb_decorator, QObject* parent)
     : QObject { parent }
 {
@@ -158,6 +169,7 @@ void MapLabels::update_labels(const std::vector<PoiTile>& updated_tiles, const s
         upload_to_gpu(vectortile.id, *vectortile.data);
         m_draw_list_generator.add_tile(vectortile.id);
     }
+    ++m_generation;
 }
 
 void MapLabels::remove_tile(const TileId& tile_id)
@@ -183,13 +195,13 @@ void MapLabels::draw(Framebuffer* gbuffer, const nucleus::camera::Definition& ca
     f->glEnable(GL_BLEND);
 
     m_label_shader->bind();
-    m_label_shader->set_uniform("label_dist_scaling", true);
-    m_label_shader->set_uniform("texin_depth", 0);
+    m_label_shader->set_uniform(uniforms::label_dist_scaling, true);
+    m_label_shader->set_uniform(uniforms::texin_depth, 0);
     gbuffer->bind_colour_texture(1, 0);
 
-    m_label_shader->set_uniform("font_sampler", 1);
+    m_label_shader->set_uniform(uniforms::font_sampler, 1);
     m_font_texture->bind(1);
-    m_label_shader->set_uniform("icon_sampler", 2);
+    m_label_shader->set_uniform(uniforms::icon_sampler, 2);
     m_icon_texture->bind(2);
 
     for (const auto& vectortile : m_gpu_tiles) {
@@ -198,13 +210,13 @@ void MapLabels::draw(Framebuffer* gbuffer, const nucleus::camera::Definition& ca
 
         if (vectortile.second->instance_count > 0) {
             vectortile.second->vao->bind();
-            m_label_shader->set_uniform("reference_position", glm::vec3(vectortile.second->reference_point - camera.position()));
+            m_label_shader->set_uniform(uniforms::reference_position, glm::vec3(vectortile.second->reference_point - camera.position()));
 
             // if the labels wouldn't collide, we could use an extra buffer, one draw call and
             // f->glBlendEquationSeparate(GL_MIN, GL_MAX);
-            m_label_shader->set_uniform("drawing_outline", true);
+            m_label_shader->set_uniform(uniforms::drawing_outline, true);
             f->glDrawElementsInstanced(GL_TRIANGLES, m_indices_count, GL_UNSIGNED_INT, 0, vectortile.second->instance_count);
-            m_label_shader->set_uniform("drawing_outline", false);
+            m_label_shader->set_uniform(uniforms::drawing_outline, false);
             f->glDrawElementsInstanced(GL_TRIANGLES, m_indices_count, GL_UNSIGNED_INT, 0, vectortile.second->instance_count);
 
             vectortile.second->vao->release();
@@ -217,8 +229,8 @@ void MapLabels::draw_picker(Framebuffer* gbuffer, const nucleus::camera::Definit
     QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
 
     m_picker_shader->bind();
-    m_picker_shader->set_uniform("label_dist_scaling", true);
-    m_picker_shader->set_uniform("texin_depth", 0);
+    m_picker_shader->set_uniform(uniforms::label_dist_scaling, true);
+    m_picker_shader->set_uniform(uniforms::texin_depth, 0);
     gbuffer->bind_colour_texture(1, 0);
 
     for (const auto& vectortile : m_gpu_tiles) {
@@ -228,7 +240,7 @@ void MapLabels::draw_picker(Framebuffer* gbuffer, const nucleus::camera::Definit
         // only draw if vector tile is fully loaded
         if (vectortile.second->instance_count > 0) {
             vectortile.second->vao->bind();
-            m_picker_shader->set_uniform("reference_position", glm::vec3(vectortile.second->reference_point - camera.position()));
+            m_picker_shader->set_uniform(uniforms::reference_position, glm::vec3(vectortile.second->reference_point - camera.position()));
 
             f->glDrawElementsInstanced(GL_TRIANGLES, m_indices_count, GL_UNSIGNED_INT, 0, vectortile.second->instance_count);
 
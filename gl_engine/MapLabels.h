@@ -62,6 +62,8 @@ public:
     void update_labels(const std::vector<nucleus::vector_tile::PoiTile>& updated_tiles, const std::vector<TileId>& removed_tiles);
 
     unsigned int tile_count() const;
+    /// incremented whenever the labels change, Window compares it to decide whether a frame has to be redrawn.
+    [[nodiscard]] unsigned generation() const { return m_generation; }
 
 private:
     void upload_to_gpu(const TileId& id, const PointOfInterestCollection& features);
@@ -80,5 +82,6 @@ private:
 
     nucleus::tile::DrawListGenerator m_draw_list_generator;
     std::unordered_map<TileId, std::shared_ptr<GPUVectorTile>, TileId::Hasher> m_gpu_tiles;
+    unsigned m_generation = 0;
 };
 } // namespace gl_engine
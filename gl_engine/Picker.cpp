@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "Picker.h"
+
+#include "Framebuffer.h"
+#include <QOpenGLContext>
+#include <QtAssert>
+
+namespace gl_engine {
+
+Picker::Picker()
+    : m_framebuffer(std::make_unique<Framebuffer>(Framebuffer::DepthFormat::Float32, std::vector { Framebuffer::ColourFormat::RGBA32F }, glm::uvec2(tile_size)))
+{
+}
+
+Picker::~Picker()
+{
+    if (m_fence && QOpenGLContext::currentContext())
+        QOpenGLContext::currentContext()->extraFunctions()->glDeleteSync(m_fence);
+}
+
+void Picker::request(const glm::dvec2& normalised_device_coordinates) { m_request = normalised_device_coordinates; }
+
+bool Picker::needs_pass() const { return m_request.has_value() && !m_fence; }
+
+bool Picker::waiting_for_result() const { return m_fence != nullptr; }
+
+void Picker::begin_pass(const glm::uvec2& viewport_size)
+{
+    Q_ASSERT(needs_pass());
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    f->glGetIntegerv(GL_VIEWPORT, m_previous_viewport);
+    m_framebuffer->bind();
+
+    // move the requested pixel into the centre of the tile. the viewport may extend beyond the framebuffer, that's fine.
+    const auto pixel = glm::ivec2((m_request.value() + 1.0) / 2.0 * glm::dvec2(viewport_size));
+    const auto offset = glm::ivec2(tile_size / 2) - pixel;
+    f->glViewport(offset.x, offset.y, GLsizei(viewport_size.x), GLsizei(viewport_size.y));
+
+    f->glClearColor(0.0, 0.0, 0.0, 0.0);
+    f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void Picker::end_pass()
+{
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    m_fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    f->glFlush(); // otherwise the fence might never signal
+    m_request.reset();
+    Framebuffer::unbind();
+    f->glViewport(m_previous_viewport[0], m_previous_viewport[1], m_previous_viewport[2], m_previous_viewport[3]);
+}
+
+std::optional<glm::vec4> Picker::poll_result()
+{
+    if (!m_fence)
+        return {};
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    const auto status = f->glClientWaitSync(m_fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+        return {};
+    f->glDeleteSync(m_fence);
+    m_fence = nullptr;
+    if (status == GL_WAIT_FAILED)
+        return {};
+
+    // the pass is finished, reading the pixel doesn't stall anymore. (pixel pack buffers can't be mapped for reading in WebGL)
+    const auto centre = (glm::dvec2(tile_size / 2) + 0.5) / double(tile_size) * 2.0 - 1.0;
+    GLint viewport[4];
+    f->glGetIntegerv(GL_VIEWPORT, viewport);
+    const auto value = m_framebuffer->read_colour_attachment_pixel<glm::vec4>(0, centre);
+    f->glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    return value;
+}
+
+} // namespace gl_engine
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QOpenGLExtraFunctions>
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+
+namespace gl_engine {
+
+class Framebuffer;
+
+/// Runs the picker pass only when a pick is requested, into a small framebuffer around the requested pixel.
+/// The value is read back once the gpu is done with the pass (fence), so that no frame waits for it.
+/// Usage per frame: poll_result(), then if (needs_pass()) { begin_pass(); draw..; end_pass(); }
+class Picker {
+public:
+    static constexpr unsigned tile_size = 16;
+
+    Picker(); // needs OpenGL context
+    ~Picker();
+
+    void request(const glm::dvec2& normalised_device_coordinates);
+    [[nodiscard]] bool needs_pass() const;
+    [[nodiscard]] bool waiting_for_result() const;
+
+    /// Binds the picker framebuffer. The viewport is set such that drawing with the full viewport_size hits the requested pixel.
+    void begin_pass(const glm::uvec2& viewport_size);
+    /// Restores the previous viewport.
+    void end_pass();
+    /// The picked value, once the gpu finished the pass.
+    [[nodiscard]] std::optional<glm::vec4> poll_result();
+
+private:
+    std::unique_ptr<Framebuffer> m_framebuffer;
+    std::optional<glm::dvec2> m_request;
+    GLsync m_fence = nullptr;
+    GLint m_previous_viewport[4] = { 0, 0, 0, 0 };
+};
+
+} // namespace gl_engine
@@ -23,18 +23,33 @@
 #include <QOpenGLExtraFunctions>
 #include <QOpenGLTexture>
 #include <QtAssert>
+#include <algorithm>
 #include <cmath>
 #include <random>
 
 namespace gl_engine {
 
+namespace {
+    // distance 0 marks a history texel as invalid
+    const GLfloat no_history[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    glm::uvec2 reduced_size_of(const Framebuffer* gbuffer, const uboSharedConfig& config)
+    {
+        return glm::max(gbuffer->size() / (1u << std::min(config.m_ssao_resolution, 2u)), glm::uvec2(1));
+    }
+} // namespace
+
 /*shader_manager->shared_ssao_program(), shader_manager->shared_ssao_blur_program()*/
 SSAO::SSAO(ShaderRegistry* shader_registry)
     : m_ssao_program(std::make_shared<ShaderProgram>("screen_pass.vert", "ssao.frag"))
     , m_ssao_blur_program(std::make_shared<ShaderProgram>("screen_pass.vert", "ssao_blur.frag"))
+    , m_ssao_temporal_program(std::make_shared<ShaderProgram>("screen_pass.vert", "ssao_temporal.frag"))
+    , m_ssao_upsample_program(std::make_shared<ShaderProgram>("screen_pass.vert", "ssao_upsample.frag"))
 {
     shader_registry->add_shader(m_ssao_program);
     shader_registry->add_shader(m_ssao_blur_program);
+    shader_registry->add_shader(m_ssao_temporal_program);
+    shader_registry->add_shader(m_ssao_upsample_program);
     m_f = QOpenGLContext::currentContext()->extraFunctions();
 
     // GENERATE SAMPLE KERNEL
@@ -62,6 +77,10 @@ SSAO::SSAO(ShaderRegistry* shader_registry)
     // GENERATE FRAMEBUFFER
     m_ssaobuffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::R8 });
     m_ssao_blurbuffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::R8 });
+    for (auto& history : m_history)
+        history = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::RGBA32F });
+    m_upsampled = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::R8 });
+    m_result = m_ssaobuffer.get();
 }
 
 void SSAO::recreate_kernel(unsigned int size) {
@@ -88,9 +107,44 @@ SSAO::~SSAO() {
 
 }
 
-void SSAO::draw(Framebuffer* gbuffer, helpers::ScreenQuadGeometry* geometry,
-    const nucleus::camera::Definition&, unsigned int kernel_size, unsigned int blur_level)
+bool SSAO::needs_update(const Framebuffer* gbuffer, const uboSharedConfig& config, bool scene_changed) const
 {
+    if (scene_changed || !m_valid || converging())
+        return true;
+    return reduced_size_of(gbuffer, config) != m_ssaobuffer->size() || bool(config.m_ssao_temporal_enabled) != m_temporal;
+}
+
+void SSAO::draw(Framebuffer* gbuffer, helpers::ScreenQuadGeometry* geometry, const nucleus::camera::Definition& camera, const uboSharedConfig& config,
+    bool scene_changed)
+{
+    const auto scale = 1u << std::min(config.m_ssao_resolution, 2u);
+    const auto reduced_size = reduced_size_of(gbuffer, config);
+    if (reduced_size != m_ssaobuffer->size()) {
+        resize_reduced_buffers(reduced_size);
+        scene_changed = true;
+    }
+    const bool temporal = config.m_ssao_temporal_enabled;
+    if (temporal != m_temporal) {
+        m_temporal = temporal;
+        scene_changed = true;
+        // stale history from the last time it was enabled
+        for (auto& history : m_history) {
+            history->bind();
+            m_f->glClearBufferfv(GL_COLOR, 0, no_history);
+        }
+    }
+
+    if (scene_changed)
+        m_n_static_frames = 0;
+    else if (m_valid && !converging())
+        return; // the occlusion is still up to date, the textures stay as they are.
+    ++m_n_static_frames;
+    ++m_frame;
+
+    // OCCLUSION, reduced resolution. with temporal accumulation each frame uses another subset of the kernel and noise offset.
+    const auto kernel_size = config.m_ssao_kernel;
+    if (kernel_size != m_ssao_kernel.size()) recreate_kernel(kernel_size);
+    const auto n_subsets = temporal ? std::min(n_temporal_subsets, kernel_size) : 1u;
     m_ssaobuffer->bind();
     auto p = m_ssao_program.get();
     p->bind();
@@ -100,42 +154,104 @@ void SSAO::draw(Framebuffer* gbuffer, helpers::ScreenQuadGeometry* geometry,
     gbuffer->bind_colour_texture(2,1);
     p->set_uniform("texin_noise", 2);
     m_ssao_noise_texture->bind(2);
-
-    if (kernel_size != m_ssao_kernel.size()) recreate_kernel(kernel_size);
+    p->set_uniform("noise_scale", glm::vec2(reduced_size) / 4.0f);
+    p->set_uniform("noise_offset", temporal ? glm::vec2(float(m_frame % 4u) * 0.25f, float((m_frame / 4u) % 4u) * 0.25f) : glm::vec2(0.0f));
+    p->set_uniform("n_samples", int(kernel_size / n_subsets));
+    p->set_uniform("sample_stride", int(n_subsets));
+    p->set_uniform("sample_offset", int(m_frame % n_subsets));
     p->set_uniform_array("samples", this->m_ssao_kernel);
     geometry->draw();
     m_ssaobuffer->unbind();
     p->release();
+    Framebuffer* result = m_ssaobuffer.get();
 
-    if (blur_level > 0) {
+    // TEMPORAL ACCUMULATION, reprojecting the history of the last frame
+    if (temporal) {
+        auto& previous = m_history[m_current_history];
+        m_current_history = 1 - m_current_history;
+        auto& current = m_history[m_current_history];
+        current->bind();
+        p = m_ssao_temporal_program.get();
+        p->bind();
+        p->set_uniform("texin_position", 0);
+        gbuffer->bind_colour_texture(1, 0);
+        p->set_uniform("texin_ssao", 1);
+        m_ssaobuffer->bind_colour_texture(0, 1);
+        p->set_uniform("texin_history", 2);
+        previous->bind_colour_texture(0, 2);
+        // maps the camera relative positions of this frame into the clip space of the previous one
+        p->set_uniform("previous_view_proj", m_previous_camera.local_view_projection_matrix(camera.position()));
+        p->set_uniform("camera_offset", glm::vec3(camera.position() - m_previous_camera.position()));
+        p->set_uniform("max_frames", float(n_temporal_frames));
+        geometry->draw();
+        current->unbind();
+        p->release();
+        m_previous_camera = camera;
+        result = current.get();
+    }
+
+    if (config.m_ssao_blur_kernel_size > 0) {
         p = m_ssao_blur_program.get();
         p->bind();
         p->set_uniform("texin_ssao", 0);
 
         // BLUR HORIZONTAL
         m_ssao_blurbuffer->bind();
-        m_ssaobuffer->bind_colour_texture(0,0);
+        result->bind_colour_texture(0,0);
         p->set_uniform("direction", 0);
         geometry->draw();
         m_ssao_blurbuffer->unbind();
 
-        // BLUR VERTICAL
+        // BLUR VERTICAL (the history must stay unblurred, so the result goes to the occlusion buffer)
         m_ssaobuffer->bind();
         m_ssao_blurbuffer->bind_colour_texture(0,0);
         p->set_uniform("direction", 1);
         geometry->draw();
         m_ssaobuffer->unbind();
         p->release();
+        result = m_ssaobuffer.get();
+    }
+
+    // DEPTH AWARE UPSAMPLING
+    if (scale > 1) {
+        m_upsampled->bind();
+        p = m_ssao_upsample_program.get();
+        p->bind();
+        p->set_uniform("texin_position", 0);
+        gbuffer->bind_colour_texture(1, 0);
+        p->set_uniform("texin_ssao", 1);
+        result->bind_colour_texture(0, 1);
+        geometry->draw();
+        m_upsampled->unbind();
+        p->release();
+        result = m_upsampled.get();
+    }
+    m_result = result;
+    m_valid = true;
+}
+
+bool SSAO::converging() const { return m_temporal && m_valid && m_n_static_frames < n_temporal_frames; }
+
+void SSAO::resize_reduced_buffers(glm::uvec2 size)
+{
+    m_ssaobuffer->resize(size);
+    m_ssao_blurbuffer->resize(size);
+    for (auto& history : m_history) {
+        history->resize(size);
+        history->bind();
+        m_f->glClearBufferfv(GL_COLOR, 0, no_history);
     }
+    Framebuffer::unbind();
 }
 
 void SSAO::resize(glm::uvec2 vp_size) {
-    m_ssaobuffer->resize(vp_size);
-    m_ssao_blurbuffer->resize(vp_size);
+    // the reduced buffers follow in draw, the resolution is part of the config
+    m_upsampled->resize(vp_size);
+    m_valid = false;
 }
 
 void SSAO::bind_ssao_texture(unsigned int location) {
-    m_ssaobuffer->bind_colour_texture(0, location);
+    m_result->bind_colour_texture(0, location);
 }
 
 }
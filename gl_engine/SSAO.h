@@ -17,7 +17,9 @@
  *****************************************************************************/
 #include <vector>
 #include <glm/glm.hpp>
+#include <array>
 #include <memory>
+#include "UniformBufferObjects.h"
 #include "helpers.h"
 #include "nucleus/camera/Definition.h"
 
@@ -40,24 +42,48 @@ public:
     // deletes the GPU Buffer
     ~SSAO();
 
-    void draw(Framebuffer* gbuffer, helpers::ScreenQuadGeometry* geometry,
-              const nucleus::camera::Definition& camera, unsigned int kernel_size, unsigned int blur_level);
+    // scene_changed: camera, gbuffer content or settings changed since the last call. otherwise the pass is skipped, unless
+    // the temporal accumulation hasn't converged yet. the occlusion is computed at a fraction of the gbuffer resolution
+    // (config.m_ssao_resolution) and upsampled with a depth aware (bilateral) filter.
+    void draw(Framebuffer* gbuffer, helpers::ScreenQuadGeometry* geometry, const nucleus::camera::Definition& camera, const uboSharedConfig& config,
+        bool scene_changed);
+
+    // false if draw would skip the pass, i.e., the occlusion of the last frame is still up to date
+    [[nodiscard]] bool needs_update(const Framebuffer* gbuffer, const uboSharedConfig& config, bool scene_changed) const;
 
     void resize(glm::uvec2 vp_size);
 
     void bind_ssao_texture(unsigned int location);
 
+    // true while the temporal accumulation wants more frames with a static camera
+    [[nodiscard]] bool converging() const;
+
 private:
+    static constexpr unsigned n_temporal_frames = 8;
+    static constexpr unsigned n_temporal_subsets = 4; // each frame uses every 4th kernel sample
 
     std::vector<glm::vec3> m_ssao_kernel;
     std::unique_ptr<QOpenGLTexture> m_ssao_noise_texture;
     std::unique_ptr<Framebuffer> m_ssaobuffer;
     std::unique_ptr<Framebuffer> m_ssao_blurbuffer;
+    std::array<std::unique_ptr<Framebuffer>, 2> m_history; // ao, distance, n accumulated frames
+    std::unique_ptr<Framebuffer> m_upsampled;
+    Framebuffer* m_result = nullptr;
     std::shared_ptr<ShaderProgram> m_ssao_program;
     std::shared_ptr<ShaderProgram> m_ssao_blur_program;
+    std::shared_ptr<ShaderProgram> m_ssao_temporal_program;
+    std::shared_ptr<ShaderProgram> m_ssao_upsample_program;
     QOpenGLExtraFunctions *m_f;
 
+    nucleus::camera::Definition m_previous_camera;
+    unsigned m_current_history = 0;
+    unsigned m_frame = 0;
+    unsigned m_n_static_frames = 0;
+    bool m_temporal = false;
+    bool m_valid = false;
+
     void recreate_kernel(unsigned int size = 64);
+    void resize_reduced_buffers(glm::uvec2 size);
 
 };
 
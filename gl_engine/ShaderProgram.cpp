@@ -19,8 +19,11 @@
 
 #include "ShaderProgram.h"
 
+#include <deque>
 #include <iostream>
+#include <mutex>
 
+#include <QCoreApplication>
 #include <QFile>
 #include <QTextStream>
 #include <QRegularExpression>
@@ -44,6 +47,37 @@
 
 using gl_engine::ShaderProgram;
 
+namespace {
+struct UniformNameRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, unsigned> ids;
+    std::deque<std::string> names; // deque, so that references stay valid
+};
+
+UniformNameRegistry& uniform_name_registry()
+{
+    static UniformNameRegistry registry;
+    return registry;
+}
+} // namespace
+
+unsigned gl_engine::uniform_name_id(const std::string& name)
+{
+    auto& registry = uniform_name_registry();
+    std::scoped_lock lock(registry.mutex);
+    const auto [iter, inserted] = registry.ids.try_emplace(name, unsigned(registry.names.size()));
+    if (inserted)
+        registry.names.push_back(name);
+    return iter->second;
+}
+
+const std::string& gl_engine::uniform_name(unsigned id)
+{
+    auto& registry = uniform_name_registry();
+    std::scoped_lock lock(registry.mutex);
+    Q_ASSERT(id < registry.names.size());
+    return registry.names[id];
+}
 
 QString ShaderProgram::get_qrc_or_path_prefix() {
     QString prefix = ":/gl_shaders/";
@@ -99,6 +133,7 @@ void ShaderProgram::preprocess_shader_content_inplace(QString& base) {
 
 // ========== STATIC DECLARATIONS =====================
 std::map<QString, QString> ShaderProgram::shader_file_cache = {};
+ShaderProgram::BuildStatistics ShaderProgram::s_build_statistics = {};
 
 #if ALP_ENABLE_SHADER_NETWORK_HOTRELOAD
 
@@ -313,8 +348,29 @@ void outputMeaningfullErrors(const QString& qtLog, const QString& code, const QS
 
 void ShaderProgram::reload()
 {
+    const auto start = std::chrono::steady_clock::now();
     QString vertexCode = load_and_preprocess_shader_code(gl_engine::ShaderType::VERTEX);
     QString fragmentCode = load_and_preprocess_shader_code(gl_engine::ShaderType::FRAGMENT);
+
+    // Cacheable shaders use Qt's program binary disk cache (glGetProgramBinary / glProgramBinary). The key is a hash of the
+    // preprocessed and versioned source (i.e., including defines and includes), gl vendor, renderer and version. Qt compiles
+    // the sources, if there is no binary or the driver rejects it. Changed sources (reload_shaders) result in a new key.
+    // WebGL has no program binaries, there it always compiles. QT_DISABLE_SHADER_DISK_CACHE=1 disables the cache.
+    {
+        auto program = std::make_unique<QOpenGLShaderProgram>();
+        if (program->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode)
+            && program->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode) && program->link()) {
+            m_q_shader_program = std::move(program);
+            m_cached_attribs.clear();
+            m_cached_uniforms.clear();
+            m_uniform_locations.clear();
+            s_build_statistics.n_programs++;
+            s_build_statistics.build_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            return;
+        }
+    }
+
+    // compile again without the cache, so that errors are reported per stage with the offending lines.
     auto program = std::make_unique<QOpenGLShaderProgram>();
     if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode)) {
         outputMeaningfullErrors(program->log(), vertexCode, m_vertex_shader);
@@ -335,9 +391,46 @@ void ShaderProgram::reload()
         m_q_shader_program = std::move(program);
         m_cached_attribs.clear();
         m_cached_uniforms.clear();
+        m_uniform_locations.clear();
     }
+    s_build_statistics.n_programs++;
+    s_build_statistics.build_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+const ShaderProgram::BuildStatistics& ShaderProgram::build_statistics() { return s_build_statistics; }
+
+bool ShaderProgram::binary_cache_enabled()
+{
+    return !QCoreApplication::testAttribute(Qt::AA_DisableShaderDiskCache) && !qEnvironmentVariableIntValue("QT_DISABLE_SHADER_DISK_CACHE");
+}
+
+int ShaderProgram::uniform_location(unsigned uniform_id)
+{
+    constexpr int unresolved = -2; // -1 is used by OpenGL for uniforms, that don't exist (or were optimised away)
+    if (uniform_id >= m_uniform_locations.size())
+        m_uniform_locations.resize(uniform_id + 1, unresolved);
+    auto& location = m_uniform_locations[uniform_id];
+    if (location == unresolved)
+        location = m_q_shader_program->uniformLocation(uniform_name(uniform_id).c_str());
+    return location;
+}
+
+template <typename T>
+void ShaderProgram::set_uniform(const UniformHandle<T>& handle, const std::type_identity_t<T>& value)
+{
+    m_q_shader_program->setUniformValue(uniform_location(handle.id()), gl_engine::helpers::toQtType(value));
 }
 
+namespace gl_engine {
+template void ShaderProgram::set_uniform<glm::mat4>(const UniformHandle<glm::mat4>&, const glm::mat4&);
+template void ShaderProgram::set_uniform<glm::vec2>(const UniformHandle<glm::vec2>&, const glm::vec2&);
+template void ShaderProgram::set_uniform<glm::vec3>(const UniformHandle<glm::vec3>&, const glm::vec3&);
+template void ShaderProgram::set_uniform<glm::vec4>(const UniformHandle<glm::vec4>&, const glm::vec4&);
+template void ShaderProgram::set_uniform<int>(const UniformHandle<int>&, const int&);
+template void ShaderProgram::set_uniform<unsigned>(const UniformHandle<unsigned>&, const unsigned&);
+template void ShaderProgram::set_uniform<float>(const UniformHandle<float>&, const float&);
+} // namespace gl_engine
+
 template<typename T>
 void ShaderProgram::set_uniform_template(const std::string& name, T value)
 {
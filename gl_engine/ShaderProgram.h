@@ -24,7 +24,9 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <type_traits>
 
+#include <chrono>
 #include <glm/glm.hpp>
 #include <QOpenGLShaderProgram>
 #include <QUrl>
@@ -47,10 +49,31 @@ enum class ShaderType {
     FRAGMENT
 };
 
+// returns a process wide id for the uniform name (the same name always gets the same id). thread safe.
+unsigned uniform_name_id(const std::string& name);
+const std::string& uniform_name(unsigned id);
+
+/// Typed uniform name, meant to be created once (e.g., as a static) and used with any ShaderProgram.
+/// The program resolves the location on first use after linking, afterwards setting the value is an array lookup
+/// instead of building and hashing a std::string.
+template <typename T>
+class UniformHandle {
+public:
+    explicit UniformHandle(const std::string& name)
+        : m_id(uniform_name_id(name))
+    {
+    }
+    [[nodiscard]] unsigned id() const { return m_id; }
+
+private:
+    unsigned m_id;
+};
+
 class ShaderProgram {
 private:
     std::unordered_map<std::string, int> m_cached_uniforms;
     std::unordered_map<std::string, int> m_cached_attribs;
+    std::vector<int> m_uniform_locations; // indexed by uniform name id, see UniformHandle
     std::unique_ptr<QOpenGLShaderProgram> m_q_shader_program;
     QString m_vertex_shader;    // either filename or native shader code
     QString m_fragment_shader;  // either filename or native shader code
@@ -68,6 +91,15 @@ private:
     // content by download if ALP_ENABLE_SHADER_NETWORK_HOTRELOAD is true
     static std::map<QString, QString> shader_file_cache;
 
+public:
+    struct BuildStatistics {
+        unsigned n_programs = 0;
+        std::chrono::microseconds build_time = {}; // reading, preprocessing, compiling or loading the binary and linking
+    };
+
+private:
+    static BuildStatistics s_build_statistics;
+
     // Helper function which returns the content of the given shader file
     // as string. Parameter name has to be the name of the shader, eg. "tile.frag".
     static QString read_file_content_local(const QString& name);
@@ -100,11 +132,18 @@ public:
     void set_uniform(const std::string& name, unsigned value);
     void set_uniform(const std::string& name, float value);
 
+    template <typename T>
+    void set_uniform(const UniformHandle<T>& handle, const std::type_identity_t<T>& value);
+
     void set_uniform_array(const std::string& name, const std::vector<glm::vec4>& array);
     void set_uniform_array(const std::string& name, const std::vector<glm::vec3>& array);
 
     static void reset_shader_cache();
 
+    // accumulated over all programs of the process, used to measure the startup time with and without binary cache.
+    [[nodiscard]] static const BuildStatistics& build_statistics();
+    [[nodiscard]] static bool binary_cache_enabled();
+
 #if ALP_ENABLE_SHADER_NETWORK_HOTRELOAD
     // Redownloads all files inside the shader_file_cache from the
     // WEBGL_SHADER_DOWNLOAD_URL location, and executes the callback when done
@@ -116,6 +155,7 @@ public slots:
 private:
     template <typename T>
     void set_uniform_template(const std::string& name, T value);
+    int uniform_location(unsigned uniform_id);
 
     QString load_and_preprocess_shader_code(gl_engine::ShaderType type);
 
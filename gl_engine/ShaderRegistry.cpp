@@ -35,6 +35,7 @@
  void ShaderRegistry::reload_shaders()
  {
      std::erase_if(m_program_list, [](const auto& wp) { return wp.expired(); });
+     // the program binary cache is keyed by the preprocessed source, changed shaders miss it and are compiled again.
      for (const auto& pp : m_program_list) {
          auto p = pp.lock();
          if (p)
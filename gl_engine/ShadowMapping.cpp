@@ -31,6 +31,55 @@
 
 namespace gl_engine {
 
+namespace {
+// cascades 0 and 1 move with every camera movement, the far ones cover so much ground that they can be reused for a while.
+constexpr unsigned first_cached_cascade = 2;
+// cached cascades are drawn larger, so that they survive some camera movement.
+constexpr float cached_cascade_padding = 0.25f;
+// redraw, if the view frustum covers less than that of a cached cascade (i.e., the resolution would be wasted).
+constexpr float min_cached_cascade_coverage = 0.5f;
+
+// keeps tiles, which can cast shadows into the light space volume. that is, the volume is extended towards the light.
+std::vector<nucleus::tile::TileBounds> cull(
+    const std::vector<nucleus::tile::TileBounds>& draw_list, const glm::mat4& light_space_matrix, const glm::dvec3& camera_position)
+{
+    std::vector<nucleus::tile::TileBounds> culled;
+    culled.reserve(draw_list.size());
+    for (const auto& tile : draw_list) {
+        const auto min = glm::vec3(tile.bounds.min - camera_position);
+        const auto max = glm::vec3(tile.bounds.max - camera_position);
+        glm::vec3 ls_min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 ls_max = glm::vec3(std::numeric_limits<float>::lowest());
+        for (unsigned i = 0; i < 8; ++i) {
+            const auto corner = glm::vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+            const auto ls_corner = glm::vec3(light_space_matrix * glm::vec4(corner, 1.0f)); // orthographic, w == 1
+            ls_min = glm::min(ls_min, ls_corner);
+            ls_max = glm::max(ls_max, ls_corner);
+        }
+        // the far plane is at 1 for both depth clip types. there is no test for the near plane, it faces the light.
+        if (ls_max.x < -1 || ls_min.x > 1 || ls_max.y < -1 || ls_min.y > 1 || ls_min.z > 1)
+            continue;
+        culled.push_back(tile);
+    }
+    return culled;
+}
+
+namespace uniforms {
+    const UniformHandle<int> current_layer("current_layer");
+
+    const std::vector<UniformHandle<unsigned>>& texin_csm()
+    {
+        static const auto handles = []() {
+            std::vector<UniformHandle<unsigned>> handles;
+            for (int i = 0; i < SHADOW_CASCADES; i++)
+                handles.emplace_back("texin_csm" + std::to_string(i + 1));
+            return handles;
+        }();
+        return handles;
+    }
+} // namespace uniforms
+} // namespace
+
 ShadowMapping::ShadowMapping(ShaderRegistry* shader_registry, DepthBufferClipType depth_buffer_clip_type)
     : m_depth_buffer_clip_type(depth_buffer_clip_type)
     , m_shadow_program(std::make_shared<ShaderProgram>("shadowmap.vert", "shadowmap.frag"))
@@ -71,8 +120,41 @@ void ShadowMapping::draw(TileGeometry* tile_geometry,
     auto qlight_dir = shared_config->data.m_sun_light_dir;
     auto light_dir = -glm::vec3(qlight_dir.x(), qlight_dir.y(), qlight_dir.z());
 
-    for (size_t i = 0; i < SHADOW_CASCADES; ++i)
-        shadow_config->data.light_space_view_proj_matrix[i] = getLightSpaceMatrix(shadow_config->data.cascade_planes[i].x, shadow_config->data.cascade_planes[i + 1].x, camera, light_dir);
+    draw_list = nucleus::tile::drawing::sort(draw_list, camera.position() + glm::dvec3(light_dir) * 1'000'000.0);
+
+    std::array<std::vector<nucleus::tile::TileBounds>, SHADOW_CASCADES> cascade_draw_lists;
+    for (unsigned i = 0; i < SHADOW_CASCADES; ++i) {
+        const auto near_plane = shadow_config->data.cascade_planes[i].x;
+        const auto far_plane = shadow_config->data.cascade_planes[i + 1].x;
+        auto& light_space_matrix = shadow_config->data.light_space_view_proj_matrix[i];
+        m_statistics.cached[i] = false;
+
+        if (i < first_cached_cascade) {
+            light_space_matrix = getLightSpaceMatrix(near_plane, far_plane, camera, light_dir);
+            cascade_draw_lists[i] = cull(draw_list, light_space_matrix, camera.position());
+            m_statistics.n_tiles[i] = unsigned(cascade_draw_lists[i].size());
+            continue;
+        }
+
+        auto& cache = m_cached_cascades[i];
+        if (cache.valid && cache.light_dir == light_dir) {
+            // the cached matrix, moved to the current camera position
+            const auto cached_matrix = cache.light_space_matrix * glm::translate(glm::vec3(camera.position() - cache.camera_position));
+            if (cached_cascade_covers(cached_matrix, getCascadeCorners(near_plane, far_plane, camera))) {
+                auto tiles = cull(draw_list, cached_matrix, camera.position());
+                if (tile_geometry->residency_hash(tiles) == cache.tile_hash) {
+                    light_space_matrix = cached_matrix;
+                    m_statistics.cached[i] = true;
+                    m_statistics.n_tiles[i] = unsigned(tiles.size());
+                    continue;
+                }
+            }
+        }
+        light_space_matrix = getLightSpaceMatrix(near_plane, far_plane, camera, light_dir, cached_cascade_padding);
+        cascade_draw_lists[i] = cull(draw_list, light_space_matrix, camera.position());
+        m_statistics.n_tiles[i] = unsigned(cascade_draw_lists[i].size());
+        cache = { true, light_space_matrix, camera.position(), light_dir, tile_geometry->residency_hash(cascade_draw_lists[i]) };
+    }
 
     shadow_config->update_gpu_data();
 
@@ -80,27 +162,42 @@ void ShadowMapping::draw(TileGeometry* tile_geometry,
     m_f->glDepthFunc(GL_LESS);
     m_f->glDisable(GL_CULL_FACE);
     m_shadow_program->bind();
-    draw_list = nucleus::tile::drawing::sort(draw_list, camera.position() + glm::dvec3(light_dir) * 1'000'000.0);
     for (int i = 0; i < SHADOW_CASCADES; i++) {
+        if (m_statistics.cached[i])
+            continue;
         m_shadowmapbuffer[i]->bind();
         m_f->glClearColor(0, 0, 0, 0);
         m_f->glClearDepthf(1.0f); // no reverse z
         m_f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        m_shadow_program->set_uniform("current_layer", i);
-        tile_geometry->draw(m_shadow_program.get(), camera, draw_list);
+        m_shadow_program->set_uniform(uniforms::current_layer, i);
+        if (!cascade_draw_lists[i].empty())
+            tile_geometry->draw(m_shadow_program.get(), camera, cascade_draw_lists[i]);
         m_shadowmapbuffer[i]->unbind();
     }
     m_shadow_program->release();
     m_f->glEnable(GL_CULL_FACE);
 }
 
+const ShadowMapping::Statistics& ShadowMapping::statistics() const { return m_statistics; }
+
+bool ShadowMapping::cached_cascade_covers(const glm::mat4& light_space_matrix, const std::vector<glm::vec4>& corners) const
+{
+    const auto min_z = (m_depth_buffer_clip_type == DepthBufferClipType::MinusOneToOne) ? -1.0f : 0.0f;
+    float coverage = 0;
+    for (const auto& corner : corners) {
+        const auto p = light_space_matrix * corner;
+        if (std::abs(p.x) > 1 || std::abs(p.y) > 1 || p.z < min_z || p.z > 1)
+            return false;
+        coverage = std::max(coverage, std::max(std::abs(p.x), std::abs(p.y)));
+    }
+    return coverage >= min_cached_cascade_coverage;
+}
+
 void ShadowMapping::bind_shadow_maps(ShaderProgram* p, unsigned int start_location) {
     for (int i = 0; i < SHADOW_CASCADES; i++) {
-        std::string uname = "texin_csm";
-        uname.append(std::to_string(i+1));
         unsigned int location = start_location + i;
-        p->set_uniform(uname, location);
+        p->set_uniform(uniforms::texin_csm()[i], location);
         m_shadowmapbuffer[i]->bind_depth_texture(location);
     }
 }
@@ -120,11 +217,17 @@ std::vector<glm::vec4> ShadowMapping::getFrustumCornersWorldSpace(const glm::mat
 
 std::vector<glm::vec4> ShadowMapping::getFrustumCornersWorldSpace(const glm::mat4& proj, const glm::mat4& view) const { return getFrustumCornersWorldSpace(proj * view); }
 
-glm::mat4 ShadowMapping::getLightSpaceMatrix(const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera, const glm::vec3& light_dir) const
+std::vector<glm::vec4> ShadowMapping::getCascadeCorners(const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera) const
 {
     const auto fb_size = camera.viewport_size();
     const auto proj = glm::perspective(glm::radians(camera.field_of_view()), (float)fb_size.x / (float)fb_size.y, nearPlane, farPlane);
-    const auto corners = getFrustumCornersWorldSpace(proj, camera.local_view_matrix());
+    return getFrustumCornersWorldSpace(proj, camera.local_view_matrix());
+}
+
+glm::mat4 ShadowMapping::getLightSpaceMatrix(
+    const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera, const glm::vec3& light_dir, float padding) const
+{
+    const auto corners = getCascadeCorners(nearPlane, farPlane, camera);
 
     glm::vec3 center = glm::vec3(0, 0, 0);
     for (const auto& v : corners)
@@ -150,6 +253,13 @@ glm::mat4 ShadowMapping::getLightSpaceMatrix(const float nearPlane, const float
         maxZ = std::max(maxZ, trf.z);
     }
 
+    const auto padding_x = (maxX - minX) * double(padding) / 2;
+    const auto padding_y = (maxY - minY) * double(padding) / 2;
+    minX -= padding_x;
+    maxX += padding_x;
+    minY -= padding_y;
+    maxY += padding_y;
+
     // Tune this parameter according to the scene
     constexpr float zMult = 10.0f;
 
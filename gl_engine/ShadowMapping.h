@@ -22,6 +22,7 @@
 #include "nucleus/camera/Definition.h"
 #include "nucleus/tile/DrawListGenerator.h"
 #include "types.h"
+#include <array>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -46,6 +47,11 @@ struct uboShadowConfig;
 class ShadowMapping
 {
 public:
+    struct Statistics {
+        std::array<unsigned, SHADOW_CASCADES> n_tiles = {}; // after culling against the light space volume of the cascade
+        std::array<bool, SHADOW_CASCADES> cached = {}; // the cascade was not redrawn, but reused from an earlier frame
+    };
+
     ShadowMapping(ShaderRegistry* shader_registry, DepthBufferClipType depth_buffer_clip_type);
 
     ~ShadowMapping();
@@ -59,15 +65,33 @@ public:
     void bind_shadow_maps(ShaderProgram* program, unsigned int start_location);
     nucleus::camera::Frustum getFrustum(const nucleus::camera::Definition& camera);
 
+    // of the last draw call
+    [[nodiscard]] const Statistics& statistics() const;
+
 private:
+    // far cascades are kept over frames, as long as they still cover their part of the view frustum
+    struct CachedCascade {
+        bool valid = false;
+        glm::mat4 light_space_matrix = {}; // relative to camera_position, like the other matrices
+        glm::dvec3 camera_position = {};
+        glm::vec3 light_dir = {};
+        size_t tile_hash = 0;
+    };
+
     DepthBufferClipType m_depth_buffer_clip_type = DepthBufferClipType(-1);
     std::shared_ptr<ShaderProgram> m_shadow_program;
     std::vector<std::unique_ptr<Framebuffer>> m_shadowmapbuffer;
     QOpenGLExtraFunctions *m_f;
+    std::array<CachedCascade, SHADOW_CASCADES> m_cached_cascades;
+    Statistics m_statistics;
 
     std::vector<glm::vec4> getFrustumCornersWorldSpace(const glm::mat4& projview) const;
     std::vector<glm::vec4> getFrustumCornersWorldSpace(const glm::mat4& proj, const glm::mat4& view) const;
-    glm::mat4 getLightSpaceMatrix(const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera, const glm::vec3& light_dir) const;
+    std::vector<glm::vec4> getCascadeCorners(const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera) const;
+    // padding grows the volume sideways, as a fraction of its size
+    glm::mat4 getLightSpaceMatrix(const float nearPlane, const float farPlane, const nucleus::camera::Definition& camera, const glm::vec3& light_dir, float padding = 0) const;
+    // whether the (moved) volume of a cached cascade still contains the cascade's part of the view frustum, without wasting too much resolution
+    bool cached_cascade_covers(const glm::mat4& light_space_matrix, const std::vector<glm::vec4>& corners) const;
     std::vector<glm::mat4> getLightSpaceMatrices(const nucleus::camera::Definition& camera, const glm::vec3& light_dir);
 
 };
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "StagingBuffer.h"
+
+#include <QOpenGLContext>
+#include <QtAssert>
+
+namespace gl_engine {
+
+namespace {
+    // offsets passed to glTexSubImage must be aligned to the size of the pixel type
+    constexpr size_t offset_alignment = 16;
+} // namespace
+
+StagingBuffer::StagingBuffer(size_t capacity)
+    : m_buffer(QOpenGLBuffer::PixelUnpackBuffer)
+    , m_capacity(capacity)
+{
+    Q_ASSERT(QOpenGLContext::currentContext());
+    m_buffer.create();
+    m_buffer.bind();
+    m_buffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+    m_buffer.allocate(int(m_capacity));
+    m_buffer.release();
+}
+
+StagingBuffer::~StagingBuffer()
+{
+    if (QOpenGLContext::currentContext())
+        m_buffer.destroy();
+}
+
+void StagingBuffer::begin_frame()
+{
+    if (m_offset == 0)
+        return;
+    // orphaning: the driver hands out fresh storage, the old one lives until the gpu is done with it.
+    m_buffer.bind();
+    m_buffer.allocate(int(m_capacity));
+    m_buffer.release();
+    m_offset = 0;
+}
+
+const void* StagingBuffer::stage(const void* data, size_t n_bytes)
+{
+    const auto offset = (m_offset + offset_alignment - 1) / offset_alignment * offset_alignment;
+    if (offset + n_bytes > m_capacity) {
+        release();
+        return data;
+    }
+    m_buffer.bind();
+    m_buffer.write(int(offset), data, int(n_bytes));
+    m_offset = offset + n_bytes;
+    return reinterpret_cast<const void*>(offset);
+}
+
+void StagingBuffer::release() { QOpenGLBuffer::release(QOpenGLBuffer::PixelUnpackBuffer); }
+
+} // namespace gl_engine
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QOpenGLBuffer>
+#include <cstddef>
+
+namespace gl_engine {
+
+/// Pixel unpack buffer for texture uploads. Copying into it is cheap, the transfer into the texture is then done by the gpu
+/// asynchronously, instead of the driver copying client memory during glTexSubImage.
+/// The storage is orphaned in begin_frame(), so that writing never waits for the transfers of the previous frame.
+class StagingBuffer {
+public:
+    explicit StagingBuffer(size_t capacity); // needs OpenGL context
+    StagingBuffer(const StagingBuffer&) = delete;
+    StagingBuffer& operator=(const StagingBuffer&) = delete;
+    ~StagingBuffer();
+
+    void begin_frame();
+    /// Copies the data into the buffer and leaves it bound. Returns the pointer for glTexSubImage (an offset into the buffer).
+    /// If the buffer is full, it is unbound and data is returned, i.e., the upload goes through client memory.
+    [[nodiscard]] const void* stage(const void* data, size_t n_bytes);
+    /// Unbinds the buffer, call after the texture uploads.
+    static void release();
+
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+    [[nodiscard]] size_t n_staged_bytes() const { return m_offset; }
+
+private:
+    QOpenGLBuffer m_buffer;
+    size_t m_capacity = 0;
+    size_t m_offset = 0;
+};
+
+} // namespace gl_engine
@@ -17,6 +17,7 @@
  *****************************************************************************/
 
 #include "Texture.h"
+#include "StagingBuffer.h"
 #include "nucleus/utils/ColourTexture.h"
 
 #include <QOpenGLExtraFunctions>
@@ -176,6 +177,16 @@ void gl_engine::Texture::upload(const nucleus::utils::ColourTexture& texture, un
 }
 
 void gl_engine::Texture::upload(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned int array_index)
+{
+    upload_mipmapped(mipped_texture, array_index, nullptr);
+}
+
+void gl_engine::Texture::upload(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned int array_index, StagingBuffer& staging)
+{
+    upload_mipmapped(mipped_texture, array_index, &staging);
+}
+
+void gl_engine::Texture::upload_mipmapped(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned int array_index, StagingBuffer* staging)
 {
     Q_ASSERT(mipped_texture.size() > 0);
     Q_ASSERT(mipped_texture.front().width() == m_width);
@@ -189,20 +200,32 @@ void gl_engine::Texture::upload(const nucleus::utils::MipmappedColourTexture& mi
     for (const auto& texture : mipped_texture) {
         const auto width = GLsizei(texture.width());
         const auto height = GLsizei(texture.height());
+        const void* data = staging ? staging->stage(texture.data(), texture.n_bytes()) : texture.data();
         if (m_format == Format::CompressedRGBA8) {
             const auto format = gl_engine::Texture::compressed_texture_format();
-            f->glCompressedTexSubImage3D(
-                GLenum(m_target), mip_level, 0, 0, GLint(array_index), width, height, 1, format, GLsizei(texture.n_bytes()), texture.data());
+            f->glCompressedTexSubImage3D(GLenum(m_target), mip_level, 0, 0, GLint(array_index), width, height, 1, format, GLsizei(texture.n_bytes()), data);
         } else if (m_format == Format::RGBA8 || m_format == Format::SRGBA8) {
-            f->glTexSubImage3D(GLenum(m_target), mip_level, 0, 0, GLint(array_index), width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, texture.data());
+            f->glTexSubImage3D(GLenum(m_target), mip_level, 0, 0, GLint(array_index), width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
         } else {
             Q_ASSERT(false);
         }
         ++mip_level;
     }
+    if (staging)
+        StagingBuffer::release();
 }
 
 template <typename T> void gl_engine::Texture::upload(const radix::Raster<T>& texture, unsigned int array_index)
+{
+    upload_layer(texture, array_index, nullptr);
+}
+
+template <typename T> void gl_engine::Texture::upload(const radix::Raster<T>& texture, unsigned int array_index, StagingBuffer& staging)
+{
+    upload_layer(texture, array_index, &staging);
+}
+
+template <typename T> void gl_engine::Texture::upload_layer(const radix::Raster<T>& texture, unsigned int array_index, StagingBuffer* staging)
 {
     Q_ASSERT(m_target == Target::_2dArray);
 
@@ -224,11 +247,16 @@ template <typename T> void gl_engine::Texture::upload(const radix::Raster<T>& te
     auto* f = QOpenGLContext::currentContext()->extraFunctions();
     f->glBindTexture(GLenum(m_target), m_id);
     f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    f->glTexSubImage3D(GLenum(m_target), 0, 0, 0, GLint(array_index), width, height, 1, p.format, p.type, texture.bytes().data());
+    const auto n_bytes = size_t(width) * size_t(height) * sizeof(T);
+    const void* data = staging ? staging->stage(texture.bytes().data(), n_bytes) : texture.bytes().data();
+    f->glTexSubImage3D(GLenum(m_target), 0, 0, 0, GLint(array_index), width, height, 1, p.format, p.type, data);
+    if (staging)
+        StagingBuffer::release();
 
     if (m_min_filter == Filter::MipMapLinear)
         f->glGenerateMipmap(GLenum(m_target));
 }
+template void gl_engine::Texture::upload<uint16_t>(const radix::Raster<uint16_t>&, unsigned, StagingBuffer&);
 template void gl_engine::Texture::upload<uint8_t>(const radix::Raster<uint8_t>&, unsigned);
 template void gl_engine::Texture::upload<uint16_t>(const radix::Raster<uint16_t>&, unsigned);
 template void gl_engine::Texture::upload<uint32_t>(const radix::Raster<uint32_t>&, unsigned);
@@ -28,6 +28,8 @@
 #include <nucleus/utils/ColourTexture.h>
 
 namespace gl_engine {
+class StagingBuffer;
+
 class Texture {
 public:
     enum class Target : GLenum { _2d = GL_TEXTURE_2D, _2dArray = GL_TEXTURE_2D_ARRAY }; // no 1D textures in webgl
@@ -63,6 +65,9 @@ public:
     void upload(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned array_index);
     template <typename T> void upload(const radix::Raster<T>& texture, unsigned int array_index);
     template <typename T> void upload(const radix::Raster<T>& texture);
+    /// uploads through the staging buffer, the transfer into the texture happens asynchronously on the gpu.
+    void upload(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned array_index, StagingBuffer& staging);
+    template <typename T> void upload(const radix::Raster<T>& texture, unsigned int array_index, StagingBuffer& staging);
 
     static GLenum compressed_texture_format();
     static nucleus::utils::ColourTexture::Format compression_algorithm();
@@ -71,6 +76,10 @@ protected:
     static GLenum max_anisotropy_param();
     static float max_anisotropy();
 
+private:
+    void upload_mipmapped(const nucleus::utils::MipmappedColourTexture& mipped_texture, unsigned array_index, StagingBuffer* staging);
+    template <typename T> void upload_layer(const radix::Raster<T>& texture, unsigned int array_index, StagingBuffer* staging);
+
 private:
     GLuint m_id = GLuint(-1);
     Target m_target = Target::_2d;
@@ -93,4 +102,6 @@ extern template void gl_engine::Texture::upload<uint32_t>(const radix::Raster<ui
 extern template void gl_engine::Texture::upload<glm::vec<2, uint32_t>>(const radix::Raster<glm::vec<2, uint32_t>>&, unsigned int);
 extern template void gl_engine::Texture::upload<glm::vec<3, uint32_t>>(const radix::Raster<glm::vec<3, uint32_t>>&, unsigned int);
 
+extern template void gl_engine::Texture::upload<uint16_t>(const radix::Raster<uint16_t>&, unsigned int, StagingBuffer&);
+
 } // namespace gl_engine
@@ -83,19 +83,48 @@ void TextureLayer::update_gpu_tiles(const std::vector<nucleus::tile::Id>& delete
         return;
 
     for (const auto& tile_id : deleted_tiles) {
+        if (m_upload_queue.remove(tile_id))
+            continue;
+        m_uploads_in_flight.remove(tile_id);
         m_gpu_array_helper.remove_tile(tile_id);
     }
     for (const auto& tile : new_tiles) {
         // test for validity
         Q_ASSERT(tile.id.zoom_level < 100);
         Q_ASSERT(tile.texture);
+    }
+    m_upload_queue.push(new_tiles);
+    if (!deleted_tiles.empty())
+        ++m_generation;
+}
 
-        // find empty spot and upload texture
-        const auto layer_index = m_gpu_array_helper.add_tile(tile.id);
-        m_texture_array->upload(*tile.texture, layer_index);
+void TextureLayer::upload_pending(const UploadPriority& priority, UploadBudget& budget, StagingBuffer& staging)
+{
+    const auto finished = m_uploads_in_flight.take_finished();
+    for (const auto& id : finished)
+        m_gpu_array_helper.commit_tile(id);
+    if (!finished.empty())
+        ++m_generation;
+
+    const auto n_bytes = [](const nucleus::tile::GpuTextureTile& tile) {
+        size_t n = 0;
+        for (const auto& level : *tile.texture)
+            n += level.n_bytes();
+        return n;
+    };
+    const auto tiles = m_upload_queue.take(priority, n_bytes, budget);
+    std::vector<nucleus::tile::Id> uploaded;
+    uploaded.reserve(tiles.size());
+    for (const auto& tile : tiles) {
+        const auto layer_index = m_gpu_array_helper.reserve_tile(tile.id);
+        m_texture_array->upload(*tile.texture, layer_index, staging);
+        uploaded.push_back(tile.id);
     }
+    m_uploads_in_flight.insert(std::move(uploaded));
 }
 
+bool TextureLayer::has_pending_uploads() const { return !m_upload_queue.empty() || !m_uploads_in_flight.empty(); }
+
 void TextureLayer::set_tile_limit(unsigned int new_limit)
 {
     Q_ASSERT(new_limit < 2048); // array textures with size > 2048 are not supported on all devices
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "UniformBuffer.h"
+#include "UploadQueue.h"
 #include <QObject>
 #include <nucleus/tile/DrawListGenerator.h>
 #include <nucleus/tile/GpuArrayHelper.h>
@@ -37,6 +38,7 @@ namespace gl_engine {
 class ShaderRegistry;
 class ShaderProgram;
 class Texture;
+class StagingBuffer;
 class TileGeometry;
 class AvalancheWarningLayer;
 
@@ -50,6 +52,12 @@ public:
     void draw(const TileGeometry& tile_geometry, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_list) const;
 
     unsigned int tile_count() const;
+    /// incremented whenever the gpu tiles change, Window compares it to decide whether a frame has to be redrawn.
+    [[nodiscard]] unsigned generation() const { return m_generation; }
+
+    /// same as TileGeometry::upload_pending
+    void upload_pending(const UploadPriority& priority, UploadBudget& budget, StagingBuffer& staging);
+    [[nodiscard]] bool has_pending_uploads() const;
 
 public slots:
     void update_gpu_tiles(const std::vector<nucleus::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuTextureTile>& new_tiles);
@@ -65,5 +73,8 @@ private:
     std::unique_ptr<Texture> m_instanced_zoom;
     std::unique_ptr<Texture> m_instanced_array_index;
     nucleus::tile::GpuArrayHelper m_gpu_array_helper;
+    UploadQueue<nucleus::tile::GpuTextureTile> m_upload_queue;
+    UploadFences m_uploads_in_flight;
+    unsigned m_generation = 0;
 };
 } // namespace gl_engine
@@ -28,12 +28,18 @@
 #include <QOpenGLVertexArrayObject>
 #include <QtAssert>
 #include <nucleus/camera/Definition.h>
+#include <nucleus/tile/OcclusionBuffer.h>
 #include <nucleus/utils/terrain_mesh_index_generator.h>
 
 namespace gl_engine {
 
 namespace {
     template <typename T> int bufferLengthInBytes(const std::vector<T>& vec) { return int(vec.size() * sizeof(T)); }
+
+    namespace uniforms {
+        const UniformHandle<unsigned> n_edge_vertices("n_edge_vertices");
+        const UniformHandle<int> height_tex_sampler("height_tex_sampler");
+    } // namespace uniforms
 } // namespace
 
 TileGeometry::TileGeometry(unsigned int texture_resolution)
@@ -44,17 +50,25 @@ TileGeometry::TileGeometry(unsigned int texture_resolution)
 void TileGeometry::init()
 {
 
+    using nucleus::tile::drawing::mesh_strides;
     using nucleus::utils::terrain_mesh_index_generator::surface_quads_with_curtains;
     Q_ASSERT(QOpenGLContext::currentContext());
-    const auto indices = surface_quads_with_curtains<uint16_t>(m_texture_resolution);
-    auto index_buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::IndexBuffer);
-    index_buffer->create();
-    index_buffer->bind();
-    index_buffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
-    index_buffer->allocate(indices.data(), bufferLengthInBytes(indices));
-    index_buffer->release();
-    m_index_buffer.first = std::move(index_buffer);
-    m_index_buffer.second = indices.size();
+    std::vector<uint16_t> indices;
+    for (size_t i = 0; i < mesh_strides.size(); ++i) {
+        if ((m_texture_resolution - 1) % mesh_strides[i] != 0) { // never chosen, mesh_errors are infinite
+            m_index_ranges[i] = m_index_ranges[i - 1];
+            continue;
+        }
+        const auto variant = surface_quads_with_curtains<uint16_t>(m_texture_resolution, mesh_strides[i]);
+        m_index_ranges[i] = { indices.size(), variant.size() };
+        indices.insert(indices.end(), variant.begin(), variant.end());
+    }
+    m_index_buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::IndexBuffer);
+    m_index_buffer->create();
+    m_index_buffer->bind();
+    m_index_buffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_index_buffer->allocate(indices.data(), bufferLengthInBytes(indices));
+    m_index_buffer->release();
 
     m_instance_bounds_buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
     m_instance_bounds_buffer->create();
@@ -80,10 +94,16 @@ void TileGeometry::init()
     m_dtm_zoom_buffer->setUsagePattern(QOpenGLBuffer::DynamicDraw);
     m_dtm_zoom_buffer->allocate(GLsizei(1024 * sizeof(uint8_t)));
 
+    m_instance_draw_index_buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
+    m_instance_draw_index_buffer->create();
+    m_instance_draw_index_buffer->bind();
+    m_instance_draw_index_buffer->setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_instance_draw_index_buffer->allocate(GLsizei(1024 * sizeof(uint16_t)));
+
     m_vao = std::make_unique<QOpenGLVertexArrayObject>();
     m_vao->create();
     m_vao->bind();
-    m_index_buffer.first->bind();
+    m_index_buffer->bind();
     m_vao->release();
 
     m_dtm_textures = std::make_unique<Texture>(Texture::Target::_2dArray, Texture::Format::R16UI);
@@ -91,80 +111,106 @@ void TileGeometry::init()
     m_dtm_textures->allocate_array(m_texture_resolution, m_texture_resolution, unsigned(m_gpu_array_helper.size()));
 
     auto example_shader = std::make_shared<ShaderProgram>("tile.vert", "tile.frag");
-    const auto instance_bounds_location = example_shader->attribute_location("instance_bounds");
-    qDebug() << "attrib location for instance_bounds: " << instance_bounds_location;
-    const auto instance_tile_id_location = example_shader->attribute_location("instance_tile_id_packed");
-    qDebug() << "attrib location for instance_tile_id_packed: " << instance_tile_id_location;
-    const auto dtm_array_index_location = example_shader->attribute_location("dtm_array_index");
-    qDebug() << "attrib location for dtm_array_index: " << dtm_array_index_location;
-    const auto dtm_zoom_location = example_shader->attribute_location("dtm_zoom");
-    qDebug() << "attrib location for dtm_zoom: " << dtm_array_index_location;
+    m_instance_bounds_location = example_shader->attribute_location("instance_bounds");
+    qDebug() << "attrib location for instance_bounds: " << m_instance_bounds_location;
+    m_instance_tile_id_location = example_shader->attribute_location("instance_tile_id_packed");
+    qDebug() << "attrib location for instance_tile_id_packed: " << m_instance_tile_id_location;
+    m_dtm_array_index_location = example_shader->attribute_location("dtm_array_index");
+    qDebug() << "attrib location for dtm_array_index: " << m_dtm_array_index_location;
+    m_dtm_zoom_location = example_shader->attribute_location("dtm_zoom");
+    qDebug() << "attrib location for dtm_zoom: " << m_dtm_zoom_location;
+    m_instance_draw_index_location = example_shader->attribute_location("instance_draw_index");
+    qDebug() << "attrib location for instance_draw_index: " << m_instance_draw_index_location;
 
     m_vao->bind();
     QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
-    if (instance_bounds_location != -1) {
+    for (const auto location :
+        { m_instance_bounds_location, m_instance_tile_id_location, m_dtm_array_index_location, m_dtm_zoom_location, m_instance_draw_index_location }) {
+        if (location == -1)
+            continue;
+        f->glEnableVertexAttribArray(GLuint(location));
+        f->glVertexAttribDivisor(GLuint(location), 1);
+    }
+    set_first_instance(0);
+    m_vao->release();
+}
+
+void TileGeometry::set_first_instance(unsigned first_instance) const
+{
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    const auto offset = [&](size_t element_size) { return reinterpret_cast<const void*>(first_instance * element_size); };
+    if (m_instance_bounds_location != -1) {
         m_instance_bounds_buffer->bind();
-        f->glEnableVertexAttribArray(GLuint(instance_bounds_location));
-        f->glVertexAttribPointer(GLuint(instance_bounds_location), /*size*/ 4, /*type*/ GL_FLOAT, /*normalised*/ GL_FALSE, /*stride*/ 0, nullptr);
-        f->glVertexAttribDivisor(GLuint(instance_bounds_location), 1);
+        f->glVertexAttribPointer(GLuint(m_instance_bounds_location), /*size*/ 4, /*type*/ GL_FLOAT, /*normalised*/ GL_FALSE, /*stride*/ 0, offset(sizeof(glm::vec4)));
     }
-    if (instance_tile_id_location != -1) {
+    if (m_instance_tile_id_location != -1) {
         m_instance_tile_id_buffer->bind();
-        f->glEnableVertexAttribArray(GLuint(instance_tile_id_location));
-        f->glVertexAttribIPointer(GLuint(instance_tile_id_location), /*size*/ 2, /*type*/ GL_UNSIGNED_INT, /*stride*/ 0, nullptr);
-        f->glVertexAttribDivisor(GLuint(instance_tile_id_location), 1);
+        f->glVertexAttribIPointer(GLuint(m_instance_tile_id_location), /*size*/ 2, /*type*/ GL_UNSIGNED_INT, /*stride*/ 0, offset(sizeof(glm::u32vec2)));
     }
-    if (dtm_array_index_location != -1) {
+    if (m_dtm_array_index_location != -1) {
         m_dtm_array_index_buffer->bind();
-        f->glEnableVertexAttribArray(GLuint(dtm_array_index_location));
-        f->glVertexAttribIPointer(GLuint(dtm_array_index_location), /*size*/ 1, /*type*/ GL_UNSIGNED_SHORT, /*stride*/ 0, nullptr);
-        f->glVertexAttribDivisor(GLuint(dtm_array_index_location), 1);
+        f->glVertexAttribIPointer(GLuint(m_dtm_array_index_location), /*size*/ 1, /*type*/ GL_UNSIGNED_SHORT, /*stride*/ 0, offset(sizeof(uint16_t)));
     }
-    if (dtm_zoom_location != -1) {
+    if (m_dtm_zoom_location != -1) {
         m_dtm_zoom_buffer->bind();
-        f->glEnableVertexAttribArray(GLuint(dtm_zoom_location));
-        f->glVertexAttribIPointer(GLuint(dtm_zoom_location), /*size*/ 1, /*type*/ GL_UNSIGNED_BYTE, /*stride*/ 0, nullptr);
-        f->glVertexAttribDivisor(GLuint(dtm_zoom_location), 1);
+        f->glVertexAttribIPointer(GLuint(m_dtm_zoom_location), /*size*/ 1, /*type*/ GL_UNSIGNED_BYTE, /*stride*/ 0, offset(sizeof(uint8_t)));
+    }
+    if (m_instance_draw_index_location != -1) {
+        m_instance_draw_index_buffer->bind();
+        f->glVertexAttribIPointer(GLuint(m_instance_draw_index_location), /*size*/ 1, /*type*/ GL_UNSIGNED_SHORT, /*stride*/ 0, offset(sizeof(uint16_t)));
     }
 }
 
 void TileGeometry::draw(ShaderProgram* shader, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_list) const
 {
     QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
-    shader->set_uniform("n_edge_vertices", m_texture_resolution);
-    shader->set_uniform("height_tex_sampler", 1);
+    shader->set_uniform(uniforms::n_edge_vertices, m_texture_resolution);
+    shader->set_uniform(uniforms::height_tex_sampler, 1);
 
     m_dtm_textures->bind(1);
     m_vao->bind();
 
-    std::vector<glm::vec4> bounds;
-    bounds.reserve(draw_list.size());
+    const auto n_instances = std::min(unsigned(draw_list.size()), 1024u);
+
+    // coarser meshes for smooth or distant tiles. instances are grouped by mesh variant, one draw call per variant.
+    // tiles drawn with the heights of a parent are already coarser and keep the full mesh.
+    std::array<unsigned, nucleus::tile::drawing::mesh_strides.size()> n_per_variant = {};
+    std::vector<unsigned> variants(n_instances, 0);
+    for (unsigned i = 0; i < n_instances; ++i) {
+        const auto& tile = draw_list[i];
+        if (m_gpu_array_helper.layer(tile.id).id == tile.id) {
+            if (const auto errors = m_mesh_errors.find(tile.id); errors != m_mesh_errors.end())
+                variants[i] = nucleus::tile::drawing::mesh_variant(tile, errors->second, camera);
+        }
+        ++n_per_variant[variants[i]];
+    }
+    std::array<unsigned, nucleus::tile::drawing::mesh_strides.size()> first_instance = {};
+    for (size_t v = 1; v < first_instance.size(); ++v)
+        first_instance[v] = first_instance[v - 1] + n_per_variant[v - 1];
 
-    std::vector<glm::u32vec2> packed_id;
-    packed_id.reserve(draw_list.size());
+    std::vector<glm::vec4> bounds(n_instances);
+    std::vector<glm::u32vec2> packed_id(n_instances);
+    std::vector<uint16_t> draw_index(n_instances); // the layers' per tile lookups are in draw list order
 
     radix::Raster<uint8_t> zoom_level_raster(glm::uvec2 { 1024, 1 });
     radix::Raster<uint16_t> array_index_raster(glm::uvec2 { 1024, 1 });
-    radix::Raster<glm::vec4> bounds_raster(glm::uvec2 { 1024, 1 });
-    for (unsigned i = 0; i < std::min(unsigned(draw_list.size()), 1024u); ++i) {
+    auto next_instance = first_instance;
+    for (unsigned i = 0; i < n_instances; ++i) {
         const auto& tile = draw_list[i];
-        bounds.push_back(glm::vec4 { tile.bounds.min.x - camera.position().x,
+        const auto slot = next_instance[variants[i]]++;
+        bounds[slot] = glm::vec4 { tile.bounds.min.x - camera.position().x,
             tile.bounds.min.y - camera.position().y,
             tile.bounds.max.x - camera.position().x,
-            tile.bounds.max.y - camera.position().y });
-        packed_id.push_back(nucleus::srs::pack(tile.id));
+            tile.bounds.max.y - camera.position().y };
+        packed_id[slot] = nucleus::srs::pack(tile.id);
+        draw_index[slot] = uint16_t(i);
 
         const auto layer = m_gpu_array_helper.layer(draw_list[i].id);
         if (layer.id.zoom_level > 50) // happens during startup
             continue;
 
-        zoom_level_raster.pixel({ i, 0 }) = layer.id.zoom_level;
-        array_index_raster.pixel({ i, 0 }) = layer.index;
-        const auto geom_aabb = m_aabb_decorator->aabb(layer.id);
-        bounds_raster.pixel({ i, 0 }) = glm::vec4 { geom_aabb.min.x - camera.position().x,
-            geom_aabb.min.y - camera.position().y,
-            geom_aabb.max.x - camera.position().x,
-            geom_aabb.max.y - camera.position().y };
+        zoom_level_raster.pixel({ slot, 0 }) = layer.id.zoom_level;
+        array_index_raster.pixel({ slot, 0 }) = layer.index;
     }
 
     m_instance_bounds_buffer->bind();
@@ -173,13 +219,27 @@ void TileGeometry::draw(ShaderProgram* shader, const nucleus::camera::Definition
     m_instance_tile_id_buffer->bind();
     m_instance_tile_id_buffer->write(0, packed_id.data(), GLsizei(packed_id.size() * sizeof(decltype(packed_id)::value_type)));
 
+    m_instance_draw_index_buffer->bind();
+    m_instance_draw_index_buffer->write(0, draw_index.data(), GLsizei(draw_index.size() * sizeof(uint16_t)));
+
     m_dtm_array_index_buffer->bind();
     m_dtm_array_index_buffer->write(0, array_index_raster.bytes().data(), GLsizei(array_index_raster.width() * sizeof(uint16_t)));
 
     m_dtm_zoom_buffer->bind();
     m_dtm_zoom_buffer->write(0, zoom_level_raster.bytes().data(), GLsizei(zoom_level_raster.width() * sizeof(uint8_t)));
 
-    f->glDrawElementsInstanced(GL_TRIANGLE_STRIP, GLsizei(m_index_buffer.second), GL_UNSIGNED_SHORT, nullptr, GLsizei(draw_list.size()));
+    for (size_t v = 0; v < n_per_variant.size(); ++v) {
+        if (n_per_variant[v] == 0)
+            continue;
+        set_first_instance(first_instance[v]);
+        const auto [index_offset, n_indices] = m_index_ranges[v];
+        f->glDrawElementsInstanced(GL_TRIANGLE_STRIP,
+            GLsizei(n_indices),
+            GL_UNSIGNED_SHORT,
+            reinterpret_cast<const void*>(index_offset * sizeof(uint16_t)),
+            GLsizei(n_per_variant[v]));
+    }
+    m_n_drawn_per_mesh_variant = n_per_variant;
     f->glBindVertexArray(0);
 }
 
@@ -193,6 +253,17 @@ void TileGeometry::set_tile_limit(unsigned int new_limit)
 
 unsigned TileGeometry::tile_count() const { return m_gpu_array_helper.n_occupied(); }
 
+size_t TileGeometry::residency_hash(const std::vector<nucleus::tile::TileBounds>& draw_list) const
+{
+    const auto hasher = nucleus::tile::Id::Hasher();
+    size_t hash = draw_list.size();
+    for (const auto& tile : draw_list) {
+        const auto layer = m_gpu_array_helper.layer(tile.id);
+        hash += (hasher(tile.id) * size_t(0x9e3779b9)) ^ (hasher(layer.id) + layer.index);
+    }
+    return hash;
+}
+
 void TileGeometry::update_gpu_tiles(const std::vector<radix::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuGeometryTile>& new_tiles)
 {
 
@@ -200,17 +271,54 @@ void TileGeometry::update_gpu_tiles(const std::vector<radix::tile::Id>& deleted_
         return;
 
     for (const auto& id : deleted_tiles) {
+        if (m_upload_queue.remove(id))
+            continue; // never reached the gpu
+        m_uploads_in_flight.remove(id);
         m_gpu_array_helper.remove_tile(id);
+        m_occluder_heights.erase(id);
+        m_mesh_errors.erase(id);
     }
     for (const auto& tile : new_tiles) {
         // test for validity
         Q_ASSERT(tile.id.zoom_level < 100);
         Q_ASSERT(tile.surface);
+    }
+    m_upload_queue.push(new_tiles);
+    if (!deleted_tiles.empty())
+        ++m_generation;
+}
 
+void TileGeometry::upload_pending(const UploadPriority& priority, UploadBudget& budget, StagingBuffer& staging)
+{
+    const auto finished = m_uploads_in_flight.take_finished();
+    for (const auto& id : finished)
+        m_gpu_array_helper.commit_tile(id);
+    if (!finished.empty())
+        ++m_generation;
+
+    const auto n_bytes = [](const nucleus::tile::GpuGeometryTile& tile) { return size_t(tile.surface->width()) * tile.surface->height() * sizeof(uint16_t); };
+    const auto tiles = m_upload_queue.take(priority, n_bytes, budget);
+    std::vector<nucleus::tile::Id> uploaded;
+    uploaded.reserve(tiles.size());
+    for (const auto& tile : tiles) {
         // find empty spot and upload texture
-        const auto layer_index = m_gpu_array_helper.add_tile(tile.id);
-        m_dtm_textures->upload(*tile.surface, layer_index);
+        const auto layer_index = m_gpu_array_helper.reserve_tile(tile.id);
+        m_dtm_textures->upload(*tile.surface, layer_index, staging);
+        m_occluder_heights[tile.id] = nucleus::tile::OcclusionBuffer::occluder_heights(*tile.surface);
+        m_mesh_errors[tile.id] = nucleus::tile::drawing::mesh_errors(*tile.surface);
+        uploaded.push_back(tile.id);
     }
+    m_uploads_in_flight.insert(std::move(uploaded));
+}
+
+bool TileGeometry::has_pending_uploads() const { return !m_upload_queue.empty() || !m_uploads_in_flight.empty(); }
+
+const radix::Raster<float>* TileGeometry::occluder_heights(const nucleus::tile::Id& id) const
+{
+    if (!m_gpu_array_helper.contains(id))
+        return nullptr;
+    const auto it = m_occluder_heights.find(id);
+    return it == m_occluder_heights.end() ? nullptr : &it->second;
 }
 
 } // namespace gl_engine
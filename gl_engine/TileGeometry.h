@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include "UploadQueue.h"
 #include <QObject>
 #include <nucleus/tile/DrawListGenerator.h>
 #include <nucleus/tile/GpuArrayHelper.h>
+#include <nucleus/tile/drawing.h>
 #include <nucleus/tile/types.h>
 #include <radix/raster.h>
 
@@ -36,6 +38,7 @@ namespace gl_engine {
 class ShaderRegistry;
 class ShaderProgram;
 class Texture;
+class StagingBuffer;
 
 class TileGeometry : public QObject {
     Q_OBJECT
@@ -46,6 +49,19 @@ public:
     void draw(ShaderProgram* shader_program, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_list) const;
 
     unsigned int tile_count() const;
+    /// changes, if the gpu tiles used for drawing draw_list change (e.g., a better tile arrived). independent of the order.
+    [[nodiscard]] size_t residency_hash(const std::vector<nucleus::tile::TileBounds>& draw_list) const;
+    /// incremented whenever the gpu tiles change, Window compares it to decide whether a frame has to be redrawn.
+    [[nodiscard]] unsigned generation() const { return m_generation; }
+
+    /// commits the tiles whose upload finished, and uploads the waiting tiles with the highest priority as long as the budget allows.
+    /// new tiles become visible (layer(), generation) only once the gpu finished their upload, until then the parents are used.
+    void upload_pending(const UploadPriority& priority, UploadBudget& budget, StagingBuffer& staging);
+    [[nodiscard]] bool has_pending_uploads() const;
+    /// occluder mesh heights (see nucleus::tile::OcclusionBuffer) of a tile, nullptr unless the tile is on the gpu.
+    [[nodiscard]] const radix::Raster<float>* occluder_heights(const nucleus::tile::Id& id) const;
+    /// number of tiles drawn with each mesh variant (nucleus::tile::drawing::mesh_strides) in the last draw call.
+    [[nodiscard]] const std::array<unsigned, nucleus::tile::drawing::mesh_strides.size()>& n_drawn_per_mesh_variant() const { return m_n_drawn_per_mesh_variant; }
 
 public slots:
     void update_gpu_tiles(const std::vector<nucleus::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuGeometryTile>& new_tiles);
@@ -58,13 +74,29 @@ private:
 
     std::unique_ptr<Texture> m_dtm_textures;
     std::unique_ptr<QOpenGLVertexArrayObject> m_vao;
-    std::pair<std::unique_ptr<QOpenGLBuffer>, size_t> m_index_buffer;
+    std::unique_ptr<QOpenGLBuffer> m_index_buffer; // all mesh variants, one after the other
+    std::array<std::pair<size_t, size_t>, nucleus::tile::drawing::mesh_strides.size()> m_index_ranges; // offset and count of each variant
     std::unique_ptr<QOpenGLBuffer> m_instance_bounds_buffer;
     std::unique_ptr<QOpenGLBuffer> m_instance_tile_id_buffer;
     std::unique_ptr<QOpenGLBuffer> m_dtm_array_index_buffer;
     std::unique_ptr<QOpenGLBuffer> m_dtm_zoom_buffer;
+    std::unique_ptr<QOpenGLBuffer> m_instance_draw_index_buffer;
+    int m_instance_bounds_location = -1;
+    int m_instance_tile_id_location = -1;
+    int m_dtm_array_index_location = -1;
+    int m_dtm_zoom_location = -1;
+    int m_instance_draw_index_location = -1;
 
     nucleus::tile::GpuArrayHelper m_gpu_array_helper;
+    UploadQueue<nucleus::tile::GpuGeometryTile> m_upload_queue;
+    UploadFences m_uploads_in_flight;
+    nucleus::tile::IdMap<radix::Raster<float>> m_occluder_heights;
+    nucleus::tile::IdMap<nucleus::tile::drawing::MeshErrors> m_mesh_errors;
+    mutable std::array<unsigned, nucleus::tile::drawing::mesh_strides.size()> m_n_drawn_per_mesh_variant = {};
     nucleus::tile::utils::AabbDecoratorPtr m_aabb_decorator;
+    unsigned m_generation = 0;
+
+    // points the per instance attributes to the instance data starting at first_instance (no base instance in OpenGL ES)
+    void set_first_instance(unsigned first_instance) const;
 };
 } // namespace gl_engine
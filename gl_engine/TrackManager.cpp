@@ -38,6 +38,18 @@
 
 namespace gl_engine {
 
+namespace {
+    namespace uniforms {
+        const UniformHandle<float> width("width");
+        const UniformHandle<int> texin_track("texin_track");
+        const UniformHandle<int> shading_method("shading_method");
+        const UniformHandle<float> max_speed("max_speed");
+        const UniformHandle<float> max_vertical_speed("max_vertical_speed");
+        const UniformHandle<int> end_index("end_index");
+        const UniformHandle<int> enable_intersection("enable_intersection");
+    } // namespace uniforms
+} // namespace
+
 TrackManager::TrackManager(ShaderRegistry* shader_registry, QObject* parent)
     : nucleus::track::Manager(parent)
     , m_shader(std::make_shared<ShaderProgram>("track.vert", "track.frag"))
@@ -45,7 +57,7 @@ TrackManager::TrackManager(ShaderRegistry* shader_registry, QObject* parent)
     shader_registry->add_shader(m_shader);
 }
 
-void TrackManager::draw(const nucleus::camera::Definition& camera) const
+void TrackManager::draw(const nucleus::camera::Definition&) const
 {
     if (m_tracks.empty()) {
         return;
@@ -59,19 +71,14 @@ void TrackManager::draw(const nucleus::camera::Definition& camera) const
 
     f->glDisable(GL_CULL_FACE);
 
-    auto view = camera.local_view_matrix();
-    auto proj = camera.projection_matrix();
-
+    // view, projection and camera position come from the camera_config uniform block
     m_shader->bind();
-    m_shader->set_uniform("proj", proj);
-    m_shader->set_uniform("view", view);
-    m_shader->set_uniform("camera_position", glm::vec3(camera.position()));
-    m_shader->set_uniform("width", m_display_width);
-    m_shader->set_uniform("texin_track", 8);
-    m_shader->set_uniform("shading_method", static_cast<int>(m_shading_method));
-    m_shader->set_uniform("max_speed", m_max_speed);
-    m_shader->set_uniform("max_vertical_speed", m_max_vertical_speed);
-    m_shader->set_uniform("end_index", static_cast<int>(m_total_point_count));
+    m_shader->set_uniform(uniforms::width, m_display_width);
+    m_shader->set_uniform(uniforms::texin_track, 8);
+    m_shader->set_uniform(uniforms::shading_method, static_cast<int>(m_shading_method));
+    m_shader->set_uniform(uniforms::max_speed, m_max_speed);
+    m_shader->set_uniform(uniforms::max_vertical_speed, m_max_vertical_speed);
+    m_shader->set_uniform(uniforms::end_index, static_cast<int>(m_total_point_count));
 
     for (const PolyLine& track : m_tracks) {
 
@@ -81,7 +88,7 @@ void TrackManager::draw(const nucleus::camera::Definition& camera) const
 
         GLsizei vertex_count = (track.point_count - 1) * 6;
 
-        m_shader->set_uniform("enable_intersection", true);
+        m_shader->set_uniform(uniforms::enable_intersection, true);
         f->glDrawArrays(GL_TRIANGLES, 0, vertex_count);
 
 #if ENABLE_BOUNDING_QUADS
@@ -89,7 +96,7 @@ void TrackManager::draw(const nucleus::camera::Definition& camera) const
         if (funcs) funcs->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 #endif
 
-        shader->set_uniform("enable_intersection", false);
+        shader->set_uniform(uniforms::enable_intersection, false);
         f->glDrawArrays(GL_TRIANGLES, 0, vertex_count);
 
 #if (defined(__linux) && !defined(__ANDROID__)) || defined(_WIN32) || defined(_WIN64)
@@ -215,9 +222,18 @@ void TrackManager::change_tracks(const QVector<nucleus::track::Gpx>& tracks)
     for (const auto& t : tracks) {
         add_track(t);
     }
+    ++m_generation;
 }
 
-void TrackManager::change_display_width(float new_width) { m_display_width = new_width; }
+void TrackManager::change_display_width(float new_width)
+{
+    m_display_width = new_width;
+    ++m_generation;
+}
 
-void TrackManager::change_shading_style(unsigned int new_style) { m_shading_method = new_style; }
+void TrackManager::change_shading_style(unsigned int new_style)
+{
+    m_shading_method = new_style;
+    ++m_generation;
+}
 } // namespace gl_engine
@@ -51,6 +51,8 @@ public:
     void draw(const nucleus::camera::Definition& camera) const;
 
     [[nodiscard]] ShaderProgram* shader() const;
+    /// incremented whenever the tracks or their style change, Window compares it to decide whether a frame has to be redrawn.
+    [[nodiscard]] unsigned generation() const { return m_generation; }
 
 public slots:
     void change_tracks(const QVector<nucleus::track::Gpx>& tracks) override;
@@ -68,5 +70,6 @@ private:
     float m_max_vertical_speed = 0.0f;
     size_t m_total_point_count = 0;
     std::vector<PolyLine> m_tracks;
+    unsigned m_generation = 0;
 };
 } // namespace gl_engine
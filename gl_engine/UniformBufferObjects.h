@@ -35,7 +35,7 @@
 //      the current instance on alpinemaps.org) this version number needs to be raised and the deserializing
 //      method needs to be adapted to work in a backwards compatible fashion!
 //      NOTE: THIS FUNCTIONALITY WAS NOT IN PLACE FOR VERSION 1. Those links therefore (in the best case) don't work anymore.
-#define CURRENT_UBO_VERSION 2
+#define CURRENT_UBO_VERSION 3
 
 // NOTE: BOOLEANS BEHAVE WEIRD! JUST DONT USE THEM AND STICK TO 32bit Formats!!
 // STD140 ALIGNMENT! USE PADDING IF NECESSARY. EVERY BLOCK OF SAME TYPE MUST BE PADDED
@@ -88,6 +88,11 @@ public:
     GLuint m_eaws_slope_angle_enabled = false;
     GLuint m_eaws_stop_or_go_enabled = false;
 
+    GLuint m_ssao_resolution = 0; // 0...full, 1...half, 2...quarter of the viewport
+    GLuint m_ssao_temporal_enabled = false; // accumulate over frames (fewer samples per frame)
+    GLuint m_padi2 = 0;
+    GLuint m_padi3 = 0;
+
     // WARNING: Don't move the following Q_PROPERTIES to the top, otherwise the MOC
     // will do weird things with the data alignment!!
     Q_PROPERTY(QVector4D sun_light MEMBER m_sun_light)
@@ -110,6 +115,8 @@ public:
     Q_PROPERTY(unsigned int ssao_kernel MEMBER m_ssao_kernel)
     Q_PROPERTY(bool ssao_range_check MEMBER m_ssao_range_check)
     Q_PROPERTY(unsigned int ssao_blur_kernel_size MEMBER m_ssao_blur_kernel_size)
+    Q_PROPERTY(unsigned int ssao_resolution MEMBER m_ssao_resolution)
+    Q_PROPERTY(bool ssao_temporal_enabled MEMBER m_ssao_temporal_enabled)
 
     Q_PROPERTY(bool height_lines_enabled MEMBER m_height_lines_enabled)
     Q_PROPERTY(bool csm_enabled MEMBER m_csm_enabled)
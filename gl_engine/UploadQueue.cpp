@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "UploadQueue.h"
+
+#include <QOpenGLContext>
+#include <QtAssert>
+
+namespace gl_engine {
+
+UploadBudget::UploadBudget(size_t max_bytes, std::chrono::microseconds max_time)
+    : m_max_bytes(max_bytes)
+    , m_max_time(max_time)
+    , m_start(std::chrono::steady_clock::now())
+{
+}
+
+bool UploadBudget::exhausted() const
+{
+    if (m_n_uploads == 0)
+        return false;
+    return m_n_bytes >= m_max_bytes || std::chrono::steady_clock::now() - m_start >= m_max_time;
+}
+
+void UploadBudget::consume(size_t n_bytes)
+{
+    m_n_bytes += n_bytes;
+    ++m_n_uploads;
+}
+
+UploadFences::~UploadFences()
+{
+    auto* context = QOpenGLContext::currentContext();
+    if (!context)
+        return;
+    for (const auto& batch : m_batches)
+        context->extraFunctions()->glDeleteSync(batch.fence);
+}
+
+void UploadFences::insert(std::vector<nucleus::tile::Id> ids)
+{
+    if (ids.empty())
+        return;
+    auto* f = QOpenGLContext::currentContext()->extraFunctions();
+    GLsync fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // make sure the fence reaches the gpu, otherwise polling it might never succeed
+    f->glFlush();
+    m_batches.push_back({ fence, std::move(ids) });
+}
+
+std::vector<nucleus::tile::Id> UploadFences::take_finished()
+{
+    std::vector<nucleus::tile::Id> finished;
+    if (m_batches.empty())
+        return finished;
+    auto* f = QOpenGLContext::currentContext()->extraFunctions();
+    while (!m_batches.empty()) {
+        const auto status = f->glClientWaitSync(m_batches.front().fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED)
+            break; // GL_WAIT_FAILED is taken as finished as well, there is nothing better to do with the tiles.
+        f->glDeleteSync(m_batches.front().fence);
+        finished.insert(finished.end(), m_batches.front().ids.begin(), m_batches.front().ids.end());
+        m_batches.pop_front();
+    }
+    return finished;
+}
+
+bool UploadFences::remove(const nucleus::tile::Id& id)
+{
+    for (auto& batch : m_batches) {
+        const auto t = std::find(batch.ids.begin(), batch.ids.end(), id);
+        if (t == batch.ids.end())
+            continue;
+        // the batch stays, even if empty, fences complete in order anyway.
+        batch.ids.erase(t);
+        return true;
+    }
+    return false;
+}
+
+} // namespace gl_engine
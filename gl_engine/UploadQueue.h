@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QOpenGLExtraFunctions>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <nucleus/tile/types.h>
+#include <vector>
+
+namespace gl_engine {
+
+using UploadPriority = std::function<double(const nucleus::tile::Id&)>;
+
+/// Limits the tile uploads of one frame (bytes and time). Shared by all layers, so that a burst of arriving tiles is spread over several frames.
+/// The first upload of a frame is always allowed, otherwise a tile larger than the budget would never be uploaded.
+class UploadBudget {
+public:
+    UploadBudget(size_t max_bytes, std::chrono::microseconds max_time);
+
+    [[nodiscard]] bool exhausted() const;
+    void consume(size_t n_bytes);
+    [[nodiscard]] size_t n_bytes() const { return m_n_bytes; }
+    [[nodiscard]] unsigned n_uploads() const { return m_n_uploads; }
+
+private:
+    size_t m_max_bytes;
+    std::chrono::microseconds m_max_time;
+    std::chrono::steady_clock::time_point m_start;
+    size_t m_n_bytes = 0;
+    unsigned m_n_uploads = 0;
+};
+
+/// Uploads, that were issued but are possibly not finished on the gpu. A fence is inserted after each batch and polled without blocking.
+class UploadFences {
+public:
+    UploadFences() = default;
+    UploadFences(const UploadFences&) = delete;
+    UploadFences& operator=(const UploadFences&) = delete;
+    ~UploadFences();
+
+    /// call after issuing the uploads of ids. needs OpenGL context
+    void insert(std::vector<nucleus::tile::Id> ids);
+    /// ids of the batches that the gpu finished, in issue order.
+    [[nodiscard]] std::vector<nucleus::tile::Id> take_finished();
+    /// returns true if the tile was in flight
+    bool remove(const nucleus::tile::Id& id);
+    [[nodiscard]] bool empty() const { return m_batches.empty(); }
+
+private:
+    struct Batch {
+        GLsync fence = nullptr;
+        std::vector<nucleus::tile::Id> ids;
+    };
+    std::deque<Batch> m_batches;
+};
+
+/// Tiles waiting for their upload. take() returns the most important ones that fit into the budget of the frame.
+template <typename Tile> class UploadQueue {
+public:
+    void push(const std::vector<Tile>& tiles) { m_tiles.insert(m_tiles.end(), tiles.begin(), tiles.end()); }
+
+    /// returns true if the tile was still waiting
+    bool remove(const nucleus::tile::Id& id)
+    {
+        const auto t = std::find_if(m_tiles.begin(), m_tiles.end(), [&](const Tile& tile) { return tile.id == id; });
+        if (t == m_tiles.end())
+            return false;
+        m_tiles.erase(t);
+        return true;
+    }
+
+    template <typename SizeFun> std::vector<Tile> take(const UploadPriority& priority, const SizeFun& n_bytes, UploadBudget& budget)
+    {
+        if (m_tiles.empty() || budget.exhausted())
+            return {};
+
+        std::vector<std::pair<double, size_t>> order;
+        order.reserve(m_tiles.size());
+        for (size_t i = 0; i < m_tiles.size(); ++i)
+            order.emplace_back(priority(m_tiles[i].id), i);
+        std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        std::vector<Tile> taken;
+        std::vector<bool> is_taken(m_tiles.size(), false);
+        for (const auto& [p, i] : order) {
+            if (budget.exhausted())
+                break;
+            budget.consume(n_bytes(m_tiles[i]));
+            taken.push_back(m_tiles[i]);
+            is_taken[i] = true;
+        }
+
+        size_t n_kept = 0;
+        for (size_t i = 0; i < m_tiles.size(); ++i) {
+            if (!is_taken[i])
+                m_tiles[n_kept++] = std::move(m_tiles[i]);
+        }
+        m_tiles.resize(n_kept);
+        return taken;
+    }
+
+    [[nodiscard]] bool empty() const { return m_tiles.empty(); }
+    [[nodiscard]] size_t size() const { return m_tiles.size(); }
+
+private:
+    std::vector<Tile> m_tiles;
+};
+
+} // namespace gl_engine
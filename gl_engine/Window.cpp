@@ -24,14 +24,17 @@
 #include "AvalancheWarningLayer.h"
 #include "Context.h"
 #include "Framebuffer.h"
+#include "Picker.h"
 #include "SSAO.h"
 #include "ShaderProgram.h"
 #include "ShaderRegistry.h"
 #include "ShadowMapping.h"
+#include "StagingBuffer.h"
 #include "TextureLayer.h"
 #include "TileGeometry.h"
 #include "TrackManager.h"
 #include "UniformBufferObjects.h"
+#include "UploadQueue.h"
 #include "helpers.h"
 #include "types.h"
 #include <QCoreApplication>
@@ -44,6 +47,7 @@
 #include <QOpenGLVertexArrayObject>
 #include <QTimer>
 #include <QtAssert>
+#include <cstring>
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <nucleus/avalanche/eaws.h>
@@ -76,6 +80,36 @@ using gl_engine::Window;
 using namespace gl_engine;
 using namespace nucleus::tile;
 
+namespace {
+// what changed since the last rendered frame. each pass is redrawn only if something it depends on changed.
+namespace damage {
+    constexpr unsigned camera = 1u << 0; // includes the viewport
+    constexpr unsigned settings = 1u << 1; // shared config (sun, shading, ..) and shaders
+    constexpr unsigned geometry = 1u << 2; // terrain tiles
+    constexpr unsigned textures = 1u << 3; // ortho, surface shading and avalanche tiles and reports
+    constexpr unsigned overlays = 1u << 4; // labels, tracks and picking
+    constexpr unsigned ambient_occlusion = 1u << 5; // temporal ssao accumulation with a static camera
+    constexpr unsigned all = unsigned(-1);
+} // namespace damage
+
+// tile uploads per frame, the rest waits for the next frames. the staging buffer has room for the overshoot of the last upload.
+constexpr size_t upload_budget_bytes = 4 * 1024 * 1024;
+constexpr auto upload_budget_time = std::chrono::microseconds(3000);
+constexpr size_t upload_staging_capacity = 2 * upload_budget_bytes;
+
+// the nearest tiles of the draw list are rasterised as occluders, they hide most in valleys.
+constexpr unsigned max_n_occluders = 48;
+
+namespace uniforms {
+    const UniformHandle<int> texin_albedo("texin_albedo");
+    const UniformHandle<int> texin_position("texin_position");
+    const UniformHandle<int> texin_normal("texin_normal");
+    const UniformHandle<int> texin_atmosphere("texin_atmosphere");
+    const UniformHandle<int> texin_ssao("texin_ssao");
+    const UniformHandle<glm::vec2> resolution("resolution");
+} // namespace uniforms
+} // namespace
+
 Window::Window(std::shared_ptr<Context> context)
     : m_context(context)
     , m_camera({ 1822577.0, 6141664.0 - 500, 171.28 + 500 }, { 1822577.0, 6141664.0, 171.28 }) // should point right at the stephansdom
@@ -185,8 +219,10 @@ void Window::initialise_gpu()
         });
 
     m_atmospherebuffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::RGBA8 });
-    m_decoration_buffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::None, std::vector { Framebuffer::ColourFormat::RGBA8 });
-    m_pickerbuffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::Float32, std::vector { Framebuffer::ColourFormat::RGBA32F });
+    // own depth, tracks clear it. the gbuffer depth must survive frames in which only the overlays are redrawn.
+    m_decoration_buffer = std::make_unique<Framebuffer>(Framebuffer::DepthFormat::Float32, std::vector { Framebuffer::ColourFormat::RGBA8 });
+    m_picker = std::make_unique<Picker>();
+    m_upload_staging = std::make_unique<StagingBuffer>(upload_staging_capacity);
     f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_gbuffer->depth_texture()->textureId(), 0);
 
     m_atmosphere_shader = std::make_shared<ShaderProgram>("screen_pass.vert", "atmosphere_bg.frag");
@@ -241,6 +277,10 @@ void Window::initialise_gpu()
         m_timer->add_timer(make_shared<CpuTimer>("cpu_b2b", "TOTAL", 240, 1.0f / 60.0f));
         m_timer->add_timer(make_shared<CpuTimer>("draw_list", "TOTAL", 240, 1.0f / 60.0f));
     }
+
+    const auto& shader_stats = ShaderProgram::build_statistics();
+    qDebug().nospace() << shader_stats.n_programs << " shader programs built in " << shader_stats.build_time.count() / 1000.0
+                       << "ms (program binary cache " << (ShaderProgram::binary_cache_enabled() ? "enabled" : "disabled") << ")";
 }
 
 void Window::resize_framebuffer(int width, int height)
@@ -252,21 +292,105 @@ void Window::resize_framebuffer(int width, int height)
     if (!f)
         return;
     m_gbuffer->resize({ width, height });
-    {
-        m_decoration_buffer->resize({ width, height });
-        // we are binding the depth buffer to the m_decoration_buffer
-        // m_decoration_buffer->resize automatically binds the m_decoration_buffer framebuffer
-        // and glFramebufferTexture2D attaches the m_gbuffer->depth_texture() to it.
-        f->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_gbuffer->depth_texture()->textureId(), 0);
-    }
+    m_decoration_buffer->resize({ width, height });
 
     m_atmospherebuffer->resize({ 1, height });
     m_ssao->resize({ width, height });
-    m_pickerbuffer->resize({ width, height });
+    m_damage = damage::all;
+}
+
+void Window::set_render_on_demand(bool enabled)
+{
+    if (m_render_on_demand == enabled)
+        return;
+    m_render_on_demand = enabled;
+    m_damage = damage::all;
+}
+
+unsigned Window::take_damage()
+{
+    std::array<unsigned, 3> generations = { m_context->tile_geometry()->generation(), m_context->ortho_layer()->generation(), 0u };
+    if (m_context->surfaceshaded_layer())
+        generations[1] += m_context->surfaceshaded_layer()->generation();
+    if (m_context->eaws_layer())
+        generations[1] += m_context->eaws_layer()->generation();
+    if (m_context->map_label_manager())
+        generations[2] += m_context->map_label_manager()->generation();
+    if (m_context->track_manager())
+        generations[2] += m_context->track_manager()->generation();
+
+    unsigned dirty = m_damage;
+    if (generations[0] != m_drawn_generations[0])
+        dirty |= damage::geometry;
+    if (generations[1] != m_drawn_generations[1])
+        dirty |= damage::textures;
+    if (generations[2] != m_drawn_generations[2] || m_picker->needs_pass())
+        dirty |= damage::overlays;
+
+    m_drawn_generations = generations;
+    m_damage = 0;
+    return dirty;
+}
+
+bool Window::upload_tiles()
+{
+    const auto frustum = m_camera.frustum();
+    const auto camera_position = m_camera.position();
+    const auto& aabb_decorator = m_context->aabb_decorator();
+    const UploadPriority priority = [&](const nucleus::tile::Id& id) {
+        return drawing::screen_coverage({ id, aabb_decorator->aabb(id) }, frustum, camera_position);
+    };
+
+    UploadBudget budget(upload_budget_bytes, upload_budget_time);
+    m_upload_staging->begin_frame();
+    bool pending = false;
+    const auto upload = [&](auto* layer) {
+        if (!layer)
+            return;
+        layer->upload_pending(priority, budget, *m_upload_staging);
+        pending = pending || layer->has_pending_uploads();
+    };
+    upload(m_context->tile_geometry());
+    upload(m_context->ortho_layer());
+    upload(m_context->surfaceshaded_layer());
+    return pending;
+}
+
+std::vector<nucleus::tile::TileBounds> Window::cull_occluded(const std::vector<nucleus::tile::TileBounds>& draw_list)
+{
+    m_occlusion_buffer.reset(m_camera);
+    for (const auto& tile : draw_list) {
+        if (m_occlusion_buffer.n_occluders() >= max_n_occluders)
+            break;
+        if (const auto* heights = m_context->tile_geometry()->occluder_heights(tile.id))
+            m_occlusion_buffer.add_occluder(tile.bounds, *heights);
+    }
+    m_occlusion_buffer.finalise();
+    return m_occlusion_buffer.cull(draw_list);
 }
 
 void Window::paint(QOpenGLFramebufferObject* framebuffer)
 {
+    // before take_damage, finished uploads increment the generations
+    const bool uploads_pending = upload_tiles();
+    const auto changes = take_damage();
+    const auto dirty = m_render_on_demand ? changes : damage::all;
+    if (dirty == 0) {
+        // nothing changed, the framebuffer still holds the last frame.
+        if (const auto picked = m_picker->poll_result())
+            emit value_picked(nucleus::utils::bit_coding::f8_4_to_u32(picked.value()));
+        m_timer->count_frame(false);
+        QList<nucleus::timing::TimerReport> new_values = m_timer->fetch_results();
+        if (new_values.size() > 0)
+            emit timer_measurements_ready(new_values);
+        if (m_picker->waiting_for_result() || uploads_pending)
+            emit update_requested();
+        return;
+    }
+    const bool draw_atmosphere = dirty & (damage::camera | damage::settings);
+    const bool draw_shadows = dirty & (damage::camera | damage::settings | damage::geometry);
+    const bool draw_terrain = dirty & (damage::camera | damage::settings | damage::geometry | damage::textures);
+
     m_timer->start_timer("cpu_total");
     m_timer->start_timer("gpu_total");
 
@@ -290,16 +414,18 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
     m_camera_config_ubo->update_gpu_data();
 
     // DRAW ATMOSPHERIC BACKGROUND
-    m_timer->start_timer("atmosphere");
-    m_atmospherebuffer->bind();
-    f->glClearColor(0.0, 0.0, 0.0, 1.0);
-    f->glClear(GL_COLOR_BUFFER_BIT);
-    f->glDisable(GL_DEPTH_TEST);
-    f->glDepthFunc(GL_ALWAYS);
-    m_atmosphere_shader->bind();
-    m_screen_quad_geometry.draw();
-    m_atmosphere_shader->release();
-    m_timer->stop_timer("atmosphere");
+    if (draw_atmosphere) {
+        m_timer->start_timer("atmosphere");
+        m_atmospherebuffer->bind();
+        f->glClearColor(0.0, 0.0, 0.0, 1.0);
+        f->glClear(GL_COLOR_BUFFER_BIT);
+        f->glDisable(GL_DEPTH_TEST);
+        f->glDepthFunc(GL_ALWAYS);
+        m_atmosphere_shader->bind();
+        m_screen_quad_geometry.draw();
+        m_atmosphere_shader->release();
+        m_timer->stop_timer("atmosphere");
+    }
 
     // Generate Draw-List
     // Note: Could also just be done on camera change
@@ -314,76 +440,92 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
 
     const auto draw_list
         = drawing::compute_bounds(drawing::limit(drawing::generate_list(m_camera, m_context->aabb_decorator(), 19), 1024u), m_context->aabb_decorator());
-    const auto culled_draw_list = drawing::sort(drawing::cull(draw_list, m_camera), m_camera.position());
+    const auto frustum_culled_draw_list = drawing::sort(drawing::cull(draw_list, m_camera), m_camera.position());
+    const auto culled_draw_list = cull_occluded(frustum_culled_draw_list);
 
     tile_stats["n_geometry_tiles_gpu"] = m_context->tile_geometry()->tile_count();
     tile_stats["n_ortho_tiles_gpu"] = m_context->ortho_layer()->tile_count();
     tile_stats["n_geometry_tiles_drawn"] = unsigned(culled_draw_list.size());
+    tile_stats["n_geometry_tiles_occluded"] = unsigned(frustum_culled_draw_list.size() - culled_draw_list.size());
     m_timer->stop_timer("draw_list");
 
     // DRAW SHADOWMAPS
-    if (m_shared_config_ubo->data.m_csm_enabled) {
+    if (m_shared_config_ubo->data.m_csm_enabled && draw_shadows) {
         m_timer->start_timer("shadowmap");
         m_shadowmapping->draw(m_context->tile_geometry(), draw_list, m_camera, m_shadow_config_ubo, m_shared_config_ubo);
         m_timer->stop_timer("shadowmap");
-    }
-
-    // DRAW GBUFFER
-    m_gbuffer->bind();
 
-    {
-        // Clear Albedo-Buffer
-        const GLfloat clearAlbedoColor[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        f->glClearBufferfv(GL_COLOR, 0, clearAlbedoColor);
-        // Clear Position-Buffer (IMPORTANT [4] to <0, such that i know by sign if fragment was processed)
-        const GLfloat clearPositionColor[4] = { 0.0f, 0.0f, 0.0f, -1.0f };
-        f->glClearBufferfv(GL_COLOR, 1, clearPositionColor);
-        // Clear Normals-Buffer
-        const GLuint clearNormalColor[2] = { 0u, 0u };
-        f->glClearBufferuiv(GL_COLOR, 2, clearNormalColor);
-        // Clear Encoded-Depth Buffer
-        const GLfloat clearEncDepthColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
-        f->glClearBufferfv(GL_COLOR, 3, clearEncDepthColor);
-        // Clear Depth-Buffer
-        f->glClearDepthf(0.0f); // reverse z
-        f->glClear(GL_DEPTH_BUFFER_BIT);
+        const auto& shadow_stats = m_shadowmapping->statistics();
+        unsigned n_cached_cascades = 0;
+        for (unsigned i = 0; i < SHADOW_CASCADES; ++i) {
+            tile_stats[QString("n_shadow_tiles_cascade_%1").arg(i)] = shadow_stats.n_tiles[i];
+            n_cached_cascades += shadow_stats.cached[i] ? 1 : 0;
+        }
+        tile_stats["n_shadow_cascades_cached"] = n_cached_cascades;
     }
 
-    f->glEnable(GL_DEPTH_TEST);
-    f->glDepthFunc(GL_GEQUAL); // reverse z, reuse z buffer for sucessive passes
+    // DRAW GBUFFER (kept from the last frame, if only overlays changed)
+    if (draw_terrain) {
+        m_gbuffer->bind();
+
+        {
+            // Clear Albedo-Buffer
+            const GLfloat clearAlbedoColor[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            f->glClearBufferfv(GL_COLOR, 0, clearAlbedoColor);
+            // Clear Position-Buffer (IMPORTANT [4] to <0, such that i know by sign if fragment was processed)
+            const GLfloat clearPositionColor[4] = { 0.0f, 0.0f, 0.0f, -1.0f };
+            f->glClearBufferfv(GL_COLOR, 1, clearPositionColor);
+            // Clear Normals-Buffer
+            const GLuint clearNormalColor[2] = { 0u, 0u };
+            f->glClearBufferuiv(GL_COLOR, 2, clearNormalColor);
+            // Clear Encoded-Depth Buffer
+            const GLfloat clearEncDepthColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            f->glClearBufferfv(GL_COLOR, 3, clearEncDepthColor);
+            // Clear Depth-Buffer
+            f->glClearDepthf(0.0f); // reverse z
+            f->glClear(GL_DEPTH_BUFFER_BIT);
+        }
 
-    m_timer->start_timer("tiles");
+        f->glEnable(GL_DEPTH_TEST);
+        f->glDepthFunc(GL_GEQUAL); // reverse z, reuse z buffer for sucessive passes
 
-    if (m_shared_config_ubo->data.m_eaws_danger_rating_enabled || m_shared_config_ubo->data.m_eaws_risk_level_enabled
-        || m_shared_config_ubo->data.m_eaws_slope_angle_enabled || m_shared_config_ubo->data.m_eaws_stop_or_go_enabled) {
-        m_context->surfaceshaded_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
-        m_context->eaws_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
-    } else {
-        m_context->ortho_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
-    }
-    m_timer->stop_timer("tiles");
+        m_timer->start_timer("tiles");
 
-    m_gbuffer->unbind();
+        if (m_shared_config_ubo->data.m_eaws_danger_rating_enabled || m_shared_config_ubo->data.m_eaws_risk_level_enabled
+            || m_shared_config_ubo->data.m_eaws_slope_angle_enabled || m_shared_config_ubo->data.m_eaws_stop_or_go_enabled) {
+            m_context->surfaceshaded_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
+            m_context->eaws_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
+        } else {
+            m_context->ortho_layer()->draw(*m_context->tile_geometry(), m_camera, culled_draw_list);
+        }
+        m_timer->stop_timer("tiles");
+
+        m_gbuffer->unbind();
 
-    if (m_shared_config_ubo->data.m_ssao_enabled) {
-        m_timer->start_timer("ssao");
-        m_ssao->draw(
-            m_gbuffer.get(), &m_screen_quad_geometry, m_camera, m_shared_config_ubo->data.m_ssao_kernel, m_shared_config_ubo->data.m_ssao_blur_kernel_size);
-        m_timer->stop_timer("ssao");
+        const auto& n_drawn_per_mesh_variant = m_context->tile_geometry()->n_drawn_per_mesh_variant();
+        for (size_t i = 0; i < n_drawn_per_mesh_variant.size(); ++i)
+            tile_stats[QString("n_geometry_tiles_drawn_stride_%1").arg(drawing::mesh_strides[i])] = n_drawn_per_mesh_variant[i];
     }
 
-    {
-        m_timer->start_timer("picker");
-        m_pickerbuffer->bind();
+    // skipped, if the gbuffer didn't change and the temporal accumulation has converged. only frames with the pass are timed.
+    if (m_shared_config_ubo->data.m_ssao_enabled && (draw_terrain || dirty & damage::ambient_occlusion)) {
+        const bool scene_changed = changes & (damage::camera | damage::settings | damage::geometry);
+        if (m_ssao->needs_update(m_gbuffer.get(), m_shared_config_ubo->data, scene_changed)) {
+            m_timer->start_timer("ssao");
+            m_ssao->draw(m_gbuffer.get(), &m_screen_quad_geometry, m_camera, m_shared_config_ubo->data, scene_changed);
+            m_timer->stop_timer("ssao");
+        }
+    }
 
-        // CLEAR PICKER BUFFER
-        f->glClearColor(0.0, 0.0, 0.0, 0.0);
-        f->glClear(GL_COLOR_BUFFER_BIT);
-        f->glClear(GL_DEPTH_BUFFER_BIT);
+    if (const auto picked = m_picker->poll_result())
+        emit value_picked(nucleus::utils::bit_coding::f8_4_to_u32(picked.value()));
 
-        // DRAW Pickbuffer
+    if (m_picker->needs_pass()) {
+        m_timer->start_timer("picker");
+        m_picker->begin_pass(m_camera.viewport_size());
         if (m_context->map_label_manager())
             m_context->map_label_manager()->draw_picker(m_gbuffer.get(), m_camera, label_tile_set);
+        m_picker->end_pass();
         m_timer->stop_timer("picker");
     }
 
@@ -391,18 +533,20 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
         framebuffer->bind();
     else
         f->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // the passes that used to set the viewport might have been skipped
+    f->glViewport(0, 0, GLsizei(m_gbuffer->size().x), GLsizei(m_gbuffer->size().y));
 
     m_compose_shader->bind();
-    m_compose_shader->set_uniform("texin_albedo", 0);
+    m_compose_shader->set_uniform(uniforms::texin_albedo, 0);
     m_gbuffer->bind_colour_texture(0, 0);
-    m_compose_shader->set_uniform("texin_position", 1);
+    m_compose_shader->set_uniform(uniforms::texin_position, 1);
     m_gbuffer->bind_colour_texture(1, 1);
-    m_compose_shader->set_uniform("texin_normal", 2);
+    m_compose_shader->set_uniform(uniforms::texin_normal, 2);
     m_gbuffer->bind_colour_texture(2, 2);
-    m_compose_shader->set_uniform("texin_atmosphere", 4);
+    m_compose_shader->set_uniform(uniforms::texin_atmosphere, 4);
     m_atmospherebuffer->bind_colour_texture(0, 4);
 
-    m_compose_shader->set_uniform("texin_ssao", 5);
+    m_compose_shader->set_uniform(uniforms::texin_ssao, 5);
     m_ssao->bind_ssao_texture(5);
 
     /* texture units 5 - 8 */
@@ -412,7 +556,8 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
     m_screen_quad_geometry.draw();
     m_timer->stop_timer("compose");
 
-    m_decoration_buffer->bind();
+    // labels are depth tested against the terrain
+    m_decoration_buffer->copy_depth_from(*m_gbuffer);
     const GLfloat clearAlbedoColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
     f->glClearBufferfv(GL_COLOR, 0, clearAlbedoColor);
     f->glEnable(GL_DEPTH_TEST);
@@ -432,11 +577,11 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
             m_timer->start_timer("tracks");
             auto* track_shader = m_context->track_manager()->shader();
             track_shader->bind();
-            track_shader->set_uniform("texin_position", 1);
+            track_shader->set_uniform(uniforms::texin_position, 1);
             m_gbuffer->bind_colour_texture(1, 1);
 
             glm::vec2 size = glm::vec2(static_cast<float>(m_gbuffer->size().x), static_cast<float>(m_gbuffer->size().y));
-            track_shader->set_uniform("resolution", size);
+            track_shader->set_uniform(uniforms::resolution, size);
 
             f->glClear(GL_DEPTH_BUFFER_BIT);
             m_context->track_manager()->draw(m_camera);
@@ -468,15 +613,23 @@ void Window::paint(QOpenGLFramebufferObject* framebuffer)
     glFinish();
 #endif
 
+    m_timer->count_frame(true);
     QList<nucleus::timing::TimerReport> new_values = m_timer->fetch_results();
     if (new_values.size() > 0) {
         emit timer_measurements_ready(new_values);
     }
     emit tile_stats_ready(tile_stats);
+
+    if (m_shared_config_ubo->data.m_ssao_enabled && m_ssao->converging())
+        m_damage |= damage::ambient_occlusion;
+    if (m_picker->waiting_for_result() || uploads_pending || m_damage)
+        emit update_requested();
 }
 
 void Window::shared_config_changed(gl_engine::uboSharedConfig ubo)
 {
+    if (std::memcmp(&m_shared_config_ubo->data, &ubo, sizeof(ubo)) != 0)
+        m_damage |= damage::settings;
     m_shared_config_ubo->data = ubo;
     m_shared_config_ubo->update_gpu_data();
     emit update_requested();
@@ -492,6 +645,7 @@ void Window::reload_shader()
         m_camera_config_ubo->bind_to_shader(shader_manager->all());
         m_shadow_config_ubo->bind_to_shader(shader_manager->all());
         m_eaws_reports_ubo->bind_to_shader(shader_manager->all());
+        m_damage = damage::all;
         qDebug("all shaders reloaded");
         emit update_requested();
     };
@@ -508,6 +662,8 @@ void Window::reload_shader()
 void Window::update_camera(const nucleus::camera::Definition& new_definition)
 {
     //    qDebug("void Window::update_camera(const nucleus::camera::Definition& new_definition)");
+    if (!(m_camera == new_definition))
+        m_damage |= damage::camera;
     m_camera = new_definition;
     emit update_requested();
 }
@@ -527,9 +683,9 @@ float Window::depth(const glm::dvec2& normalised_device_coordinates)
 
 void Window::pick_value(const glm::dvec2& screen_space_coordinates)
 {
-    const auto value
-        = nucleus::utils::bit_coding::f8_4_to_u32(m_pickerbuffer->read_colour_attachment_pixel<glm::vec4>(0, m_camera.to_ndc(screen_space_coordinates)));
-    emit value_picked(value);
+    // the picker pass runs with the next frame, the value is emitted once it's read back (usually one frame later).
+    m_picker->request(m_camera.to_ndc(screen_space_coordinates));
+    emit update_requested();
 }
 
 void Window::update_eaws_reports(const nucleus::avalanche::UboEawsReports& newUboEawsReports)
@@ -537,6 +693,7 @@ void Window::update_eaws_reports(const nucleus::avalanche::UboEawsReports& newUb
     Q_ASSERT(m_eaws_reports_ubo);
     m_eaws_reports_ubo->data = newUboEawsReports;
     m_eaws_reports_ubo->update_gpu_data();
+    m_damage |= damage::textures;
     emit update_requested();
 }
 
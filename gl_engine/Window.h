@@ -31,11 +31,13 @@
 #include <QPainter>
 #include <QVariantMap>
 #include <QVector3D>
+#include <array>
 #include <glm/glm.hpp>
 #include <memory>
 #include <nucleus/AbstractRenderWindow.h>
 #include <nucleus/camera/AbstractDepthTester.h>
 #include <nucleus/camera/Definition.h>
+#include <nucleus/tile/OcclusionBuffer.h>
 #include <nucleus/timing/TimerManager.h>
 #include <nucleus/track/GPX.h>
 
@@ -52,8 +54,10 @@ namespace gl_engine {
 class MapLabels;
 class ShaderProgram;
 class Framebuffer;
+class Picker;
 class SSAO;
 class ShadowMapping;
+class StagingBuffer;
 class Context;
 class Window : public nucleus::AbstractRenderWindow, public nucleus::camera::AbstractDepthTester {
     Q_OBJECT
@@ -70,6 +74,11 @@ public:
     [[nodiscard]] nucleus::camera::AbstractDepthTester* depth_tester() override;
     [[nodiscard]] nucleus::utils::ColourTexture::Format ortho_tile_compression_algorithm() const override;
 
+    /// Skips frames whose inputs (camera, settings, gpu tiles, labels, tracks) didn't change, and the passes that don't
+    /// depend on what changed (e.g., atmosphere and shadows for new ortho tiles). Only enable it if the target framebuffer
+    /// keeps its content between frames. Off by default, continuous rendering (benchmarks) should draw everything.
+    void set_render_on_demand(bool enabled);
+
 public slots:
     void update_camera(const nucleus::camera::Definition& new_definition) override;
     void update_debug_scheduler_stats(const QString& stats) override;
@@ -83,13 +92,21 @@ signals:
     void tile_stats_ready(QVariantMap stats);
 
 private:
+    /// returns the damage since the last rendered frame (see damage namespace in Window.cpp) and resets it.
+    unsigned take_damage();
+    /// uploads waiting tiles within the frame budget, most visible first. returns true if uploads are still waiting or in flight.
+    bool upload_tiles();
+    /// removes tiles hidden behind the nearest tiles of the (front to back sorted) draw list.
+    std::vector<nucleus::tile::TileBounds> cull_occluded(const std::vector<nucleus::tile::TileBounds>& draw_list);
+
     std::shared_ptr<Context> m_context;
     std::unique_ptr<MapLabels> m_map_label_manager;
 
     std::unique_ptr<Framebuffer> m_gbuffer;
     std::unique_ptr<Framebuffer> m_decoration_buffer;
     std::unique_ptr<Framebuffer> m_atmospherebuffer;
-    std::unique_ptr<Framebuffer> m_pickerbuffer;
+    std::unique_ptr<Picker> m_picker;
+    std::unique_ptr<StagingBuffer> m_upload_staging;
 
     std::shared_ptr<ShaderProgram> m_atmosphere_shader;
     std::shared_ptr<ShaderProgram> m_compose_shader;
@@ -104,9 +121,13 @@ private:
     helpers::ScreenQuadGeometry m_screen_quad_geometry;
 
     nucleus::camera::Definition m_camera;
+    nucleus::tile::OcclusionBuffer m_occlusion_buffer;
 
     int m_frame = 0;
     bool m_initialised = false;
+    bool m_render_on_demand = false;
+    unsigned m_damage = unsigned(-1);
+    std::array<unsigned, 3> m_drawn_generations = {}; // geometry, textures, overlays
     float m_permissible_screen_space_error = 2.f;
     QString m_debug_text;
     QString m_debug_scheduler_stats;
@@ -30,6 +30,7 @@ precision highp float;
 uniform highp usampler2DArray texture_sampler;
 uniform highp usampler2D instanced_texture_array_index_sampler;
 uniform highp usampler2D instanced_texture_zoom_sampler;
+uniform highp usampler2D id_remap_sampler; // raster id -> internal region id for the selected date, 256x256
 uniform highp sampler2DArray texture_sampler2;
 uniform highp usampler2D instanced_texture_array_index_sampler2;
 uniform highp usampler2D instanced_texture_zoom_sampler2;
@@ -110,7 +111,8 @@ void main() {
     decrease_zoom_level_until(tile_id, uv, texelFetch(instanced_texture_zoom_sampler, ivec2(instance_id, 0), 0).x);
     highp float texture_layer_f = float(texelFetch(instanced_texture_array_index_sampler, ivec2(instance_id, 0), 0).x);
 
-    highp uint eawsRegionId = texelFetch(texture_sampler, ivec3(int(uv.x * float(512)), int(uv.y * float(512)) , texture_layer_f), 0).r;
+    highp uint eawsRasterId = texelFetch(texture_sampler, ivec3(int(uv.x * float(512)), int(uv.y * float(512)) , texture_layer_f), 0).r;
+    highp uint eawsRegionId = texelFetch(id_remap_sampler, ivec2(eawsRasterId & 255u, eawsRasterId >> 8u), 0).r;
     ivec4 report = eaws.reports[eawsRegionId];
     vec3 eaws_color = color_no_report_available;
 
@@ -57,4 +57,9 @@ layout (std140) uniform shared_config {
     highp uint eaws_risk_level_enabled;
     highp uint eaws_slope_angle_enabled;
     highp uint eaws_stop_or_go_enabled;
+
+    highp uint ssao_resolution;
+    highp uint ssao_temporal_enabled;
+    highp uint padi2;
+    highp uint padi3;
 } conf;
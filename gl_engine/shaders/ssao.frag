@@ -31,6 +31,11 @@ uniform highp usampler2D texin_normal;
 uniform highp sampler2D texin_noise;
 
 uniform highp vec3 samples[MAX_SSAO_KERNEL_SIZE];
+uniform highp vec2 noise_scale;     // output resolution / noise texture size
+uniform highp vec2 noise_offset;    // varies per frame with temporal accumulation
+uniform lowp int n_samples;         // samples[i * sample_stride + sample_offset] for i < n_samples
+uniform lowp int sample_stride;
+uniform lowp int sample_offset;
 
 highp float calculate_falloff(highp float dist, highp float from, highp float to) {
     return clamp(1.0 - (dist - from) / (to - from), 0.0, 1.0);
@@ -45,18 +50,15 @@ void main()
     if (dist < 0.0) {
         out_color = conf.ssao_falloff_to_value;
     } else {
-        // tile noise texture over screen based on screen dimensions divided by noise size
-        highp vec2 noiseScale = camera.viewport_size / 4.0;
-
-        // get input for SSAO algorithm
+        // get input for SSAO algorithm (noise texture tiled over the output)
         highp vec3 normal_ws = octNormalDecode2u16(texture(texin_normal, texcoords).xy);
-        highp vec3 randomVec = normalize(texture(texin_noise, texcoords * noiseScale).xyz);
+        highp vec3 randomVec = normalize(texture(texin_noise, texcoords * noise_scale + noise_offset).xyz);
 
         // Depth dependet radius.
         highp float radius = dist / 10.0 + 20.0;// / 10.0 + 50.0; //dist / 10.0 + 10.0;
         highp float bias = radius / 1000.0; //radius / 1000.0; //0.0000001; //radius / 1000.0;
 
-        lowp int kernel = int(conf.ssao_kernel);
+        lowp int kernel = n_samples;
 
         highp float falloff = calculate_falloff(dist, 50000.0, 65000.0);
 
@@ -73,7 +75,7 @@ void main()
             {
 
                 // get sample position in world space
-                highp vec3 sample_pos_cws = TBN * samples[i];
+                highp vec3 sample_pos_cws = TBN * samples[i * sample_stride + sample_offset];
                 sample_pos_cws = pos_cws + sample_pos_cws * radius;
                 highp float sample_gt_dist = length(sample_pos_cws);
 
@@ -46,13 +46,13 @@ void main()
     out_ssao = texture(texin_ssao, texcoords).x * weight[aO+0];
     if (level == 0) return;
     if (direction == 0) {
-        highp float scale_fact = 1.0 / camera.viewport_size.x;
+        highp float scale_fact = 1.0 / float(textureSize(texin_ssao, 0).x); // might be a reduced resolution
         for (lowp int i = 1; i < level + 1; i++) {
             out_ssao += texture(texin_ssao, texcoords + vec2(0.0, offset[aO+i]) * scale_fact).r * weight[aO+i];
             out_ssao += texture(texin_ssao, texcoords - vec2(0.0, offset[aO+i]) * scale_fact).r * weight[aO+i];
         }
     } else {
-        highp float scale_fact = 1.0 / camera.viewport_size.y;
+        highp float scale_fact = 1.0 / float(textureSize(texin_ssao, 0).y);
         for (lowp int i = 1; i < level + 1; i++) {
             out_ssao += texture(texin_ssao, texcoords + vec2(offset[aO+i], 0.0) * scale_fact).r * weight[aO+i];
             out_ssao += texture(texin_ssao, texcoords - vec2(offset[aO+i], 0.0) * scale_fact).r * weight[aO+i];
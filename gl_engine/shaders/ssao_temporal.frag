@@ -0,0 +1,57 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+layout (location = 0) out highp vec4 out_history; // ao, distance, number of accumulated frames
+
+in highp vec2 texcoords;
+
+uniform highp sampler2D texin_position;
+uniform lowp sampler2D texin_ssao;          // occlusion of this frame
+uniform highp sampler2D texin_history;      // out_history of the previous frame
+
+uniform highp mat4 previous_view_proj;      // camera relative positions of this frame -> clip space of the previous frame
+uniform highp vec3 camera_offset;           // camera position of this frame - camera position of the previous frame
+uniform highp float max_frames;
+
+void main()
+{
+    lowp float ao = texture(texin_ssao, texcoords).r;
+    highp vec3 pos_cws = texture(texin_position, texcoords).xyz;
+    highp float dist = texture(texin_position, texcoords).w; // negative if sky
+    if (dist < 0.0) {
+        out_history = vec4(ao, 0.0, 1.0, 0.0);
+        return;
+    }
+
+    highp float accumulated = ao;
+    highp float n = 1.0;
+    highp vec4 previous_clip = previous_view_proj * vec4(pos_cws, 1.0);
+    if (previous_clip.w > 0.0) {
+        highp vec2 previous_uv = previous_clip.xy / previous_clip.w * 0.5 + 0.5;
+        if (all(greaterThanEqual(previous_uv, vec2(0.0))) && all(lessThanEqual(previous_uv, vec2(1.0)))) {
+            highp vec4 history = texture(texin_history, previous_uv);
+            highp float expected_dist = length(pos_cws + camera_offset);
+            // the history shows another surface, if the distance doesn't match (disocclusion)
+            if (history.y > 0.0 && abs(history.y - expected_dist) < 0.02 * expected_dist) {
+                n = min(history.z + 1.0, max_frames);
+                accumulated = mix(history.x, ao, 1.0 / n);
+            }
+        }
+    }
+    out_history = vec4(accumulated, length(pos_cws), n, 0.0);
+}
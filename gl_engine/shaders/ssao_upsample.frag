@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+layout (location = 0) out lowp float out_ssao;
+
+in highp vec2 texcoords;
+
+uniform highp sampler2D texin_position;     // full resolution
+uniform lowp sampler2D texin_ssao;          // reduced resolution
+
+// bilinear upsampling, but texels of other surfaces (different distance) get (almost) no weight.
+void main()
+{
+    highp float dist = texture(texin_position, texcoords).w;
+    highp ivec2 reduced_size = textureSize(texin_ssao, 0);
+    highp vec2 p = texcoords * vec2(reduced_size) - 0.5;
+    highp vec2 base = floor(p);
+    highp vec2 f = p - base;
+
+    highp float sum = 0.0;
+    highp float weight_sum = 0.0;
+    lowp float nearest = texelFetch(texin_ssao, clamp(ivec2(round(p)), ivec2(0), reduced_size - 1), 0).r;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            highp ivec2 texel = clamp(ivec2(base) + ivec2(x, y), ivec2(0), reduced_size - 1);
+            // the distance the reduced texel was computed for (it sampled the gbuffer at its centre)
+            highp float texel_dist = texture(texin_position, (vec2(texel) + 0.5) / vec2(reduced_size)).w;
+            highp float bilinear = (x == 0 ? 1.0 - f.x : f.x) * (y == 0 ? 1.0 - f.y : f.y);
+            highp float depth_weight = 1.0 / (0.001 + abs(texel_dist - dist) / max(0.01 * abs(dist), 0.001));
+            highp float weight = bilinear * depth_weight;
+            sum += texelFetch(texin_ssao, texel, 0).r * weight;
+            weight_sum += weight;
+        }
+    }
+    out_ssao = weight_sum > 0.000001 ? sum / weight_sum : nearest;
+}
@@ -24,6 +24,7 @@ layout(location = 0) in highp vec4 instance_bounds;
 layout(location = 1) in highp uvec2 instance_tile_id_packed;
 layout(location = 2) in mediump uint dtm_array_index;
 layout(location = 3) in lowp uint dtm_zoom;
+layout(location = 4) in highp uint instance_draw_index; // position in the draw list, instances are grouped by mesh variant (gl_InstanceID isn't)
 
 uniform highp int n_edge_vertices;
 uniform mediump usampler2DArray height_tex_sampler;
@@ -37,7 +37,7 @@ void main() {
     compute_vertex(var_pos_cws, var_uv, var_tile_id, conf.normal_mode == 1u, var_normal, var_altitude);
 
     gl_Position = camera.view_proj_matrix * vec4(var_pos_cws, 1);
-    instance_id = uint(gl_InstanceID);
+    instance_id = instance_draw_index; // per tile lookups of the layers are in draw list order
 
     vertex_color = vec3(0.0);
     switch(conf.overlay_mode) {
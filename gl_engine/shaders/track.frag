@@ -21,6 +21,7 @@
 #include "hashing.glsl"
 #include "encoder.glsl"
 #include "shared_config.glsl"
+#include "camera_config.glsl"
 #include "turbo_colormap.glsl"
 
 layout (location = 0) out lowp vec4 out_color;
@@ -30,11 +31,8 @@ flat in int instance_id;
 
 uniform highp sampler2D texin_track;
 uniform highp sampler2D texin_position;
-uniform highp vec3 camera_position;
 uniform bool enable_intersection;
 uniform int shading_method;
-uniform highp mat4 view;
-uniform highp mat4 proj;
 uniform highp float max_speed;
 uniform highp float max_vertical_speed;
 uniform highp float width;
@@ -104,6 +102,7 @@ void main() {
     } else {
 
         highp vec2 texcoords = gl_FragCoord.xy / resolution.xy;
+        highp vec3 camera_position = camera.position.xyz;
 
         highp vec3 sun_light_dir = conf.sun_light_dir.xyz;
 
@@ -133,7 +132,7 @@ void main() {
         if (dist < 0.) {
             // ray does not hit terrain, it hits sky
 
-            highp vec3 dir = camera_ray(texcoords, inverse(proj), inverse(view));
+            highp vec3 dir = camera_ray(texcoords, camera.inv_proj_matrix, camera.inv_view_matrix);
             ray = Ray(vec3(0, 0, 0), dir);
             dist = INF;
 
@@ -17,14 +17,12 @@
  *****************************************************************************/
 
 #include "overlay_steepness.glsl"
+#include "camera_config.glsl"
 
 layout(location = 0) in highp vec3 a_position;
 layout(location = 1) in highp vec3 a_direction;
 layout(location = 2) in highp vec3 a_offset;
 
-uniform highp mat4 view;
-uniform highp mat4 proj;
-uniform highp vec3 camera_position;
 uniform highp float width;
 uniform highp sampler2D texin_track;
 
@@ -32,7 +30,7 @@ flat out highp int vertex_id;
 
 void main() {
 
-  highp mat4 matrix = proj * view;
+  highp vec3 camera_position = camera.position.xyz;
 
   vertex_id = int(a_offset.y);
 
@@ -46,5 +44,5 @@ void main() {
 
   highp vec3 position = x0 + (v * width * a_offset.x) + (u * width * a_offset.z);
 
-  gl_Position = matrix * vec4(position, 1);
+  gl_Position = camera.view_proj_matrix * vec4(position, 1);
 }
@@ -53,6 +53,8 @@ public slots:
 
 signals:
     void update_requested();
+    /// like update_requested, but for tile arrivals. views may coalesce bursts of these into one frame.
+    void tile_update_requested();
     void value_picked(uint32_t value);
 };
 
@@ -0,0 +1,261 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "RegionGeometryCache.h"
+#include <QtAssert>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace nucleus::avalanche {
+
+namespace {
+    using Bounds = RegionIndex::Bounds;
+
+    struct IndexEntry {
+        Bounds bounds;
+        uint32_t id;
+    };
+
+    glm::vec2 centre(const Bounds& b) { return (b.min + b.max) * 0.5f; }
+
+    Bounds merged(const Bounds& a, const Bounds& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+
+    bool intersects(const Bounds& a, const Bounds& b) { return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y; }
+
+    Bounds empty_bounds()
+    {
+        constexpr auto inf = std::numeric_limits<float>::infinity();
+        return { glm::vec2(inf), glm::vec2(-inf) };
+    }
+
+    // sort-tile-recursive: sort by x, cut into sqrt(n_nodes) vertical slices, sort every slice by y.
+    // consecutive runs of node_capacity entries then form compact nodes.
+    void str_sort(std::vector<IndexEntry>& entries)
+    {
+        const auto n_nodes = (entries.size() + RegionIndex::node_capacity - 1) / RegionIndex::node_capacity;
+        const auto n_slices = size_t(std::ceil(std::sqrt(double(n_nodes))));
+        const auto slice_size = std::max(size_t(1), n_slices) * RegionIndex::node_capacity;
+
+        std::sort(entries.begin(), entries.end(), [](const IndexEntry& a, const IndexEntry& b) { return centre(a.bounds).x < centre(b.bounds).x; });
+        for (size_t begin = 0; begin < entries.size(); begin += slice_size) {
+            const auto end = std::min(begin + slice_size, entries.size());
+            std::sort(entries.begin() + long(begin), entries.begin() + long(end), [](const IndexEntry& a, const IndexEntry& b) {
+                return centre(a.bounds).y < centre(b.bounds).y;
+            });
+        }
+    }
+} // namespace
+
+RegionIndex::RegionIndex(const std::vector<Bounds>& bounds)
+{
+    if (bounds.empty())
+        return;
+
+    std::vector<IndexEntry> entries;
+    entries.reserve(bounds.size());
+    for (uint32_t i = 0; i < bounds.size(); ++i)
+        entries.push_back({ bounds[i], i });
+    str_sort(entries);
+    m_items.reserve(entries.size());
+    m_item_bounds.reserve(entries.size());
+    for (const auto& e : entries) {
+        m_items.push_back(e.id);
+        m_item_bounds.push_back(e.bounds);
+    }
+
+    // group the entries of the level below into nodes, until there is only the root left
+    while (true) {
+        std::vector<Node> nodes;
+        nodes.reserve((entries.size() + node_capacity - 1) / node_capacity);
+        for (size_t first = 0; first < entries.size(); first += node_capacity) {
+            const auto count = std::min(size_t(node_capacity), entries.size() - first);
+            Bounds node_bounds = entries[first].bounds;
+            for (size_t i = first + 1; i < first + count; ++i)
+                node_bounds = merged(node_bounds, entries[i].bounds);
+            nodes.push_back({ node_bounds, uint32_t(first), uint32_t(count) });
+        }
+        if (nodes.size() == 1) {
+            m_levels.push_back(std::move(nodes));
+            break;
+        }
+
+        // the nodes themselves are sorted for the next level. that is fine, as they only reference ranges in the level below
+        entries.clear();
+        for (uint32_t i = 0; i < nodes.size(); ++i)
+            entries.push_back({ nodes[i].bounds, i });
+        str_sort(entries);
+        std::vector<Node> sorted_nodes;
+        sorted_nodes.reserve(nodes.size());
+        for (const auto& e : entries)
+            sorted_nodes.push_back(nodes[e.id]);
+        m_levels.push_back(std::move(sorted_nodes));
+    }
+}
+
+std::vector<uint32_t> RegionIndex::query(const Bounds& query) const
+{
+    std::vector<uint32_t> result;
+    if (m_levels.empty())
+        return result;
+
+    std::vector<std::pair<uint32_t, uint32_t>> stack; // level, node
+    stack.emplace_back(uint32_t(m_levels.size() - 1), 0u);
+    while (!stack.empty()) {
+        const auto [level, node_index] = stack.back();
+        stack.pop_back();
+        const Node& node = m_levels[level][node_index];
+        if (!intersects(node.bounds, query))
+            continue;
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (level == 0) {
+                if (intersects(m_item_bounds[i], query))
+                    result.push_back(m_items[i]);
+            } else {
+                stack.emplace_back(level - 1, i);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+size_t RegionIndex::memory_usage() const
+{
+    size_t bytes = sizeof(RegionIndex) + m_items.capacity() * sizeof(uint32_t) + m_item_bounds.capacity() * sizeof(Bounds);
+    for (const auto& level : m_levels)
+        bytes += sizeof(level) + level.capacity() * sizeof(Node);
+    return bytes;
+}
+
+ParsedRegionTile::ParsedRegionTile(RegionTile tile)
+    : region_tile(std::move(tile))
+{
+    bounds.reserve(region_tile.second.size());
+    memory_usage = sizeof(ParsedRegionTile);
+    for (const auto& region : region_tile.second) {
+        Bounds b = empty_bounds();
+        for (const auto& v : region.vertices_in_local_coordinates)
+            b = merged(b, Bounds { v, v });
+        bounds.push_back(b);
+        memory_usage += sizeof(Region) + region.vertices_in_local_coordinates.capacity() * sizeof(glm::vec2) + size_t(region.id.capacity()) * sizeof(QChar);
+    }
+    index = RegionIndex(bounds);
+    memory_usage += bounds.capacity() * sizeof(Bounds) + index.memory_usage();
+}
+
+std::vector<uint32_t> ParsedRegionTile::regions_intersecting(const radix::tile::Id& tile_id_out) const
+{
+    const auto tile_bounds = tile_bounds_in_local_coordinates(region_tile.first, tile_id_out);
+    // the outline is drawn with a width of one pixel, which can reach slightly outside of the polygon
+    const auto margin = tile_bounds.size() * 0.01;
+    return index.query(Bounds { glm::vec2(tile_bounds.min - margin), glm::vec2(tile_bounds.max + margin) });
+}
+
+void draw_regions(const ParsedRegionTile& parsed_tile, UIntIdManager& internal_id_manager, radix::Raster<uint16_t>* raster, const radix::tile::Id& tile_id_out)
+{
+    const auto region_indices = parsed_tile.regions_intersecting(tile_id_out);
+    if (region_indices.empty())
+        return;
+    draw_regions(parsed_tile.region_tile, region_indices, internal_id_manager, raster, tile_id_out);
+}
+
+RegionGeometryCache::RegionGeometryCache(size_t memory_limit)
+    : m_memory_limit(memory_limit)
+{
+}
+
+std::shared_ptr<const ParsedRegionTile> RegionGeometryCache::get_or_parse(const tile::Id& id, QByteArrayView data)
+{
+    if (auto cached = get(id))
+        return cached;
+
+    auto region_tile = vector_tile_reader(data, id);
+    if (!region_tile.has_value())
+        return {};
+    auto parsed = std::make_shared<const ParsedRegionTile>(std::move(region_tile.value()));
+    insert(id, parsed);
+    return parsed;
+}
+
+std::shared_ptr<const ParsedRegionTile> RegionGeometryCache::get(const tile::Id& id)
+{
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        return {};
+    it->second.last_used = ++m_clock;
+    return it->second.tile;
+}
+
+std::shared_ptr<const ParsedRegionTile> RegionGeometryCache::find_ancestor(tile::Id id)
+{
+    while (true) {
+        if (auto cached = get(id))
+            return cached;
+        if (id.zoom_level == 0)
+            return {};
+        id = id.parent();
+    }
+}
+
+void RegionGeometryCache::insert(const tile::Id& id, std::shared_ptr<const ParsedRegionTile> tile)
+{
+    Q_ASSERT(tile);
+    auto& entry = m_entries[id];
+    if (entry.tile)
+        m_memory_usage -= entry.tile->memory_usage;
+    entry.tile = std::move(tile);
+    entry.last_used = ++m_clock;
+    m_memory_usage += entry.tile->memory_usage;
+    evict();
+}
+
+void RegionGeometryCache::set_memory_limit(size_t bytes)
+{
+    m_memory_limit = bytes;
+    evict();
+}
+
+void RegionGeometryCache::clear()
+{
+    m_entries.clear();
+    m_memory_usage = 0;
+}
+
+void RegionGeometryCache::evict()
+{
+    if (m_memory_usage <= m_memory_limit)
+        return;
+
+    std::vector<std::pair<uint64_t, tile::Id>> by_age;
+    by_age.reserve(m_entries.size());
+    for (const auto& [id, entry] : m_entries)
+        by_age.emplace_back(entry.last_used, id);
+    std::sort(by_age.begin(), by_age.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [last_used, id] : by_age) {
+        if (m_memory_usage <= m_memory_limit)
+            break;
+        const auto it = m_entries.find(id);
+        m_memory_usage -= it->second.tile->memory_usage;
+        m_entries.erase(it);
+    }
+}
+
+} // namespace nucleus::avalanche
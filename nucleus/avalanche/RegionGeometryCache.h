@@ -0,0 +1,105 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include "eaws.h"
+#include <memory>
+#include <nucleus/tile/types.h>
+#include <radix/geometry.h>
+#include <unordered_map>
+#include <vector>
+
+namespace nucleus::avalanche {
+
+// Static R-tree over axis aligned bounding boxes, packed with sort-tile-recursive (built once, no insertion or removal).
+class RegionIndex {
+public:
+    using Bounds = radix::geometry::Aabb2<float>;
+    static constexpr uint32_t node_capacity = 16;
+
+    RegionIndex() = default;
+    explicit RegionIndex(const std::vector<Bounds>& bounds);
+
+    // Indices of all boxes intersecting query (touching counts), in ascending order
+    [[nodiscard]] std::vector<uint32_t> query(const Bounds& query) const;
+    [[nodiscard]] size_t memory_usage() const;
+    [[nodiscard]] bool empty() const { return m_levels.empty(); }
+
+private:
+    struct Node {
+        Bounds bounds;
+        uint32_t first; // first child in the level below, or first entry of m_items for the leaf level
+        uint32_t count;
+    };
+    std::vector<uint32_t> m_items; // box indices in leaf order
+    std::vector<Bounds> m_item_bounds; // same order as m_items
+    std::vector<std::vector<Node>> m_levels; // m_levels.front() are the leaves, m_levels.back() contains only the root
+};
+
+// Parsed vector tile with the bounds of every region (in local coordinates) and an index over them
+struct ParsedRegionTile {
+    RegionTile region_tile;
+    std::vector<RegionIndex::Bounds> bounds;
+    RegionIndex index;
+    size_t memory_usage = 0;
+
+    explicit ParsedRegionTile(RegionTile region_tile);
+
+    // Regions that intersect tile_id_out, in drawing order
+    [[nodiscard]] std::vector<uint32_t> regions_intersecting(const radix::tile::Id& tile_id_out) const;
+};
+
+// Fills the regions of the parsed tile that intersect tile_id_out into the raster (see draw_regions in eaws.h)
+void draw_regions(const ParsedRegionTile& parsed_tile, UIntIdManager& internal_id_manager, radix::Raster<uint16_t>* raster, const radix::tile::Id& tile_id_out);
+
+// Keeps parsed EAWS region tiles, so that the protobuf is decoded only once per source tile, and tiles without data (e.g., above the
+// max zoom level of the region tiles) can be derived from a cached ancestor. Memory bounded, least recently used tiles are evicted first.
+// Not thread safe, it is meant to be owned by the scheduler.
+class RegionGeometryCache {
+public:
+    explicit RegionGeometryCache(size_t memory_limit = 32 * 1024 * 1024);
+
+    // Returns the cached tile, or parses data and caches it. Returns nullptr if data can't be parsed.
+    std::shared_ptr<const ParsedRegionTile> get_or_parse(const tile::Id& id, QByteArrayView data);
+    // Returns the cached tile or nullptr
+    std::shared_ptr<const ParsedRegionTile> get(const tile::Id& id);
+    // Returns the cached tile with the highest zoom level containing id (including id itself), or nullptr
+    std::shared_ptr<const ParsedRegionTile> find_ancestor(tile::Id id);
+    void insert(const tile::Id& id, std::shared_ptr<const ParsedRegionTile> tile);
+
+    void set_memory_limit(size_t bytes);
+    [[nodiscard]] size_t memory_limit() const { return m_memory_limit; }
+    [[nodiscard]] size_t memory_usage() const { return m_memory_usage; }
+    [[nodiscard]] size_t n_tiles() const { return m_entries.size(); }
+    void clear();
+
+private:
+    struct Entry {
+        std::shared_ptr<const ParsedRegionTile> tile;
+        uint64_t last_used = 0;
+    };
+    void evict();
+
+    std::unordered_map<tile::Id, Entry, tile::Id::Hasher> m_entries;
+    size_t m_memory_limit = 0;
+    size_t m_memory_usage = 0;
+    uint64_t m_clock = 0;
+};
+
+} // namespace nucleus::avalanche
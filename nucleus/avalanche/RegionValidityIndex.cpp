@@ -0,0 +1,112 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "RegionValidityIndex.h"
+#include <QtAssert>
+#include <algorithm>
+#include <limits>
+
+namespace nucleus::avalanche {
+
+bool RegionValidityIndex::insert(uint32_t internal_id, const std::optional<QDate>& start_date, const std::optional<QDate>& end_date)
+{
+    const Interval interval { (start_date.has_value() && start_date->isValid()) ? start_date->toJulianDay() : std::numeric_limits<int64_t>::min(),
+        (end_date.has_value() && end_date->isValid()) ? end_date->toJulianDay() : std::numeric_limits<int64_t>::max() };
+
+    const auto [it, inserted] = m_intervals.try_emplace(internal_id, interval);
+    if (!inserted) {
+        if (it->second == interval)
+            return false;
+        it->second = interval;
+    }
+    m_dirty = true;
+    return true;
+}
+
+void RegionValidityIndex::clear()
+{
+    m_intervals.clear();
+    m_entries.clear();
+    m_max_end.clear();
+    m_dirty = false;
+}
+
+std::vector<uint32_t> RegionValidityIndex::valid_on(const QDate& date) const
+{
+    Q_ASSERT(date.isValid());
+    if (m_dirty)
+        build();
+
+    std::vector<uint32_t> result;
+    stab(0, m_entries.size(), date.toJulianDay(), &result);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool RegionValidityIndex::is_valid_on(uint32_t internal_id, const QDate& date) const
+{
+    const auto it = m_intervals.find(internal_id);
+    if (it == m_intervals.end())
+        return false;
+    const auto day = date.toJulianDay();
+    return it->second.start <= day && day <= it->second.end;
+}
+
+void RegionValidityIndex::build() const
+{
+    m_entries.clear();
+    m_entries.reserve(m_intervals.size());
+    for (const auto& [id, interval] : m_intervals)
+        m_entries.push_back({ interval, id });
+    std::sort(m_entries.begin(), m_entries.end(), [](const TreeEntry& a, const TreeEntry& b) {
+        return a.interval.start < b.interval.start || (a.interval.start == b.interval.start && a.id < b.id);
+    });
+
+    m_max_end.resize(m_entries.size());
+    // post order, so that the children are done before their parent
+    const auto fill = [this](auto& self, size_t begin, size_t end) -> int64_t {
+        if (begin >= end)
+            return std::numeric_limits<int64_t>::min();
+        const auto node = begin + (end - begin) / 2;
+        const auto left = self(self, begin, node);
+        const auto right = self(self, node + 1, end);
+        m_max_end[node] = std::max({ m_entries[node].interval.end, left, right });
+        return m_max_end[node];
+    };
+    fill(fill, 0, m_entries.size());
+    m_dirty = false;
+}
+
+void RegionValidityIndex::stab(size_t begin, size_t end, int64_t day, std::vector<uint32_t>* result) const
+{
+    while (begin < end) {
+        const auto node = begin + (end - begin) / 2;
+        // nothing in this subtree reaches day
+        if (m_max_end[node] < day)
+            return;
+        stab(begin, node, day, result);
+        // entries are sorted by start, so the node and the right subtree start after day
+        if (m_entries[node].interval.start > day)
+            return;
+        if (day <= m_entries[node].interval.end)
+            result->push_back(m_entries[node].id);
+        begin = node + 1;
+    }
+}
+
+} // namespace nucleus::avalanche
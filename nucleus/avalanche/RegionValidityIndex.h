@@ -0,0 +1,67 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QDate>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace nucleus::avalanche {
+
+// Maps internal region ids to the time interval in which the region is valid (start and end date inclusive, both optional).
+// Stabbing queries ("which regions are valid on this day?") are answered with an interval tree, that is rebuilt lazily after changes.
+// Ids without an interval are unknown to the index (use is_known to distinguish them from ids that are not valid).
+class RegionValidityIndex {
+public:
+    // Sets (or replaces) the validity of internal_id and returns whether anything changed.
+    // Setting the same interval again is cheap and does not invalidate the tree.
+    bool insert(uint32_t internal_id, const std::optional<QDate>& start_date, const std::optional<QDate>& end_date);
+    void clear();
+
+    // All ids valid on date, in ascending order
+    [[nodiscard]] std::vector<uint32_t> valid_on(const QDate& date) const;
+    [[nodiscard]] bool is_valid_on(uint32_t internal_id, const QDate& date) const;
+    [[nodiscard]] bool is_known(uint32_t internal_id) const { return m_intervals.contains(internal_id); }
+    [[nodiscard]] size_t size() const { return m_intervals.size(); }
+
+private:
+    struct Interval {
+        int64_t start; // julian day
+        int64_t end; // julian day, inclusive
+        bool operator==(const Interval&) const = default;
+    };
+    struct TreeEntry {
+        Interval interval;
+        uint32_t id;
+    };
+    void build() const;
+    void stab(size_t begin, size_t end, int64_t day, std::vector<uint32_t>* result) const;
+
+    std::unordered_map<uint32_t, Interval> m_intervals;
+
+    // implicit balanced binary tree over the entries sorted by start. the node of range [begin, end) is at the middle index,
+    // m_max_end[node] is the maximum end within its range.
+    mutable std::vector<TreeEntry> m_entries;
+    mutable std::vector<int64_t> m_max_end;
+    mutable bool m_dirty = false;
+};
+
+} // namespace nucleus::avalanche
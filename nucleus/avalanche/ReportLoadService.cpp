@@ -1,4 +1,5 @@
 #include "nucleus/avalanche/ReportLoadService.h"
+#include <QDebug>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -14,45 +15,33 @@
 
 namespace nucleus::avalanche {
 
-// helper function that encodes reports in an uint vector
-nucleus::avalanche::UboEawsReports convertReportsToUbo(
-    UboEawsReports& ubo, const std::vector<ReportTUWien>& reports, std::shared_ptr<UIntIdManager> m_uint_id_manager)
+UboEawsReports convert_reports_to_ubo(const std::vector<ReportTUWien>& reports, UIntIdManager& id_manager)
 {
     // Fill array with initial vectors
-    std::fill(ubo.reports, ubo.reports + 1000, glm::ivec4(-1, 0, 0, 0));
-
-    // if reports arrived as expected write them to ubo object
-    for (const nucleus::avalanche::ReportTUWien& report : reports) {
-
-        // Correct region id if it has invalid format: That means create new sub regions with same forecast
-        std::vector<QString> new_region_ids;
-        if (report.region_id.endsWith("-00")) {
-            // remove last three digits
-            QString parent_region_id = report.region_id;
-            parent_region_id = parent_region_id.left(parent_region_id.length() - 3);
-
-            // check if our map contains subregions of current report region and save these as vector
-            uint i = 1;
-            QString new_region_id = parent_region_id + QString("-01");
-            while (m_uint_id_manager->contains(new_region_id)) {
-                new_region_ids.push_back(new_region_id);
-                i++;
-                new_region_id = i < 10 ? parent_region_id + QString("-0") + QString::number(i) : parent_region_id + QString("-") + QString::number(i);
-            }
+    UboEawsReports ubo;
+    std::fill(std::begin(ubo.reports), std::end(ubo.reports), glm::ivec4(-1, 0, 0, 0));
 
-            // If no subregions of report region were found, use report region
-            if (new_region_ids.empty()) {
-                new_region_ids.push_back(parent_region_id);
-            }
-        } else {
-            new_region_ids.push_back(report.region_id);
+    const auto write = [&ubo](uint internal_id, const ReportTUWien& report) {
+        if (internal_id >= std::size(ubo.reports)) {
+            qWarning() << "EAWS report for internal id" << internal_id << "does not fit into the report buffer";
+            return;
         }
+        ubo.reports[internal_id] = glm::ivec4(report.unfavorable, report.border, report.rating_lo, report.rating_hi);
+    };
 
-        // Write (corrected) region(s) to ubo
-        for (QString new_region_id : new_region_ids) {
-            uint idx = m_uint_id_manager->convert_region_id_to_internal_id(new_region_id);
-            ubo.reports[idx] = glm::ivec4(report.unfavorable, report.border, report.rating_lo, report.rating_hi);
+    for (const ReportTUWien& report : reports) {
+        // Region ids ending with -00 refer to all sub regions (e.g., AT-02-02-00 to AT-02-02-01, AT-02-02-02, ..)
+        // If no sub regions are known, the parent region (AT-02-02) is used
+        if (report.region_id.endsWith("-00")) {
+            const auto parent_region_id = report.region_id.chopped(3);
+            const auto sub_regions = id_manager.sub_regions_of(parent_region_id);
+            for (const auto internal_id : sub_regions)
+                write(internal_id, report);
+            if (sub_regions.empty())
+                write(id_manager.convert_region_id_to_internal_id(parent_region_id), report);
+            continue;
         }
+        write(id_manager.convert_region_id_to_internal_id(report.region_id), report);
     }
     return ubo;
 }
@@ -179,11 +168,8 @@ void ReportLoadService::load_from_tu_wien(const QDate& date) const
             region_ratings.push_back(region_rating);
         }
 
-        // Convert reports to ubo
-        nucleus::avalanche::UboEawsReports ubo = convertReportsToUbo(ubo, region_ratings, m_uint_id_manager);
-
-        // Emit ratings
-        emit this->load_from_TU_Wien_finished(ubo);
+        // Convert reports to ubo and emit them
+        emit this->load_from_TU_Wien_finished(convert_reports_to_ubo(region_ratings, *m_uint_id_manager));
         reply->deleteLater();
     });
 }
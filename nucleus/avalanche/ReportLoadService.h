@@ -42,6 +42,10 @@ struct ReportTUWien {
     bool operator==(const ReportTUWien& rhs) const = default;
 };
 
+// Writes the reports to the ubo, indexed by internal region id. Reports for "-00" region ids are written to all sub regions.
+// Regions without report get x = -1. Linear in the number of reports (and sub regions).
+UboEawsReports convert_reports_to_ubo(const std::vector<ReportTUWien>& reports, UIntIdManager& id_manager);
+
 // Loads a Bulletinn from the server and converts it to custom struct
 class ReportLoadService : public QObject {
     Q_OBJECT
@@ -21,7 +21,6 @@
 #include "eaws.h"
 #include <QDate>
 #include <QtAssert>
-#include <nucleus/utils/image_loader.h>
 
 namespace nucleus::avalanche {
 
@@ -29,11 +28,26 @@ Scheduler::Scheduler(const Settings& settings)
     : nucleus::tile::Scheduler(settings)
     , m_default_raster(glm::uvec2(settings.tile_resolution), 0)
 {
-    m_uint_id_manager = std::make_shared<UIntIdManager>(QDate(2025, 7, 1));
+    m_uint_id_manager = std::make_shared<UIntIdManager>();
 }
 
 Scheduler::~Scheduler() = default;
 
+void Scheduler::set_reference_date(const QDate& date)
+{
+    Q_ASSERT(date.isValid());
+    if (date == m_reference_date)
+        return;
+    m_reference_date = date;
+    emit_id_remap();
+}
+
+void Scheduler::emit_id_remap()
+{
+    m_emitted_id_remap_revision = m_uint_id_manager->revision();
+    emit id_remap_updated(std::make_shared<const radix::Raster<glm::uint16>>(m_uint_id_manager->id_remap(m_reference_date)));
+}
+
 void Scheduler::transform_and_emit(const std::vector<nucleus::tile::DataQuad>& new_quads, const std::vector<nucleus::tile::Id>& deleted_quads)
 {
     std::vector<nucleus::tile::GpuEawsTile> new_gpu_tiles;
@@ -43,55 +57,58 @@ void Scheduler::transform_and_emit(const std::vector<nucleus::tile::DataQuad>& n
     for (const auto& quad : new_quads) {
         nucleus::tile::GpuEawsTile gpu_tile_from_quad;
         gpu_tile_from_quad.id = quad.id;
-        radix::Raster<glm::uint16> quad_as_raster = to_raster(quad, m_default_raster, m_uint_id_manager);
+        radix::Raster<glm::uint16> quad_as_raster = to_raster(quad, m_default_raster, m_uint_id_manager, &m_geometry_cache);
         gpu_tile_from_quad.texture = std::make_shared<radix::Raster<glm::uint16>>(quad_as_raster);
         new_gpu_tiles.push_back(gpu_tile_from_quad);
     }
 
+    // new regions or overlaps, the remap must be there before the tiles using them are drawn
+    if (m_uint_id_manager->revision() != m_emitted_id_remap_revision)
+        emit_id_remap();
     emit gpu_tiles_updated(deleted_quads, new_gpu_tiles);
 }
 
-radix::Raster<glm::uint16> Scheduler::to_raster(
-    const nucleus::tile::DataQuad& quad, const radix::Raster<glm::uint16>& default_raster, std::shared_ptr<UIntIdManager> uint_id_manager)
+radix::Raster<glm::uint16> Scheduler::to_raster(const nucleus::tile::DataQuad& quad,
+    const radix::Raster<glm::uint16>& default_raster,
+    std::shared_ptr<UIntIdManager> uint_id_manager,
+    RegionGeometryCache* geometry_cache)
 {
     std::array<radix::Raster<glm::uint16>, 4> quad_rasters;
     std::array<tile::Id, 4> quad_ids;
     for (const auto& tile : quad.tiles) {
         const auto quad_index = unsigned(quad_position(tile.id));
         quad_ids[quad_index] = tile.id;
-        if (!tile.data->size()) {
-            // Data not available use default raster
-            quad_rasters[quad_index] = default_raster;
-            continue;
-        }
 
-        // Read vector tile from data
-        std::expected<RegionTile, QString> result = vector_tile_reader(*tile.data, tile.id);
+        std::shared_ptr<const ParsedRegionTile> parsed_tile;
+        if (!tile.data.empty()) {
+            // Read vector tile from data (or take it from the cache, if it was parsed already)
+            bool is_new = true;
+            if (geometry_cache) {
+                is_new = !geometry_cache->get(tile.id);
+                parsed_tile = geometry_cache->get_or_parse(tile.id, tile.data.view());
+            } else if (auto result = vector_tile_reader(tile.data.view(), tile.id); result.has_value()) {
+                parsed_tile = std::make_shared<const ParsedRegionTile>(std::move(result.value()));
+            }
+            // All regions of new tiles are registered at once, so that reports find their sub regions even if they weren't drawn yet
+            if (parsed_tile && is_new)
+                uint_id_manager->register_regions(parsed_tile->region_tile.second);
+        } else if (geometry_cache && tile.id.zoom_level > 0) {
+            // Data not available (e.g., above the max zoom level of the region tiles), derive the raster from an ancestor
+            parsed_tile = geometry_cache->find_ancestor(tile.id.parent());
+        }
 
-        // could not read vector tile from data, use default raster
-        if (!result.has_value()) {
+        // could not read vector tile from data and there is no ancestor, use default raster
+        if (!parsed_tile) {
             quad_rasters[quad_index] = default_raster;
             continue;
         }
 
-        // Reading tile worked. Create qimage with color coded eaws regions for current tile
-        RegionTile eaws_region_tile = result.value();
-        QImage eawsImage = draw_regions(eaws_region_tile, uint_id_manager, 256, 256, tile.id);
-
-        // Convert Qimage to raster with a 16bit uint region id
-        radix::Raster<glm::uint16> eaws_raster_16bit(glm::uvec2(256, 256), 0);
-        for (int i = 0; i < 256; i++) {
-            for (int j = 0; j < 256; j++) {
-                glm::u8vec4 color_vector_8bit(0, 0, 0, 0);
-                QColor color = eawsImage.pixelColor(QPoint(i, j));
-                color_vector_8bit.x = static_cast<uint8_t>(color.red());
-                color_vector_8bit.y = static_cast<uint8_t>(color.green());
-                eaws_raster_16bit.pixel(glm::uvec2(i, j)) = 256 * color_vector_8bit.x + color_vector_8bit.y;
-            }
-        }
+        // Rasterize the regions intersecting the current tile with their internal id
+        radix::Raster<glm::uint16> eaws_raster_16bit(default_raster.size(), 0);
+        draw_regions(*parsed_tile, *uint_id_manager, &eaws_raster_16bit, tile.id);
 
         // Collect raster of current tile in quad
-        quad_rasters[quad_index] = radix::Raster<glm::uint16>(eaws_raster_16bit);
+        quad_rasters[quad_index] = std::move(eaws_raster_16bit);
     }
 
     // Merge 4 tiles from quad into one raster representing the quad
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <nucleus/avalanche/RegionGeometryCache.h>
 #include <nucleus/avalanche/UIntIdManager.h>
 #include <nucleus/tile/Scheduler.h>
 #include <nucleus/tile/types.h>
@@ -28,19 +29,35 @@ class Scheduler : public nucleus::tile::Scheduler {
 public:
     Scheduler(const Scheduler::Settings& settings);
     ~Scheduler();
-    static radix::Raster<glm::uint16> to_raster(
-        const nucleus::tile::DataQuad& quad, const radix::Raster<glm::uint16>& default_raster, std::shared_ptr<UIntIdManager> uint_id_manager);
+    // Tiles without data are derived from the closest ancestor in geometry_cache (if given), otherwise default_raster is used
+    static radix::Raster<glm::uint16> to_raster(const nucleus::tile::DataQuad& quad,
+        const radix::Raster<glm::uint16>& default_raster,
+        std::shared_ptr<UIntIdManager> uint_id_manager,
+        RegionGeometryCache* geometry_cache = nullptr);
     std::shared_ptr<UIntIdManager> get_uint_id_manager() { return m_uint_id_manager; }
+    RegionGeometryCache& geometry_cache() { return m_geometry_cache; }
+    QDate reference_date() const { return m_reference_date; }
+
+public slots:
+    // Regions are shown as they were defined on this date. Only the id remap is updated, the tiles are not rasterised again.
+    void set_reference_date(const QDate& date);
 
 signals:
     void gpu_tiles_updated(const std::vector<nucleus::tile::Id>& deleted_quads, const std::vector<nucleus::tile::GpuEawsTile>& new_tiles);
+    // Maps raster ids in the tiles to internal region ids for the reference date, see UIntIdManager::id_remap
+    void id_remap_updated(std::shared_ptr<const radix::Raster<glm::uint16>> id_remap);
 
 protected:
     void transform_and_emit(const std::vector<nucleus::tile::DataQuad>& new_quads, const std::vector<nucleus::tile::Id>& deleted_quads) override;
 
 private:
+    void emit_id_remap();
+
     radix::Raster<glm::uint16> m_default_raster;
     std::shared_ptr<UIntIdManager> m_uint_id_manager;
+    RegionGeometryCache m_geometry_cache;
+    QDate m_reference_date = QDate::currentDate();
+    uint64_t m_emitted_id_remap_revision = 0;
 };
 
 } // namespace nucleus::avalanche
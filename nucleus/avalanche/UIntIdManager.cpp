@@ -18,7 +18,9 @@
  *****************************************************************************/
 
 #include "UIntIdManager.h"
+#include "eaws.h"
 #include <QCoreApplication>
+#include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QJsonArray>
@@ -28,37 +30,55 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QtAssert>
+#include <algorithm>
 #include <expected>
 #include <iostream>
+#include <limits>
 
 namespace nucleus::avalanche {
-UIntIdManager::UIntIdManager(const QDate& reference_date)
-    : m_reference_date(reference_date)
+namespace {
+    constexpr uint max_raster_id = std::numeric_limits<uint16_t>::max();
+}
+
+UIntIdManager::UIntIdManager()
 {
     // intern_id = 0 means "no region"
     m_region_id_to_internal_id[QString("")] = 0;
-    m_internal_id_to_region_id[0] = QString("");
+    m_internal_id_to_region_id.push_back(QString(""));
     Q_ASSERT(m_max_internal_id == 0);
 }
 
 uint UIntIdManager::convert_region_id_to_internal_id(const QString& region_id)
 {
     // If Key exists return its value, else add it and return its newly created value
-    auto entry = m_region_id_to_internal_id.find(region_id);
-    if (entry == m_region_id_to_internal_id.end()) {
-        m_region_id_to_internal_id[region_id] = ++m_max_internal_id;
-        return m_max_internal_id;
-    } else
+    const auto [entry, inserted] = m_region_id_to_internal_id.try_emplace(region_id, m_max_internal_id + 1);
+    if (!inserted)
         return entry->second;
+
+    ++m_max_internal_id;
+    Q_ASSERT(m_max_internal_id < max_raster_id - m_stacks.size()); // internal ids and stack ids must not meet
+    Q_ASSERT(m_internal_id_to_region_id.size() == m_max_internal_id);
+    m_internal_id_to_region_id.push_back(region_id);
+
+    // sub regions have a two digit suffix (-01, -02, .., -99), e.g., AT-02-02-01 is a sub region of AT-02-02. reports use -00 for the parent.
+    const auto separator = region_id.lastIndexOf('-');
+    if (separator > 0) {
+        const auto suffix = QStringView(region_id).sliced(separator + 1);
+        bool is_number = false;
+        const auto number = suffix.toUInt(&is_number);
+        if (suffix.size() == 2 && is_number && number > 0)
+            m_sub_regions[region_id.left(separator)].push_back(m_max_internal_id);
+    }
+
+    ++m_revision;
+    return m_max_internal_id;
 }
 
 QString UIntIdManager::convert_internal_id_to_region_id(const uint& internal_id) const
 {
-    auto entry = m_internal_id_to_region_id.find(internal_id);
-    if (entry == m_internal_id_to_region_id.end())
+    if (internal_id >= m_internal_id_to_region_id.size())
         return QString("");
-    else
-        return entry->second;
+    return m_internal_id_to_region_id[internal_id];
 }
 
 QColor UIntIdManager::convert_region_id_to_color(const QString& region_id)
@@ -69,33 +89,118 @@ QColor UIntIdManager::convert_region_id_to_color(const QString& region_id)
     return QColor::fromRgb(red, green, 0);
 }
 
-QString UIntIdManager::convert_color_to_region_id(const QColor& color) const
+QString UIntIdManager::convert_color_to_region_id(const QColor& color) const { return convert_internal_id_to_region_id(convert_color_to_internal_id(color)); }
+
+uint UIntIdManager::convert_color_to_internal_id(const QColor& color) const
+{
+    const auto internal_id = uint(color.red() * 256 + color.green());
+    return internal_id < m_internal_id_to_region_id.size() ? internal_id : 0;
+}
+
+std::vector<QString> UIntIdManager::get_all_registered_region_ids() const { return m_internal_id_to_region_id; }
+
+bool UIntIdManager::contains(const QString& region_id) const { return m_region_id_to_internal_id.contains(region_id); }
+
+void UIntIdManager::register_regions(std::span<const Region> regions)
 {
-    uint internal_id = color.red() * 256 + color.green();
-    auto entry = m_internal_id_to_region_id.find(internal_id);
-    if (entry == m_internal_id_to_region_id.end())
-        return QString("");
-    return m_internal_id_to_region_id.at(internal_id);
+    m_region_id_to_internal_id.reserve(m_region_id_to_internal_id.size() + regions.size());
+    m_internal_id_to_region_id.reserve(m_internal_id_to_region_id.size() + regions.size());
+    for (const auto& region : regions)
+        set_validity(convert_region_id_to_internal_id(region.id), region.start_date, region.end_date);
 }
 
-uint UIntIdManager::convert_color_to_internal_id(const QColor& color) const
+std::span<const uint> UIntIdManager::sub_regions_of(const QString& parent_region_id) const
 {
-    QString region_id = this->convert_color_to_region_id(color);
-    auto entry = m_region_id_to_internal_id.find(region_id);
-    if (entry == m_region_id_to_internal_id.end())
-        return 0;
-    else
+    const auto entry = m_sub_regions.find(parent_region_id);
+    if (entry == m_sub_regions.end())
+        return {};
+    return entry->second;
+}
+
+void UIntIdManager::set_validity(uint internal_id, const std::optional<QDate>& start_date, const std::optional<QDate>& end_date)
+{
+    // regions are drawn for every tile they touch, the revision must only change if the interval is new
+    if (m_validity.insert(internal_id, start_date, end_date))
+        ++m_revision;
+}
+
+uint16_t UIntIdManager::stack_region(uint16_t raster_id, uint internal_id)
+{
+    Q_ASSERT(internal_id > 0 && internal_id <= m_max_internal_id);
+    if (raster_id == internal_id)
+        return raster_id;
+    if (raster_id == 0)
+        return uint16_t(internal_id);
+
+    auto stack = regions_of(raster_id);
+    if (stack.back() == internal_id)
+        return raster_id;
+    std::erase(stack, uint16_t(internal_id));
+    stack.push_back(uint16_t(internal_id));
+    if (stack.size() == 1)
+        return stack.front();
+
+    const auto entry = m_stack_to_raster_id.find(stack);
+    if (entry != m_stack_to_raster_id.end())
         return entry->second;
+
+    // internal ids and stack ids must not meet. if they would, the pixel keeps its regions and the new one is not drawn there.
+    if (max_raster_id - m_stacks.size() <= m_max_internal_id) {
+        if (!m_out_of_stack_ids_reported)
+            qWarning() << "UIntIdManager: out of raster ids for region stacks, overlapping regions are not stacked anymore";
+        m_out_of_stack_ids_reported = true;
+        return raster_id;
+    }
+    const auto new_raster_id = uint16_t(max_raster_id - m_stacks.size());
+    m_stack_to_raster_id[stack] = new_raster_id;
+    m_stacks.push_back(std::move(stack));
+    ++m_revision;
+    return new_raster_id;
 }
 
-std::vector<QString> UIntIdManager::get_all_registered_region_ids() const
+std::vector<uint16_t> UIntIdManager::regions_of(uint16_t raster_id) const
 {
-    std::vector<QString> region_ids(m_internal_id_to_region_id.size());
-    for (const auto& [internal_id, region_id] : m_internal_id_to_region_id)
-        region_ids[internal_id] = region_id;
-    return region_ids;
+    if (raster_id == 0)
+        return {};
+    const auto stack_index = max_raster_id - raster_id;
+    if (stack_index < m_stacks.size())
+        return m_stacks[stack_index];
+    return { raster_id };
 }
 
-bool UIntIdManager::contains(const QString& region_id) const { return m_region_id_to_internal_id.contains(region_id); }
+uint UIntIdManager::resolve(uint16_t raster_id, const QDate& date) const
+{
+    const auto stack = regions_of(raster_id);
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        if (!m_validity.is_known(*it) || m_validity.is_valid_on(*it, date))
+            return *it;
+    }
+    return 0;
+}
+
+radix::Raster<uint16_t> UIntIdManager::id_remap(const QDate& date) const
+{
+    static_assert(id_remap_size * id_remap_size == max_raster_id + 1);
+    std::vector<bool> is_valid(m_max_internal_id + 1, false);
+    for (uint id = 1; id <= m_max_internal_id; ++id)
+        is_valid[id] = !m_validity.is_known(id);
+    for (const auto id : m_validity.valid_on(date)) {
+        if (id < is_valid.size())
+            is_valid[id] = true;
+    }
+
+    radix::Raster<uint16_t> remap(glm::uvec2(id_remap_size), 0);
+    const auto set = [&remap](uint raster_id, uint internal_id) {
+        remap.pixel({ raster_id % id_remap_size, raster_id / id_remap_size }) = uint16_t(internal_id);
+    };
+    for (uint id = 1; id <= m_max_internal_id; ++id)
+        set(id, is_valid[id] ? id : 0);
+    for (size_t i = 0; i < m_stacks.size(); ++i) {
+        const auto& stack = m_stacks[i];
+        const auto top_valid = std::find_if(stack.rbegin(), stack.rend(), [&is_valid](uint16_t id) { return is_valid[id]; });
+        set(uint(max_raster_id - i), top_valid == stack.rend() ? 0u : uint(*top_valid));
+    }
+    return remap;
+}
 
 } // namespace nucleus::avalanche
@@ -1,21 +1,35 @@
 #pragma once
 
+#include "RegionValidityIndex.h"
 #include <QDate>
 #include <QImage>
 #include <QObject>
 #include <expected>
+#include <map>
+#include <radix/raster.h>
+#include <span>
 
 class QNetworkAccessManager;
 namespace nucleus::avalanche {
+struct Region; // comes from nucleus/avalanche/eaws.h
+
 // This class handles conversion from region-id strings to internal ids as uint and as color
 // querying a region, that the manager does not know, returns 0
 // querying an int that is 0 or unknown, returns empty string,
+// Internal ids are dense, colors encode them directly as red * 256 + green.
+//
+// Region rasters contain raster ids: either the internal id of a single region, or (where regions overlap, e.g., outdated regions and
+// the ones that replaced them) the id of a stack of regions. Stack ids are handed out downwards from 65535, internal ids upwards from 1.
+// Which region of a stack is shown depends on the date, id_remap(date) resolves all raster ids to internal ids. Therefore switching
+// the date only requires uploading a new remap, the rasters stay the same.
 class UIntIdManager : public QObject {
     Q_OBJECT
 
 public:
     const std::vector<QImage::Format> supported_image_formats { QImage::Format_ARGB32 };
-    UIntIdManager(const QDate& reference_date);
+    static constexpr unsigned id_remap_size = 256; // id_remap() is id_remap_size x id_remap_size, i.e., it covers all 16 bit ids
+
+    UIntIdManager();
     QColor convert_region_id_to_color(const QString& region_id);
     QString convert_color_to_region_id(const QColor& color) const;
     uint convert_region_id_to_internal_id(const QString& color);
@@ -23,12 +37,37 @@ public:
     uint convert_color_to_internal_id(const QColor& color) const;
     bool contains(const QString& region_id) const;
     std::vector<QString> get_all_registered_region_ids() const;
-    QDate get_reference_date() const { return m_reference_date; }
+    uint n_internal_ids() const { return uint(m_internal_id_to_region_id.size()); } // including 0
+
+    // Interns the ids of all regions (e.g., the catalogue contained in a region tile) and sets their validity
+    void register_regions(std::span<const Region> regions);
+    // Internal ids of the registered sub regions of parent_region_id, e.g., AT-02-02-01 and AT-02-02-02 for AT-02-02
+    std::span<const uint> sub_regions_of(const QString& parent_region_id) const;
+
+    // Regions without validity are valid at all times
+    void set_validity(uint internal_id, const std::optional<QDate>& start_date, const std::optional<QDate>& end_date);
+    const RegionValidityIndex& validity() const { return m_validity; }
+
+    // Returns the raster id for a pixel with raster_id, on which the region with internal_id is drawn on top (0 is an empty pixel)
+    uint16_t stack_region(uint16_t raster_id, uint internal_id);
+    // Regions of a raster id from bottom to top (a single region for internal ids, empty for 0)
+    std::vector<uint16_t> regions_of(uint16_t raster_id) const;
+    // Internal id of the topmost region of raster_id that is valid on date, or 0
+    uint resolve(uint16_t raster_id, const QDate& date) const;
+    // Lookup table of resolve() for all raster ids, the raster id is encoded as x + y * id_remap_size
+    radix::Raster<uint16_t> id_remap(const QDate& date) const;
+    // Changes whenever regions, stacks or validities are added, i.e., whenever id_remap() might have changed
+    uint64_t revision() const { return m_revision; }
 
 private:
     std::unordered_map<QString, uint> m_region_id_to_internal_id;
-    std::unordered_map<uint, QString> m_internal_id_to_region_id;
+    std::vector<QString> m_internal_id_to_region_id; // indexed by internal id
+    std::unordered_map<QString, std::vector<uint>> m_sub_regions; // parent region id -> internal ids of sub regions
     uint m_max_internal_id = 0;
-    QDate m_reference_date;
+    RegionValidityIndex m_validity;
+    std::vector<std::vector<uint16_t>> m_stacks; // m_stacks[i] has raster id 65535 - i
+    std::map<std::vector<uint16_t>, uint16_t> m_stack_to_raster_id;
+    uint64_t m_revision = 0;
+    bool m_out_of_stack_ids_reported = false;
 };
 } // namespace nucleus::avalanche
@@ -27,29 +27,34 @@
 #include <QNetworkRequest>
 #include <QtAssert>
 #include <algorithm>
+#include <numeric>
 #include <extern/radix/src/radix/tile.h>
-#include <nucleus/tile/conversion.h>
+#include <nucleus/utils/rasterizer.h>
 #include <nucleus/vector_tile/util.h>
 
 namespace nucleus::avalanche {
 
-std::expected<RegionTile, QString> vector_tile_reader(const QByteArray& input_data, const radix::tile::Id& tile_id)
+std::expected<RegionTile, QString> vector_tile_reader(QByteArrayView input_data, const radix::tile::Id& tile_id)
 {
     // This name could theoretically be changed by the EAWS (very unlikely though)
     const QString& name_of_layer_with_eaws_regions = "micro-regions";
 
     // Get all layers of the vector tile and check that the relevant layer (containing EAWS micro regions) exists
-    std::string input_data_as_string = input_data.toStdString();
-    mapbox::vector_tile::buffer tile_buffer(input_data_as_string);
-    std::map<std::string, const protozero::data_view> layers = tile_buffer.getLayers();
-    if (!layers.contains(name_of_layer_with_eaws_regions.toStdString())) {
+    std::map<std::string, protozero::data_view> layers;
+    try {
+        layers = nucleus::vector_tile::util::layers(input_data);
+    } catch (const protozero::exception& e) {
+        return std::unexpected(QString("ERROR in vector_tile::reader::eaws_region: The vector tile is malformed (%1).").arg(e.what()));
+    }
+    const auto layer_entry = layers.find(name_of_layer_with_eaws_regions.toStdString());
+    if (layer_entry == layers.end()) {
         QString error_message
             = "ERROR in vector_tile::reader::eaws_region: The vector tile contains no layer with name " + name_of_layer_with_eaws_regions + ".";
         return std::unexpected(error_message);
     }
 
     // Get the relevant layer and check if it contains data
-    mapbox::vector_tile::layer layer = tile_buffer.getLayer(name_of_layer_with_eaws_regions.toStdString());
+    mapbox::vector_tile::layer layer(layer_entry->second);
     if (layer.featureCount() <= 0) {
         QString error_message = "ERROR in vector_tile::reader::eaws_region: The vector tile contains no EAWS micro-regions in the layer \""
             + name_of_layer_with_eaws_regions + "\".";
@@ -99,68 +104,137 @@ std::expected<RegionTile, QString> vector_tile_reader(const QByteArray& input_da
     return std::expected<RegionTile, QString>(RegionTile(tile_id, regions_to_be_returned));
 }
 
-// Auxillary function: Calculates new coordinates of a region boundary after zoom in / out
-std::vector<QPointF> transform_vertices(const Region& region, const radix::tile::Id& tile_id_in, const radix::tile::Id& tile_id_out, QImage* img)
+radix::geometry::Aabb2<double> tile_bounds_in_local_coordinates(const radix::tile::Id& tile_id_in, const radix::tile::Id& tile_id_out)
 {
-    // Check if input is consistent
-    Q_ASSERT(img->devicePixelRatio() == 1.0);
-    Q_ASSERT((region.resolution.x > 0 && region.resolution.y > 0));
-    Q_ASSERT((img->width() > 0 && img->height() > 0));
-    Q_ASSERT(tile_id_in.coords.x < qPow(2, tile_id_in.zoom_level));
-    Q_ASSERT(tile_id_in.coords.y < qPow(2, tile_id_in.zoom_level));
-    Q_ASSERT(tile_id_out.coords.x < qPow(2, tile_id_out.zoom_level));
-    Q_ASSERT(tile_id_out.coords.y < qPow(2, tile_id_out.zoom_level));
-
-    // Check whether we are zooming in or out for the output raster
-    uint zoom_level_in = tile_id_in.zoom_level;
-    uint zoom_level_out = tile_id_out.zoom_level;
-    float tile_size_in = qPow(0.5f, zoom_level_in);
-    float tile_size_out = qPow(0.5f, zoom_level_out);
-    glm::vec2 origin_in = tile_size_in * glm::vec2((float)tile_id_in.coords.x, (float)tile_id_in.coords.y);
-    glm::vec2 origin_out = tile_size_out * glm::vec2((float)tile_id_out.coords.x, (float)tile_id_out.coords.y);
-    float relative_zoom = 1.f;
-    glm::vec2 relative_origin(0.f, 0.f);
-
-    if (zoom_level_in < zoom_level_out) {
-
-        // Output tile origin must lie within input tile
-        Q_ASSERT(origin_in.x <= origin_out.x && origin_in.y <= origin_out.y);
-        Q_ASSERT(origin_out.x + tile_size_out <= origin_in.x + tile_size_in && origin_out.y + tile_size_out <= origin_in.y + tile_size_in);
-
-        // Determine origin of output tile w.r.t to input tile. Result in [0,1]x[0,1] since the output origin lies within the input tile
-        relative_origin = glm::vec2((origin_out.x - origin_in.x) / tile_size_in, (origin_out.y - origin_in.y) / tile_size_in);
-
-        // Calculate scale factor
-        float n = zoom_level_out - zoom_level_in; // n is the differnc ein zoom steps between in and out
-        relative_zoom = qPow(2, (float)n);
-    }
+    Q_ASSERT(tile_id_in.scheme == tile_id_out.scheme);
+    Q_ASSERT(tile_id_in.coords.x < (1u << tile_id_in.zoom_level) && tile_id_in.coords.y < (1u << tile_id_in.zoom_level));
+    Q_ASSERT(tile_id_out.coords.x < (1u << tile_id_out.zoom_level) && tile_id_out.coords.y < (1u << tile_id_out.zoom_level));
 
-    // This case does not work and it is not clear at this point if this case is necessary
-    Q_ASSERT(zoom_level_in <= zoom_level_out);
-    /*
-    else if (zoom_level_out < zoom_level_in) {
-        // zoom_in > zoom_out => Output tile origin must lie within input tile
-        Q_ASSERT(origin_out.x <= origin_in.x && origin_out.y <= origin_in.y);
-        Q_ASSERT(origin_in.x + tile_size_in <= origin_out.x + tile_size_out && origin_in.y + tile_size_in <= origin_out.y + tile_size_out);
+    // relative to the coarser of the two tiles, so that the numbers stay small at high zoom levels
+    const auto common_zoom_level = std::min(tile_id_in.zoom_level, tile_id_out.zoom_level);
+    const auto in_scale = double(1u << (tile_id_in.zoom_level - common_zoom_level));
+    const auto out_scale = double(1u << (tile_id_out.zoom_level - common_zoom_level));
+    const auto origin = (glm::dvec2(tile_id_out.coords) / out_scale - glm::dvec2(tile_id_in.coords) / in_scale) * in_scale;
+    const auto size = in_scale / out_scale;
+    return { origin, origin + glm::dvec2(size) };
+}
 
-        // Determine origin of input tile w.r.t to output tile. Results in [0,1]x[0,1] since the input origin must lie within the ouput tile
-        relative_origin = glm::vec2((origin_in.x - origin_out.x) / tile_size_out, (origin_in.y - origin_out.y) / tile_size_out);
+namespace {
+    // Maps local region coordinates ([0,1] w.r.t. tile_id_in) to pixel coordinates of a raster covering tile_id_out.
+    // Works for any zoom offset: if tile_id_out is coarser, the input tile only covers a part of the raster, if it is finer, the
+    // polygons extend beyond the raster and are clipped by the rasterizer.
+    struct RegionTransform {
+        glm::dvec2 offset;
+        glm::dvec2 scale;
+        glm::vec2 operator()(const glm::vec2& local) const { return glm::vec2((glm::dvec2(local) - offset) * scale); }
+    };
 
-        // Set logical coordinates to the resolution of the region. These are the coordinates within which we provide vertices of region boundaries
-        float n = zoom_level_in - zoom_level_out; // n is the differnc ein zoom steps between in and out
-        relative_zoom = qPow(0.5, (float)n);
+    RegionTransform region_transform(const radix::tile::Id& tile_id_in, const radix::tile::Id& tile_id_out, const glm::uvec2& raster_size)
+    {
+        const auto bounds = tile_bounds_in_local_coordinates(tile_id_in, tile_id_out);
+        return { bounds.min, glm::dvec2(raster_size) / bounds.size() };
     }
-    */
+} // namespace
+
+void draw_regions(const RegionTile& region_tile,
+    std::span<const uint32_t> region_indices,
+    UIntIdManager& internal_id_manager,
+    radix::Raster<uint16_t>* raster,
+    const radix::tile::Id& tile_id_out)
+{
+    Q_ASSERT(raster);
+    Q_ASSERT(raster->width() > 0 && raster->height() > 0);
+
+    const auto transform = region_transform(region_tile.first, tile_id_out, raster->size());
+    const auto raster_size = glm::ivec2(raster->size());
+    // Overlapping regions are stacked (see UIntIdManager), most pixels are either empty or already hold the same region.
+    // Otherwise the last lookup is remembered, as neighbouring pixels usually have the same overlap.
+    uint16_t last_raster_id = 0;
+    uint last_internal_id = 0;
+    uint16_t last_stacked = 0;
+    // Pixels that were only touched by the outline of a region. The outline also hits pixels of the neighbours, which are not an
+    // overlap, so these pixels are overwritten by a fill instead of being stacked.
+    std::vector<bool> is_outline(size_t(raster_size.x) * size_t(raster_size.y), false);
+    size_t n_filled = 0;
+    const auto is_inside = [raster_size](glm::ivec2 pos) { return pos.x >= 0 && pos.y >= 0 && pos.x < raster_size.x && pos.y < raster_size.y; };
+    const auto index_of = [raster_size](glm::ivec2 pos) { return size_t(pos.y) * size_t(raster_size.x) + size_t(pos.x); };
+    const auto fill_writer = [&](glm::ivec2 pos, unsigned int internal_id) {
+        if (!is_inside(pos))
+            return;
+        ++n_filled;
+        auto& pixel = raster->pixel(glm::uvec2(pos));
+        const auto index = index_of(pos);
+        if (is_outline[index]) {
+            is_outline[index] = false;
+            pixel = uint16_t(internal_id);
+            return;
+        }
+        if (pixel == internal_id)
+            return;
+        if (pixel == 0) {
+            pixel = uint16_t(internal_id);
+            return;
+        }
+        if (pixel != last_raster_id || internal_id != last_internal_id) {
+            last_raster_id = pixel;
+            last_internal_id = internal_id;
+            last_stacked = internal_id_manager.stack_region(pixel, internal_id);
+        }
+        pixel = last_stacked;
+    };
+    const auto outline_writer = [&](glm::ivec2 pos, unsigned int internal_id) {
+        if (!is_inside(pos))
+            return;
+        auto& pixel = raster->pixel(glm::uvec2(pos));
+        if (pixel != 0)
+            return;
+        pixel = uint16_t(internal_id);
+        is_outline[index_of(pos)] = true;
+    };
+    const auto is_outside = [raster_size](const glm::vec2& a, const glm::vec2& b) {
+        return std::max(a.x, b.x) < -1.f || std::max(a.y, b.y) < -1.f
+            || std::min(a.x, b.x) > raster_size.x + 1.f || std::min(a.y, b.y) > raster_size.y + 1.f;
+    };
+
+    std::vector<glm::vec2> vertices;
+    for (const auto region_index : region_indices) {
+        Q_ASSERT(region_index < region_tile.second.size());
+        const auto& region = region_tile.second[region_index];
+        if (region.vertices_in_local_coordinates.empty())
+            continue;
+
+        vertices.clear();
+        vertices.reserve(region.vertices_in_local_coordinates.size());
+        for (const auto& v : region.vertices_in_local_coordinates)
+            vertices.push_back(transform(v));
 
-    // Transform boundary according to input/output tile parameters
-    std::vector<QPointF> transformed_vertices_as_QPointFs;
-    for (const glm::vec2& vec_in : region.vertices_in_local_coordinates) {
-        glm::vec2 vec_out = (vec_in - relative_origin) * relative_zoom;
-        transformed_vertices_as_QPointFs.push_back(QPointF((float)vec_out.x * img->width(), (float)vec_out.y * img->height()));
+        // All regions are drawn regardless of their validity, later ones on top of earlier ones. The date is applied on the GPU.
+        const auto internal_id = internal_id_manager.convert_region_id_to_internal_id(region.id);
+        internal_id_manager.set_validity(internal_id, region.start_date, region.end_date);
+        n_filled = 0;
+        utils::rasterizer::fill_polygon(fill_writer, std::span<const glm::vec2>(vertices), raster_size, utils::rasterizer::FillRule::EvenOdd, internal_id);
+
+        // The outline is drawn as well (like a cosmetic pen), otherwise regions thinner than a pixel would disappear. It only goes into
+        // empty pixels, unless the region has no pixel of its own; then it is stacked like a fill.
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const auto& a = vertices[i];
+            const auto& b = vertices[(i + 1) % vertices.size()];
+            if (is_outside(a, b))
+                continue;
+            if (n_filled > 0)
+                utils::rasterizer::details::render_line_preprocess(outline_writer, { a, b }, internal_id, 0.0f);
+            else
+                utils::rasterizer::details::render_line_preprocess(fill_writer, { a, b }, internal_id, 0.0f);
+        }
     }
+}
 
-    // Return transformed vertices
-    return transformed_vertices_as_QPointFs;
+void draw_regions(const RegionTile& region_tile, UIntIdManager& internal_id_manager, radix::Raster<uint16_t>* raster, const radix::tile::Id& tile_id_out)
+{
+    Q_ASSERT(region_tile.second.size() > 0);
+    std::vector<uint32_t> all_regions(region_tile.second.size());
+    std::iota(all_regions.begin(), all_regions.end(), 0u);
+    draw_regions(region_tile, all_regions, internal_id_manager, raster, tile_id_out);
 }
 
 QImage draw_regions(const RegionTile& region_tile,
@@ -170,37 +244,19 @@ QImage draw_regions(const RegionTile& region_tile,
     const radix::tile::Id& tile_id_out,
     const QImage::Format& image_format)
 {
-    // Create correctly formatted image to draw to
-    QImage img(image_width, image_height, image_format);
-    img.fill(QColor::fromRgb(0, 0, 0));
-
-    // Create painter on the provided image
-    QPainter painter(&img);
-    painter.setRenderHint(QPainter::Antialiasing, false);
+    const auto raster = rasterize_regions(region_tile, internal_id_manager, image_width, image_height, tile_id_out);
 
-    // Draw all regions to the image
-    Q_ASSERT(region_tile.second.size() > 0);
-    radix::tile::Id tile_id_in = region_tile.first;
-    for (const auto& region : region_tile.second) {
-        // Only draw regions as of July 1st 2025
-        QDate refDate(2025, 7, 1);
-        if ((region.start_date.has_value() && region.start_date > refDate) || (region.end_date.has_value() && region.end_date < refDate))
-            continue;
-
-        // Calculate vertex coordinates of region w.r.t. output tile at output resolution
-        std::vector<QPointF> transformed_vertices_as_QPointFs = transform_vertices(region, tile_id_in, tile_id_out, &img);
-
-        // Convert region id to color, for debugging use  color_of_region = QColor::fromRgb(255, 255, 255);
-        QColor color_of_region = internal_id_manager->convert_region_id_to_color(region.id);
-        painter.setBrush(QBrush(color_of_region));
-        painter.setPen(QPen(color_of_region)); // we also have to set the pen if we want to draw boundaries
-
-        // Draw polygon: The first point is implicitly connected to the last point, and the polygon is filled with the current brush().
-        Q_ASSERT(img.devicePixelRatio() == 1.0);
-        painter.drawPolygon(transformed_vertices_as_QPointFs.data(), transformed_vertices_as_QPointFs.size());
-        Q_ASSERT(img.devicePixelRatio() == 1.0);
+    // Internal id is encoded as red * 256 + green, see UIntIdManager::convert_region_id_to_color
+    QImage img(image_width, image_height, QImage::Format_ARGB32);
+    for (uint y = 0; y < image_height; ++y) {
+        auto* line = reinterpret_cast<QRgb*>(img.scanLine(y));
+        for (uint x = 0; x < image_width; ++x) {
+            const auto id = raster.pixel(glm::uvec2(x, y));
+            line[x] = qRgb(id / 256, id % 256, 0);
+        }
     }
-    // return image with all regions in it
+    if (image_format != QImage::Format_ARGB32)
+        return img.convertedTo(image_format);
     return img;
 }
 
@@ -210,9 +266,8 @@ radix::Raster<uint16_t> rasterize_regions(const RegionTile& region_tile,
     const uint raster_height,
     const radix::tile::Id& tile_id_out)
 {
-    // Draw region ids to image, if all pixel have same value return one pixel with this value
-    const QImage img = draw_regions(region_tile, internal_id_manager, raster_width, raster_height, tile_id_out);
-    const auto raster = nucleus::tile::conversion::qimage_to_u16raster(img);
+    radix::Raster<uint16_t> raster(glm::uvec2(raster_width, raster_height), 0);
+    draw_regions(region_tile, *internal_id_manager, &raster, tile_id_out);
     return raster;
 }
 
@@ -17,11 +17,14 @@
  *****************************************************************************/
 #pragma once
 
+#include <QByteArrayView>
 #include <QDate>
-#include <QPainter>
+#include <QImage>
 #include <expected>
 #include <mapbox/vector_tile.hpp>
+#include <radix/geometry.h>
 #include <radix/raster.h>
+#include <span>
 
 namespace radix::tile {
 struct Id;
@@ -56,15 +59,30 @@ using RegionTile = std::pair<radix::tile::Id, std::vector<Region>>;
  * @param input_data: An array holding the data read froma vector tile (usually obtained by reading a from a mvt file).
  * @param tile_id: The zoom, x-y-cordinates and tile-scheme belonging to the input data
  */
-std::expected<RegionTile, QString> vector_tile_reader(const QByteArray& input_data, const radix::tile::Id& tile_id);
+std::expected<RegionTile, QString> vector_tile_reader(QByteArrayView input_data, const radix::tile::Id& tile_id);
 
 // This struct contains report data written to ubo on gpu
 struct UboEawsReports {
     glm::ivec4 reports[1000]; // ~600 regions where each region has a forecast of the form: .x: unfavorable .y: border .z: rating below border .a: rating above
 };
 
-// Creates a new QImage and draws all regions to it where color encodes the region id. Throws error when no regions are provided
-// Note: tile_id_out must have greater or equal zoomlevel than tile_id_in
+// Bounds of tile_id_out in the local coordinates of tile_id_in, i.e., tile_id_in covers [0,1]x[0,1]. Both ids must use the same scheme.
+radix::geometry::Aabb2<double> tile_bounds_in_local_coordinates(const radix::tile::Id& tile_id_in, const radix::tile::Id& tile_id_out);
+
+// Fills all regions into the raster, writing their raster id. The raster covers tile_id_out, which may have any zoom level
+// relative to the tile of the regions (parts outside of the raster are clipped). Regions must not be empty.
+// Regions are drawn regardless of their validity dates: where they overlap, the raster id refers to a stack of regions, which is
+// resolved for a specific date with UIntIdManager::id_remap. The validity of all drawn regions is registered in the manager.
+void draw_regions(const RegionTile& region_tile, UIntIdManager& internal_id_manager, radix::Raster<uint16_t>* raster, const radix::tile::Id& tile_id_out);
+
+// Same as above, but only draws the regions with the given indices (in the given order, later ones are drawn on top).
+void draw_regions(const RegionTile& region_tile,
+    std::span<const uint32_t> region_indices,
+    UIntIdManager& internal_id_manager,
+    radix::Raster<uint16_t>* raster,
+    const radix::tile::Id& tile_id_out);
+
+// Creates a new QImage and draws all regions to it where color encodes the raster id (red * 256 + green), for debugging and previews.
 QImage draw_regions(const RegionTile& region_tile,
     std::shared_ptr<UIntIdManager> internal_id_manager,
     const uint& image_width,
@@ -72,8 +90,7 @@ QImage draw_regions(const RegionTile& region_tile,
     const radix::tile::Id& tile_id_out,
     const QImage::Format& image_format = QImage::Format_ARGB32);
 
-// Creates a raster from a QImage with regions in it. Throws error when raster_width or raster_height is 0.
-// Note: tile_id_out must have greater or equal zoomlevel than tile_id_in
+// Creates a raster with the raster ids of all regions (see draw_regions). raster_width and raster_height must be > 0.
 radix::Raster<uint16_t> rasterize_regions(const RegionTile& region_tile,
     std::shared_ptr<UIntIdManager> internal_id_manager,
     const uint raster_width,
@@ -34,3 +34,8 @@ std::optional<float> AnimationStyle::operation_centre_distance(Definition)
 {
     return {};
 }
+
+std::vector<Definition> AnimationStyle::future_path(Definition, unsigned, unsigned)
+{
+    return {};
+}
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "Definition.h"
 
@@ -32,6 +33,9 @@ public:
     virtual std::optional<Definition> update(Definition camera, AbstractDepthTester* depth_tester);
     virtual std::optional<glm::vec2> operation_centre();
     virtual std::optional<float> operation_centre_distance(Definition camera);
+    // cameras along the rest of the animation, n_samples evenly spaced over the next horizon_msecs (fewer if the animation ends earlier).
+    // used for prefetching tiles. empty if the path is not known in advance.
+    virtual std::vector<Definition> future_path(Definition camera, unsigned horizon_msecs, unsigned n_samples);
 };
 
 } // namespace nucleus::camera
@@ -34,6 +34,11 @@
 
 using namespace nucleus::camera;
 
+namespace {
+constexpr unsigned camera_path_horizon = 2000; // msecs
+constexpr unsigned camera_path_samples = 8;
+} // namespace
+
 Controller::Controller(const Definition& camera, AbstractDepthTester* depth_tester, DataQuerier* data_querier)
     : m_definition(camera)
     , m_depth_tester(depth_tester)
@@ -227,11 +232,14 @@ void Controller::advance_camera()
         if (!new_camera_definition) {
             m_animation_style.reset();
             m_interaction_style->reset_interaction(m_definition, m_depth_tester);
+            update_camera_path();
             return;
         }
         m_definition = new_camera_definition.value();
         update();
+        update_camera_path();
     } else {
+        update_camera_path(); // clears a stale path, if an interaction cancelled the animation
         const auto new_definition = m_interaction_style->update(m_definition, m_depth_tester);
         if (!new_definition)
             return;
@@ -240,6 +248,19 @@ void Controller::advance_camera()
     }
 }
 
+void Controller::update_camera_path()
+{
+    if (m_animation_style) {
+        emit camera_path_changed(m_animation_style->future_path(m_definition, camera_path_horizon, camera_path_samples));
+        m_camera_path_sent = true;
+        return;
+    }
+    if (m_camera_path_sent) {
+        emit camera_path_changed({});
+        m_camera_path_sent = false;
+    }
+}
+
 std::optional<glm::vec2> Controller::operation_centre()
 {
     if (m_animation_style) {
@@ -27,6 +27,7 @@
 #include <QObject>
 #include <glm/glm.hpp>
 #include <memory>
+#include <vector>
 #include <nucleus/event_parameter.h>
 
 namespace nucleus {
@@ -74,10 +75,13 @@ public slots:
 signals:
     void definition_changed(const Definition& new_definition) const;
     void global_cursor_position_changed(glm::dvec3 pos) const;
+    /// where the camera is going to be during the next moments, if known (animations). empty otherwise.
+    void camera_path_changed(const std::vector<nucleus::camera::Definition>& path) const;
 
 private:
     void set_interaction_style(std::unique_ptr<InteractionStyle> new_style);
     void set_animation_style(std::unique_ptr<InteractionStyle> new_style);
+    void update_camera_path();
 
     recording::Device m_recorder;
     Definition m_definition;
@@ -86,6 +90,7 @@ private:
     std::unique_ptr<InteractionStyle> m_interaction_style;
     std::unique_ptr<AnimationStyle> m_animation_style;
     std::chrono::steady_clock::time_point m_last_frame_time;
+    bool m_camera_path_sent = false;
 };
 
 }
@@ -20,6 +20,7 @@
 #include "LinearCameraAnimation.h"
 
 #include <QEasingCurve>
+#include <algorithm>
 
 #include "AbstractDepthTester.h"
 
@@ -44,17 +45,31 @@ std::optional<Definition> LinearCameraAnimation::update(Definition camera, Abstr
         dt = m_total_duration - m_current_duration;
     }
 
-    const float t_eased = ease_in_out((m_current_duration + float(dt)) / float(m_total_duration));
-
     m_current_duration += dt;
-
-    const auto mix_factor = t_eased; //m_current_duration / float(m_total_duration);
-    const auto new_matrix = m_start * double(1 - mix_factor) + m_end * double(mix_factor);
-    camera.set_model_matrix(new_matrix);
+    camera.set_model_matrix(matrix_at(m_current_duration));
 
     return camera;
 }
 
+std::vector<Definition> LinearCameraAnimation::future_path(Definition camera, unsigned horizon_msecs, unsigned n_samples)
+{
+    std::vector<Definition> path;
+    for (unsigned i = 1; i <= n_samples; ++i) {
+        const auto msecs = std::min(m_current_duration + float(horizon_msecs) * float(i) / float(n_samples), float(m_total_duration));
+        camera.set_model_matrix(matrix_at(msecs));
+        path.push_back(camera);
+        if (msecs >= float(m_total_duration))
+            break;
+    }
+    return path;
+}
+
+glm::dmat4 LinearCameraAnimation::matrix_at(float msecs) const
+{
+    const auto mix_factor = ease_in_out(msecs / float(m_total_duration));
+    return m_start * double(1 - mix_factor) + m_end * double(mix_factor);
+}
+
 float LinearCameraAnimation::ease_in_out(float t)
 {
     QEasingCurve c(QEasingCurve::Type::OutExpo);
@@ -35,8 +35,10 @@ class LinearCameraAnimation : public AnimationStyle
 public:
     LinearCameraAnimation(Definition start, Definition end);
     std::optional<Definition> update(Definition camera, AbstractDepthTester* depth_tester) override;
+    std::vector<Definition> future_path(Definition camera, unsigned horizon_msecs, unsigned n_samples) override;
 
 private:
-    float ease_in_out(float t);
+    [[nodiscard]] glm::dmat4 matrix_at(float msecs) const;
+    static float ease_in_out(float t);
 };
 }
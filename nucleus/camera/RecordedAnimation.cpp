@@ -49,3 +49,19 @@ std::optional<nucleus::camera::Definition> nucleus::camera::RecordedAnimation::u
     camera.set_model_matrix(new_matrix);
     return camera;
 }
+
+std::vector<nucleus::camera::Definition> nucleus::camera::RecordedAnimation::future_path(Definition camera, unsigned horizon_msecs, unsigned n_samples)
+{
+    const auto current_time = m_stopwatch.total().count();
+    std::vector<Definition> path;
+    auto frame_iter = m_animation.cbegin();
+    for (unsigned i = 1; i <= n_samples; ++i) {
+        const auto sample_time = current_time + (long long)(horizon_msecs) * i / n_samples;
+        frame_iter = std::find_if(frame_iter, m_animation.cend(), [&](const auto& f) { return f.msec >= sample_time; });
+        if (frame_iter == m_animation.cend())
+            break; // the animation restarts, but we don't predict across that jump
+        camera.set_model_matrix(frame_iter->camera_to_world_matrix);
+        path.push_back(camera);
+    }
+    return path;
+}
@@ -30,6 +30,7 @@ class RecordedAnimation : public AnimationStyle {
 public:
     RecordedAnimation(const recording::Animation& animation);
     std::optional<Definition> update(Definition camera, AbstractDepthTester* depth_tester) override;
+    std::vector<Definition> future_path(Definition camera, unsigned horizon_msecs, unsigned n_samples) override;
 
 private:
     utils::Stopwatch m_stopwatch = {};
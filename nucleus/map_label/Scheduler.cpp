@@ -40,7 +40,7 @@ void Scheduler::transform_and_emit(const std::vector<tile::DataQuad>& new_quads,
         for (const auto& data_tile : data_quad.tiles) {
             vector_tile::PoiTile gpu_tile;
             gpu_tile.id = data_tile.id;
-            auto pois = nucleus::vector_tile::parse::points_of_interest(*data_tile.data, dataquerier().get());
+            auto pois = nucleus::vector_tile::parse::points_of_interest(data_tile.data.view(), dataquerier().get());
             gpu_tile.data = std::make_shared<vector_tile::PointOfInterestCollection>(std::move(pois));
             new_gpu_tiles.emplace_back(gpu_tile);
         }
@@ -21,10 +21,8 @@
 #include "Scheduler.h"
 #include <QThread>
 #include <memory>
-#include <nucleus/tile/QuadAssembler.h>
-#include <nucleus/tile/RateLimiter.h>
-#include <nucleus/tile/SlotLimiter.h>
 #include <nucleus/tile/TileLoadService.h>
+#include <nucleus/tile/pipeline.h>
 
 namespace nucleus::map_label::setup {
 
@@ -36,7 +34,11 @@ struct SchedulerHolder {
     TileLoadServicePtr tile_service;
 };
 
-SchedulerHolder scheduler(TileLoadServicePtr tile_service, const tile::utils::AabbDecoratorPtr& aabb_decorator, const DataQuerierPtr& data_querier, QThread* thread = nullptr)
+SchedulerHolder scheduler(TileLoadServicePtr tile_service,
+    const tile::utils::AabbDecoratorPtr& aabb_decorator,
+    const DataQuerierPtr& data_querier,
+    QThread* thread = nullptr,
+    const nucleus::tile::setup::PipelineOptions& options = {})
 {
     Scheduler::Settings settings;
     settings.max_zoom_level = 18;
@@ -46,39 +48,7 @@ SchedulerHolder scheduler(TileLoadServicePtr tile_service, const tile::utils::Aa
     scheduler->set_aabb_decorator(aabb_decorator);
     scheduler->set_dataquerier(data_querier);
 
-    {
-        using nucleus::tile::QuadAssembler;
-        using nucleus::tile::RateLimiter;
-        using nucleus::tile::SlotLimiter;
-        using nucleus::tile::TileLoadService;
-        auto* sch = scheduler.get();
-        auto* sl = new SlotLimiter(sch);
-        auto* rl = new RateLimiter(sch);
-        auto* qa = new QuadAssembler(sch);
-
-        QObject::connect(sch, &Scheduler::quads_requested, sl, &SlotLimiter::request_quads);
-        QObject::connect(sl, &SlotLimiter::quad_requested, rl, &RateLimiter::request_quad);
-        QObject::connect(rl, &RateLimiter::quad_requested, qa, &QuadAssembler::load);
-        QObject::connect(qa, &QuadAssembler::tile_requested, tile_service.get(), &TileLoadService::load);
-        QObject::connect(tile_service.get(), &TileLoadService::load_finished, qa, &QuadAssembler::deliver_tile);
-
-        QObject::connect(qa, &QuadAssembler::quad_loaded, sl, &SlotLimiter::deliver_quad);
-        QObject::connect(sl, &SlotLimiter::quad_delivered, sch, &nucleus::map_label::Scheduler::receive_quad);
-    }
-    if (QNetworkInformation::loadDefaultBackend() && QNetworkInformation::instance()) {
-        QNetworkInformation* n = QNetworkInformation::instance();
-        scheduler->set_network_reachability(n->reachability());
-        QObject::connect(n, &QNetworkInformation::reachabilityChanged, scheduler.get(), &Scheduler::set_network_reachability);
-    }
-
-    Q_UNUSED(thread);
-#ifdef ALP_ENABLE_THREADING
-    if (thread)
-        tile_service->moveToThread(thread);
-    if (thread)
-        scheduler->moveToThread(thread);
-#endif
-
+    nucleus::tile::setup::build_pipeline(scheduler.get(), tile_service.get(), thread, options);
     return { std::move(scheduler), std::move(tile_service) };
 }
 } // namespace nucleus::map_label::setup
@@ -24,10 +24,13 @@
 #include <algorithm>
 #include <filesystem>
 #include <mutex>
+#include <nucleus/utils/ByteBuffer.h>
 #include <nucleus/utils/lang.h>
 #include <shared_mutex>
+#include <span>
 #include <expected>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <zpp_bits.h>
 
@@ -47,6 +50,41 @@ constexpr auto serialize(auto & archive, glm::vec<2, T> & vec)
 
 }
 
+namespace nucleus::tile::detail {
+// The tile file that is read on this thread, see Cache::read_from_disk.
+inline thread_local const nucleus::utils::ByteBuffer* deserialisation_source = nullptr;
+} // namespace nucleus::tile::detail
+
+namespace nucleus::utils {
+
+// Size prefixed bytes. Buffers read from inside tile::detail::deserialisation_source are slices of it (no copy).
+inline zpp::bits::errc serialize(auto& archive, const ByteBuffer& buffer)
+{
+    return archive(uint32_t(buffer.size()), zpp::bits::unsized(std::span<const char>(buffer.data(), buffer.size())));
+}
+
+inline zpp::bits::errc serialize(auto& archive, ByteBuffer& buffer)
+{
+    using Archive = std::remove_cvref_t<decltype(archive)>;
+    if constexpr (Archive::kind() == zpp::bits::kind::out) {
+        return serialize(archive, std::as_const(buffer));
+    } else {
+        uint32_t size = 0;
+        if (const auto r = archive(size); failure(r))
+            return r;
+        const auto remaining = archive.remaining_data();
+        if (remaining.size() < size)
+            return std::errc::result_out_of_range;
+        const auto* data = reinterpret_cast<const char*>(remaining.data());
+        const auto* source = tile::detail::deserialisation_source;
+        buffer = source ? source->slice_or_copy(data, size) : ByteBuffer::copy_of(QByteArrayView(data, qsizetype(size)));
+        archive.position() += size;
+        return {};
+    }
+}
+
+} // namespace nucleus::utils
+
 namespace nucleus::tile {
 
 /// This class is thread safe. be careful with the visit method as it writes the cache and therefore locks an internal mutex.
@@ -284,12 +322,14 @@ template <NamedTile T> std::expected<void, QString> Cache<T>::read_from_disk(con
         const MetaData& meta = entry.second;
 
         const auto path = tile_path(base_path, id);
-        const auto bytes = read_all(path);
+        auto bytes = read_all(path);
         if (!bytes.has_value()) {
             clean_up();
             return std::unexpected(bytes.error());
         }
-        zpp::bits::in in(bytes.value());
+        // the tiles keep the file buffer alive, instead of copying their bytes out of it
+        const auto file = nucleus::utils::ByteBuffer(std::move(bytes.value()));
+        zpp::bits::in in(std::span<const char>(file.data(), file.size()));
         {
             const auto r = check_version(&in, path);
             if (!r.has_value()) {
@@ -300,7 +340,9 @@ template <NamedTile T> std::expected<void, QString> Cache<T>::read_from_disk(con
 
         CacheObject d;
         {
+            detail::deserialisation_source = &file;
             const auto r = in(d.data);
+            detail::deserialisation_source = nullptr;
             if (failure(r)) {
                 clean_up();
                 return unexpected_error(r);
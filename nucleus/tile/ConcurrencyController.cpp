@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "ConcurrencyController.h"
+
+#include <QtAssert>
+#include <algorithm>
+#include <limits>
+
+using namespace nucleus::tile;
+
+ConcurrencyController::ConcurrencyController(QObject* parent)
+    : ConcurrencyController(Settings {}, parent)
+{
+}
+
+ConcurrencyController::ConcurrencyController(const Settings& settings, QObject* parent)
+    : QObject { parent }
+{
+    set_settings(settings);
+}
+
+const ConcurrencyController::Settings& ConcurrencyController::settings() const { return m_settings; }
+
+void ConcurrencyController::set_settings(const Settings& settings)
+{
+    Q_ASSERT(settings.min_slots > 0 && settings.min_slots <= settings.max_slots);
+    Q_ASSERT(settings.min_rate > 0 && settings.min_rate <= settings.max_rate);
+    Q_ASSERT(settings.decrease_factor > 0 && settings.decrease_factor < 1);
+    m_settings = settings;
+    apply_limits(m_state.slot_limit, m_state.rate_limit);
+}
+
+const ConcurrencyController::State& ConcurrencyController::state() const { return m_state; }
+
+void ConcurrencyController::report(const LoadReport& report)
+{
+    m_window.push_back(report);
+    if (m_window.size() >= std::max(m_settings.min_window_size, m_state.slot_limit))
+        evaluate_window();
+}
+
+void ConcurrencyController::evaluate_window()
+{
+    unsigned n_failed = 0;
+    uint64_t n_bytes = 0;
+    uint64_t latency_sum = 0;
+    uint64_t window_min_latency = std::numeric_limits<uint64_t>::max();
+    uint64_t window_start = std::numeric_limits<uint64_t>::max();
+    uint64_t window_end = 0;
+    for (const auto& r : m_window) {
+        window_start = std::min(window_start, r.started_at);
+        window_end = std::max(window_end, r.finished_at);
+        if (r.failed) {
+            n_failed++;
+            continue;
+        }
+        const auto latency = r.finished_at - std::min(r.started_at, r.finished_at);
+        latency_sum += latency;
+        window_min_latency = std::min(window_min_latency, latency);
+        n_bytes += r.n_bytes;
+    }
+    const auto n_succeeded = unsigned(m_window.size()) - n_failed;
+    m_state.failure_rate = float(n_failed) / float(m_window.size());
+    m_state.bytes_per_second = float(n_bytes) * 1000.0f / float(std::max(uint64_t(1), window_end - std::min(window_start, window_end)));
+    if (n_succeeded > 0) {
+        m_state.latency_msecs = float(latency_sum) / float(n_succeeded);
+        // the lowest latency approximates the round trip time without queuing. it is allowed to drift up slowly, in case the route changed.
+        if (m_state.min_latency_msecs == 0)
+            m_state.min_latency_msecs = float(window_min_latency);
+        else
+            m_state.min_latency_msecs = std::min(m_state.min_latency_msecs * 1.05f, float(window_min_latency));
+    }
+    m_window.clear();
+
+    const auto latency_limit = m_settings.latency_tolerance * m_state.min_latency_msecs + m_settings.latency_slack_msecs;
+    const auto congested = m_state.failure_rate > m_settings.max_failure_rate || (n_succeeded > 0 && m_state.latency_msecs > latency_limit);
+    if (congested) {
+        m_state.n_decreases++;
+        apply_limits(unsigned(float(m_state.slot_limit) * m_settings.decrease_factor), unsigned(float(m_state.rate_limit) * m_settings.decrease_factor));
+    } else {
+        m_state.n_increases++;
+        apply_limits(m_state.slot_limit + m_settings.slot_increase, m_state.rate_limit + m_settings.rate_increase);
+    }
+    emit state_changed(m_state);
+}
+
+void ConcurrencyController::apply_limits(unsigned slot_limit, unsigned rate_limit)
+{
+    slot_limit = std::clamp(slot_limit, m_settings.min_slots, m_settings.max_slots);
+    rate_limit = std::clamp(rate_limit, m_settings.min_rate, m_settings.max_rate);
+    if (slot_limit != m_state.slot_limit) {
+        m_state.slot_limit = slot_limit;
+        emit slot_limit_changed(slot_limit);
+    }
+    if (rate_limit != m_state.rate_limit) {
+        m_state.rate_limit = rate_limit;
+        emit rate_limit_changed(rate_limit, 1000);
+    }
+}
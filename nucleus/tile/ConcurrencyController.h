@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <vector>
+
+#include "types.h"
+
+namespace nucleus::tile {
+
+// Adapts the slot limit (SlotLimiter) and request rate (RateLimiter) to the network, using additive increase / multiplicative decrease.
+// The reports of TileLoadService are collected in windows of about one slot limit worth of requests. A window is congested if too many
+// requests failed, or if the mean latency grew well beyond the lowest latency seen (the requests queue up somewhere). Congestion
+// decreases both limits multiplicatively, otherwise they are increased additively. Always within the configured bounds.
+class ConcurrencyController : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        unsigned min_slots = 4;
+        unsigned max_slots = 64;
+        unsigned min_rate = 20; // requests per second
+        unsigned max_rate = 400;
+        unsigned slot_increase = 2;
+        unsigned rate_increase = 20;
+        float decrease_factor = 0.7f;
+        float max_failure_rate = 0.05f;
+        float latency_tolerance = 2.0f; // mean latency may grow up to latency_tolerance * min latency + latency_slack_msecs
+        float latency_slack_msecs = 20.0f;
+        unsigned min_window_size = 8;
+    };
+    struct State {
+        unsigned slot_limit = 16;
+        unsigned rate_limit = 100; // requests per second
+        float latency_msecs = 0; // mean latency in the last window
+        float min_latency_msecs = 0;
+        float failure_rate = 0;
+        float bytes_per_second = 0;
+        unsigned n_increases = 0;
+        unsigned n_decreases = 0;
+    };
+
+    explicit ConcurrencyController(QObject* parent = nullptr);
+    explicit ConcurrencyController(const Settings& settings, QObject* parent = nullptr);
+
+    [[nodiscard]] const Settings& settings() const;
+    // clamps the current limits into the new bounds
+    void set_settings(const Settings& settings);
+    [[nodiscard]] const State& state() const;
+
+public slots:
+    void report(const LoadReport& report);
+
+signals:
+    void slot_limit_changed(unsigned limit);
+    void rate_limit_changed(unsigned rate, unsigned period_msecs);
+    void state_changed(const ConcurrencyController::State& state);
+
+private:
+    void evaluate_window();
+    void apply_limits(unsigned slot_limit, unsigned rate_limit);
+
+    Settings m_settings;
+    State m_state;
+    std::vector<LoadReport> m_window;
+};
+
+} // namespace nucleus::tile
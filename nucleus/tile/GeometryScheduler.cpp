@@ -44,11 +44,13 @@ void GeometryScheduler::transform_and_emit(const std::vector<tile::DataQuad>& ne
         for (const auto& tile : quad.tiles) {
             GpuGeometryTile gpu_tile;
             gpu_tile.id = tile.id;
-            if (tile.data->size()) {
+            if (aabb_decorator())
+                gpu_tile.bounds = aabb_decorator()->aabb(tile.id);
+            if (!tile.data.empty()) {
                 // tile is available
                 using namespace nucleus::utils;
                 gpu_tile.surface = std::make_shared<const radix::Raster<uint16_t>>(
-                    image_loader::rgba8(*tile.data).and_then(error::wrap_to_expected(conversion::to_u16raster)).value_or(m_default_raster));
+                    image_loader::rgba8(tile.data.view()).and_then(error::wrap_to_expected(conversion::to_u16raster)).value_or(m_default_raster));
             } else {
                 // tile is not available (use default tile)
                 gpu_tile.surface = std::make_shared<const radix::Raster<uint16_t>>(m_default_raster);
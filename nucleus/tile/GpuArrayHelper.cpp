@@ -24,21 +24,39 @@ namespace nucleus::tile {
 GpuArrayHelper::GpuArrayHelper() { }
 
 unsigned GpuArrayHelper::add_tile(const tile::Id& id)
+{
+    const auto layer = reserve_tile(id);
+    m_id_to_layer.emplace(id, layer);
+    return layer;
+}
+
+unsigned GpuArrayHelper::reserve_tile(const tile::Id& id)
 {
     Q_ASSERT(!m_id_to_layer.contains(id));
+    Q_ASSERT(std::find(m_array.begin(), m_array.end(), id) == m_array.end());
     const auto t = std::find(m_array.begin(), m_array.end(), tile::Id { unsigned(-1), {} });
     Q_ASSERT(t != m_array.end());
     *t = id;
 
     // returns index in texture array
-    const auto layer = unsigned(t - m_array.begin());
-    m_id_to_layer.emplace(id, layer);
-    return layer;
+    return unsigned(t - m_array.begin());
+}
+
+void GpuArrayHelper::commit_tile(const tile::Id& tile_id)
+{
+    Q_ASSERT(!m_id_to_layer.contains(tile_id));
+    const auto t = std::find(m_array.begin(), m_array.end(), tile_id);
+    Q_ASSERT(t != m_array.end()); // committing a tile that wasn't reserved
+    m_id_to_layer.emplace(tile_id, unsigned(t - m_array.begin()));
+}
+
+bool GpuArrayHelper::is_reserved(const tile::Id& tile_id) const
+{
+    return !m_id_to_layer.contains(tile_id) && std::find(m_array.begin(), m_array.end(), tile_id) != m_array.end();
 }
 
 void GpuArrayHelper::remove_tile(const tile::Id& tile_id)
 {
-    Q_ASSERT(m_id_to_layer.contains(tile_id));
     m_id_to_layer.erase(tile_id);
     const auto t = std::find(m_array.begin(), m_array.end(), tile_id);
     Q_ASSERT(t != m_array.end()); // removing a tile that's not here. likely there is a race.
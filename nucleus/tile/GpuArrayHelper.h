@@ -38,7 +38,13 @@ public:
 
     /// returns index in texture array
     unsigned add_tile(const tile::Id& tile_id);
+    /// takes an index in the texture array, but the tile stays invisible (layer(), contains(), dictionary) until commit_tile.
+    /// used while the upload is in flight.
+    unsigned reserve_tile(const tile::Id& tile_id);
+    void commit_tile(const tile::Id& tile_id);
+    /// removes committed and reserved tiles
     void remove_tile(const tile::Id& tile_id);
+    bool is_reserved(const tile::Id& tile_id) const;
     void set_tile_limit(unsigned new_limit);
     unsigned size() const;
     unsigned int n_occupied() const;
@@ -0,0 +1,288 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "OcclusionBuffer.h"
+
+#include <QtAssert>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <nucleus/utils/rasterizer.h>
+
+namespace nucleus::tile {
+
+namespace {
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+    constexpr float height_scale = 0.125f; // metres per unit of the height tiles, same as in tile.glsl
+
+    using Polygon = std::vector<glm::dvec2>;
+
+    // Sutherland-Hodgman against one axis aligned edge
+    Polygon clip_edge(const Polygon& polygon, int axis, double value, bool keep_less)
+    {
+        Polygon out;
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            const auto& a = polygon[i];
+            const auto& b = polygon[(i + 1) % polygon.size()];
+            const bool a_inside = keep_less ? a[axis] <= value : a[axis] >= value;
+            const bool b_inside = keep_less ? b[axis] <= value : b[axis] >= value;
+            if (a_inside)
+                out.push_back(a);
+            if (a_inside != b_inside)
+                out.push_back(a + (value - a[axis]) / (b[axis] - a[axis]) * (b - a));
+        }
+        return out;
+    }
+
+    // triangles close to the camera project far outside of the buffer, the rasteriser would walk all of those pixels.
+    Polygon clip_to_rect(Polygon polygon, const glm::dvec2& size)
+    {
+        polygon = clip_edge(polygon, 0, 0.0, false);
+        polygon = clip_edge(polygon, 0, size.x, true);
+        polygon = clip_edge(polygon, 1, 0.0, false);
+        polygon = clip_edge(polygon, 1, size.y, true);
+        return polygon;
+    }
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(unsigned width)
+    : m_width(width)
+{
+}
+
+void OcclusionBuffer::reset(const camera::Definition& camera)
+{
+    m_view_projection = camera.world_view_projection_matrix();
+    m_camera_position = camera.position();
+    m_camera_forward = -camera.z_axis();
+    m_near_plane = camera.near_plane();
+    const auto viewport = camera.viewport_size();
+    const auto height = std::max(1u, unsigned(std::lround(double(m_width) * viewport.y / std::max(viewport.x, 1u))));
+    m_pyramid.assign(1, radix::Raster<float>(glm::uvec2(m_width, height), infinity));
+    m_n_occluders = 0;
+}
+
+OcclusionBuffer::Projected OcclusionBuffer::project(const glm::dvec3& world_position) const
+{
+    const auto clip = m_view_projection * glm::dvec4(world_position, 1.0);
+    const auto ndc = glm::dvec2(clip) / clip.w;
+    const auto& buffer = m_pyramid.front();
+    return { { (ndc.x * 0.5 + 0.5) * buffer.width(), (0.5 - ndc.y * 0.5) * buffer.height() }, glm::dot(world_position - m_camera_position, m_camera_forward) };
+}
+
+void OcclusionBuffer::add_occluder(const SrsAndHeightBounds& bounds, const radix::Raster<float>& heights)
+{
+    Q_ASSERT(!m_pyramid.empty());
+    Q_ASSERT(heights.width() == heights.height() && heights.width() >= 2);
+    const unsigned n = heights.width() - 1;
+    const auto cell_size = glm::dvec2(bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y) / double(n);
+
+    // the occluders must be seen from above. from below the terrain one sees through it (back faces are culled).
+    // if the camera is not above the cell beneath it, this occluder is skipped (the camera is in or under the terrain there).
+    const auto& c = m_camera_position;
+    if (c.x >= bounds.min.x && c.x <= bounds.max.x && c.y >= bounds.min.y && c.y <= bounds.max.y) {
+        const auto col = std::min(unsigned((c.x - bounds.min.x) / cell_size.x), n - 1);
+        const auto row = std::min(unsigned((bounds.max.y - c.y) / cell_size.y), n - 1);
+        const auto cell_max = std::max({ heights.pixel({ col, row }), heights.pixel({ col + 1, row }), heights.pixel({ col, row + 1 }), heights.pixel({ col + 1, row + 1 }) });
+        if (c.z <= double(cell_max))
+            return;
+    }
+    ++m_n_occluders;
+
+    auto& buffer = m_pyramid.front();
+    const auto buffer_size = glm::dvec2(buffer.width(), buffer.height());
+
+    std::vector<Projected> vertices;
+    vertices.reserve((n + 1) * (n + 1));
+    for (unsigned row = 0; row <= n; ++row) {
+        for (unsigned col = 0; col <= n; ++col) {
+            const auto position = glm::dvec3(bounds.min.x + col * cell_size.x, bounds.max.y - row * cell_size.y, heights.pixel({ col, row }));
+            vertices.push_back(project(position));
+        }
+    }
+
+    std::vector<glm::vec2> triangles;
+    std::vector<float> depths;
+    const auto add_triangle = [&](const Projected& a, const Projected& b, const Projected& c) {
+        if (a.depth < m_near_plane || b.depth < m_near_plane || c.depth < m_near_plane)
+            return;
+        const auto polygon = clip_to_rect({ a.position, b.position, c.position }, buffer_size);
+        if (polygon.size() < 3)
+            return;
+        // conservative: the whole triangle is as far away as its farthest vertex
+        const auto depth = std::nextafter(float(std::max({ a.depth, b.depth, c.depth })), infinity);
+        for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+            std::array<glm::vec2, 3> t = { glm::vec2(polygon[0]), glm::vec2(polygon[i]), glm::vec2(polygon[i + 1]) };
+            std::sort(t.begin(), t.end(), [](const glm::vec2& l, const glm::vec2& r) { return l.y < r.y; });
+            if (t[2].y - t[0].y < 0.001f)
+                continue; // degenerate, the rasteriser divides by the height
+            triangles.insert(triangles.end(), t.begin(), t.end());
+            depths.push_back(depth);
+        }
+    };
+    for (unsigned row = 0; row < n; ++row) {
+        for (unsigned col = 0; col < n; ++col) {
+            const auto& v00 = vertices[row * (n + 1) + col];
+            const auto& v01 = vertices[row * (n + 1) + col + 1];
+            const auto& v10 = vertices[(row + 1) * (n + 1) + col];
+            const auto& v11 = vertices[(row + 1) * (n + 1) + col + 1];
+            add_triangle(v00, v10, v11);
+            add_triangle(v00, v11, v01);
+        }
+    }
+
+    const auto pixel_writer = [&](glm::ivec2 p, unsigned triangle_index) {
+        if (p.x < 0 || p.y < 0 || unsigned(p.x) >= buffer.width() || unsigned(p.y) >= buffer.height())
+            return;
+        auto& d = buffer.pixel(glm::uvec2(p));
+        d = std::min(d, depths[triangle_index]);
+    };
+    nucleus::utils::rasterizer::rasterize_triangle(pixel_writer, triangles);
+}
+
+void OcclusionBuffer::finalise()
+{
+    Q_ASSERT(!m_pyramid.empty());
+    m_pyramid.resize(1);
+    if (!enabled())
+        return;
+
+    // the rasteriser writes every touched pixel. eroding by one pixel leaves only pixels that are covered completely.
+    const auto& buffer = m_pyramid.front();
+    const auto w = int(buffer.width());
+    const auto h = int(buffer.height());
+    radix::Raster<float> eroded(buffer.size(), infinity);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            float d = 0;
+            for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, h - 1); ++ny) {
+                for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, w - 1); ++nx)
+                    d = std::max(d, buffer.pixel({ unsigned(nx), unsigned(ny) }));
+            }
+            eroded.pixel({ unsigned(x), unsigned(y) }) = d;
+        }
+    }
+    m_pyramid.front() = std::move(eroded);
+
+    while (m_pyramid.back().width() > 1 || m_pyramid.back().height() > 1) {
+        const auto& fine = m_pyramid.back();
+        const auto size = (fine.size() + 1u) / 2u;
+        radix::Raster<float> coarse(size, 0.f);
+        for (unsigned y = 0; y < size.y; ++y) {
+            for (unsigned x = 0; x < size.x; ++x) {
+                float d = 0;
+                for (unsigned fy = 2 * y; fy < std::min(2 * y + 2, fine.height()); ++fy) {
+                    for (unsigned fx = 2 * x; fx < std::min(2 * x + 2, fine.width()); ++fx)
+                        d = std::max(d, fine.pixel({ fx, fy }));
+                }
+                coarse.pixel({ x, y }) = d;
+            }
+        }
+        m_pyramid.push_back(std::move(coarse));
+    }
+}
+
+bool OcclusionBuffer::is_occluded(const SrsAndHeightBounds& bounds) const
+{
+    if (!enabled() || m_pyramid.size() < 2)
+        return false;
+
+    double min_depth = std::numeric_limits<double>::infinity();
+    auto lo = glm::dvec2(std::numeric_limits<double>::infinity());
+    auto hi = glm::dvec2(-std::numeric_limits<double>::infinity());
+    for (unsigned i = 0; i < 8; ++i) {
+        const auto corner = glm::dvec3(i & 1 ? bounds.max.x : bounds.min.x, i & 2 ? bounds.max.y : bounds.min.y, i & 4 ? bounds.max.z : bounds.min.z);
+        const auto p = project(corner);
+        if (p.depth < m_near_plane)
+            return false;
+        min_depth = std::min(min_depth, p.depth);
+        lo = glm::min(lo, p.position);
+        hi = glm::max(hi, p.position);
+    }
+
+    const auto& base = m_pyramid.front();
+    lo = glm::max(lo, glm::dvec2(0.0));
+    hi = glm::min(hi, glm::dvec2(base.width(), base.height()));
+    if (lo.x >= hi.x || lo.y >= hi.y)
+        return false; // outside of the view, that's for frustum culling to decide
+
+    auto p0 = glm::uvec2(glm::floor(lo));
+    auto p1 = glm::max(p0, glm::min(glm::uvec2(glm::ceil(hi)) - 1u, base.size() - 1u));
+    // hierarchical: go up until the rect covers at most 2x2 texels
+    unsigned level = 0;
+    while (level + 1 < m_pyramid.size() && (p1.x - p0.x > 1 || p1.y - p0.y > 1)) {
+        p0 /= 2u;
+        p1 /= 2u;
+        ++level;
+    }
+    const auto& depth = m_pyramid[level];
+    for (unsigned y = p0.y; y <= p1.y; ++y) {
+        for (unsigned x = p0.x; x <= p1.x; ++x) {
+            if (double(depth.pixel({ x, y })) >= min_depth)
+                return false;
+        }
+    }
+    return true;
+}
+
+std::vector<TileBounds> OcclusionBuffer::cull(std::vector<TileBounds> list) const
+{
+    if (!enabled())
+        return list;
+    std::erase_if(list, [this](const TileBounds& tile) { return is_occluded(tile.bounds); });
+    return list;
+}
+
+radix::Raster<float> OcclusionBuffer::occluder_heights(const radix::Raster<uint16_t>& surface, unsigned n_cells)
+{
+    Q_ASSERT(surface.width() == surface.height() && surface.width() >= 2);
+    Q_ASSERT(n_cells >= 1);
+    const auto n_quads = surface.width() - 1;
+    const auto sample_range = [&](unsigned cell) { return std::pair { cell * n_quads / n_cells, (cell + 1) * n_quads / n_cells }; };
+
+    // heights are not corrected for the latitude (that factor is >= 1), which only lowers the occluders further.
+    radix::Raster<float> cell_min({ n_cells, n_cells }, infinity);
+    for (unsigned cy = 0; cy < n_cells; ++cy) {
+        const auto [y0, y1] = sample_range(cy);
+        for (unsigned cx = 0; cx < n_cells; ++cx) {
+            const auto [x0, x1] = sample_range(cx);
+            uint16_t m = std::numeric_limits<uint16_t>::max();
+            for (unsigned y = y0; y <= y1; ++y) {
+                for (unsigned x = x0; x <= x1; ++x)
+                    m = std::min(m, surface.pixel({ x, y }));
+            }
+            cell_min.pixel({ cx, cy }) = float(m) * height_scale;
+        }
+    }
+
+    radix::Raster<float> heights({ n_cells + 1, n_cells + 1 }, infinity);
+    for (unsigned vy = 0; vy <= n_cells; ++vy) {
+        for (unsigned vx = 0; vx <= n_cells; ++vx) {
+            float h = infinity;
+            for (unsigned cy = vy == 0 ? 0 : vy - 1; cy <= std::min(vy, n_cells - 1); ++cy) {
+                for (unsigned cx = vx == 0 ? 0 : vx - 1; cx <= std::min(vx, n_cells - 1); ++cx)
+                    h = std::min(h, cell_min.pixel({ cx, cy }));
+            }
+            heights.pixel({ vx, vy }) = h;
+        }
+    }
+    return heights;
+}
+
+} // namespace nucleus::tile
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include "types.h"
+#include <nucleus/camera/Definition.h>
+#include <radix/raster.h>
+#include <vector>
+
+namespace nucleus::tile {
+
+/// Coarse cpu depth buffer for culling tiles that are hidden behind nearby terrain (e.g., ridges of a valley).
+/// Occluders are meshes through the minimum heights of a tile (occluder_heights), i.e., they lie on or below the rendered terrain.
+/// Each occluder triangle is written with the depth of its farthest vertex, and the buffer is eroded by one pixel, so that partially
+/// covered pixels don't count. Testing against a max-depth pyramid only rejects tiles that are certainly hidden.
+/// Usage per frame: reset(camera), add_occluder(..) for the nearest tiles, finalise(), cull(draw_list).
+class OcclusionBuffer {
+public:
+    explicit OcclusionBuffer(unsigned width = 128);
+
+    void reset(const camera::Definition& camera);
+    /// heights: (n+1)x(n+1) vertex heights covering bounds, row 0 is north. see occluder_heights.
+    /// skipped if the camera is not above the occluder at its position.
+    void add_occluder(const SrsAndHeightBounds& bounds, const radix::Raster<float>& heights);
+    void finalise();
+
+    /// false if the tile might be visible, also if the buffer can't decide (bounds behind the near plane).
+    [[nodiscard]] bool is_occluded(const SrsAndHeightBounds& bounds) const;
+    [[nodiscard]] std::vector<TileBounds> cull(std::vector<TileBounds> list) const;
+    [[nodiscard]] bool enabled() const { return m_n_occluders > 0; }
+    [[nodiscard]] unsigned n_occluders() const { return m_n_occluders; }
+    [[nodiscard]] const radix::Raster<float>& depth(unsigned level = 0) const { return m_pyramid.at(level); }
+
+    /// vertex heights of an n_cells x n_cells occluder mesh for a height tile (as stored in GpuGeometryTile::surface).
+    /// each vertex gets the minimum of the adjacent cells, so the mesh is nowhere above the rendered surface.
+    [[nodiscard]] static radix::Raster<float> occluder_heights(const radix::Raster<uint16_t>& surface, unsigned n_cells = 8);
+
+private:
+    struct Projected {
+        glm::dvec2 position;
+        double depth;
+    };
+    [[nodiscard]] Projected project(const glm::dvec3& world_position) const;
+
+    unsigned m_width;
+    glm::dmat4 m_view_projection = {};
+    glm::dvec3 m_camera_position = {};
+    glm::dvec3 m_camera_forward = {};
+    double m_near_plane = 0;
+    unsigned m_n_occluders = 0;
+    std::vector<radix::Raster<float>> m_pyramid; // max depth, level 0 is the eroded buffer
+};
+
+} // namespace nucleus::tile
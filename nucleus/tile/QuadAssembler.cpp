@@ -18,6 +18,8 @@
 
 #include "QuadAssembler.h"
 
+#include <algorithm>
+
 using namespace nucleus::tile;
 
 QuadAssembler::QuadAssembler(QObject* parent)
@@ -27,9 +29,18 @@ QuadAssembler::QuadAssembler(QObject* parent)
 
 size_t QuadAssembler::n_items_in_flight() const { return m_quads.size(); }
 
+void QuadAssembler::set_batch_requests(bool enabled) { m_batch_requests = enabled; }
+
+bool QuadAssembler::batch_requests() const { return m_batch_requests; }
+
 void QuadAssembler::load(const tile::Id& tile_id)
 {
     m_quads[tile_id].id = tile_id;
+    if (m_batch_requests) {
+        const auto children = tile_id.children();
+        emit tiles_requested(std::vector<tile::Id>(children.begin(), children.end()));
+        return;
+    }
     for (const auto& child_id : tile_id.children()) {
         emit tile_requested(child_id);
     }
@@ -37,10 +48,35 @@ void QuadAssembler::load(const tile::Id& tile_id)
 
 void QuadAssembler::deliver_tile(const Data& tile)
 {
-    auto& quad = m_quads[tile.id.parent()];
+    const auto it = m_quads.find(tile.id.parent());
+    if (it == m_quads.end())
+        return; // cancelled
+    auto& quad = it->second;
+    // a late tile of a cancelled and re-requested quad can arrive twice
+    const auto tiles_end = quad.tiles.begin() + quad.n_tiles;
+    if (std::find_if(quad.tiles.begin(), tiles_end, [&](const Data& t) { return t.id == tile.id; }) != tiles_end)
+        return;
     quad.tiles[quad.n_tiles++] = tile;
     if (quad.n_tiles == 4) {
         emit quad_loaded(quad);
         m_quads.erase(quad.id);
     }
 }
+
+void QuadAssembler::cancel_quads(const std::vector<tile::Id>& ids)
+{
+    std::vector<tile::Id> cancelled_tiles;
+    for (const auto& id : ids) {
+        const auto it = m_quads.find(id);
+        if (it == m_quads.end())
+            continue;
+        for (const auto& child_id : id.children()) {
+            const auto delivered = std::any_of(it->second.tiles.cbegin(), it->second.tiles.cbegin() + it->second.n_tiles, [&](const Data& t) { return t.id == child_id; });
+            if (!delivered)
+                cancelled_tiles.push_back(child_id);
+        }
+        m_quads.erase(it);
+    }
+    if (!cancelled_tiles.empty())
+        emit tiles_cancelled(cancelled_tiles);
+}
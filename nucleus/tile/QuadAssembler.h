@@ -19,6 +19,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include <QObject>
 #include "types.h"
 
@@ -29,17 +30,25 @@ class QuadAssembler : public QObject {
     using TileId2QuadMap = std::unordered_map<tile::Id, DataQuad, tile::Id::Hasher>;
 
     TileId2QuadMap m_quads;
+    bool m_batch_requests = false;
 
 public:
     explicit QuadAssembler(QObject* parent = nullptr);
     [[nodiscard]] size_t n_items_in_flight() const;
+    // If enabled, the 4 tiles of a quad are requested with a single tiles_requested instead of 4x tile_requested
+    void set_batch_requests(bool enabled);
+    [[nodiscard]] bool batch_requests() const;
 
 public slots:
     void load(const tile::Id& tile_id);
     void deliver_tile(const Data& tile);
+    // drops the partially assembled quads and cancels their missing tiles (tiles_cancelled)
+    void cancel_quads(const std::vector<tile::Id>& ids);
 
 signals:
     void tile_requested(const tile::Id& tile_id);
+    void tiles_requested(const std::vector<tile::Id>& tile_ids);
+    void tiles_cancelled(const std::vector<tile::Id>& tile_ids);
     void quad_loaded(const DataQuad& tile);
 };
 }
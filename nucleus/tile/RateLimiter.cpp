@@ -20,6 +20,7 @@
 
 #include <QTimer>
 #include <QtAssert>
+#include <algorithm>
 #include <nucleus/utils/lang.h>
 
 using namespace nucleus::tile;
@@ -58,6 +59,20 @@ void RateLimiter::request_quad(const tile::Id& id)
     process_request_queue();
 }
 
+void RateLimiter::cancel_quads(const std::vector<tile::Id>& ids)
+{
+    std::vector<tile::Id> sent_on;
+    for (const auto& id : ids) {
+        const auto it = std::find(m_request_queue.cbegin(), m_request_queue.cend(), id);
+        if (it == m_request_queue.cend())
+            sent_on.push_back(id);
+        else
+            m_request_queue.erase(it);
+    }
+    if (!sent_on.empty())
+        emit quads_cancelled(sent_on);
+}
+
 void RateLimiter::process_request_queue()
 {
     const auto current_msecs = utils::time_since_epoch();
@@ -46,11 +46,14 @@ public:
 
 public slots:
     void request_quad(const tile::Id& id);
+    // queued quads are dropped, those that were already sent on are forwarded with quads_cancelled
+    void cancel_quads(const std::vector<tile::Id>& ids);
 
 private slots:
     void process_request_queue();
 
 signals:
     void quad_requested(const tile::Id& tile_id);
+    void quads_cancelled(const std::vector<tile::Id>& tile_ids);
 };
 }
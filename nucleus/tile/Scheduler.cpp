@@ -27,14 +27,23 @@
 #include <QTimer>
 #include <QVariantMap>
 #include <QtAssert>
+#include <algorithm>
+#include <cmath>
 #include <nucleus/DataQuerier.h>
 #include <nucleus/tile/utils.h>
 #include <radix/quad_tree.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
 using namespace nucleus::tile;
 
+namespace {
+constexpr uint64_t max_camera_update_interval = 500; // msecs, longer pauses reset the velocity estimate
+constexpr uint64_t max_camera_velocity_age = 250; // msecs, the camera is considered stationary after that
+constexpr uint64_t prefetch_retention = 30000; // msecs, prefetched quads that weren't used after that don't count as hits anymore
+} // namespace
+
 Scheduler::Scheduler(const Settings& settings)
     : m(settings)
 {
@@ -56,13 +65,34 @@ Scheduler::~Scheduler() = default;
 
 void Scheduler::update_camera(const camera::Definition& camera)
 {
+    const auto now = nucleus::utils::time_since_epoch();
+    const auto dt = now - m_last_camera_update;
+    if (dt > max_camera_update_interval) {
+        m_camera_velocity = {};
+        m_last_camera_position = camera.position();
+        m_last_camera_update = now;
+    } else if (dt > 0) {
+        const auto velocity = (camera.position() - m_last_camera_position) / double(dt);
+        m_camera_velocity = glm::mix(m_camera_velocity, velocity, 0.5);
+        m_last_camera_position = camera.position();
+        m_last_camera_update = now;
+    }
     m_current_camera = camera;
     schedule_update();
 }
 
+void Scheduler::update_camera_path(const std::vector<camera::Definition>& path)
+{
+    m_camera_path = path;
+    schedule_update();
+}
+
 void Scheduler::receive_quad(const DataQuad& new_quad)
 {
     using Status = NetworkInfo::Status;
+    m_statistics.n_tiles_received += new_quad.n_tiles;
+    for (unsigned i = 0; i < new_quad.n_tiles; ++i)
+        m_statistics.n_bytes_copied += new_quad.tiles[i].data.n_copied_bytes();
 #ifdef __EMSCRIPTEN__
     // webassembly doesn't report 404 (well, probably it does, but not if there is a cors failure as well).
     // so we'll simply treat any 404 as network error.
@@ -81,6 +111,7 @@ void Scheduler::receive_quad(const DataQuad& new_quad)
         m_ram_cache.insert(new_quad);
         QVariantMap stats;
         stats["n_quads_ram"] = m_ram_cache.n_cached_objects();
+        stats["bytes_copied_per_tile"] = float(m_statistics.n_bytes_copied) / float(std::max(1u, m_statistics.n_tiles_received));
         emit stats_ready(m_name, stats);
         schedule_purge();
         schedule_update();
@@ -116,6 +147,22 @@ void Scheduler::set_network_reachability(QNetworkInformation::Reachability reach
     }
 }
 
+void Scheduler::update_network_statistics(const ConcurrencyController::State& state)
+{
+    m_statistics.network = state;
+    emit statistics_updated(m_statistics);
+
+    QVariantMap stats;
+    stats["network_slot_limit"] = state.slot_limit;
+    stats["network_rate_limit"] = state.rate_limit;
+    stats["network_latency_ms"] = state.latency_msecs;
+    stats["network_failure_rate"] = state.failure_rate;
+    stats["network_kbytes_per_second"] = state.bytes_per_second / 1024.0f;
+    emit stats_ready(m_name, stats);
+}
+
+const Scheduler::Statistics& Scheduler::statistics() const { return m_statistics; }
+
 void Scheduler::update_gpu_quads()
 {
     const auto should_refine = tile::utils::refineFunctor(m_current_camera, m_aabb_decorator, m.tile_resolution, m.max_zoom_level);
@@ -164,12 +211,22 @@ void Scheduler::send_quad_requests()
 {
     if (!m_network_requests_enabled)
         return;
-    auto quads = missing_quads_for_current_camera();
+    const auto visible_quads = quads_for_current_camera_position();
+    auto quads = missing_quads(visible_quads, m_current_camera);
+    const auto prefetched_quads = prefetch_quads(quads);
+    update_prefetch_statistics(visible_quads, prefetched_quads);
+
     QVariantMap stats;
     stats["n_quads_ram"] = m_ram_cache.n_cached_objects();
     stats["n_quads_ram_max"] = m.ram_quad_limit;
     stats["n_quads_requested"] = unsigned(quads.size());
+    stats["n_quads_prefetched"] = unsigned(prefetched_quads.size());
+    stats["prefetch_hit_rate"] = float(m_statistics.n_prefetch_hits) / float(std::max(1u, m_statistics.n_prefetch_hits + m_statistics.n_prefetch_misses));
     emit stats_ready(m_name, stats);
+
+    // prefetched quads go last, so they only get slots that are not needed for visible quads.
+    // in flight prefetches have to be listed again, otherwise the slot limiter cancels them.
+    quads.insert(quads.end(), prefetched_quads.cbegin(), prefetched_quads.cend());
     emit quads_requested(std::move(quads));
 }
 
@@ -280,11 +337,13 @@ bool Scheduler::read_disk_cache()
     return true;
 }
 
-std::vector<Id> Scheduler::quads_for_current_camera_position() const
+std::vector<Id> Scheduler::quads_for_current_camera_position() const { return quads_for_camera(m_current_camera); }
+
+std::vector<Id> Scheduler::quads_for_camera(const camera::Definition& camera) const
 {
     std::vector<Id> all_inner_nodes;
     const auto all_leaves = radix::quad_tree::onTheFlyTraverse(Id { 0, { 0, 0 } },
-        tile::utils::refineFunctor(m_current_camera, m_aabb_decorator, m.tile_resolution, m.max_zoom_level),
+        tile::utils::refineFunctor(camera, m_aabb_decorator, m.tile_resolution, m.max_zoom_level),
         [&all_inner_nodes](const Id& v) {
             all_inner_nodes.push_back(v);
             return v.children();
@@ -296,16 +355,113 @@ std::vector<Id> Scheduler::quads_for_current_camera_position() const
 
 const utils::AabbDecoratorPtr& Scheduler::aabb_decorator() const { return m_aabb_decorator; }
 
-std::vector<Id> Scheduler::missing_quads_for_current_camera() const
+std::vector<Id> Scheduler::missing_quads_for_current_camera() const { return missing_quads(quads_for_current_camera_position(), m_current_camera); }
+
+std::vector<Id> Scheduler::missing_quads(std::vector<Id> tiles, const camera::Definition& camera) const
 {
-    auto tiles = quads_for_current_camera_position();
     const auto current_time = nucleus::utils::time_since_epoch();
     std::erase_if(tiles, [this, current_time](const tile::Id& id) {
         return m_ram_cache.contains(id) && m_ram_cache.peak_at(id).network_info().timestamp + m.retirement_age_for_tile_cache > current_time;
     });
+
+    // the most visible quads first. this is recomputed for every request, i.e., after the camera moved.
+    const auto screen_space_error = tile::utils::screen_space_error_functor(camera, m_aabb_decorator, m.tile_resolution);
+    std::unordered_map<tile::Id, float, tile::Id::Hasher> priority;
+    priority.reserve(tiles.size());
+    for (const auto& id : tiles)
+        priority[id] = screen_space_error(id);
+
+    // a child can't be shown before its parent, and a child can have a larger error than its parent (e.g., it is closer to the camera).
+    // therefore a quad gets at least the priority of its missing descendants, and parents go first on ties.
+    auto finest_first = tiles;
+    std::stable_sort(finest_first.begin(), finest_first.end(), [](const auto& a, const auto& b) { return a.zoom_level > b.zoom_level; });
+    for (const auto& id : finest_first) {
+        for (auto ancestor = id; ancestor.zoom_level > 0;) {
+            ancestor = ancestor.parent();
+            const auto entry = priority.find(ancestor);
+            if (entry == priority.end())
+                continue;
+            entry->second = std::max(entry->second, priority[id]);
+            break;
+        }
+    }
+
+    std::vector<std::pair<float, tile::Id>> prioritised;
+    prioritised.reserve(tiles.size());
+    for (const auto& id : tiles)
+        prioritised.emplace_back(priority[id], id);
+    std::stable_sort(prioritised.begin(), prioritised.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first)
+            return a.first > b.first;
+        return a.second.zoom_level < b.second.zoom_level;
+    });
+    for (size_t i = 0; i < tiles.size(); ++i)
+        tiles[i] = prioritised[i].second;
     return tiles;
 }
 
+std::vector<nucleus::camera::Definition> Scheduler::predicted_cameras() const
+{
+    if (!m_camera_path.empty())
+        return m_camera_path;
+
+    // no path known, extrapolate linearly. only the position, rotations are too jittery to be useful.
+    const auto velocity_age = nucleus::utils::time_since_epoch() - m_last_camera_update;
+    if (velocity_age > max_camera_velocity_age || m_camera_velocity == glm::dvec3(0))
+        return {};
+    std::vector<camera::Definition> cameras;
+    cameras.reserve(m.prefetch_samples);
+    for (unsigned i = 1; i <= m.prefetch_samples; ++i) {
+        auto camera = m_current_camera;
+        camera.move(m_camera_velocity * (double(m.prefetch_horizon) * i / m.prefetch_samples));
+        cameras.push_back(camera);
+    }
+    return cameras;
+}
+
+std::vector<Id> Scheduler::prefetch_quads(const std::vector<Id>& visible) const
+{
+    if (m.prefetch_bandwidth_share <= 0)
+        return {};
+    const auto max_quads = std::max(1u, unsigned(std::lround(m.prefetch_bandwidth_share * float(m_statistics.network.slot_limit))));
+
+    std::unordered_set<Id, Id::Hasher> listed(visible.cbegin(), visible.cend());
+    std::vector<Id> quads;
+    for (const auto& camera : predicted_cameras()) {
+        for (const auto& id : missing_quads(quads_for_camera(camera), camera)) {
+            if (!listed.insert(id).second)
+                continue;
+            quads.push_back(id);
+            if (quads.size() >= max_quads)
+                return quads;
+        }
+    }
+    return quads;
+}
+
+void Scheduler::update_prefetch_statistics(const std::vector<Id>& visible_quads, const std::vector<Id>& prefetched_quads)
+{
+    const auto now = nucleus::utils::time_since_epoch();
+    std::erase_if(m_prefetched, [now](const auto& entry) { return entry.second + prefetch_retention < now; });
+
+    // only quads coming into view count. the very first cut would only add misses, it can't have been prefetched.
+    if (!m_previous_quads.empty()) {
+        for (const auto& id : visible_quads) {
+            if (m_previous_quads.contains(id))
+                continue;
+            if (!m_ram_cache.contains(id))
+                ++m_statistics.n_prefetch_misses;
+            else if (m_prefetched.erase(id))
+                ++m_statistics.n_prefetch_hits;
+        }
+    }
+    for (const auto& id : prefetched_quads) {
+        if (m_prefetched.emplace(id, now).second)
+            ++m_statistics.n_prefetch_requested;
+    }
+    m_previous_quads = { visible_quads.cbegin(), visible_quads.cend() };
+}
+
 std::shared_ptr<nucleus::DataQuerier> Scheduler::dataquerier() const { return m_dataquerier; }
 
 void Scheduler::set_retirement_age_for_tile_cache(unsigned int new_retirement_age_for_tile_cache)
@@ -346,6 +502,20 @@ void Scheduler::set_purge_timeout(unsigned int new_purge_timeout)
     }
 }
 
+void Scheduler::set_prefetch_bandwidth_share(float new_prefetch_bandwidth_share)
+{
+    Q_ASSERT(new_prefetch_bandwidth_share >= 0 && new_prefetch_bandwidth_share <= 1);
+    m.prefetch_bandwidth_share = new_prefetch_bandwidth_share;
+}
+
+void Scheduler::set_network_settings(const ConcurrencyController::Settings& settings)
+{
+    m_network_settings = settings;
+    emit network_settings_changed(m_network_settings);
+}
+
+const ConcurrencyController::Settings& Scheduler::network_settings() const { return m_network_settings; }
+
 void Scheduler::set_ram_quad_limit(unsigned int new_ram_quad_limit) { m.ram_quad_limit = new_ram_quad_limit; }
 
 void Scheduler::set_gpu_quad_limit(unsigned int new_gpu_quad_limit) { m.gpu_quad_limit = new_gpu_quad_limit; }
@@ -22,11 +22,14 @@
 #include <memory>
 
 #include "Cache.h"
+#include "ConcurrencyController.h"
 #include "nucleus/camera/Definition.h"
 #include "radix/tile.h"
 #include "types.h"
 #include <QNetworkInformation>
 #include <QObject>
+#include <unordered_map>
+#include <unordered_set>
 
 class QTimer;
 
@@ -46,6 +49,12 @@ public:
     struct Statistics {
         unsigned n_tiles_in_ram_cache = 0;
         unsigned n_tiles_in_gpu_cache = 0;
+        unsigned n_tiles_received = 0;
+        uint64_t n_bytes_copied = 0; // between network (or disk) and the scheduler, should stay 0. see nucleus::utils::ByteBuffer
+        unsigned n_prefetch_requested = 0;
+        unsigned n_prefetch_hits = 0; // quads that came into view and were in the ram cache thanks to prefetching
+        unsigned n_prefetch_misses = 0; // quads that came into view and were not in the ram cache
+        ConcurrencyController::State network;
     };
     struct Settings {
         unsigned tile_resolution = 256;
@@ -56,6 +65,9 @@ public:
         unsigned update_timeout = 100;
         unsigned purge_timeout = 1000;
         unsigned persist_timeout = 10000;
+        float prefetch_bandwidth_share = 0.25f; // max prefetched quads per request, as a fraction of the network slot limit (or this layer's share of a slot budget). 0 disables prefetching
+        unsigned prefetch_horizon = 1000; // msecs, how far camera motion is extrapolated if there is no camera path
+        unsigned prefetch_samples = 4; // number of extrapolated cameras
     };
 
     explicit Scheduler(const Settings& settings);
@@ -74,6 +86,12 @@ public:
 
     void set_purge_timeout(unsigned int new_purge_timeout);
 
+    void set_prefetch_bandwidth_share(float new_prefetch_bandwidth_share);
+
+    // bounds of this layer's ConcurrencyController, which is wired up by setup::build_pipeline (see network_settings_changed)
+    void set_network_settings(const ConcurrencyController::Settings& settings);
+    [[nodiscard]] const ConcurrencyController::Settings& network_settings() const;
+
     const Cache<DataQuad>& ram_cache() const;
     Cache<DataQuad>& ram_cache();
 
@@ -91,7 +109,13 @@ public:
 
     const utils::AabbDecoratorPtr& aabb_decorator() const;
 
+    [[nodiscard]] const Statistics& statistics() const;
+
+    // sorted by descending priority (screen space error). a quad has at least the priority of its missing descendants, parents come first.
     std::vector<tile::Id> missing_quads_for_current_camera() const;
+    // quads, which will be needed along the predicted camera path and are not in the visible list. sorted by time along the path,
+    // then by screen space error. limited by Settings::prefetch_bandwidth_share.
+    std::vector<tile::Id> prefetch_quads(const std::vector<tile::Id>& visible) const;
 
     [[nodiscard]] const QString& name() const;
     void set_name(const QString& new_name);
@@ -104,11 +128,15 @@ signals:
     void stats_ready(const QString& scheduler_name, const QVariantMap& new_stats);
     void quad_received(const tile::Id& ids);
     void quads_requested(const std::vector<tile::Id>& ids);
+    void network_settings_changed(const ConcurrencyController::Settings& settings);
 
 public slots:
     void update_camera(const nucleus::camera::Definition& camera);
+    // future cameras, e.g., of an animation (see camera::Controller::camera_path_changed). replaces extrapolation while not empty.
+    void update_camera_path(const std::vector<nucleus::camera::Definition>& path);
     void receive_quad(const DataQuad& new_quad);
     void set_network_reachability(QNetworkInformation::Reachability reachability);
+    void update_network_statistics(const ConcurrencyController::State& state);
     void update_gpu_quads();
     void send_quad_requests();
     void purge_ram_cache();
@@ -119,6 +147,10 @@ protected:
     void schedule_purge();
     void schedule_persist();
     std::vector<tile::Id> quads_for_current_camera_position() const;
+    std::vector<tile::Id> quads_for_camera(const camera::Definition& camera) const;
+    std::vector<tile::Id> missing_quads(std::vector<tile::Id> quads, const camera::Definition& camera) const;
+    std::vector<camera::Definition> predicted_cameras() const;
+    void update_prefetch_statistics(const std::vector<tile::Id>& visible_quads, const std::vector<tile::Id>& prefetched_quads);
     virtual bool is_ready_to_ship(const DataQuad&) const { return true; }
     virtual void transform_and_emit(const std::vector<DataQuad>& new_quads, const std::vector<tile::Id>& deleted_quads) = 0;
 
@@ -129,10 +161,17 @@ private:
     bool m_enabled = false;
     bool m_network_requests_enabled = true;
     Statistics m_statistics;
+    ConcurrencyController::Settings m_network_settings;
     std::unique_ptr<QTimer> m_update_timer;
     std::unique_ptr<QTimer> m_purge_timer;
     std::unique_ptr<QTimer> m_persist_timer;
     camera::Definition m_current_camera;
+    std::vector<camera::Definition> m_camera_path;
+    glm::dvec3 m_camera_velocity = { 0, 0, 0 }; // per msec
+    glm::dvec3 m_last_camera_position = { 0, 0, 0 };
+    uint64_t m_last_camera_update = 0;
+    std::unordered_map<tile::Id, uint64_t, tile::Id::Hasher> m_prefetched; // id -> time of the request
+    std::unordered_set<tile::Id, tile::Id::Hasher> m_previous_quads;
     utils::AabbDecoratorPtr m_aabb_decorator;
     Cache<DataQuad> m_ram_cache;
     Cache<GpuCacheInfo> m_gpu_cached;
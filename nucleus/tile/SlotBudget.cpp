@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "SlotBudget.h"
+
+#include "ConcurrencyController.h"
+#include "SlotLimiter.h"
+#include <QtAssert>
+#include <algorithm>
+#include <cmath>
+
+using namespace nucleus::tile;
+
+ConcurrencyController::Settings SlotBudget::default_controller_settings()
+{
+    ConcurrencyController::Settings settings;
+    settings.min_slots = 8;
+    settings.max_slots = 128;
+    return settings;
+}
+
+SlotBudget::SlotBudget(QObject* parent)
+    : SlotBudget(default_controller_settings(), parent)
+{
+}
+
+SlotBudget::SlotBudget(const ConcurrencyController::Settings& controller_settings, QObject* parent)
+    : QObject { parent }
+{
+    m_controller = new ConcurrencyController(controller_settings, this);
+    m_limit = m_controller->state().slot_limit;
+    connect(m_controller, &ConcurrencyController::slot_limit_changed, this, &SlotBudget::set_limit);
+}
+
+SlotBudget::~SlotBudget() { Q_ASSERT(m_layers.empty()); }
+
+unsigned SlotBudget::limit() const { return m_limit; }
+
+unsigned SlotBudget::slots_taken() const
+{
+    unsigned n = 0;
+    for (const auto& layer : m_layers)
+        n += layer.limiter->slots_taken();
+    return n;
+}
+
+size_t SlotBudget::n_layers() const { return m_layers.size(); }
+
+ConcurrencyController* SlotBudget::controller() const { return m_controller; }
+
+unsigned SlotBudget::share_of(const SlotLimiter* limiter) const
+{
+    float total_weight = 0;
+    float weight = 0;
+    for (const auto& layer : m_layers) {
+        total_weight += layer.weight;
+        if (layer.limiter == limiter)
+            weight = layer.weight;
+    }
+    if (weight == 0)
+        return m_limit;
+    return std::max(1u, unsigned(std::lround(float(m_limit) * weight / total_weight)));
+}
+
+void SlotBudget::add(SlotLimiter* limiter, float weight)
+{
+    Q_ASSERT(limiter);
+    Q_ASSERT(weight > 0);
+    Q_ASSERT(std::none_of(m_layers.cbegin(), m_layers.cend(), [&](const Layer& l) { return l.limiter == limiter; }));
+    m_layers.push_back({ limiter, weight, m_virtual_time });
+}
+
+void SlotBudget::remove(SlotLimiter* limiter)
+{
+    std::erase_if(m_layers, [&](const Layer& l) { return l.limiter == limiter; });
+    // the slots of the removed layer are free now
+    dispatch();
+}
+
+void SlotBudget::set_limit(unsigned limit)
+{
+    Q_ASSERT(limit > 0);
+    m_limit = limit;
+    // a lower limit takes effect when in flight quads are delivered
+    dispatch();
+}
+
+void SlotBudget::set_controller_settings(const ConcurrencyController::Settings& settings) { m_controller->set_settings(settings); }
+
+void SlotBudget::dispatch()
+{
+    while (slots_taken() < m_limit) {
+        // the next request of a layer starts at its last finish tag, or now if the layer was idle.
+        // the smallest start tag goes first, ties go to the heavier layer (and then to the one added first).
+        Layer* next = nullptr;
+        double next_start = 0;
+        for (auto& layer : m_layers) {
+            if (layer.limiter->queue_size() == 0)
+                continue;
+            const auto start = std::max(layer.finish_tag, m_virtual_time);
+            if (!next || start < next_start || (start == next_start && layer.weight > next->weight)) {
+                next = &layer;
+                next_start = start;
+            }
+        }
+        if (!next)
+            return;
+        m_virtual_time = next_start;
+        next->finish_tag = next_start + 1.0 / double(next->weight);
+        next->limiter->dispatch_next();
+    }
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include "ConcurrencyController.h"
+#include <QObject>
+#include <vector>
+
+namespace nucleus::tile {
+class SlotLimiter;
+
+// One slot limit shared by the SlotLimiters of several layers (geometry, ortho, labels, ..), so that they don't compete for the
+// same connection without coordination. Free slots are handed out with weighted fair queuing (start time fair queuing): while
+// several layers are waiting, a layer with weight 4 gets 4 slots for every slot of a layer with weight 1. Within a layer, the
+// SlotLimiter's priority order is kept. Idle layers don't save up credit.
+// The limit is adapted to the network by controller(), which gets the load reports of all layers.
+// Not thread safe, the budget and all its limiters must live on the same thread.
+class SlotBudget : public QObject {
+    Q_OBJECT
+public:
+    // the budget is shared by all layers, so it may grow larger than the limit of a single layer
+    static ConcurrencyController::Settings default_controller_settings();
+
+    explicit SlotBudget(QObject* parent = nullptr);
+    explicit SlotBudget(const ConcurrencyController::Settings& controller_settings, QObject* parent = nullptr);
+    ~SlotBudget() override;
+
+    [[nodiscard]] unsigned limit() const;
+    [[nodiscard]] unsigned slots_taken() const;
+    [[nodiscard]] size_t n_layers() const;
+    [[nodiscard]] ConcurrencyController* controller() const;
+    // slots of the limit that belong to limiter while all layers are waiting, i.e., its weighted share (at least 1)
+    [[nodiscard]] unsigned share_of(const SlotLimiter* limiter) const;
+
+    // called by SlotLimiter::set_budget
+    void add(SlotLimiter* limiter, float weight);
+    void remove(SlotLimiter* limiter);
+
+    // hands free slots to the waiting requests of the layers
+    void dispatch();
+
+public slots:
+    void set_limit(unsigned limit);
+    // bounds of controller(), the limit is clamped into them
+    void set_controller_settings(const ConcurrencyController::Settings& settings);
+
+private:
+    struct Layer {
+        SlotLimiter* limiter = nullptr;
+        float weight = 1.0f;
+        double finish_tag = 0; // virtual time at which the last request of this layer is served
+    };
+    std::vector<Layer> m_layers;
+    unsigned m_limit = 16;
+    double m_virtual_time = 0;
+    ConcurrencyController* m_controller = nullptr;
+};
+
+} // namespace nucleus::tile
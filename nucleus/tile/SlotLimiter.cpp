@@ -18,7 +18,9 @@
 
 #include "SlotLimiter.h"
 
+#include "SlotBudget.h"
 #include <QtAssert>
+#include <algorithm>
 
 using namespace nucleus::tile;
 
@@ -27,10 +29,22 @@ SlotLimiter::SlotLimiter(QObject* parent)
 {
 }
 
+SlotLimiter::~SlotLimiter()
+{
+    if (m_budget) {
+        // our slots are given to the other layers, but we don't have anything to request anymore
+        m_request_queue.clear();
+        m_in_flight.clear();
+        m_budget->remove(this);
+    }
+}
+
 void SlotLimiter::set_limit(unsigned new_limit)
 {
     Q_ASSERT(new_limit > 0);
     m_limit = new_limit;
+    // a lower limit takes effect when in flight quads are delivered
+    fill_slots();
 }
 
 unsigned SlotLimiter::limit() const
@@ -43,29 +57,67 @@ unsigned SlotLimiter::slots_taken() const
     return unsigned(m_in_flight.size());
 }
 
+size_t SlotLimiter::queue_size() const { return m_request_queue.size(); }
+
+void SlotLimiter::set_budget(std::shared_ptr<SlotBudget> budget, float weight)
+{
+    if (m_budget)
+        m_budget->remove(this);
+    m_budget = std::move(budget);
+    if (m_budget)
+        m_budget->add(this, weight);
+    fill_slots();
+}
+
+SlotBudget* SlotLimiter::budget() const { return m_budget.get(); }
+
+void SlotLimiter::dispatch_next()
+{
+    Q_ASSERT(!m_request_queue.empty());
+    const auto next = m_request_queue.back();
+    m_request_queue.pop_back();
+    m_in_flight.insert(next);
+    emit quad_requested(next);
+}
+
+void SlotLimiter::fill_slots()
+{
+    if (m_budget) {
+        m_budget->dispatch();
+        return;
+    }
+    while (m_in_flight.size() < m_limit && !m_request_queue.empty())
+        dispatch_next();
+}
+
 void SlotLimiter::request_quads(const std::vector<tile::Id>& ids)
 {
+    const std::unordered_set<tile::Id, tile::Id::Hasher> requested(ids.cbegin(), ids.cend());
+    std::vector<tile::Id> cancelled;
+    std::erase_if(m_in_flight, [&](const tile::Id& id) {
+        if (requested.contains(id))
+            return false;
+        cancelled.push_back(id);
+        return true;
+    });
+    if (!cancelled.empty())
+        emit quads_cancelled(cancelled);
+
     m_request_queue.clear();
     for (const tile::Id& id : ids) {
-        if (m_in_flight.contains(id))
-            continue;
-        if (m_in_flight.size() >= m_limit) {
+        if (!m_in_flight.contains(id))
             m_request_queue.push_back(id);
-        } else {
-            m_in_flight.insert(id);
-            emit quad_requested(id);
-        }
     }
+    std::reverse(m_request_queue.begin(), m_request_queue.end());
+    fill_slots();
 }
 
 void SlotLimiter::deliver_quad(const DataQuad& tile)
 {
-    m_in_flight.erase(tile.id);
+    // quads that were cancelled, but had already been on their way, are still passed on. but they don't free a slot.
+    const auto freed_slot = m_in_flight.erase(tile.id) > 0;
     emit quad_delivered(tile);
-    if (m_request_queue.empty())
-        return;
-
-    m_in_flight.insert(m_request_queue.front());
-    emit quad_requested(m_request_queue.front());
-    m_request_queue.erase(m_request_queue.cbegin());
+    // with a budget, the freed slot may go to another layer
+    if (freed_slot)
+        fill_slots();
 }
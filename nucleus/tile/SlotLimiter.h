@@ -19,32 +19,54 @@
 #pragma once
 
 #include <unordered_set>
+#include <memory>
 #include <QObject>
 #include "types.h"
 
 namespace nucleus::tile {
+class SlotBudget;
 
 class SlotLimiter : public QObject {
     Q_OBJECT
 
     unsigned m_limit = 16;
     std::unordered_set<tile::Id, tile::Id::Hasher> m_in_flight;
+    // priority queue of waiting requests, stored in ascending priority so that the next request is at the back.
+    // it is replaced by every call to request_quads, that is, priorities are re-evaluated whenever the scheduler sends a new list.
     std::vector<tile::Id> m_request_queue;
+    std::shared_ptr<SlotBudget> m_budget;
 
 public:
     explicit SlotLimiter(QObject* parent = nullptr);
+    ~SlotLimiter() override;
 
+    // the limit of this layer. it is ignored while the limiter takes part in a shared budget.
     void set_limit(unsigned int new_limit);
     [[nodiscard]] unsigned int limit() const;
     unsigned int slots_taken() const;
+    [[nodiscard]] size_t queue_size() const;
+
+    // shares the slots with the other limiters of budget, weight is this layer's share (see SlotBudget). nullptr leaves the budget.
+    void set_budget(std::shared_ptr<SlotBudget> budget, float weight = 1.0f);
+    [[nodiscard]] SlotBudget* budget() const;
 
 public slots:
-    void request_quads(const std::vector<tile::Id>& id);
+    // ids are sorted by descending priority (see Scheduler::missing_quads_for_current_camera).
+    // in flight quads that are not in ids anymore are cancelled (quads_cancelled), freeing their slots for the new requests.
+    void request_quads(const std::vector<tile::Id>& ids);
     void deliver_quad(const DataQuad& tile);
 
 signals:
     void quad_requested(const tile::Id& tile_id);
+    void quads_cancelled(const std::vector<tile::Id>& tile_ids);
     void quad_delivered(const DataQuad& id);
+
+private:
+    friend class SlotBudget;
+    // requests the highest priority quad from the queue
+    void dispatch_next();
+    // takes requests from the queue until the own limit or the budget is exhausted
+    void fill_slots();
 };
 
 }
@@ -42,7 +42,7 @@ void Texture3DScheduler::transform_and_emit(const std::vector<tile::DataQuad>& n
         for (size_t i = 0; i < 4; i++) {
             const auto& tile = quad.tiles[i];
 
-            if (tile.data->size() == 0)
+            if (tile.data.empty())
                 continue;
 
             // NOTE: This implementation is quite specific to the cloud texture loading. Not intended for general purpose use.
@@ -53,7 +53,7 @@ void Texture3DScheduler::transform_and_emit(const std::vector<tile::DataQuad>& n
             gpu_tile.texture = texture;
 
             ktxTexture* ktx = nullptr;
-            ktxTexture_CreateFromMemory(reinterpret_cast<const ktx_uint8_t*>(tile.data.get()->data()), tile.data->size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx);
+            ktxTexture_CreateFromMemory(reinterpret_cast<const ktx_uint8_t*>(tile.data.data()), tile.data.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &ktx);
 
             texture->reserve(ktx->numLevels);
             ktxTexture_IterateLevelFaces(ktx, [](int /*miplevel*/, int /*face*/, int width, int height, int depth, ktx_uint64_t faceLodSize, void *pixels, void *userdata) {
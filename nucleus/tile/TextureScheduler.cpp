@@ -63,9 +63,9 @@ radix::Raster<glm::u8vec4> TextureScheduler::to_raster(const tile::DataQuad& qua
     for (const auto& tile : quad.tiles) {
         const auto quad_index = unsigned(quad_position(tile.id));
         quad_ids[quad_index] = tile.id;
-        if (tile.data->size()) {
+        if (!tile.data.empty()) {
             // Ortho image is available
-            const auto ortho_raster = nucleus::utils::image_loader::rgba8(*tile.data.get()).value_or(default_raster);
+            const auto ortho_raster = nucleus::utils::image_loader::rgba8(tile.data.view()).value_or(default_raster);
             quad_rasters[quad_index] = std::move(ortho_raster);
         } else {
             // Ortho image is not available (use white default tile)
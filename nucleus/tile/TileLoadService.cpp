@@ -18,16 +18,21 @@
  *****************************************************************************/
 
 #include "TileLoadService.h"
+#include "batch.h"
 
 #include <QDebug>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
+#include <QUrlQuery>
 #include <QtVersionChecks>
 #include <QtAssert>
 #include <nucleus/srs.h>
+#include <algorithm>
+#include <limits>
 #include <nucleus/utils/lang.h>
 
 using namespace nucleus::tile;
+using nucleus::utils::ByteBuffer;
 
 TileLoadService::TileLoadService(const QString& base_url, UrlPattern url_pattern, const QString& file_ending, const LoadBalancingTargets& load_balancing_targets)
     : m_network_manager(new QNetworkAccessManager(this))
@@ -40,35 +45,149 @@ TileLoadService::TileLoadService(const QString& base_url, UrlPattern url_pattern
 
 TileLoadService::~TileLoadService() = default;
 
-void TileLoadService::load(const tile::Id& tile_id) const
+QNetworkRequest TileLoadService::make_request(const QUrl& url, unsigned zoom_level) const
 {
-    QNetworkRequest request(QUrl(build_tile_url(tile_id)));
+    QNetworkRequest request(url);
     request.setTransferTimeout(int(m_transfer_timeout));
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+    // multiplex all tile requests over one connection per host, instead of queuing them on the (max 6) http/1.1 connections
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    // coarse tiles cover most of the screen and unblock refinement, so they should overtake the fine ones
+    if (zoom_level <= 8)
+        request.setPriority(QNetworkRequest::HighPriority);
+    else if (zoom_level >= 16)
+        request.setPriority(QNetworkRequest::LowPriority);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
     request.setAttribute(QNetworkRequest::UseCredentialsAttribute, false);
 #endif
+    return request;
+}
 
-    QNetworkReply* reply = m_network_manager->get(request);
-    connect(reply, &QNetworkReply::finished, [tile_id, reply, this]() {
+void TileLoadService::load(const tile::Id& tile_id) const
+{
+    const auto started_at = utils::time_since_epoch();
+    QNetworkReply* reply = m_network_manager->get(make_request(QUrl(build_tile_url(tile_id)), tile_id.zoom_level));
+    m_in_flight[tile_id] = reply;
+    connect(reply, &QNetworkReply::finished, [tile_id, reply, started_at, this]() {
+        if (!take_in_flight(tile_id, reply)) {
+            reply->deleteLater();
+            return;
+        }
         const auto error = reply->error();
         const auto timestamp = utils::time_since_epoch();
         if (error == QNetworkReply::NoError) {
-            auto tile = std::make_shared<QByteArray>(reply->readAll());
+            auto tile = ByteBuffer(reply->readAll());
+            emit request_finished({ started_at, timestamp, uint64_t(tile.size()), 1, false });
             emit load_finished({tile_id, {NetworkInfo::Status::Good, timestamp}, tile});
         } else if (error == QNetworkReply::ContentNotFoundError) {
-            auto tile = std::make_shared<QByteArray>();
-            emit load_finished({tile_id, {NetworkInfo::Status::NotFound, timestamp}, tile});
+            emit request_finished({ started_at, timestamp, 0, 1, false });
+            emit load_finished({ tile_id, { NetworkInfo::Status::NotFound, timestamp }, {} });
         } else {
             //            qDebug() << reply->url() << ": " << error;
-            auto tile = std::make_shared<QByteArray>();
-            emit load_finished({tile_id, {NetworkInfo::Status::NetworkError, timestamp}, tile});
+            emit request_finished({ started_at, timestamp, 0, 1, true });
+            emit load_finished({ tile_id, { NetworkInfo::Status::NetworkError, timestamp }, {} });
         }
         reply->deleteLater();
     });
 }
 
-QString TileLoadService::build_tile_url(tile::Id tile_id) const
+void TileLoadService::load_batch(const std::vector<tile::Id>& tile_ids) const
+{
+    if (m_batch_url.isEmpty() || tile_ids.size() == 1) {
+        for (const auto& id : tile_ids)
+            load(id);
+        return;
+    }
+    if (tile_ids.empty())
+        return;
+
+    QStringList addresses;
+    addresses.reserve(qsizetype(tile_ids.size()));
+    unsigned min_zoom_level = std::numeric_limits<unsigned>::max();
+    for (const auto& id : tile_ids) {
+        addresses.append(tile_address(id) + m_file_ending);
+        min_zoom_level = std::min<unsigned>(min_zoom_level, id.zoom_level);
+    }
+    // the whole batch goes to the target of its first tile
+    QUrl url(load_balanced(m_batch_url, tile_address(tile_ids.front())));
+    QUrlQuery query(url);
+    query.addQueryItem("tiles", addresses.join(','));
+    url.setQuery(query);
+
+    const auto started_at = utils::time_since_epoch();
+    QNetworkReply* reply = m_network_manager->get(make_request(url, min_zoom_level));
+    for (const auto& id : tile_ids)
+        m_in_flight[id] = reply;
+    connect(reply, &QNetworkReply::finished, [tile_ids, reply, started_at, this]() {
+        reply->deleteLater();
+        std::vector<bool> wanted(tile_ids.size());
+        for (size_t i = 0; i < tile_ids.size(); ++i)
+            wanted[i] = take_in_flight(tile_ids[i], reply);
+        if (std::find(wanted.cbegin(), wanted.cend(), true) == wanted.cend())
+            return; // cancelled
+
+        const auto timestamp = utils::time_since_epoch();
+        const auto fail_all = [&]() {
+            emit request_finished({ started_at, timestamp, 0, unsigned(tile_ids.size()), true });
+            for (size_t i = 0; i < tile_ids.size(); ++i) {
+                if (wanted[i])
+                    emit load_finished({ tile_ids[i], { NetworkInfo::Status::NetworkError, timestamp }, {} });
+            }
+        };
+        if (reply->error() != QNetworkReply::NoError) {
+            fail_all();
+            return;
+        }
+        const auto container = ByteBuffer(reply->readAll());
+        const auto entries = batch::decode(container);
+        if (!entries.has_value() || entries->size() != tile_ids.size()) {
+            qWarning() << "TileLoadService: invalid batch response from" << reply->url() << ":" << (entries.has_value() ? QString("wrong tile count") : entries.error());
+            fail_all();
+            return;
+        }
+        emit request_finished({ started_at, timestamp, uint64_t(container.size()), unsigned(tile_ids.size()), false });
+        for (size_t i = 0; i < tile_ids.size(); ++i) {
+            if (!wanted[i])
+                continue;
+            const auto& entry = (*entries)[i];
+            auto status = NetworkInfo::Status::NetworkError;
+            if (entry.http_status == 200)
+                status = NetworkInfo::Status::Good;
+            else if (entry.http_status == 404)
+                status = NetworkInfo::Status::NotFound;
+            emit load_finished({ tile_ids[i], { status, timestamp }, status == NetworkInfo::Status::Good ? entry.data : ByteBuffer() });
+        }
+    });
+}
+
+void TileLoadService::cancel(const std::vector<tile::Id>& tile_ids) const
+{
+    // first remove all tiles, abort emits finished synchronously and would report the other tiles of a batch otherwise
+    std::vector<QNetworkReply*> replies;
+    for (const auto& id : tile_ids) {
+        const auto it = m_in_flight.find(id);
+        if (it == m_in_flight.end())
+            continue;
+        if (std::find(replies.cbegin(), replies.cend(), it->second) == replies.cend())
+            replies.push_back(it->second);
+        m_in_flight.erase(it);
+    }
+    for (QNetworkReply* reply : replies) {
+        if (reply->isRunning())
+            reply->abort();
+    }
+}
+
+bool TileLoadService::take_in_flight(const tile::Id& tile_id, const QNetworkReply* reply) const
+{
+    const auto it = m_in_flight.find(tile_id);
+    if (it == m_in_flight.end() || it->second != reply)
+        return false;
+    m_in_flight.erase(it);
+    return true;
+}
+
+QString TileLoadService::tile_address(tile::Id tile_id) const
 {
     switch (m_url_pattern) {
     case UrlPattern::ZXY:
@@ -81,24 +200,31 @@ QString TileLoadService::build_tile_url(tile::Id tile_id) const
         break;
     }
 
-    QString tile_address;
     switch (m_url_pattern) {
     case UrlPattern::ZXY:
     case UrlPattern::ZXY_yPointingSouth:
-        tile_address = QString("%1/%2/%3").arg(tile_id.zoom_level).arg(tile_id.coords.x).arg(tile_id.coords.y);
-        break;
+        return QString("%1/%2/%3").arg(tile_id.zoom_level).arg(tile_id.coords.x).arg(tile_id.coords.y);
     case UrlPattern::ZYX:
     case UrlPattern::ZYX_yPointingSouth:
-        tile_address = QString("%1/%3/%2").arg(tile_id.zoom_level).arg(tile_id.coords.x).arg(tile_id.coords.y);
-        break;
+        return QString("%1/%3/%2").arg(tile_id.zoom_level).arg(tile_id.coords.x).arg(tile_id.coords.y);
     }
-    if (!m_load_balancing_targets.empty()) {
-        const unsigned hash = qHash(tile_address) % 1024;
-        const auto index = unsigned((float(hash) / 1024.1f) * float(m_load_balancing_targets.size()));
-        Q_ASSERT(index < m_load_balancing_targets.size());
-        return m_base_url.arg(m_load_balancing_targets[index]) + tile_address + m_file_ending;
-    }
-    return m_base_url + tile_address + m_file_ending;
+    Q_UNREACHABLE();
+}
+
+QString TileLoadService::load_balanced(const QString& url, const QString& address) const
+{
+    if (m_load_balancing_targets.empty())
+        return url;
+    const unsigned hash = qHash(address) % 1024;
+    const auto index = unsigned((float(hash) / 1024.1f) * float(m_load_balancing_targets.size()));
+    Q_ASSERT(index < m_load_balancing_targets.size());
+    return url.arg(m_load_balancing_targets[index]);
+}
+
+QString TileLoadService::build_tile_url(tile::Id tile_id) const
+{
+    const auto address = tile_address(tile_id);
+    return load_balanced(m_base_url, address) + address + m_file_ending;
 }
 
 unsigned int TileLoadService::transfer_timeout() const
@@ -113,3 +239,7 @@ void TileLoadService::set_transfer_timeout(unsigned int new_transfer_timeout)
 }
 
 void TileLoadService::set_base_url(const QString& base_url) { m_base_url = base_url; }
+
+const QString& TileLoadService::batch_url() const { return m_batch_url; }
+
+void TileLoadService::set_batch_url(const QString& batch_url) { m_batch_url = batch_url; }
@@ -19,11 +19,15 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <QObject>
 #include "constants.h"
 #include "types.h"
 
 class QNetworkAccessManager;
+class QNetworkReply;
+class QNetworkRequest;
 
 namespace nucleus::tile {
 
@@ -47,18 +51,42 @@ public:
 
     void set_base_url(const QString& base_url);
 
+    // Url of a multi tile endpoint (e.g., "https://example.org/batch"), that is requested with ?tiles=<address>,<address>,..
+    // and answers with a container (see batch.h). Empty (default) means batching is disabled and load_batch falls back to load.
+    // Like the base url, it may contain %1 for the load balancing target. Addresses are the ones of single loads, including the file ending.
+    [[nodiscard]] const QString& batch_url() const;
+    void set_batch_url(const QString& batch_url);
+
 public slots:
     void load(const tile::Id& tile_id) const;
+    // Loads all tiles with a single request to the batch endpoint. load_finished is emitted once per tile, in order.
+    // If the batch request fails as a whole, all tiles are reported with a network error.
+    // This is a slot that is invoked across threads, therefore the ids are passed by vector (not span).
+    void load_batch(const std::vector<tile::Id>& tile_ids) const;
+    // Aborts the requests of tiles that are not needed anymore. load_finished is not emitted for them.
+    // Other tiles in the same batch request are reported with a network error.
+    void cancel(const std::vector<tile::Id>& tile_ids) const;
 
 signals:
     void load_finished(Data tile) const;
+    // one report per finished network request (a batch is one request), not for cancelled ones. emitted before load_finished.
+    void request_finished(const LoadReport& report) const;
 
 private:
+    [[nodiscard]] QString tile_address(tile::Id tile_id) const;
+    // fills in the load balancing target (if any) for the tile at address
+    [[nodiscard]] QString load_balanced(const QString& url, const QString& address) const;
+    [[nodiscard]] QNetworkRequest make_request(const QUrl& url, unsigned zoom_level) const;
+    // returns false if the tile was cancelled (and shouldn't be reported)
+    bool take_in_flight(const tile::Id& tile_id, const QNetworkReply* reply) const;
+
     unsigned m_transfer_timeout = tile::constants::default_network_timeout;
     std::shared_ptr<QNetworkAccessManager> m_network_manager;
     QString m_base_url;
+    QString m_batch_url;
     UrlPattern m_url_pattern;
     QString m_file_ending;
     LoadBalancingTargets m_load_balancing_targets;
+    mutable std::unordered_map<tile::Id, QNetworkReply*, tile::Id::Hasher> m_in_flight;
 };
 }
@@ -0,0 +1,80 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "batch.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace nucleus::tile::batch {
+
+namespace {
+    void append_uint32(QByteArray* bytes, uint32_t value)
+    {
+        const auto little_endian = qToLittleEndian(value);
+        bytes->append(reinterpret_cast<const char*>(&little_endian), sizeof(little_endian));
+    }
+    uint32_t read_uint32(const nucleus::utils::ByteBuffer& bytes, size_t position) { return qFromLittleEndian<uint32_t>(bytes.data() + position); }
+} // namespace
+
+QByteArray encode(const std::vector<Entry>& entries)
+{
+    size_t data_size = 0;
+    for (const auto& entry : entries)
+        data_size += entry.data.size();
+
+    QByteArray container;
+    container.reserve(qsizetype(sizeof(magic) + 8 + entries.size() * 8 + data_size));
+    container.append(magic, sizeof(magic));
+    append_uint32(&container, version);
+    append_uint32(&container, uint32_t(entries.size()));
+    for (const auto& entry : entries) {
+        append_uint32(&container, entry.http_status);
+        append_uint32(&container, uint32_t(entry.data.size()));
+    }
+    for (const auto& entry : entries)
+        container.append(entry.data.view());
+    return container;
+}
+
+std::expected<std::vector<Entry>, QString> decode(const nucleus::utils::ByteBuffer& container)
+{
+    constexpr size_t header_size = sizeof(magic) + 8;
+    if (container.size() < header_size || std::memcmp(container.data(), magic, sizeof(magic)) != 0)
+        return std::unexpected(QString("not a tile batch container"));
+    if (read_uint32(container, 4) != version)
+        return std::unexpected(QString("unsupported tile batch container version %1").arg(read_uint32(container, 4)));
+
+    const auto count = size_t(read_uint32(container, 8));
+    if (container.size() < header_size + count * 8)
+        return std::unexpected(QString("tile batch container index is truncated"));
+
+    std::vector<Entry> entries;
+    entries.reserve(count);
+    size_t data_position = header_size + count * 8;
+    for (size_t i = 0; i < count; ++i) {
+        const auto status = read_uint32(container, header_size + i * 8);
+        const auto size = size_t(read_uint32(container, header_size + i * 8 + 4));
+        if (data_position + size > container.size())
+            return std::unexpected(QString("tile batch container data is truncated"));
+        entries.push_back({ status, container.sliced(data_position, size) });
+        data_position += size;
+    }
+    return entries;
+}
+
+} // namespace nucleus::tile::batch
@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <expected>
+#include <nucleus/utils/ByteBuffer.h>
+#include <vector>
+
+// Multi tile container, as returned by a batch endpoint (see TileLoadService::set_batch_url).
+// The endpoint is requested with ?tiles=<address>,<address>,.. where address is z/x/y (or z/y/x) in the url pattern of the service.
+// The response contains the tiles in the same order, with an index header in front (all integers are little endian uint32):
+//   "ATBC", version (1), tile count, count x (http status, byte size), tile data concatenated
+namespace nucleus::tile::batch {
+
+constexpr char magic[4] = { 'A', 'T', 'B', 'C' };
+constexpr uint32_t version = 1;
+
+struct Entry {
+    uint32_t http_status = 200; // 200 for tiles that are available, 404 for tiles that are not
+    nucleus::utils::ByteBuffer data;
+};
+
+QByteArray encode(const std::vector<Entry>& entries);
+// the data of the entries are slices of the container (no copy)
+std::expected<std::vector<Entry>, QString> decode(const nucleus::utils::ByteBuffer& container);
+
+} // namespace nucleus::tile::batch
@@ -42,15 +42,14 @@ inline std::expected<float, QString> query_altitude(MemoryCache* cache, const gl
         }
         return false;
     });
-    if (!selected_tile.data)
+    if (selected_tile.data.empty())
         return std::unexpected(QString("Couldn't find altitude for %1/%2").arg(lat_long.x).arg(lat_long.y));
-    Q_ASSERT(selected_tile.data->size());
 
     const auto bounds = srs::tile_bounds(selected_tile.id);
     const auto uv = (world_space - bounds.min) / bounds.size();
 
-    if (selected_tile.data && selected_tile.data->size()) {
-        if (const auto height_tile_expected = nucleus::utils::image_loader::rgba8(*selected_tile.data)) {
+    if (!selected_tile.data.empty()) {
+        if (const auto height_tile_expected = nucleus::utils::image_loader::rgba8(selected_tile.data.view())) {
             const auto& height_tile = height_tile_expected.value();
             const auto p = glm::uvec2(uint32_t(uv.x * height_tile.width()), uint32_t((1 - uv.y) * height_tile.height()));
             const auto px = height_tile.pixel(p);
@@ -17,6 +17,9 @@
  *****************************************************************************/
 
 #include "drawing.h"
+#include <cmath>
+#include <limits>
+#include <nucleus/srs.h>
 #include <radix/quad_tree.h>
 #include <unordered_set>
 
@@ -94,6 +97,64 @@ std::vector<TileBounds> cull(std::vector<TileBounds> tiles, const camera::Defini
     return culled_tiles;
 }
 
+double screen_coverage(const TileBounds& tile, const camera::Frustum& frustum, const glm::dvec3& camera_position)
+{
+    const auto size = tile.bounds.size();
+    const auto nearest = glm::clamp(camera_position, tile.bounds.min, tile.bounds.max);
+    const auto distance_sq = std::max(glm::dot(nearest - camera_position, nearest - camera_position), 1.0);
+    const auto coverage = size.x * size.y / distance_sq;
+    if (!tile::utils::camera_frustum_contains_tile(frustum, tile.bounds))
+        return coverage * 0.01;
+    return coverage;
+}
+
+MeshErrors mesh_errors(const radix::Raster<uint16_t>& heights)
+{
+    const auto height_at = [&](unsigned row, unsigned col) { return float(heights.pixel({ col, row })); };
+    const auto n_quads = unsigned(heights.width()) - 1;
+    MeshErrors errors;
+    for (size_t i = 0; i < mesh_strides.size(); ++i) {
+        const auto stride = mesh_strides[i];
+        if (heights.width() != heights.height() || n_quads == 0 || n_quads % stride != 0) {
+            errors[i] = std::numeric_limits<float>::infinity();
+            continue;
+        }
+        // quads are split along the diagonal from bottom left to top right (see terrain_mesh_index_generator)
+        float max_error = 0;
+        for (unsigned row = 0; row <= n_quads; ++row) {
+            for (unsigned col = 0; col <= n_quads; ++col) {
+                const auto row0 = std::min(row / stride * stride, n_quads - stride);
+                const auto col0 = std::min(col / stride * stride, n_quads - stride);
+                const auto v = float(row - row0) / float(stride);
+                const auto u = float(col - col0) / float(stride);
+                const auto h00 = height_at(row0, col0);
+                const auto h01 = height_at(row0, col0 + stride);
+                const auto h10 = height_at(row0 + stride, col0);
+                const auto h11 = height_at(row0 + stride, col0 + stride);
+                const auto interpolated = (u + v <= 1) ? h00 + u * (h01 - h00) + v * (h10 - h00) : h11 + (1 - u) * (h10 - h11) + (1 - v) * (h01 - h11);
+                max_error = std::max(max_error, std::abs(interpolated - height_at(row, col)));
+            }
+        }
+        errors[i] = max_error * 0.125f; // height raster unit -> metres
+    }
+    return errors;
+}
+
+unsigned mesh_variant(const TileBounds& tile, const MeshErrors& errors, const camera::Definition& camera)
+{
+    const auto distance = float(radix::geometry::distance(tile.bounds, camera.position()));
+    // altitudes are scaled like the horizontal coordinates in web mercator
+    const auto latitude = srs::world_to_lat_long(glm::dvec2(tile.bounds.min + tile.bounds.max) * 0.5).x;
+    const auto mercator_scale = float(1.0 / std::cos(glm::radians(latitude)));
+    unsigned variant = 0;
+    for (unsigned i = 1; i < errors.size(); ++i) {
+        if (camera.to_screen_space(errors[i] * mercator_scale, distance) > camera.pixel_error_threshold())
+            break;
+        variant = i;
+    }
+    return variant;
+}
+
 std::vector<TileBounds> sort(std::vector<TileBounds> list, const glm::dvec3& camera_position)
 {
     std::sort(list.begin(), list.end(), [&](const TileBounds& a, const TileBounds& b) {
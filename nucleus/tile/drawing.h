@@ -20,6 +20,7 @@
 
 #include "types.h"
 #include "utils.h"
+#include <array>
 #include <nucleus/camera/Definition.h>
 
 namespace nucleus::tile::drawing {
@@ -29,4 +30,16 @@ std::vector<TileBounds> compute_bounds(const std::vector<tile::Id>& tiles, utils
 std::vector<tile::Id> limit(std::vector<tile::Id> tiles, uint max_n_tiles);
 std::vector<TileBounds> cull(std::vector<TileBounds> list, const camera::Definition& camera);
 std::vector<TileBounds> sort(std::vector<TileBounds> list, const glm::dvec3& camera_position);
+/// rough estimate of the screen area a tile covers (its horizontal area over the squared distance), for prioritising work.
+/// tiles outside of the frustum get a small fraction of that, so they are still processed, but after the visible ones.
+double screen_coverage(const TileBounds& tile, const camera::Frustum& frustum, const glm::dvec3& camera_position);
+
+/// strides of the terrain mesh variants, finest first (65, 33, 17 and 9 vertices per edge for 65x65 height tiles).
+constexpr std::array<unsigned, 4> mesh_strides = { 1, 2, 4, 8 };
+using MeshErrors = std::array<float, mesh_strides.size()>;
+/// largest vertical distance (altitude in metres) between the full resolution heights and each mesh variant, i.e., how rough the tile is.
+/// infinite for strides that don't fit the raster. computed once per tile, on upload.
+MeshErrors mesh_errors(const radix::Raster<uint16_t>& heights);
+/// coarsest mesh variant whose error, projected to the screen, stays below the pixel error threshold of the camera.
+unsigned mesh_variant(const TileBounds& tile, const MeshErrors& errors, const camera::Definition& camera);
 }
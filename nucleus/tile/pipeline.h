@@ -0,0 +1,128 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include "ConcurrencyController.h"
+#include "QuadAssembler.h"
+#include "RateLimiter.h"
+#include "Scheduler.h"
+#include "SlotBudget.h"
+#include "SlotLimiter.h"
+#include "TileLoadService.h"
+#include <QCoreApplication>
+#include <QNetworkInformation>
+#include <QPointer>
+#include <QThread>
+#include <memory>
+
+namespace nucleus::tile::setup {
+
+struct PipelineOptions {
+    // shared by the layers of an app. without a budget, the layer has its own slot limit and concurrency controller.
+    std::shared_ptr<SlotBudget> budget;
+    // share of the budget, relative to the other layers (e.g., geometry 4 and ortho 1: geometry gets 4 of 5 slots while both are waiting)
+    float weight = 1.0f;
+    // bounds of the layer's controller. with a budget, only the rate bounds apply (the slot bounds are the budget's).
+    // can be changed later with Scheduler::set_network_settings.
+    ConcurrencyController::Settings network_settings;
+};
+
+// Wires the tile loading chain of one layer:
+// Scheduler → SlotLimiter → RateLimiter → QuadAssembler → TileLoadService, cancellations along the same way, and the loaded quads back.
+// Limiters, assembler and controller are children of the scheduler. Scheduler and service are moved to thread, which is meant to be
+// shared by all layers (on webassembly the service stays on the main thread due to QTBUG-109396). The budget must live on that
+// thread as well, it is moved there with the first layer. Joining the budget is queued to that thread, i.e., it happens once the
+// thread's event loop runs.
+inline void build_pipeline(Scheduler* sch, TileLoadService* tile_service, QThread* thread, const PipelineOptions& options = {})
+{
+    auto* sl = new SlotLimiter(sch);
+    auto* rl = new RateLimiter(sch);
+    auto* qa = new QuadAssembler(sch);
+
+    QObject::connect(sch, &Scheduler::quads_requested, sl, &SlotLimiter::request_quads);
+    QObject::connect(sl, &SlotLimiter::quad_requested, rl, &RateLimiter::request_quad);
+    QObject::connect(rl, &RateLimiter::quad_requested, qa, &QuadAssembler::load);
+    QObject::connect(qa, &QuadAssembler::tile_requested, tile_service, &TileLoadService::load);
+    QObject::connect(qa, &QuadAssembler::tiles_requested, tile_service, &TileLoadService::load_batch);
+    // the service decides per request, whether the batch url is set (it falls back to single loads otherwise)
+    qa->set_batch_requests(true);
+    QObject::connect(tile_service, &TileLoadService::load_finished, qa, &QuadAssembler::deliver_tile);
+    QObject::connect(sl, &SlotLimiter::quads_cancelled, rl, &RateLimiter::cancel_quads);
+    QObject::connect(rl, &RateLimiter::quads_cancelled, qa, &QuadAssembler::cancel_quads);
+    QObject::connect(qa, &QuadAssembler::tiles_cancelled, tile_service, &TileLoadService::cancel);
+
+    // the request rate and latencies are per layer (i.e., per server), so every layer has its own controller. with a shared budget,
+    // only the slot limit is adapted by the budget's controller, which gets the reports of all layers.
+    sch->set_network_settings(options.network_settings);
+    auto* cc = new ConcurrencyController(options.network_settings, sch);
+    QObject::connect(sch, &Scheduler::network_settings_changed, cc, &ConcurrencyController::set_settings);
+    QObject::connect(tile_service, &TileLoadService::request_finished, cc, &ConcurrencyController::report);
+    QObject::connect(cc, &ConcurrencyController::rate_limit_changed, rl, &RateLimiter::set_limit);
+    // the scheduler sees the slot limit in force, with a budget that is this layer's share of it (used for prefetching and stats)
+    const auto update_network_statistics = [sch, sl](ConcurrencyController::State state) {
+        if (const auto* budget = sl->budget())
+            state.slot_limit = budget->share_of(sl);
+        sch->update_network_statistics(state);
+    };
+    QObject::connect(cc, &ConcurrencyController::state_changed, sch, update_network_statistics);
+    if (options.budget) {
+        QObject::connect(tile_service, &TileLoadService::request_finished, options.budget->controller(), &ConcurrencyController::report);
+        QObject::connect(options.budget->controller(), &ConcurrencyController::slot_limit_changed, sch, [cc, update_network_statistics]() {
+            update_network_statistics(cc->state());
+        });
+    } else {
+        QObject::connect(cc, &ConcurrencyController::slot_limit_changed, sl, &SlotLimiter::set_limit);
+    }
+
+    QObject::connect(qa, &QuadAssembler::quad_loaded, sl, &SlotLimiter::deliver_quad);
+    QObject::connect(sl, &SlotLimiter::quad_delivered, sch, &Scheduler::receive_quad);
+
+    if (QNetworkInformation::loadDefaultBackend() && QNetworkInformation::instance()) {
+        QNetworkInformation* n = QNetworkInformation::instance();
+        sch->set_network_reachability(n->reachability());
+        QObject::connect(n, &QNetworkInformation::reachabilityChanged, sch, &Scheduler::set_network_reachability);
+    }
+
+    Q_UNUSED(thread);
+#ifdef ALP_ENABLE_THREADING
+#ifdef __EMSCRIPTEN__ // make request from main thread on webassembly due to QTBUG-109396
+    tile_service->moveToThread(QCoreApplication::instance()->thread());
+#else
+    if (thread)
+        tile_service->moveToThread(thread);
+#endif
+    if (thread)
+        sch->moveToThread(thread);
+    if (thread && options.budget && options.budget->thread() != thread)
+        options.budget->moveToThread(thread);
+#endif
+
+    // the budget is not thread safe, so the layer joins it on the budget's thread (where the limiter lives now as well).
+    // registering may hand out slots already, so it comes last.
+    if (options.budget) {
+        QMetaObject::invokeMethod(options.budget.get(), [sl = QPointer<SlotLimiter>(sl), cc, budget = options.budget, weight = options.weight, update_network_statistics]() {
+            if (!sl)
+                return;
+            sl->set_budget(budget, weight);
+            update_network_statistics(cc->state());
+        });
+    }
+}
+
+} // namespace nucleus::tile::setup
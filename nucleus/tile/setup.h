@@ -20,14 +20,11 @@
 #pragma once
 
 #include "GeometryScheduler.h"
-#include "QuadAssembler.h"
-#include "RateLimiter.h"
-#include "SlotLimiter.h"
 #include "Texture3DScheduler.h"
 #include "TextureScheduler.h"
 #include "TileLoadService.h"
+#include "pipeline.h"
 #include "utils.h"
-#include <QCoreApplication>
 #include <QThread>
 #include <QtAssert>
 #include <memory>
@@ -42,7 +39,8 @@ struct GeometrySchedulerHolder {
     TileLoadServicePtr tile_service;
 };
 
-inline GeometrySchedulerHolder geometry_scheduler(TileLoadServicePtr tile_service, const tile::utils::AabbDecoratorPtr& aabb_decorator, QThread* thread = nullptr)
+inline GeometrySchedulerHolder geometry_scheduler(
+    TileLoadServicePtr tile_service, const tile::utils::AabbDecoratorPtr& aabb_decorator, QThread* thread = nullptr, const PipelineOptions& options = {})
 {
     Scheduler::Settings settings;
     settings.max_zoom_level = 18;
@@ -51,42 +49,12 @@ inline GeometrySchedulerHolder geometry_scheduler(TileLoadServicePtr tile_servic
     auto scheduler = std::make_unique<GeometryScheduler>(settings, 65);
     scheduler->set_aabb_decorator(aabb_decorator);
 
-    {
-        using nucleus::tile::QuadAssembler;
-        using nucleus::tile::RateLimiter;
-        using nucleus::tile::SlotLimiter;
-        using nucleus::tile::TileLoadService;
-        auto* sch = scheduler.get();
-        auto* sl = new SlotLimiter(sch);
-        auto* rl = new RateLimiter(sch);
-        auto* qa = new QuadAssembler(sch);
-
-        QObject::connect(sch, &Scheduler::quads_requested, sl, &SlotLimiter::request_quads);
-        QObject::connect(sl, &SlotLimiter::quad_requested, rl, &RateLimiter::request_quad);
-        QObject::connect(rl, &RateLimiter::quad_requested, qa, &QuadAssembler::load);
-        QObject::connect(qa, &QuadAssembler::tile_requested, tile_service.get(), &TileLoadService::load);
-        QObject::connect(tile_service.get(), &TileLoadService::load_finished, qa, &QuadAssembler::deliver_tile);
-
-        QObject::connect(qa, &QuadAssembler::quad_loaded, sl, &SlotLimiter::deliver_quad);
-        QObject::connect(sl, &SlotLimiter::quad_delivered, sch, &TextureScheduler::receive_quad);
-    }
-    if (QNetworkInformation::loadDefaultBackend() && QNetworkInformation::instance()) {
-        QNetworkInformation* n = QNetworkInformation::instance();
-        scheduler->set_network_reachability(n->reachability());
-        QObject::connect(n, &QNetworkInformation::reachabilityChanged, scheduler.get(), &Scheduler::set_network_reachability);
-    }
-
-    Q_UNUSED(thread);
-#ifdef ALP_ENABLE_THREADING
-    if (thread)
-        tile_service->moveToThread(thread);
-    if (thread)
-        scheduler->moveToThread(thread);
-#endif
-
+    build_pipeline(scheduler.get(), tile_service.get(), thread, options);
     return { std::move(scheduler), std::move(tile_service) };
 }
 
+inline Scheduler::Settings texture_scheduler_settings() { return { .tile_resolution = 256, .max_zoom_level = 20, .gpu_quad_limit = 1024 }; }
+
 struct TextureSchedulerHolder {
     std::shared_ptr<TextureScheduler> scheduler;
     TileLoadServicePtr tile_service;
@@ -97,94 +65,29 @@ struct Texture3DSchedulerHolder {
     TileLoadServicePtr tile_service;
 };
 
-inline TextureSchedulerHolder texture_scheduler(TileLoadServicePtr tile_service, const tile::utils::AabbDecoratorPtr& aabb_decorator, QThread* thread = nullptr, Scheduler::Settings settings = {.tile_resolution = 256, .max_zoom_level = 20, .gpu_quad_limit = 1024 })
+inline TextureSchedulerHolder texture_scheduler(TileLoadServicePtr tile_service,
+    const tile::utils::AabbDecoratorPtr& aabb_decorator,
+    QThread* thread = nullptr,
+    Scheduler::Settings settings = texture_scheduler_settings(),
+    const PipelineOptions& options = {})
 {
     auto scheduler = std::make_unique<TextureScheduler>(settings);
     scheduler->set_aabb_decorator(aabb_decorator);
 
-    {
-        using nucleus::tile::QuadAssembler;
-        using nucleus::tile::RateLimiter;
-        using nucleus::tile::SlotLimiter;
-        using nucleus::tile::TileLoadService;
-        auto* sch = scheduler.get();
-        auto* sl = new SlotLimiter(sch);
-        auto* rl = new RateLimiter(sch);
-        auto* qa = new QuadAssembler(sch);
-
-        QObject::connect(sch, &Scheduler::quads_requested, sl, &SlotLimiter::request_quads);
-        QObject::connect(sl, &SlotLimiter::quad_requested, rl, &RateLimiter::request_quad);
-        QObject::connect(rl, &RateLimiter::quad_requested, qa, &QuadAssembler::load);
-        QObject::connect(qa, &QuadAssembler::tile_requested, tile_service.get(), &TileLoadService::load);
-        QObject::connect(tile_service.get(), &TileLoadService::load_finished, qa, &QuadAssembler::deliver_tile);
-
-        QObject::connect(qa, &QuadAssembler::quad_loaded, sl, &SlotLimiter::deliver_quad);
-        QObject::connect(sl, &SlotLimiter::quad_delivered, sch, &TextureScheduler::receive_quad);
-    }
-    if (QNetworkInformation::loadDefaultBackend() && QNetworkInformation::instance()) {
-        QNetworkInformation* n = QNetworkInformation::instance();
-        scheduler->set_network_reachability(n->reachability());
-        QObject::connect(n, &QNetworkInformation::reachabilityChanged, scheduler.get(), &Scheduler::set_network_reachability);
-    }
-
-    Q_UNUSED(thread);
-#ifdef ALP_ENABLE_THREADING
-#ifdef __EMSCRIPTEN__ // make request from main thread on webassembly due to QTBUG-109396
-    tile_service->moveToThread(QCoreApplication::instance()->thread());
-#else
-    if (thread)
-        tile_service->moveToThread(thread);
-#endif
-    if (thread)
-        scheduler->moveToThread(thread);
-#endif
-
+    build_pipeline(scheduler.get(), tile_service.get(), thread, options);
     return { std::move(scheduler), std::move(tile_service) };
 }
 
-
-inline Texture3DSchedulerHolder texture_scheduler_3d(TileLoadServicePtr tile_service, const tile::utils::AabbDecoratorPtr& aabb_decorator, QThread* thread = nullptr, Scheduler::Settings settings = {.tile_resolution = 256, .max_zoom_level = 20, .gpu_quad_limit = 1024 })
+inline Texture3DSchedulerHolder texture_scheduler_3d(TileLoadServicePtr tile_service,
+    const tile::utils::AabbDecoratorPtr& aabb_decorator,
+    QThread* thread = nullptr,
+    Scheduler::Settings settings = texture_scheduler_settings(),
+    const PipelineOptions& options = {})
 {
     auto scheduler = std::make_unique<Texture3DScheduler>(settings);
     scheduler->set_aabb_decorator(aabb_decorator);
 
-    {
-        using nucleus::tile::QuadAssembler;
-        using nucleus::tile::RateLimiter;
-        using nucleus::tile::SlotLimiter;
-        using nucleus::tile::TileLoadService;
-        auto* sch = scheduler.get();
-        auto* sl = new SlotLimiter(sch);
-        auto* rl = new RateLimiter(sch);
-        auto* qa = new QuadAssembler(sch);
-
-        QObject::connect(sch, &Scheduler::quads_requested, sl, &SlotLimiter::request_quads);
-        QObject::connect(sl, &SlotLimiter::quad_requested, rl, &RateLimiter::request_quad);
-        QObject::connect(rl, &RateLimiter::quad_requested, qa, &QuadAssembler::load);
-        QObject::connect(qa, &QuadAssembler::tile_requested, tile_service.get(), &TileLoadService::load);
-        QObject::connect(tile_service.get(), &TileLoadService::load_finished, qa, &QuadAssembler::deliver_tile);
-
-        QObject::connect(qa, &QuadAssembler::quad_loaded, sl, &SlotLimiter::deliver_quad);
-        QObject::connect(sl, &SlotLimiter::quad_delivered, sch, &TextureScheduler::receive_quad);
-    }
-    if (QNetworkInformation::loadDefaultBackend() && QNetworkInformation::instance()) {
-        QNetworkInformation* n = QNetworkInformation::instance();
-        scheduler->set_network_reachability(n->reachability());
-        QObject::connect(n, &QNetworkInformation::reachabilityChanged, scheduler.get(), &Scheduler::set_network_reachability);
-    }
-
-    Q_UNUSED(thread);
-#ifdef ALP_ENABLE_THREADING
-#ifdef __EMSCRIPTEN__ // make request from main thread on webassembly due to QTBUG-109396
-    tile_service->moveToThread(QCoreApplication::instance()->thread());
-#else
-    if (thread)
-        tile_service->moveToThread(thread);
-#endif
-    if (thread)
-        scheduler->moveToThread(thread);
-#endif
-
+    build_pipeline(scheduler.get(), tile_service.get(), thread, options);
     return { std::move(scheduler), std::move(tile_service) };
 }
 
@@ -18,8 +18,7 @@
 
 #pragma once
 
-#include <QByteArray>
-
+#include <nucleus/utils/ByteBuffer.h>
 #include <nucleus/utils/ColourTexture.h>
 #include <nucleus/utils/ColourTexture3D.h>
 #include <nucleus/utils/lang.h>
@@ -51,6 +50,15 @@ struct NetworkInfo {
     }
 };
 
+// Measurement of one network request (of one or several tiles), reported by TileLoadService for adaptive concurrency control
+struct LoadReport {
+    uint64_t started_at = 0; // msecs since epoch
+    uint64_t finished_at = 0; // msecs since epoch
+    uint64_t n_bytes = 0;
+    unsigned n_tiles = 1;
+    bool failed = false; // network error or timeout. not found is a valid answer.
+};
+
 template <typename T>
 concept NamedTile = requires(T t) {
     { t.id } -> nucleus::utils::convertible_to<tile::Id>;
@@ -63,7 +71,7 @@ concept SerialisableTile
 struct Data {
     tile::Id id;
     NetworkInfo network_info;
-    std::shared_ptr<QByteArray> data;
+    nucleus::utils::ByteBuffer data;
 };
 static_assert(NamedTile<Data>);
 
@@ -72,7 +80,7 @@ struct DataQuad {
     unsigned n_tiles = 0;
     std::array<Data, 4> tiles = {};
     NetworkInfo network_info() const { return NetworkInfo::join(tiles[0].network_info, tiles[1].network_info, tiles[2].network_info, tiles[3].network_info); }
-    static constexpr std::array<char, 25> version_information = { "DataQuad, version 0.1" };
+    static constexpr std::array<char, 25> version_information = { "DataQuad, version 0.2" };
 };
 static_assert(NamedTile<DataQuad>);
 static_assert(SerialisableTile<DataQuad>);
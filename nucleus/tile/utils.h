@@ -248,5 +248,18 @@ namespace utils {
         };
         return refine;
     }
+
+    // Screen space error of a tile in pixels (size of a tile pixel projected to the screen), the measure used by refineFunctor.
+    // It is at least twice as large for the parent of a tile, so sorting by it loads coarse tiles before their children.
+    inline auto screen_space_error_functor(const nucleus::camera::Definition& camera, const AabbDecoratorPtr& aabb_decorator, unsigned tile_size)
+    {
+        constexpr auto sqrt2 = 1.414213562373095;
+        return [&camera, tile_size, aabb_decorator](const tile::Id& tile) {
+            const auto aabb = aabb_decorator->aabb(tile);
+            const auto distance = float(radix::geometry::distance(aabb, camera.position()));
+            const auto pixel_size = float(sqrt2 * aabb.size().x / tile_size);
+            return camera.to_screen_space(pixel_size, distance);
+        };
+    }
 }
 }
@@ -65,9 +65,23 @@ QList<TimerReport> TimerManager::fetch_results()
             new_values.emplace_back(tmr->last_measurement(), tmr->name(), tmr->group(), tmr->queue_size(), tmr->average_weight());
         }
     }
+    if (m_frame_counters_changed) {
+        new_values.emplace_back(float(m_n_frames_rendered), QString("frames_rendered"), QString("FRAMES"));
+        new_values.emplace_back(float(m_n_frames_skipped), QString("frames_skipped"), QString("FRAMES"));
+        m_frame_counters_changed = false;
+    }
     return new_values;
 }
 
+void TimerManager::count_frame(bool rendered)
+{
+    if (rendered)
+        ++m_n_frames_rendered;
+    else
+        ++m_n_frames_skipped;
+    m_frame_counters_changed = true;
+}
+
 std::shared_ptr<TimerInterface> TimerManager::add_timer(std::shared_ptr<TimerInterface> tmr) {
     m_timer[tmr->name()] = tmr;
     m_timer_in_order.push_back(tmr);
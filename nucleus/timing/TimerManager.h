@@ -58,8 +58,14 @@ public:
     void stop_timer(const QString& name);
 
     // Fetches the results of all timers and returns the new values
+    // (plus the frame counters in group "FRAMES", if they changed since the last fetch)
     QList<TimerReport> fetch_results();
 
+    // Counts a frame, that was either rendered or skipped because nothing changed (render on demand)
+    void count_frame(bool rendered);
+    [[nodiscard]] unsigned n_frames_rendered() const { return m_n_frames_rendered; }
+    [[nodiscard]] unsigned n_frames_skipped() const { return m_n_frames_skipped; }
+
     TimerManager();
 
 #ifdef ALP_ENABLE_TRACK_OBJECT_LIFECYCLE
@@ -74,6 +80,10 @@ private:
     // Contains the timer as map for fast access by name
     std::map<QString, std::shared_ptr<TimerInterface>> m_timer;
 
+    unsigned m_n_frames_rendered = 0;
+    unsigned m_n_frames_skipped = 0;
+    bool m_frame_counters_changed = false;
+
 #ifdef QT_DEBUG
     // Contains the timer name if a warning for this timer was already published
     std::set<QString> m_timer_already_warned_about;
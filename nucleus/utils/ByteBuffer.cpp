@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "ByteBuffer.h"
+
+#include <QtAssert>
+#include <functional>
+
+using namespace nucleus::utils;
+
+ByteBuffer::ByteBuffer(QByteArray bytes)
+    : m_owner(std::make_shared<const QByteArray>(std::move(bytes)))
+    , m_data(m_owner->constData())
+    , m_size(size_t(m_owner->size()))
+{
+}
+
+ByteBuffer ByteBuffer::copy_of(QByteArrayView bytes)
+{
+    ByteBuffer buffer(bytes.toByteArray());
+    buffer.m_copied = true;
+    return buffer;
+}
+
+ByteBuffer ByteBuffer::sliced(size_t position, size_t size) const
+{
+    Q_ASSERT(position <= m_size && size <= m_size - position);
+    ByteBuffer slice = *this;
+    slice.m_data = m_data + position;
+    slice.m_size = size;
+    return slice;
+}
+
+ByteBuffer ByteBuffer::slice_or_copy(const char* data, size_t size) const
+{
+    // std::less gives a total order also for pointers into different objects
+    const auto less = std::less<const char*>();
+    if (m_data && !less(data, m_data) && !less(m_data + m_size, data) && size <= size_t(m_data + m_size - data))
+        return sliced(size_t(data - m_data), size);
+    return copy_of(QByteArrayView(data, qsizetype(size)));
+}
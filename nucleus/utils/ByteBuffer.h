@@ -0,0 +1,63 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <memory>
+#include <string_view>
+
+namespace nucleus::utils {
+
+/// Immutable, reference counted bytes. Copies and slices share the memory, so that a tile goes from the network reply
+/// through the pipeline, the caches and into the parsers without being copied.
+class ByteBuffer {
+public:
+    ByteBuffer() = default;
+    /// Takes over the memory of bytes (moving a QByteArray doesn't copy it).
+    explicit ByteBuffer(QByteArray bytes);
+    /// Deep copy, counted in n_copied_bytes().
+    [[nodiscard]] static ByteBuffer copy_of(QByteArrayView bytes);
+
+    [[nodiscard]] const char* data() const { return m_data; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+    [[nodiscard]] const char* begin() const { return m_data; }
+    [[nodiscard]] const char* end() const { return m_data + m_size; }
+    [[nodiscard]] QByteArrayView view() const { return { m_data, qsizetype(m_size) }; }
+    [[nodiscard]] std::string_view string_view() const { return { m_data, m_size }; }
+
+    /// Shares the memory with this buffer.
+    [[nodiscard]] ByteBuffer sliced(size_t position, size_t size) const;
+    /// Slice of this buffer if [data, data + size) lies inside of it, a copy otherwise.
+    [[nodiscard]] ByteBuffer slice_or_copy(const char* data, size_t size) const;
+
+    /// Number of bytes that were copied to make this buffer (0 for buffers that took over their memory and slices of them).
+    [[nodiscard]] size_t n_copied_bytes() const { return m_copied ? m_size : 0; }
+
+    friend bool operator==(const ByteBuffer& a, const ByteBuffer& b) { return a.view() == b.view(); }
+
+private:
+    std::shared_ptr<const QByteArray> m_owner;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_copied = false;
+};
+
+} // namespace nucleus::utils
@@ -41,14 +41,14 @@
 
 namespace nucleus::utils::image_loader {
 
-std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QByteArray& byteArray)
+std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(QByteArrayView bytes)
 {
     int width, height, channels;
     const int requested_channels = 4; // Request 4 channels to always get RGBA8 images
-    const stbi_uc* source_data = reinterpret_cast<const stbi_uc*>(byteArray.constData());
+    const stbi_uc* source_data = reinterpret_cast<const stbi_uc*>(bytes.data());
     unsigned char* data = stbi_load_from_memory(
         source_data,
-        byteArray.size(),
+        int(bytes.size()),
         &width, &height, &channels,
         requested_channels
         );
@@ -68,6 +68,8 @@ std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QByteArray& byteA
     return raster;
 }
 
+std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QByteArray& byteArray) { return rgba8(QByteArrayView(byteArray)); }
+
 std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QString& filename)
 {
     QFile file(filename);
@@ -20,11 +20,13 @@
 #pragma once
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <expected>
 #include <radix/raster.h>
 
 namespace nucleus::utils::image_loader {
 
+std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(QByteArrayView bytes);
 std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QByteArray& byteArray);
 
 std::expected<radix::Raster<glm::u8vec4>, QString> rgba8(const QString& filename);
@@ -100,4 +100,25 @@ std::vector<glm::vec2> triangulize(std::vector<glm::vec2> polygon_points, std::v
     return processed_triangles;
 }
 
+namespace details {
+
+    void append_ring_edges(std::vector<ScanlineEdge>& edges, std::span<const glm::vec2> ring)
+    {
+        if (ring.size() < 2)
+            return;
+        edges.reserve(edges.size() + ring.size());
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const glm::vec2& a = ring[i];
+            const glm::vec2& b = ring[(i + 1) % ring.size()];
+            if (a.y == b.y)
+                continue;
+            const bool downwards = a.y < b.y;
+            const glm::vec2& top = downwards ? a : b;
+            const glm::vec2& bottom = downwards ? b : a;
+            edges.push_back({ top, bottom.y, (bottom.x - top.x) / (bottom.y - top.y), downwards ? 1 : -1 });
+        }
+    }
+
+} // namespace details
+
 } // namespace nucleus::utils::rasterizer
@@ -18,7 +18,10 @@
 
 #include <QtAssert>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -557,4 +560,118 @@ template <PixelWriterFunctionConcept PixelWriterFunction> void rasterize_polygon
     rasterize_triangle(pixel_writer, triangles, distance);
 }
 
+/*
+ * Fill rules for fill_polygon, they have the same meaning as in svg or QPainter (Qt::OddEvenFill and Qt::WindingFill)
+ */
+enum class FillRule { EvenOdd, NonZero };
+
+namespace details {
+
+    /*
+     * non-horizontal polygon edge, oriented from top to bottom.
+     * winding is +1 if the original edge went downwards, -1 otherwise.
+     */
+    struct ScanlineEdge {
+        glm::vec2 top;
+        float bottom_y;
+        float dx_dy;
+        int winding;
+    };
+
+    /*
+     * appends the edges of a closed ring (the last point is connected to the first one) to edges.
+     * horizontal edges are dropped, they never cross a scanline.
+     */
+    void append_ring_edges(std::vector<ScanlineEdge>& edges, std::span<const glm::vec2> ring);
+
+    /*
+     * scanline fill with pixel centre sampling: a pixel (x, y) is set if (x + 0.5, y + 0.5) is inside.
+     * a sample exactly on an edge counts as inside for left and top edges only, so polygons sharing an edge
+     * never set the same pixel twice and never leave a gap.
+     */
+    template <PixelWriterFunctionConcept PixelWriterFunction>
+    void fill_edges(
+        const PixelWriterFunction& pixel_writer, std::vector<ScanlineEdge> edges, const glm::ivec2& size, FillRule fill_rule, unsigned int data_index)
+    {
+        if (edges.empty() || size.x <= 0 || size.y <= 0)
+            return;
+
+        std::sort(edges.begin(), edges.end(), [](const ScanlineEdge& a, const ScanlineEdge& b) { return a.top.y < b.top.y; });
+        float max_y = edges.front().bottom_y;
+        for (const auto& edge : edges)
+            max_y = std::max(max_y, edge.bottom_y);
+
+        // edge covers sample row y if top.y <= y + 0.5 < bottom_y
+        const int first_row = std::max(0, int(std::ceil(edges.front().top.y - 0.5f)));
+        const int last_row = std::min(size.y - 1, int(std::ceil(max_y - 0.5f)) - 1);
+
+        std::vector<const ScanlineEdge*> active;
+        std::vector<std::pair<float, int>> crossings;
+        size_t next_edge = 0;
+        for (int y = first_row; y <= last_row; ++y) {
+            const float sample_y = float(y) + 0.5f;
+            while (next_edge < edges.size() && edges[next_edge].top.y <= sample_y)
+                active.push_back(&edges[next_edge++]);
+            std::erase_if(active, [&](const ScanlineEdge* edge) { return edge->bottom_y <= sample_y; });
+
+            crossings.clear();
+            for (const auto* edge : active)
+                crossings.emplace_back(edge->top.x + (sample_y - edge->top.y) * edge->dx_dy, edge->winding);
+            std::sort(crossings.begin(), crossings.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+            int winding = 0;
+            for (size_t i = 0; i + 1 < crossings.size(); ++i) {
+                winding += (fill_rule == FillRule::EvenOdd) ? 1 : crossings[i].second;
+                const bool inside = (fill_rule == FillRule::EvenOdd) ? (winding & 1) : (winding != 0);
+                if (!inside)
+                    continue;
+                // pixels with x + 0.5 in [left, right)
+                const int x_begin = std::max(0, int(std::ceil(crossings[i].first - 0.5f)));
+                const int x_end = std::min(size.x, int(std::ceil(crossings[i + 1].first - 0.5f)));
+                for (int x = x_begin; x < x_end; ++x)
+                    invokePixelWriter(pixel_writer, glm::ivec2(x, y), data_index);
+            }
+        }
+    }
+
+} // namespace details
+
+/*
+ * Fill a polygon consisting of one or more closed rings (outlines and holes), without triangulation
+ * pixels are set if their centre is inside according to the fill rule, pixels outside of [0, size) are never written.
+ * use this for large, possibly self-intersecting polygons (e.g. region outlines from vector tiles), where
+ * triangulation would be expensive. data_index is passed through to the pixel writer.
+ *
+ * example usage:
+ *      const std::vector<std::vector<glm::vec2>> rings = { { { 10, 10 }, { 50, 10 }, { 50, 50 }, { 10, 50 } }, { { 20, 20 }, { 40, 20 }, { 40, 40 }, { 20, 40 } } };
+ *      radix::Raster<uint16_t> output({ 64, 64 }, 0u);
+ *      const auto pixel_writer = [&output](glm::ivec2 pos, unsigned int id) { output.pixel(pos) = uint16_t(id); };
+ *      nucleus::utils::rasterizer::fill_polygon(pixel_writer, rings, { 64, 64 }, FillRule::EvenOdd, 42);
+ */
+template <PixelWriterFunctionConcept PixelWriterFunction>
+void fill_polygon(const PixelWriterFunction& pixel_writer,
+    const std::vector<std::vector<glm::vec2>>& rings,
+    const glm::ivec2& size,
+    FillRule fill_rule = FillRule::EvenOdd,
+    unsigned int data_index = 0)
+{
+    std::vector<details::ScanlineEdge> edges;
+    for (const auto& ring : rings)
+        details::append_ring_edges(edges, ring);
+    details::fill_edges(pixel_writer, std::move(edges), size, fill_rule, data_index);
+}
+
+// Overload for a single ring
+template <PixelWriterFunctionConcept PixelWriterFunction>
+void fill_polygon(const PixelWriterFunction& pixel_writer,
+    std::span<const glm::vec2> ring,
+    const glm::ivec2& size,
+    FillRule fill_rule = FillRule::EvenOdd,
+    unsigned int data_index = 0)
+{
+    std::vector<details::ScanlineEdge> edges;
+    details::append_ring_edges(edges, ring);
+    details::fill_edges(pixel_writer, std::move(edges), size, fill_rule, data_index);
+}
+
 } // namespace nucleus::utils::rasterizer
@@ -19,13 +19,20 @@
 #pragma once
 
 #include <QtAssert>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <numeric>
 #include <vector>
 
 // functions in this file generate the indices for our terrain meshes.
 // we use a regular grid. vertex positions are computed in the vertex shader on the fly,
 // but we still need the indices of the triangles.
 // the triangles are drawn as a triangle strip, and we want as few repetitions as possible.
+// alternatively, there are indexed triangle lists in space filling curve order, reordered for the post transform
+// vertex cache, or partitioned into meshlets (see the analysis in unittests/nucleus/terrain_mesh_index_generator.cpp).
 
 // tile meshes consist of the visible surface and additional skirts, which help against holes.
 
@@ -43,63 +50,332 @@ namespace nucleus::utils::terrain_mesh_index_generator {
 // i.e., for the example 0, 4, 1, 5, 2, 6, 3, 7, 7, 4, 4, 8, 5, 9, 6, 10, 7, 11, 11, 8, 8, ..
 // triangles (3, 7, 7), (7, 7, 4), (4, 4, 8), (11, 11, 8) etc are degenerate intentionally.
 // this keeps the strip running, and shouldn't be visible.
+//
+// with stride > 1, only every stride-th row and column is used (coarser mesh, e.g., 33x33 out of 65x65 for stride 2).
+// the indices still refer to the full vertex_side_length grid, so the vertex shader doesn't need to know about the stride.
 template<typename Index>
-std::vector<Index> surface_quads(unsigned vertex_side_length)
+std::vector<Index> surface_quads(unsigned vertex_side_length, unsigned stride = 1)
 {
     Q_ASSERT(vertex_side_length >= 2);
     Q_ASSERT(vertex_side_length * vertex_side_length < std::numeric_limits<Index>::max());
+    Q_ASSERT(stride >= 1 && (vertex_side_length - 1) % stride == 0);
     std::vector<Index> indices;
     const auto height = vertex_side_length;
     const auto width = vertex_side_length;
 
     const auto index_for = [&width](auto row, auto col) { return col + row * width; };
 
-    for (size_t row = 0; row < height - 1; row++) {
-        for (size_t col = 0; col < width; col++) {
+    for (size_t row = 0; row < height - 1; row += stride) {
+        for (size_t col = 0; col < width; col += stride) {
             indices.push_back(Index(index_for(row, col)));
-            indices.push_back(Index(index_for(row + 1, col)));
+            indices.push_back(Index(index_for(row + stride, col)));
         }
-        indices.push_back(Index(index_for(row + 1, width - 1)));
-        indices.push_back(Index(index_for(row + 1, 0)));
+        indices.push_back(Index(index_for(row + stride, width - 1)));
+        indices.push_back(Index(index_for(row + stride, 0)));
     }
     indices.resize(indices.size() - 2);
     return indices;
 }
 
+// curtain vertices are numbered after the surface vertices, one per edge vertex of the full grid (anti-clockwise, starting at the
+// bottom right corner). with stride > 1, the curtains of the coarse mesh use the ones below its edge vertices. they hang down far
+// enough to cover the t-junctions between neighbouring tiles of different stride.
 template<typename Index>
-std::vector<Index> surface_quads_with_curtains(unsigned vertex_side_length)
+std::vector<Index> surface_quads_with_curtains(unsigned vertex_side_length, unsigned stride = 1)
 {
     Q_ASSERT(vertex_side_length >= 2);
     Q_ASSERT(vertex_side_length * vertex_side_length < std::numeric_limits<Index>::max());
-    std::vector<Index> indices = surface_quads<Index>(vertex_side_length);
+    std::vector<Index> indices = surface_quads<Index>(vertex_side_length, stride);
     const auto height = vertex_side_length;
     const auto width = vertex_side_length;
     const auto index_for = [&width](auto row, auto col) { return col + row * width; };
-    auto curtain_index = indices.back() + 1;
-    const auto first_curtain_index = curtain_index;
+    const auto first_curtain_index = Index(width * height);
+    const auto n_edge_quads = size_t(width - 1);
+    const auto curtain_for = [&](size_t edge, size_t i) { return Index(first_curtain_index + edge * n_edge_quads + i); };
 
-    for (size_t row = height - 1; row >= 1; row--) {
+    for (size_t row = height - 1; row >= 1; row -= stride) {
         indices.push_back(Index(index_for(row, width - 1)));
-        indices.push_back(curtain_index++);
+        indices.push_back(curtain_for(0, height - 1 - row));
     }
 
-    for (size_t col = width - 1; col >= 1; col--) {
+    for (size_t col = width - 1; col >= 1; col -= stride) {
         indices.push_back(Index(index_for(0, col)));
-        indices.push_back(curtain_index++);
+        indices.push_back(curtain_for(1, width - 1 - col));
     }
 
-    for (size_t row = 0; row < height - 1; row++) {
+    for (size_t row = 0; row < height - 1; row += stride) {
         indices.push_back(Index(index_for(row, 0)));
-        indices.push_back(curtain_index++);
+        indices.push_back(curtain_for(2, row));
     }
 
-    for (size_t col = 0; col < width - 1; col++) {
+    for (size_t col = 0; col < width - 1; col += stride) {
         indices.push_back(Index(index_for(height - 1, col)));
-        indices.push_back(curtain_index++);
+        indices.push_back(curtain_for(3, col));
     }
-    indices.push_back(index_for(height - 1, width - 1));
+    indices.push_back(Index(index_for(height - 1, width - 1)));
     indices.push_back(first_curtain_index);
 
     return indices;
 }
+
+// converts a strip (as generated above) into a triangle list with the same winding. degenerate triangles are dropped.
+template<typename Index>
+std::vector<Index> strip_to_triangles(const std::vector<Index>& strip)
+{
+    std::vector<Index> triangles;
+    for (size_t i = 2; i < strip.size(); i++) {
+        const auto a = strip[i - 2];
+        const auto b = strip[i - 1];
+        const auto c = strip[i];
+        if (a == b || b == c || a == c)
+            continue;
+        if (i % 2 == 0)
+            triangles.insert(triangles.end(), { a, b, c });
+        else
+            triangles.insert(triangles.end(), { b, a, c });
+    }
+    return triangles;
+}
+
+enum class QuadOrder { RowMajor, Morton, Hilbert };
+
+// triangle list of the surface, same triangles and winding as surface_quads. the quads are visited in the given order,
+// space filling curves keep the recently used vertices close by, which helps the vertex cache and gives compact meshlets.
+template<typename Index>
+std::vector<Index> surface_triangles(unsigned vertex_side_length, QuadOrder order = QuadOrder::RowMajor, unsigned stride = 1)
+{
+    Q_ASSERT(vertex_side_length >= 2);
+    Q_ASSERT(vertex_side_length * vertex_side_length < std::numeric_limits<Index>::max());
+    Q_ASSERT(stride >= 1 && (vertex_side_length - 1) % stride == 0);
+    const auto width = vertex_side_length;
+    const auto n_quads = (vertex_side_length - 1) / stride;
+    const auto index_for = [&](unsigned row, unsigned col) { return Index(col * stride + row * stride * width); };
+
+    std::vector<Index> indices;
+    indices.reserve(size_t(n_quads) * n_quads * 6);
+    const auto add_quad = [&](unsigned row, unsigned col) {
+        if (row >= n_quads || col >= n_quads)
+            return;
+        const auto top_left = index_for(row, col);
+        const auto bottom_left = index_for(row + 1, col);
+        const auto top_right = index_for(row, col + 1);
+        const auto bottom_right = index_for(row + 1, col + 1);
+        indices.insert(indices.end(), { top_left, bottom_left, top_right, top_right, bottom_left, bottom_right });
+    };
+
+    // curves are defined on a power of two sized square, quads outside of the grid are skipped
+    const auto side = std::bit_ceil(n_quads);
+    switch (order) {
+    case QuadOrder::RowMajor:
+        for (unsigned row = 0; row < n_quads; row++) {
+            for (unsigned col = 0; col < n_quads; col++)
+                add_quad(row, col);
+        }
+        break;
+    case QuadOrder::Morton: {
+        const auto compact_bits = [](uint32_t v) {
+            v &= 0x55555555;
+            v = (v | (v >> 1)) & 0x33333333;
+            v = (v | (v >> 2)) & 0x0f0f0f0f;
+            v = (v | (v >> 4)) & 0x00ff00ff;
+            v = (v | (v >> 8)) & 0x0000ffff;
+            return v;
+        };
+        for (uint32_t d = 0; d < side * side; d++)
+            add_quad(compact_bits(d >> 1), compact_bits(d));
+        break;
+    }
+    case QuadOrder::Hilbert:
+        for (unsigned d = 0; d < side * side; d++) {
+            unsigned row = 0;
+            unsigned col = 0;
+            for (unsigned s = 1, t = d; s < side; s *= 2, t /= 4) {
+                const auto rx = 1 & (t / 2);
+                const auto ry = 1 & (t ^ rx);
+                if (ry == 0) {
+                    if (rx == 1) {
+                        col = s - 1 - col;
+                        row = s - 1 - row;
+                    }
+                    std::swap(col, row);
+                }
+                col += s * rx;
+                row += s * ry;
+            }
+            add_quad(row, col);
+        }
+        break;
+    }
+    return indices;
+}
+
+// surface_triangles followed by the curtain triangles (same as in surface_quads_with_curtains).
+template<typename Index>
+std::vector<Index> surface_triangles_with_curtains(unsigned vertex_side_length, QuadOrder order = QuadOrder::RowMajor, unsigned stride = 1)
+{
+    auto indices = surface_triangles<Index>(vertex_side_length, order, stride);
+    const auto n_surface_indices = indices.size();
+    const auto strip = strip_to_triangles(surface_quads_with_curtains<Index>(vertex_side_length, stride));
+    Q_ASSERT(strip.size() >= n_surface_indices);
+    indices.insert(indices.end(), strip.begin() + std::ptrdiff_t(n_surface_indices), strip.end());
+    return indices;
+}
+
+// reorders the triangles of a list for the post transform vertex cache, after Tom Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006).
+// greedily takes the triangle whose vertices score best, where the score favours vertices in a simulated lru cache and vertices with
+// few triangles left (so that no lonely triangles remain). the winding is kept.
+template<typename Index>
+std::vector<Index> optimise_vertex_cache(const std::vector<Index>& triangles, unsigned cache_size = 32)
+{
+    Q_ASSERT(triangles.size() % 3 == 0);
+    Q_ASSERT(cache_size > 3);
+    const auto n_triangles = triangles.size() / 3;
+    size_t n_vertices = 0;
+    for (const auto index : triangles)
+        n_vertices = std::max(n_vertices, size_t(index) + 1);
+
+    // triangles using a vertex, the not yet emitted ones first
+    std::vector<unsigned> adjacency_offset(n_vertices + 1, 0);
+    for (const auto index : triangles)
+        adjacency_offset[size_t(index) + 1]++;
+    std::partial_sum(adjacency_offset.begin(), adjacency_offset.end(), adjacency_offset.begin());
+    std::vector<unsigned> adjacency(triangles.size());
+    std::vector<unsigned> n_remaining(n_vertices, 0);
+    for (size_t t = 0; t < n_triangles; t++) {
+        for (size_t k = 0; k < 3; k++) {
+            const auto v = size_t(triangles[t * 3 + k]);
+            adjacency[adjacency_offset[v] + n_remaining[v]++] = unsigned(t);
+        }
+    }
+
+    std::vector<int> cache_position(n_vertices, -1);
+    const auto vertex_score = [&](size_t v) {
+        if (n_remaining[v] == 0)
+            return -1.f;
+        float score = 0;
+        const auto position = cache_position[v];
+        if (position >= 0) {
+            if (position < 3)
+                score = 0.75f; // used by the last triangle. lower than the next positions, otherwise we would get a strip.
+            else
+                score = std::pow(1.f - float(position - 3) / float(cache_size - 3), 1.5f);
+        }
+        return score + 2.f / std::sqrt(float(n_remaining[v]));
+    };
+    std::vector<float> score(n_vertices);
+    for (size_t v = 0; v < n_vertices; v++)
+        score[v] = vertex_score(v);
+    std::vector<float> triangle_score(n_triangles);
+    for (size_t t = 0; t < n_triangles; t++)
+        triangle_score[t] = score[triangles[t * 3]] + score[triangles[t * 3 + 1]] + score[triangles[t * 3 + 2]];
+
+    std::vector<bool> emitted(n_triangles, false);
+    std::vector<Index> cache;
+    std::vector<Index> result;
+    result.reserve(triangles.size());
+    std::ptrdiff_t best = -1;
+    for (size_t n_emitted = 0; n_emitted < n_triangles; n_emitted++) {
+        if (best < 0) {
+            // none of the cached vertices has triangles left (or it's the start), take the best of all.
+            float best_score = -1;
+            for (size_t t = 0; t < n_triangles; t++) {
+                if (!emitted[t] && triangle_score[t] > best_score) {
+                    best = std::ptrdiff_t(t);
+                    best_score = triangle_score[t];
+                }
+            }
+        }
+        const auto t = size_t(best);
+        emitted[t] = true;
+        std::vector<Index> new_cache(triangles.begin() + std::ptrdiff_t(t * 3), triangles.begin() + std::ptrdiff_t(t * 3 + 3));
+        for (const auto v : new_cache) {
+            result.push_back(v);
+            const auto begin = adjacency.begin() + adjacency_offset[v];
+            std::iter_swap(std::find(begin, begin + n_remaining[v], unsigned(t)), begin + n_remaining[v] - 1);
+            n_remaining[v]--;
+        }
+        for (const auto v : cache) {
+            if (std::find(new_cache.begin(), new_cache.begin() + 3, v) == new_cache.begin() + 3)
+                new_cache.push_back(v);
+        }
+        for (size_t i = 0; i < new_cache.size(); i++)
+            cache_position[new_cache[i]] = i < cache_size ? int(i) : -1;
+
+        // update the scores of the vertices whose cache position changed, and find the best triangle using them
+        best = -1;
+        float best_score = -1;
+        for (const auto v : new_cache) {
+            const auto new_score = vertex_score(v);
+            const auto delta = new_score - score[v];
+            score[v] = new_score;
+            for (unsigned i = 0; i < n_remaining[v]; i++) {
+                const auto adjacent = adjacency[adjacency_offset[v] + i];
+                triangle_score[adjacent] += delta;
+            }
+        }
+        new_cache.resize(std::min(new_cache.size(), size_t(cache_size)));
+        for (const auto v : new_cache) {
+            for (unsigned i = 0; i < n_remaining[v]; i++) {
+                const auto adjacent = adjacency[adjacency_offset[v] + i];
+                if (triangle_score[adjacent] > best_score) {
+                    best = std::ptrdiff_t(adjacent);
+                    best_score = triangle_score[adjacent];
+                }
+            }
+        }
+        cache = std::move(new_cache);
+    }
+    return result;
+}
+
+// triangles partitioned into small, independent meshes, e.g., for mesh shaders or compute rasterisation.
+// the partitioning is greedy in triangle order, so the input should be spatially coherent (e.g., hilbert ordered).
+template<typename Index>
+struct Meshlets {
+    struct Meshlet {
+        uint32_t vertex_offset = 0;
+        uint32_t vertex_count = 0;
+        uint32_t triangle_offset = 0;
+        uint32_t triangle_count = 0;
+    };
+    std::vector<Meshlet> meshlets;
+    std::vector<Index> vertices; // mesh vertex of each meshlet vertex
+    std::vector<uint8_t> triangles; // 3 meshlet vertex indices per triangle
+};
+
+template<typename Index>
+Meshlets<Index> meshlets(const std::vector<Index>& triangles, unsigned max_vertices = 64, unsigned max_triangles = 124)
+{
+    Q_ASSERT(triangles.size() % 3 == 0);
+    Q_ASSERT(max_vertices >= 3 && max_vertices <= 256);
+    Q_ASSERT(max_triangles >= 1);
+    Meshlets<Index> result;
+    typename Meshlets<Index>::Meshlet current;
+    const auto local_index = [&](Index v) -> int {
+        const auto begin = result.vertices.begin() + current.vertex_offset;
+        const auto it = std::find(begin, result.vertices.end(), v);
+        return it == result.vertices.end() ? -1 : int(it - begin);
+    };
+    for (size_t t = 0; t < triangles.size(); t += 3) {
+        unsigned n_new_vertices = 0;
+        for (size_t k = 0; k < 3; k++)
+            n_new_vertices += local_index(triangles[t + k]) < 0 ? 1 : 0;
+        if (current.vertex_count + n_new_vertices > max_vertices || current.triangle_count == max_triangles) {
+            result.meshlets.push_back(current);
+            current = { uint32_t(result.vertices.size()), 0, uint32_t(result.triangles.size() / 3), 0 };
+        }
+        for (size_t k = 0; k < 3; k++) {
+            auto local = local_index(triangles[t + k]);
+            if (local < 0) {
+                local = int(current.vertex_count++);
+                result.vertices.push_back(triangles[t + k]);
+            }
+            result.triangles.push_back(uint8_t(local));
+        }
+        current.triangle_count++;
+    }
+    if (current.triangle_count > 0)
+        result.meshlets.push_back(current);
+    return result;
+}
 }
@@ -43,19 +43,16 @@ static std::atomic_int32_t s_number_of_pois = {};
 } // namespace
 
 nucleus::vector_tile::PointOfInterestCollection nucleus::vector_tile::parse::points_of_interest(
-    const QByteArray& vector_tile_data, const DataQuerier* data_querier)
+    QByteArrayView vector_tile_data, const DataQuerier* data_querier)
 {
     if (vector_tile_data.isEmpty())
         return {};
 
-    std::string d = vector_tile_data.toStdString();
-    mapbox::vector_tile::buffer tile(d);
-
     // create empty output variable
     std::vector<PointOfInterest> pois;
 
-    for (auto const& layer_name : tile.layerNames()) {
-        const mapbox::vector_tile::layer layer = tile.getLayer(layer_name);
+    for (auto const& [layer_name, layer_view] : util::layers(vector_tile_data)) {
+        const mapbox::vector_tile::layer layer(layer_view);
         const auto type = type_from_layer_name(layer_name);
 
         std::size_t feature_count = layer.featureCount();
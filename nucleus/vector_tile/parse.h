@@ -21,9 +21,9 @@
 
 #include "types.h"
 #include <QArrayData>
-#include <QByteArray>
+#include <QByteArrayView>
 #include <nucleus/DataQuerier.h>
 
 namespace nucleus::vector_tile::parse {
-PointOfInterestCollection points_of_interest(const QByteArray& vector_tile_data, const DataQuerier* data_querier = nullptr);
+PointOfInterestCollection points_of_interest(QByteArrayView vector_tile_data, const DataQuerier* data_querier = nullptr);
 }
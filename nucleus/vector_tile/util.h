@@ -18,8 +18,11 @@
  *****************************************************************************/
 
 #pragma once
+#include <QByteArrayView>
 #include <QString>
+#include <map>
 #include <mapbox/vector_tile.hpp>
+#include <string>
 
 namespace nucleus::vector_tile::util {
 namespace detail {
@@ -37,4 +40,22 @@ namespace detail {
     };
 } // namespace detail
 const static detail::StringPrintVisitor string_print_visitor = {};
+
+// Layers of a vector tile by name. mapbox::vector_tile::buffer needs a std::string copy of the tile, these views point into
+// vector_tile_data directly (which must outlive them). Throws protozero::exception on malformed data.
+inline std::map<std::string, protozero::data_view> layers(QByteArrayView vector_tile_data)
+{
+    std::map<std::string, protozero::data_view> layers;
+    protozero::pbf_reader tile_reader(protozero::data_view(vector_tile_data.data(), size_t(vector_tile_data.size())));
+    while (tile_reader.next(3)) { // Tile.layers
+        const auto layer_view = tile_reader.get_view();
+        protozero::pbf_reader layer_reader(layer_view);
+        std::string name;
+        while (layer_reader.next(1)) // Layer.name
+            name = layer_reader.get_string();
+        if (!name.empty())
+            layers.emplace(std::move(name), layer_view);
+    }
+    return layers;
+}
 } // namespace nucleus::vector_tile::util
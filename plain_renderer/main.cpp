@@ -128,12 +128,14 @@ int main(int argc, char** argv)
     auto decorator = nucleus::tile::setup::aabb_decorator();
     QThread scheduler_thread;
     nucleus::tile::SchedulerDirector director;
+    auto tile_slot_budget = std::make_shared<nucleus::tile::SlotBudget>();
 
-    auto geometry_scheduler = nucleus::tile::setup::geometry_scheduler(std::move(terrain_service), decorator, &scheduler_thread);
+    auto geometry_scheduler = nucleus::tile::setup::geometry_scheduler(std::move(terrain_service), decorator, &scheduler_thread, { tile_slot_budget, 4.0f });
     director.check_in("geometry", geometry_scheduler.scheduler);
     auto data_querier = std::make_shared<DataQuerier>(&geometry_scheduler.scheduler->ram_cache());
 
-    auto ortho_scheduler = nucleus::tile::setup::texture_scheduler(std::move(ortho_service), decorator, &scheduler_thread);
+    auto ortho_scheduler = nucleus::tile::setup::texture_scheduler(
+        std::move(ortho_service), decorator, &scheduler_thread, nucleus::tile::setup::texture_scheduler_settings(), { tile_slot_budget, 1.0f });
     director.check_in("ortho", ortho_scheduler.scheduler);
 
     auto context = std::make_shared<gl_engine::Context>();
@@ -164,6 +166,8 @@ int main(int argc, char** argv)
     // clang-format off
     QObject::connect(&camera_controller, &nucleus::camera::Controller::definition_changed, geometry_scheduler.scheduler.get(), &Scheduler::update_camera);
     QObject::connect(&camera_controller, &nucleus::camera::Controller::definition_changed, ortho_scheduler.scheduler.get(), &Scheduler::update_camera);
+    QObject::connect(&camera_controller, &nucleus::camera::Controller::camera_path_changed, geometry_scheduler.scheduler.get(), &Scheduler::update_camera_path);
+    QObject::connect(&camera_controller, &nucleus::camera::Controller::camera_path_changed, ortho_scheduler.scheduler.get(), &Scheduler::update_camera_path);
     QObject::connect(&camera_controller, &nucleus::camera::Controller::definition_changed, glWindow.render_window(), &AbstractRenderWindow::update_camera);
     QObject::connect(geometry_scheduler.scheduler.get(), &GeometryScheduler::gpu_tiles_updated, context->tile_geometry(), &gl_engine::TileGeometry::update_gpu_tiles);
     QObject::connect(geometry_scheduler.scheduler.get(), &GeometryScheduler::gpu_tiles_updated, glWindow.render_window(), &AbstractRenderWindow::update_requested);
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <QOpenGLExtraFunctions>
+#include <catch2/catch_test_macros.hpp>
+
+#include "gl_engine/Framebuffer.h"
+#include "gl_engine/Picker.h"
+#include "gl_engine/ShaderProgram.h"
+#include "gl_engine/helpers.h"
+
+#include "UnittestGLContext.h"
+
+using gl_engine::Framebuffer;
+using gl_engine::Picker;
+using gl_engine::ShaderProgram;
+
+namespace {
+// a grid of 16x8 cells with distinct ids, similar to what the label picker shader produces
+ShaderProgram create_id_grid_shader()
+{
+    static const char* const vertex_source = R"(
+    out highp vec2 texcoords;
+    void main() {
+        vec2 vertices[3]=vec2[3](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+        gl_Position = vec4(vertices[gl_VertexID], 0.0, 1.0);
+        texcoords = 0.5 * gl_Position.xy + vec2(0.5);
+    })";
+    static const char* const fragment_source = R"(
+    in highp vec2 texcoords;
+    out highp vec4 out_Color;
+    void main() {
+        out_Color = vec4(floor(texcoords * vec2(16.0, 8.0)), 1.0, 2.0);
+    })";
+    return ShaderProgram(vertex_source, fragment_source, gl_engine::ShaderCodeSource::PLAINTEXT);
+}
+} // namespace
+
+TEST_CASE("gl picker")
+{
+    UnittestGLContext::initialise();
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    REQUIRE(f);
+    const auto viewport = glm::uvec2(512, 256);
+    ShaderProgram shader = create_id_grid_shader();
+    const auto geometry = gl_engine::helpers::create_screen_quad_geometry();
+
+    // reference: full resolution picker buffer, as it was drawn every frame before
+    Framebuffer reference(Framebuffer::DepthFormat::Float32, { Framebuffer::ColourFormat::RGBA32F }, viewport);
+    reference.bind();
+    f->glClearColor(0, 0, 0, 0);
+    f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    shader.bind();
+    geometry.draw();
+    Framebuffer::unbind();
+
+    SECTION("no pass without request")
+    {
+        Picker picker;
+        CHECK(!picker.needs_pass());
+        CHECK(!picker.waiting_for_result());
+        CHECK(!picker.poll_result().has_value());
+    }
+
+    SECTION("picked values match the full resolution picker buffer")
+    {
+        Picker picker;
+        // cell centres, borders and the corners of the screen
+        const auto pixels = std::vector<glm::uvec2> { { 16, 16 }, { 48, 16 }, { 250, 100 }, { 31, 15 }, { 32, 16 }, { 0, 0 }, { 511, 255 }, { 0, 255 }, { 511, 0 } };
+        for (const auto& pixel : pixels) {
+            const auto ndc = (glm::dvec2(pixel) + 0.5) / glm::dvec2(viewport) * 2.0 - 1.0;
+            picker.request(ndc);
+            REQUIRE(picker.needs_pass());
+            picker.begin_pass(viewport);
+            shader.bind();
+            geometry.draw();
+            picker.end_pass();
+            CHECK(!picker.needs_pass());
+            CHECK(picker.waiting_for_result());
+
+            f->glFinish();
+            const auto value = picker.poll_result();
+            REQUIRE(value.has_value());
+            CHECK(!picker.waiting_for_result());
+            const auto expected = reference.read_colour_attachment_pixel<glm::vec4>(0, ndc);
+            CHECK(value.value() == expected);
+        }
+    }
+
+    SECTION("the viewport is restored after the pass")
+    {
+        Picker picker;
+        f->glViewport(0, 0, 123, 45);
+        picker.request({ 0.2, -0.3 });
+        picker.begin_pass(viewport);
+        picker.end_pass();
+        GLint restored[4];
+        f->glGetIntegerv(GL_VIEWPORT, restored);
+        CHECK(restored[0] == 0);
+        CHECK(restored[1] == 0);
+        CHECK(restored[2] == 123);
+        CHECK(restored[3] == 45);
+    }
+}
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "gl_engine/Framebuffer.h"
+#include "gl_engine/ShaderProgram.h"
+#include "gl_engine/helpers.h"
+
+#include "UnittestGLContext.h"
+
+using gl_engine::Framebuffer;
+using gl_engine::ShaderProgram;
+using gl_engine::UniformHandle;
+
+namespace {
+const char* const vertex_source = R"(
+void main() {
+    vec2 vertices[3]=vec2[3](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));
+    gl_Position = vec4(vertices[gl_VertexID], 0.0, 1.0);
+})";
+
+// the padding uniforms move colour to different locations in the two programs
+const char* const fragment_source_a = R"(
+uniform lowp vec4 colour;
+out lowp vec4 out_Color;
+void main() {
+    out_Color = colour;
+})";
+
+const char* const fragment_source_b = R"(
+uniform lowp vec4 padding_a;
+uniform lowp vec4 padding_b;
+uniform lowp vec4 colour;
+out lowp vec4 out_Color;
+void main() {
+    out_Color = colour + padding_a * 0.0 + padding_b * 0.0;
+})";
+
+glm::u8vec4 draw(ShaderProgram* shader)
+{
+    Framebuffer b(Framebuffer::DepthFormat::None, { Framebuffer::ColourFormat::RGBA8 }, { 1, 1 });
+    b.bind();
+    shader->bind();
+    gl_engine::helpers::create_screen_quad_geometry().draw();
+    return b.read_colour_attachment_pixel<glm::u8vec4>(0, glm::dvec2(0.0, 0.0));
+}
+} // namespace
+
+TEST_CASE("gl_engine/shader_program")
+{
+    UnittestGLContext::initialise();
+
+    SECTION("uniform handles")
+    {
+        const UniformHandle<glm::vec4> colour("colour");
+        CHECK(UniformHandle<glm::vec4>("colour").id() == colour.id());
+        CHECK(UniformHandle<glm::vec4>("padding_a").id() != colour.id());
+
+        ShaderProgram a(vertex_source, fragment_source_a, gl_engine::ShaderCodeSource::PLAINTEXT);
+        ShaderProgram b(vertex_source, fragment_source_b, gl_engine::ShaderCodeSource::PLAINTEXT);
+
+        a.bind();
+        a.set_uniform(colour, glm::vec4(1, 0, 0, 1));
+        CHECK(draw(&a) == glm::u8vec4(255, 0, 0, 255));
+
+        b.bind();
+        b.set_uniform(UniformHandle<glm::vec4>("padding_a"), glm::vec4(1.0));
+        b.set_uniform(UniformHandle<glm::vec4>("padding_b"), glm::vec4(1.0));
+        b.set_uniform(colour, glm::vec4(0, 1, 0, 1));
+        CHECK(draw(&b) == glm::u8vec4(0, 255, 0, 255));
+
+        // locations are resolved again after linking
+        a.reload();
+        a.bind();
+        a.set_uniform(colour, glm::vec4(0, 0, 1, 1));
+        CHECK(draw(&a) == glm::u8vec4(0, 0, 255, 255));
+
+        // handles and names can be mixed
+        a.bind();
+        a.set_uniform("colour", glm::vec4(1, 1, 0, 1));
+        CHECK(draw(&a) == glm::u8vec4(255, 255, 0, 255));
+    }
+
+    SECTION("program binary cache")
+    {
+        const auto n_programs_before = ShaderProgram::build_statistics().n_programs;
+        const UniformHandle<glm::vec4> colour("colour");
+        // the second one is loaded from the cache (if there is a cache on this platform), both must work
+        for (int i = 0; i < 2; ++i) {
+            ShaderProgram shader(vertex_source, fragment_source_a, gl_engine::ShaderCodeSource::PLAINTEXT);
+            shader.bind();
+            shader.set_uniform(colour, glm::vec4(1, 0, 1, 1));
+            CHECK(draw(&shader) == glm::u8vec4(255, 0, 255, 255));
+        }
+        CHECK(ShaderProgram::build_statistics().n_programs == n_programs_before + 2);
+
+        // run with QT_DISABLE_SHADER_DISK_CACHE=1 to compare with compilation.
+        BENCHMARK("build shader program")
+        {
+            return ShaderProgram(vertex_source, fragment_source_b, gl_engine::ShaderCodeSource::PLAINTEXT);
+        };
+    }
+
+    SECTION("benchmark uniform setting (cpu)")
+    {
+        ShaderProgram shader(vertex_source, fragment_source_b, gl_engine::ShaderCodeSource::PLAINTEXT);
+        shader.bind();
+        const UniformHandle<glm::vec4> colour("colour");
+        const UniformHandle<glm::vec4> padding_a("padding_a");
+        const UniformHandle<glm::vec4> padding_b("padding_b");
+        // roughly what MapLabels::draw does for one frame with many label tiles
+        constexpr unsigned n_draws = 1000;
+
+        BENCHMARK("set_uniform by name")
+        {
+            for (unsigned i = 0; i < n_draws; ++i) {
+                shader.set_uniform("padding_a", glm::vec4(float(i)));
+                shader.set_uniform("padding_b", glm::vec4(float(i)));
+                shader.set_uniform("colour", glm::vec4(float(i)));
+            }
+        };
+        BENCHMARK("set_uniform by handle")
+        {
+            for (unsigned i = 0; i < n_draws; ++i) {
+                shader.set_uniform(padding_a, glm::vec4(float(i)));
+                shader.set_uniform(padding_b, glm::vec4(float(i)));
+                shader.set_uniform(colour, glm::vec4(float(i)));
+            }
+        };
+        QOpenGLContext::currentContext()->extraFunctions()->glFinish();
+    }
+}
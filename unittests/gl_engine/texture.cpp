@@ -23,6 +23,7 @@
 #include "UnittestGLContext.h"
 #include <gl_engine/Framebuffer.h>
 #include <gl_engine/ShaderProgram.h>
+#include <gl_engine/StagingBuffer.h>
 #include <gl_engine/Texture.h>
 #include <gl_engine/helpers.h>
 #include <nucleus/tile/conversion.h>
@@ -606,6 +607,48 @@ TEST_CASE("gl texture")
         }
     }
 
+    SECTION("red16 array through staging buffer")
+    {
+        Framebuffer b(Framebuffer::DepthFormat::None, { Framebuffer::ColourFormat::RGBA8, Framebuffer::ColourFormat::RGBA8 }, { 1, 1 });
+        b.bind();
+
+        gl_engine::Texture opengl_texture(gl_engine::Texture::Target::_2dArray, gl_engine::Texture::Format::R16UI);
+        opengl_texture.allocate_array(1, 1, 2);
+        opengl_texture.setParams(gl_engine::Texture::Filter::Nearest, gl_engine::Texture::Filter::Nearest);
+        // the second upload doesn't fit (aligned offset 16) and goes through client memory
+        gl_engine::StagingBuffer staging(16);
+        staging.begin_frame();
+        opengl_texture.upload(radix::Raster<uint16_t>({ 1, 1 }, uint16_t((120 * 65535) / 255)), 0, staging);
+        CHECK(staging.n_staged_bytes() == 2);
+        opengl_texture.upload(radix::Raster<uint16_t>({ 1, 1 }, uint16_t((190 * 65535) / 255)), 1, staging);
+        CHECK(staging.n_staged_bytes() == 2);
+
+        ShaderProgram shader = create_debug_shader(R"(
+            uniform mediump usampler2DArray texture_sampler;
+            layout (location = 0) out lowp vec4 out_color1;
+            layout (location = 1) out lowp vec4 out_color2;
+            void main() {
+                {
+                    mediump uint v = texture(texture_sampler, vec3(0.5, 0.5, 0)).r;
+                    highp float v2 = float(v);
+                    out_color1 = vec4(v2 / 65535.0, 0, 0, 1);
+                }
+                {
+                    mediump uint v = texture(texture_sampler, vec3(0.5, 0.5, 1)).r;
+                    highp float v2 = float(v);
+                    out_color2 = vec4(v2 / 65535.0, 0, 0, 1);
+                }
+            }
+        )");
+        shader.bind();
+        opengl_texture.bind(0);
+        shader.set_uniform("texture_sampler", 0);
+        gl_engine::helpers::create_screen_quad_geometry().draw();
+
+        CHECK(qRed(b.read_colour_attachment(0).pixel(0, 0)) == 120);
+        CHECK(qRed(b.read_colour_attachment(1).pixel(0, 0)) == 190);
+    }
+
     SECTION("red8 array")
     {
         Framebuffer b(Framebuffer::DepthFormat::None, { Framebuffer::ColourFormat::RGBA8, Framebuffer::ColourFormat::RGBA8 }, { 1, 1 });
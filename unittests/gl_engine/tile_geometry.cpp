@@ -0,0 +1,147 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <QImage>
+#include <QOpenGLExtraFunctions>
+#include <catch2/catch_test_macros.hpp>
+
+#include "gl_engine/Framebuffer.h"
+#include "gl_engine/ShaderProgram.h"
+#include "gl_engine/StagingBuffer.h"
+#include "gl_engine/Texture.h"
+#include "gl_engine/TileGeometry.h"
+#include "gl_engine/UploadQueue.h"
+#include <nucleus/camera/PositionStorage.h>
+#include <nucleus/srs.h>
+
+#include "UnittestGLContext.h"
+
+using gl_engine::Framebuffer;
+using gl_engine::ShaderProgram;
+using gl_engine::Texture;
+using namespace nucleus::tile;
+
+namespace {
+// every instance covers one pixel column, selected by its draw list index. the fragment compares the tile id of the
+// instance with the per tile lookup at that index (filled in draw list order, like the ortho and avalanche layers do).
+ShaderProgram create_instance_shader()
+{
+    static const char* const vertex_source = R"(
+    #include "shared_config.glsl"
+    #include "camera_config.glsl"
+    #include "tile.glsl"
+
+    uniform highp int n_instances;
+    flat out highp uint instance_id;
+    flat out highp uint tile_x;
+    void main() {
+        instance_id = instance_draw_index;
+        tile_x = unpack_tile_id(instance_tile_id_packed).x;
+        highp int row = gl_VertexID / n_edge_vertices;
+        highp int col = gl_VertexID - row * n_edge_vertices;
+        highp vec2 uv = vec2(0.5); // curtains collapse into the column of the instance
+        if (gl_VertexID < n_edge_vertices * n_edge_vertices)
+            uv = vec2(float(col), float(row)) / float(n_edge_vertices - 1);
+        highp float x = (float(instance_id) + uv.x) / float(n_instances);
+        gl_Position = vec4(x * 2.0 - 1.0, uv.y * 2.0 - 1.0, 0.0, 1.0);
+    })";
+    static const char* const fragment_source = R"(
+    uniform mediump usampler2D instanced_lookup_sampler;
+    flat in highp uint instance_id;
+    flat in highp uint tile_x;
+    out lowp vec4 out_color;
+    void main() {
+        highp uint expected_x = texelFetch(instanced_lookup_sampler, ivec2(int(instance_id), 0), 0).x;
+        out_color = vec4(expected_x == tile_x ? 121.0 / 255.0 : 9.0 / 255.0, 0.0, 0.0, 1.0);
+    })";
+    return ShaderProgram(vertex_source, fragment_source, gl_engine::ShaderCodeSource::PLAINTEXT);
+}
+} // namespace
+
+TEST_CASE("gl tile geometry")
+{
+    UnittestGLContext::initialise();
+    QOpenGLExtraFunctions* f = QOpenGLContext::currentContext()->extraFunctions();
+    REQUIRE(f);
+
+    SECTION("mesh variants keep the per tile lookups in draw list order")
+    {
+        auto camera = nucleus::camera::PositionStorage::instance()->get("grossglockner");
+        camera.set_viewport_size({ 1920, 1080 });
+
+        gl_engine::TileGeometry geometry(65);
+        geometry.set_tile_limit(64);
+        geometry.init();
+
+        // smooth tiles get the coarsest mesh, tiles with a large spike the full one. alternating, so the instances are reordered.
+        constexpr unsigned n_tiles = 8;
+        const auto first_id = nucleus::srs::world_xy_to_tile_id(glm::dvec2(camera.position()), 14);
+        radix::Raster<uint16_t> flat(glm::uvec2(65), uint16_t(8000));
+        radix::Raster<uint16_t> spiky = flat;
+        spiky.pixel({ 31, 33 }) = 60000;
+        std::vector<GpuGeometryTile> tiles;
+        std::vector<TileBounds> draw_list;
+        for (unsigned i = 0; i < n_tiles; ++i) {
+            const auto id = Id { first_id.zoom_level, first_id.coords + glm::uvec2(i, 0) };
+            const auto srs_bounds = nucleus::srs::tile_bounds(id);
+            const auto bounds = SrsAndHeightBounds { .min = glm::dvec3(srs_bounds.min, 1000.0), .max = glm::dvec3(srs_bounds.max, 8000.0) };
+            tiles.push_back({ id, bounds, std::make_shared<const radix::Raster<uint16_t>>(i % 2 ? spiky : flat) });
+            draw_list.push_back({ id, bounds });
+        }
+
+        geometry.update_gpu_tiles({}, tiles);
+        gl_engine::StagingBuffer staging(8 * 1024 * 1024);
+        const gl_engine::UploadPriority priority = [](const Id&) { return 1.0; };
+        for (unsigned i = 0; i < 2; ++i) { // the second call commits the finished uploads
+            gl_engine::UploadBudget budget(size_t(-1), std::chrono::seconds(10));
+            staging.begin_frame();
+            geometry.upload_pending(priority, budget, staging);
+            f->glFinish();
+        }
+        REQUIRE(!geometry.has_pending_uploads());
+
+        radix::Raster<uint16_t> lookup(glm::uvec2 { 1024, 1 }, uint16_t(0));
+        for (unsigned i = 0; i < n_tiles; ++i)
+            lookup.pixel({ i, 0 }) = uint16_t(draw_list[i].id.coords.x);
+        Texture lookup_texture(Texture::Target::_2d, Texture::Format::R16UI);
+        lookup_texture.setParams(Texture::Filter::Nearest, Texture::Filter::Nearest);
+        lookup_texture.bind(7);
+        lookup_texture.upload(lookup);
+
+        Framebuffer b(Framebuffer::DepthFormat::None, { Framebuffer::ColourFormat::RGBA8 }, { n_tiles, 1 });
+        b.bind();
+        const GLfloat clear_colour[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        f->glClearBufferfv(GL_COLOR, 0, clear_colour);
+        ShaderProgram shader = create_instance_shader();
+        shader.bind();
+        shader.set_uniform("n_instances", int(n_tiles));
+        shader.set_uniform("instanced_lookup_sampler", 7);
+        geometry.draw(&shader, camera, draw_list);
+
+        const auto n_drawn = geometry.n_drawn_per_mesh_variant();
+        CHECK(n_drawn[0] == n_tiles / 2);
+        CHECK(n_drawn[drawing::mesh_strides.size() - 1] == n_tiles / 2);
+
+        const QImage render_result = b.read_colour_attachment(0);
+        Framebuffer::unbind();
+        for (unsigned i = 0; i < n_tiles; ++i) {
+            CAPTURE(i);
+            CHECK(qRed(render_result.pixel(int(i), 0)) == 121);
+        }
+    }
+}
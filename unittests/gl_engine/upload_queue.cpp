@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <QOpenGLExtraFunctions>
+#include <catch2/catch_test_macros.hpp>
+
+#include "gl_engine/UploadQueue.h"
+
+#include "UnittestGLContext.h"
+
+using gl_engine::UploadBudget;
+using gl_engine::UploadFences;
+using gl_engine::UploadQueue;
+using nucleus::tile::Id;
+
+namespace {
+struct TestTile {
+    Id id;
+    size_t n_bytes = 0;
+};
+} // namespace
+
+TEST_CASE("gl upload queue")
+{
+    const auto n_bytes = [](const TestTile& tile) { return tile.n_bytes; };
+    // higher zoom levels first
+    const auto priority = [](const Id& id) { return double(id.zoom_level); };
+
+    SECTION("budget")
+    {
+        UploadBudget budget(100, std::chrono::seconds(10));
+        CHECK(!budget.exhausted());
+        budget.consume(1000); // the first upload is always allowed, even if larger than the budget
+        CHECK(budget.exhausted());
+
+        UploadBudget time_budget(100, std::chrono::microseconds(0));
+        CHECK(!time_budget.exhausted());
+        time_budget.consume(1);
+        CHECK(time_budget.exhausted());
+    }
+
+    SECTION("takes by priority within the budget")
+    {
+        UploadQueue<TestTile> queue;
+        queue.push({ { Id { 1, { 0, 0 } }, 40 }, { Id { 3, { 0, 0 } }, 40 }, { Id { 2, { 0, 0 } }, 40 }, { Id { 4, { 0, 0 } }, 40 } });
+
+        UploadBudget budget(100, std::chrono::seconds(10));
+        const auto taken = queue.take(priority, n_bytes, budget);
+        REQUIRE(taken.size() == 3);
+        CHECK(taken[0].id.zoom_level == 4);
+        CHECK(taken[1].id.zoom_level == 3);
+        CHECK(taken[2].id.zoom_level == 2);
+        REQUIRE(queue.size() == 1);
+        CHECK(queue.take(priority, n_bytes, budget).empty());
+
+        UploadBudget next_frame(100, std::chrono::seconds(10));
+        const auto rest = queue.take(priority, n_bytes, next_frame);
+        REQUIRE(rest.size() == 1);
+        CHECK(rest[0].id.zoom_level == 1);
+        CHECK(queue.empty());
+    }
+
+    SECTION("remove")
+    {
+        UploadQueue<TestTile> queue;
+        queue.push({ { Id { 1, { 0, 0 } }, 40 }, { Id { 2, { 0, 0 } }, 40 } });
+        CHECK(queue.remove(Id { 1, { 0, 0 } }));
+        CHECK(!queue.remove(Id { 1, { 0, 0 } }));
+        CHECK(queue.size() == 1);
+    }
+
+    SECTION("fences")
+    {
+        UnittestGLContext::initialise();
+        auto* f = QOpenGLContext::currentContext()->extraFunctions();
+
+        UploadFences fences;
+        CHECK(fences.empty());
+        fences.insert({ Id { 1, { 0, 0 } }, Id { 2, { 0, 0 } } });
+        fences.insert({ Id { 3, { 0, 0 } } });
+        CHECK(!fences.empty());
+        CHECK(fences.remove(Id { 2, { 0, 0 } }));
+        CHECK(!fences.remove(Id { 2, { 0, 0 } }));
+
+        f->glFinish();
+        const auto finished = fences.take_finished();
+        REQUIRE(finished.size() == 2);
+        CHECK(finished[0] == Id { 1, { 0, 0 } });
+        CHECK(finished[1] == Id { 3, { 0, 0 } });
+        CHECK(fences.empty());
+    }
+}
@@ -0,0 +1,140 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "TestTileServer.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QtAssert>
+#include <algorithm>
+#include <chrono>
+
+#include "nucleus/tile/batch.h"
+
+using namespace unittests;
+
+namespace {
+QByteArray http_response(int status, const QByteArray& body)
+{
+    const QByteArray reason = status == 200 ? "OK" : (status == 404 ? "Not Found" : "Bad Request");
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + reason + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Content-Type: application/octet-stream\r\n";
+    response += "Connection: keep-alive\r\n\r\n";
+    return response + body;
+}
+} // namespace
+
+TestTileServer::TestTileServer(Settings settings, QObject* parent)
+    : QObject(parent)
+    , m_settings(std::move(settings))
+    , m_server(new QTcpServer(this))
+{
+    const auto listening = m_server->listen(QHostAddress::LocalHost);
+    Q_ASSERT(listening);
+    Q_UNUSED(listening);
+    connect(m_server, &QTcpServer::newConnection, this, &TestTileServer::accept);
+    m_clock.start();
+}
+
+TestTileServer::~TestTileServer() = default;
+
+QString TestTileServer::tile_url() const { return QString("http://127.0.0.1:%1/tiles/").arg(m_server->serverPort()); }
+
+QString TestTileServer::batch_url() const { return QString("http://127.0.0.1:%1/batch").arg(m_server->serverPort()); }
+
+void TestTileServer::accept()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_n_connections++;
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { read(socket); });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void TestTileServer::read(QTcpSocket* socket)
+{
+    // requests may be pipelined, the request buffer is kept on the socket
+    auto buffer = socket->property("request_buffer").toByteArray() + socket->readAll();
+    while (true) {
+        const auto header_end = buffer.indexOf("\r\n\r\n");
+        if (header_end < 0)
+            break;
+        const auto request_line = buffer.left(buffer.indexOf("\r\n")).split(' ');
+        buffer.remove(0, header_end + 4);
+        m_n_requests++;
+
+        const auto response = (request_line.size() >= 2 && request_line[0] == "GET") ? respond(request_line[1]) : http_response(400, {});
+        int64_t delay = m_settings.latency_ms;
+        if (m_settings.bandwidth > 0) {
+            // a single link, responses are sent one after the other
+            const auto now = m_clock.elapsed();
+            m_link_free_at = std::max(m_link_free_at, now) + int64_t(response.size()) * 1000 / m_settings.bandwidth;
+            delay += m_link_free_at - now;
+        }
+        // the socket is the context, the timer is cancelled if the connection is gone. delays grow monotonically, keeping the order of pipelined responses
+        QTimer::singleShot(std::chrono::milliseconds(delay), socket, [socket, response]() { socket->write(response); });
+    }
+    socket->setProperty("request_buffer", buffer);
+}
+
+QByteArray TestTileServer::respond(const QByteArray& path)
+{
+    const QUrl url(QString::fromUtf8(path));
+    if (url.path().startsWith("/tiles/")) {
+        auto address = url.path().mid(QString("/tiles/").size());
+        if (!address.endsWith(m_settings.file_ending))
+            return http_response(404, {});
+        address.chop(m_settings.file_ending.size());
+        const auto [status, data] = tile(address);
+        return http_response(status, data);
+    }
+    if (url.path() == "/batch") {
+        const auto addresses = QUrlQuery(url).queryItemValue("tiles").split(',', Qt::SkipEmptyParts);
+        std::vector<nucleus::tile::batch::Entry> entries;
+        entries.reserve(size_t(addresses.size()));
+        for (auto address : addresses) {
+            if (!address.endsWith(m_settings.file_ending)) {
+                entries.push_back({ 404, {} });
+                continue;
+            }
+            address.chop(m_settings.file_ending.size());
+            const auto [status, data] = tile(address);
+            entries.push_back({ uint32_t(status), nucleus::utils::ByteBuffer(data) });
+        }
+        return http_response(200, nucleus::tile::batch::encode(entries));
+    }
+    return http_response(404, {});
+}
+
+std::pair<int, QByteArray> TestTileServer::tile(const QString& address)
+{
+    const auto parts = address.split('/');
+    bool zoom_ok = false;
+    const auto zoom_level = parts.isEmpty() ? 0u : parts[0].toUInt(&zoom_ok);
+    if (parts.size() != 3 || !zoom_ok || zoom_level > m_settings.max_zoom_level)
+        return { 404, {} };
+    m_n_tiles_served++;
+    auto data = address.toUtf8();
+    if (unsigned(data.size()) < m_settings.tile_size)
+        data.append(qsizetype(m_settings.tile_size) - data.size(), '.');
+    return { 200, data };
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <utility>
+
+class QTcpServer;
+class QTcpSocket;
+
+namespace unittests {
+
+// Minimal HTTP/1.1 (keep-alive) tile server on localhost, so that tile loading can be tested and benchmarked offline.
+// GET /tiles/<z>/<a>/<b><ending> answers with "<z>/<a>/<b>" (padded with '.' to tile_size), or 404 if z > max_zoom_level.
+// GET /batch?tiles=<z>/<a>/<b>,.. answers with a container of those tiles (see nucleus/tile/batch.h).
+// Latency and bandwidth can be throttled to simulate slow (mobile) links.
+class TestTileServer : public QObject {
+    Q_OBJECT
+public:
+    struct Settings {
+        unsigned latency_ms = 0; // added to every response
+        unsigned bandwidth = 0; // bytes per second, shared by all connections (responses queue up for the link), 0 = unlimited
+        unsigned max_zoom_level = 18;
+        unsigned tile_size = 0; // minimum tile size in bytes
+        QString file_ending = ".png";
+    };
+
+    explicit TestTileServer(Settings settings, QObject* parent = nullptr);
+    ~TestTileServer() override;
+
+    [[nodiscard]] QString tile_url() const; // base url for TileLoadService, ending with '/'
+    [[nodiscard]] QString batch_url() const;
+    [[nodiscard]] Settings& settings() { return m_settings; }
+
+    [[nodiscard]] unsigned n_requests() const { return m_n_requests; }
+    [[nodiscard]] unsigned n_tiles_served() const { return m_n_tiles_served; }
+    [[nodiscard]] unsigned n_connections() const { return m_n_connections; }
+
+private:
+    void accept();
+    void read(QTcpSocket* socket);
+    [[nodiscard]] QByteArray respond(const QByteArray& path);
+    [[nodiscard]] std::pair<int, QByteArray> tile(const QString& address);
+
+    Settings m_settings;
+    QTcpServer* m_server = nullptr;
+    unsigned m_n_requests = 0;
+    unsigned m_n_tiles_served = 0;
+    unsigned m_n_connections = 0;
+    QElapsedTimer m_clock;
+    int64_t m_link_free_at = 0; // msecs on m_clock
+};
+}
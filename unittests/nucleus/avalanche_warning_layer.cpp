@@ -20,8 +20,12 @@
 #include "test_helpers.h"
 #include <QFile>
 #include <QSignalSpy>
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <extern/radix/src/radix/tile.h>
+#include <nucleus/avalanche/RegionGeometryCache.h>
+#include <nucleus/avalanche/RegionValidityIndex.h>
 #include <nucleus/avalanche/ReportLoadService.h>
 #include <nucleus/avalanche/Scheduler.h>
 #include <nucleus/avalanche/UIntIdManager.h>
@@ -31,6 +35,8 @@
 #include <nucleus/tile/types.h>
 #include <nucleus/tile/utils.h>
 #include <nucleus/utils/image_loader.h>
+#include <limits>
+#include <numbers>
 
 TEST_CASE("nucleus/EAWS Vector Tiles")
 {
@@ -128,7 +134,7 @@ TEST_CASE("nucleus/EAWS Vector Tiles")
         }
 
         // Create internal id manager that is later needed to write region ids to image pixels
-        std::shared_ptr<nucleus::avalanche::UIntIdManager> internal_id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>(QDate(2025, 7, 1));
+        std::shared_ptr<nucleus::avalanche::UIntIdManager> internal_id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
         internal_id_manager->convert_region_id_to_internal_id(QString("TestRegion1"));
         internal_id_manager->convert_region_id_to_internal_id(QString("TestRegion2"));
         CHECK(internal_id_manager->convert_region_id_to_internal_id("") == 0);
@@ -197,14 +203,17 @@ TEST_CASE("nucleus/EAWS Vector Tiles")
 
         // Check if raster contains correct internal region-ids at certain pixels
         CHECK(0 == raster.pixel(glm::uvec2(0, 0)));
-        CHECK(internal_id_manager->convert_region_id_to_internal_id(region_with_start_date.id) == raster.pixel(glm::vec2(2128, 1459)));
+        // the region might overlap outdated ones, the raster id needs to be resolved for a date after its start date
+        CHECK(internal_id_manager->convert_region_id_to_internal_id(region_with_start_date.id)
+            == internal_id_manager->resolve(raster.pixel(glm::vec2(2128, 1459)), QDate(2025, 7, 1)));
 
         // Check if raster and image have same values when drawn with same resolution
         QImage img_small = nucleus::avalanche::draw_regions(region_tile_2_2_0, internal_id_manager, 20, 20, tile_id_2_2_0);
         const auto raster_small = nucleus::avalanche::rasterize_regions(region_tile_2_2_0, internal_id_manager, 20, 20, tile_id_2_2_0);
         for (uint i = 0; i < 10; i++) {
             for (uint j = 0; j < 10; j++) {
-                uint id_from_img = internal_id_manager->convert_color_to_internal_id(img_small.pixel(i, j));
+                const QColor color(img_small.pixel(i, j));
+                uint id_from_img = uint(color.red() * 256 + color.green());
                 uint id_from_raster = raster_small.pixel(glm::uvec2(i, j));
                 CHECK(id_from_img == id_from_raster);
             }
@@ -212,7 +221,8 @@ TEST_CASE("nucleus/EAWS Vector Tiles")
 
         // Check if tile that has only region NO-3035 in it produces a 1x1 raster with the corresponding internal region id
         const auto raster_NO3035 = nucleus::avalanche::rasterize_regions(region_tile_10_236_299, internal_id_manager);
-        CHECK(internal_id_manager->convert_region_id_to_internal_id("NO-3035") == raster_NO3035.pixel(glm::uvec2(0, 0)));
+        CHECK(internal_id_manager->convert_region_id_to_internal_id("NO-3035")
+            == internal_id_manager->resolve(raster_NO3035.pixel(glm::uvec2(0, 0)), QDate(2025, 7, 1)));
     }
 }
 
@@ -222,7 +232,7 @@ TEST_CASE("nucleus/avalanche/ReportLoadService")
     //{"regionCode":"AT-02-02-00","dangerBorder":2400,"dangerRatingHi":2,"dangerRatingLo":1,"startTime":"2025-01-05T16:00:00.000Z","endTime":"2025-01-06T16:00:00.000Z","unfavorable":225}
 
     // Load id of region we will test for correct avalanche report
-    std::shared_ptr<nucleus::avalanche::UIntIdManager> id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>(QDate(2025, 7, 1));
+    std::shared_ptr<nucleus::avalanche::UIntIdManager> id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
     uint testId = id_manager->convert_region_id_to_internal_id(QString("AT-02-02"));
     // Create Report Load Service and let it load a reference report
     nucleus::avalanche::ReportLoadService reportLoadService(id_manager);
@@ -274,8 +284,7 @@ TEST_CASE("nucleus/avalanche/Scheduler")
     SECTION("to_raster")
     {
         // Build Quad and save its tiles as raster
-        QDate refDate(2025, 7, 1);
-        std::shared_ptr<nucleus::avalanche::UIntIdManager> id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>(refDate);
+        std::shared_ptr<nucleus::avalanche::UIntIdManager> id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
         nucleus::tile::DataQuad quad;
         quad.id = radix::tile::Id { 6, { 33, 22 }, radix::tile::Scheme::SlippyMap };
         std::vector<nucleus::avalanche::RegionTile> tiles;
@@ -288,7 +297,7 @@ TEST_CASE("nucleus/avalanche/Scheduler")
             std::pair<QByteArray, nucleus::avalanche::RegionTile> data_and_tile = load_tile_from_file(file_name.toStdString(), tile_id);
             rasters.push_back(rasterize_regions(data_and_tile.second, id_manager, 256, 256, data_and_tile.second.first));
 
-            quad.tiles[idx].data = std::make_shared<QByteArray>(std::move(data_and_tile.first));
+            quad.tiles[idx].data = nucleus::utils::ByteBuffer(std::move(data_and_tile.first));
             quad.tiles[idx].network_info = { nucleus::tile::NetworkInfo::Status::Good, 12345 };
             idx = (idx + 1) % 4;
         }
@@ -313,3 +322,598 @@ TEST_CASE("nucleus/avalanche/Scheduler")
         CHECK(joined.pixel(glm::uvec2(511, 511)) == rasters[3].pixel(glm::uvec2(255, 255)));
     }
 }
+
+namespace {
+// The previous QPainter based implementation of draw_regions (for tile_id_out == tile_id_in), used as a reference for the scanline rasterizer
+radix::Raster<uint16_t> draw_regions_with_qpainter(const nucleus::avalanche::RegionTile& region_tile, nucleus::avalanche::UIntIdManager& id_manager, int size)
+{
+    QImage img(size, size, QImage::Format_ARGB32);
+    img.fill(QColor::fromRgb(0, 0, 0));
+    QPainter painter(&img);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    const QDate ref_date(2025, 7, 1);
+    for (const auto& region : region_tile.second) {
+        if ((region.start_date.has_value() && region.start_date > ref_date) || (region.end_date.has_value() && region.end_date < ref_date))
+            continue;
+        std::vector<QPointF> vertices;
+        for (const auto& v : region.vertices_in_local_coordinates)
+            vertices.emplace_back(v.x * size, v.y * size);
+        const QColor color = id_manager.convert_region_id_to_color(region.id);
+        painter.setBrush(QBrush(color));
+        painter.setPen(QPen(color));
+        painter.drawPolygon(vertices.data(), int(vertices.size()));
+    }
+    painter.end();
+    return nucleus::tile::conversion::qimage_to_u16raster(img);
+}
+
+// raster ids resolved to internal ids for date, like on the gpu
+radix::Raster<uint16_t> resolve_regions(const radix::Raster<uint16_t>& raster, const nucleus::avalanche::UIntIdManager& id_manager, const QDate& date)
+{
+    const auto remap = id_manager.id_remap(date);
+    const auto remap_size = nucleus::avalanche::UIntIdManager::id_remap_size;
+    radix::Raster<uint16_t> resolved(raster.size(), 0);
+    for (unsigned y = 0; y < raster.height(); ++y) {
+        for (unsigned x = 0; x < raster.width(); ++x) {
+            const auto raster_id = raster.pixel({ x, y });
+            resolved.pixel({ x, y }) = remap.pixel({ raster_id % remap_size, raster_id / remap_size });
+        }
+    }
+    return resolved;
+}
+
+// pixels where the whole 3x3 neighbourhood has the same id, i.e., pixels that are not touched by any region boundary
+bool is_interior(const radix::Raster<uint16_t>& raster, unsigned x, unsigned y)
+{
+    if (x == 0 || y == 0 || x + 1 >= raster.width() || y + 1 >= raster.height())
+        return false;
+    for (unsigned j = y - 1; j <= y + 1; ++j) {
+        for (unsigned i = x - 1; i <= x + 1; ++i) {
+            if (raster.pixel({ i, j }) != raster.pixel({ x, y }))
+                return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE("nucleus/avalanche/rasterize_regions")
+{
+    auto id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
+
+    SECTION("matches QPainter")
+    {
+        for (const auto& tile_id : { radix::tile::Id { 2, { 2, 0 }, radix::tile::Scheme::SlippyMap },
+                 radix::tile::Id { 6, { 33, 22 }, radix::tile::Scheme::SlippyMap },
+                 radix::tile::Id { 7, { 67, 45 }, radix::tile::Scheme::SlippyMap } }) {
+            const auto file_name = QString("eaws_%1-%2-%3.mvt").arg(tile_id.zoom_level).arg(tile_id.coords.x).arg(tile_id.coords.y);
+            const auto region_tile = load_tile_from_file(file_name.toStdString(), tile_id).second;
+
+            const auto reference = draw_regions_with_qpainter(region_tile, *id_manager, 256);
+            const auto raster_ids = nucleus::avalanche::rasterize_regions(region_tile, id_manager, 256, 256, tile_id);
+            const auto raster = resolve_regions(raster_ids, *id_manager, QDate(2025, 7, 1));
+            REQUIRE(raster.size() == reference.size());
+
+            // QPainter and the scanline rasterizer treat pixels touched by an edge slightly differently, everything else must be identical
+            unsigned n_interior_mismatches = 0;
+            unsigned n_mismatches = 0;
+            for (unsigned y = 0; y < 256; ++y) {
+                for (unsigned x = 0; x < 256; ++x) {
+                    if (raster.pixel({ x, y }) == reference.pixel({ x, y }))
+                        continue;
+                    ++n_mismatches;
+                    if (is_interior(reference, x, y))
+                        ++n_interior_mismatches;
+                }
+            }
+            CHECK(n_interior_mismatches == 0);
+            CHECK(n_mismatches < 256 * 256 / 50);
+        }
+    }
+
+    SECTION("zoom offsets")
+    {
+        const auto count_mismatches = [](const radix::Raster<uint16_t>& a, const radix::Raster<uint16_t>& b, const glm::uvec2& offset_in_b) {
+            unsigned n = 0;
+            for (unsigned y = 0; y < a.height(); ++y) {
+                for (unsigned x = 0; x < a.width(); ++x)
+                    n += a.pixel({ x, y }) != b.pixel(glm::uvec2(x, y) + offset_in_b);
+            }
+            return n;
+        };
+
+        // a finer output tile is the corresponding part of the input tile at a higher resolution
+        const radix::tile::Id coarse_id { 2, { 2, 0 }, radix::tile::Scheme::SlippyMap };
+        const auto coarse_tile = load_tile_from_file("eaws_2-2-0.mvt", coarse_id).second;
+        const auto coarse = nucleus::avalanche::rasterize_regions(coarse_tile, id_manager, 512, 512, coarse_id);
+        const auto fine = nucleus::avalanche::rasterize_regions(coarse_tile, id_manager, 256, 256, radix::tile::Id { 3, { 5, 1 }, radix::tile::Scheme::SlippyMap });
+        CHECK(count_mismatches(fine, coarse, { 256, 256 }) < 256 * 256 / 1000);
+
+        // a coarser output tile contains the input tile in one of its quarters
+        const radix::tile::Id child_id { 7, { 66, 44 }, radix::tile::Scheme::SlippyMap };
+        const auto child_tile = load_tile_from_file("eaws_7-66-44.mvt", child_id).second;
+        const auto child = nucleus::avalanche::rasterize_regions(child_tile, id_manager, 256, 256, child_id);
+        const auto parent = nucleus::avalanche::rasterize_regions(child_tile, id_manager, 512, 512, child_id.parent());
+        CHECK(count_mismatches(child, parent, { 0, 0 }) < 256 * 256 / 1000);
+    }
+}
+
+TEST_CASE("nucleus/avalanche/rasterize_regions benchmarks")
+{
+    auto id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
+    const radix::tile::Id tile_id { 6, { 33, 22 }, radix::tile::Scheme::SlippyMap };
+    const auto region_tile = load_tile_from_file("eaws_6-33-22.mvt", tile_id).second;
+
+    BENCHMARK("QPainter (previous implementation)") { return draw_regions_with_qpainter(region_tile, *id_manager, 256); };
+    BENCHMARK("scanline rasterizer") { return nucleus::avalanche::rasterize_regions(region_tile, id_manager, 256, 256, tile_id); };
+}
+
+namespace {
+// slippy map tiles at zoom_level covering (roughly) the alps
+std::vector<radix::tile::Id> alpine_tile_ids(unsigned zoom_level)
+{
+    const auto tile_of = [zoom_level](double lat, double lon) {
+        const auto n = double(1u << zoom_level);
+        const auto lat_rad = lat * std::numbers::pi / 180.0;
+        return glm::uvec2(unsigned((lon + 180.0) / 360.0 * n), unsigned((1.0 - std::asinh(std::tan(lat_rad)) / std::numbers::pi) / 2.0 * n));
+    };
+    const auto min = tile_of(48.3, 5.5);
+    const auto max = tile_of(43.8, 16.3);
+    std::vector<radix::tile::Id> ids;
+    for (unsigned y = min.y; y <= max.y; ++y) {
+        for (unsigned x = min.x; x <= max.x; ++x)
+            ids.push_back({ zoom_level, { x, y }, radix::tile::Scheme::SlippyMap });
+    }
+    return ids;
+}
+} // namespace
+
+TEST_CASE("nucleus/avalanche/RegionGeometryCache")
+{
+    auto id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
+    const radix::tile::Id root_id { 0, { 0, 0 }, radix::tile::Scheme::SlippyMap };
+    const auto root_data = load_raw_data_from_file("eaws_0-0-0.mvt");
+
+    SECTION("region index")
+    {
+        using Bounds = nucleus::avalanche::RegionIndex::Bounds;
+        std::vector<Bounds> bounds;
+        for (unsigned i = 0; i < 1000; ++i) {
+            const auto origin = glm::vec2(float((i * 37) % 100), float((i * 91) % 100)) / 100.0f;
+            bounds.push_back({ origin, origin + glm::vec2(0.01f + float(i % 7) * 0.01f) });
+        }
+        const nucleus::avalanche::RegionIndex index(bounds);
+        for (unsigned q = 0; q < 50; ++q) {
+            const auto origin = glm::vec2(float((q * 13) % 50), float((q * 29) % 50)) / 50.0f;
+            const Bounds query { origin, origin + glm::vec2(0.05f + float(q % 5) * 0.05f) };
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < bounds.size(); ++i) {
+                if (bounds[i].min.x <= query.max.x && query.min.x <= bounds[i].max.x && bounds[i].min.y <= query.max.y && query.min.y <= bounds[i].max.y)
+                    expected.push_back(i);
+            }
+            CHECK(index.query(query) == expected);
+        }
+        CHECK(nucleus::avalanche::RegionIndex().query(Bounds { glm::vec2(0), glm::vec2(1) }).empty());
+    }
+
+    SECTION("tiles are parsed once and derived tiles only touch intersecting regions")
+    {
+        nucleus::avalanche::RegionGeometryCache cache;
+        const auto parsed = cache.get_or_parse(root_id, root_data);
+        REQUIRE(parsed);
+        CHECK(cache.get_or_parse(root_id, root_data) == parsed);
+        CHECK(cache.n_tiles() == 1);
+        CHECK(cache.memory_usage() >= parsed->memory_usage);
+        CHECK(parsed->memory_usage > 0);
+
+        CHECK(!cache.get_or_parse({ 1, { 0, 0 }, radix::tile::Scheme::SlippyMap }, QByteArray("not a vector tile")));
+        CHECK(cache.n_tiles() == 1);
+
+        const radix::tile::Id child_id { 7, { 67, 45 }, radix::tile::Scheme::SlippyMap };
+        CHECK(cache.find_ancestor(child_id) == parsed);
+        CHECK(!cache.get(child_id));
+
+        const auto intersecting = parsed->regions_intersecting(child_id);
+        CHECK(!intersecting.empty());
+        CHECK(intersecting.size() < parsed->region_tile.second.size() / 10);
+
+        // same result as drawing all regions
+        radix::Raster<uint16_t> with_index({ 256, 256 }, 0);
+        nucleus::avalanche::draw_regions(*parsed, *id_manager, &with_index, child_id);
+        const auto without_index = nucleus::avalanche::rasterize_regions(parsed->region_tile, id_manager, 256, 256, child_id);
+        CHECK(std::ranges::equal(with_index.buffer(), without_index.buffer()));
+    }
+
+    SECTION("memory bound")
+    {
+        nucleus::avalanche::RegionGeometryCache cache(std::numeric_limits<size_t>::max());
+        const auto root = cache.get_or_parse(root_id, root_data);
+        REQUIRE(root);
+        for (const auto& child : root_id.children())
+            cache.insert(child, root); // accounted once per entry, like separate tiles
+        for (const auto& child : root_id.children())
+            cache.get(child);
+        CHECK(cache.n_tiles() == 5);
+
+        cache.set_memory_limit(root->memory_usage * 2);
+        CHECK(cache.n_tiles() == 2);
+        CHECK(cache.memory_usage() <= cache.memory_limit());
+        CHECK(!cache.get(root_id)); // least recently used is evicted first
+
+        cache.clear();
+        CHECK(cache.n_tiles() == 0);
+        CHECK(cache.memory_usage() == 0);
+    }
+
+    SECTION("scheduler derives tiles without data from a cached ancestor")
+    {
+        nucleus::avalanche::RegionGeometryCache cache;
+        REQUIRE(cache.get_or_parse(root_id, root_data));
+
+        nucleus::tile::DataQuad quad;
+        quad.id = radix::tile::Id { 11, { 1088, 728 }, radix::tile::Scheme::SlippyMap };
+        unsigned idx = 0;
+        for (const auto& tile_id : quad.id.children()) {
+            quad.tiles[idx].id = tile_id;
+            quad.tiles[idx].data = {};
+            quad.tiles[idx].network_info = { nucleus::tile::NetworkInfo::Status::NotFound, 12345 };
+            ++idx;
+        }
+        quad.n_tiles = 4;
+
+        const radix::Raster<glm::uint16> default_raster(glm::uvec2(256, 256), glm::uint16 { 0 });
+        const auto without_cache = nucleus::avalanche::Scheduler::to_raster(quad, default_raster, id_manager);
+        CHECK(std::ranges::all_of(without_cache.buffer(), [](glm::uint16 v) { return v == 0; }));
+
+        const auto with_cache = nucleus::avalanche::Scheduler::to_raster(quad, default_raster, id_manager, &cache);
+        REQUIRE(with_cache.width() == 512);
+        CHECK(std::ranges::any_of(with_cache.buffer(), [](glm::uint16 v) { return v != 0; }));
+    }
+}
+
+// hidden, run with "[benchmark]" explicitly. rasterizes 640 tiles
+TEST_CASE("nucleus/avalanche/RegionGeometryCache benchmarks", "[.][benchmark]")
+{
+    auto id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
+    const radix::tile::Id root_id { 0, { 0, 0 }, radix::tile::Scheme::SlippyMap };
+    const auto root_data = load_raw_data_from_file("eaws_0-0-0.mvt");
+    const auto tile_ids = alpine_tile_ids(10);
+
+    BENCHMARK("parse zoom 0 tile")
+    {
+        return nucleus::avalanche::vector_tile_reader(root_data, root_id).has_value();
+    };
+
+    BENCHMARK("zoom 10 alps, parse for every tile (previous behaviour)")
+    {
+        size_t n = 0;
+        for (const auto& id : tile_ids) {
+            const auto region_tile = nucleus::avalanche::vector_tile_reader(root_data, root_id);
+            n += nucleus::avalanche::rasterize_regions(region_tile.value(), id_manager, 256, 256, id).pixel({ 128, 128 });
+        }
+        return n;
+    };
+
+    BENCHMARK("zoom 10 alps, cached geometry and region index")
+    {
+        nucleus::avalanche::RegionGeometryCache cache;
+        const auto parsed = cache.get_or_parse(root_id, root_data);
+        size_t n = 0;
+        for (const auto& id : tile_ids) {
+            radix::Raster<uint16_t> raster({ 256, 256 }, 0);
+            nucleus::avalanche::draw_regions(*cache.find_ancestor(id), *id_manager, &raster, id);
+            n += raster.pixel({ 128, 128 });
+        }
+        return n;
+    };
+}
+
+TEST_CASE("nucleus/avalanche/region validity")
+{
+    SECTION("interval tree with overlapping intervals")
+    {
+        // synthetic intervals with lots of overlap, some open ended, compared to brute force
+        struct Interval {
+            std::optional<QDate> start;
+            std::optional<QDate> end;
+        };
+        const QDate origin(2020, 1, 1);
+        std::vector<Interval> intervals;
+        nucleus::avalanche::RegionValidityIndex index;
+        for (uint32_t i = 0; i < 500; ++i) {
+            Interval interval;
+            if (i % 11 != 0)
+                interval.start = origin.addDays((i * 37) % 1000);
+            if (i % 7 != 0)
+                interval.end = origin.addDays((i * 37) % 1000 + (i * 13) % 200);
+            intervals.push_back(interval);
+            CHECK(index.insert(i + 1, interval.start, interval.end));
+        }
+        CHECK(index.size() == 500);
+
+        for (int day = -10; day < 1300; day += 3) {
+            const auto date = origin.addDays(day);
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < intervals.size(); ++i) {
+                const auto& [start, end] = intervals[i];
+                if ((!start || *start <= date) && (!end || date <= *end))
+                    expected.push_back(i + 1);
+            }
+            CHECK(index.valid_on(date) == expected);
+            for (const auto id : expected)
+                CHECK(index.is_valid_on(id, date));
+        }
+
+        // start and end are inclusive
+        CHECK(index.is_valid_on(2, origin.addDays(37)));
+        CHECK(!index.is_valid_on(2, origin.addDays(36)));
+
+        // setting the same interval again changes nothing, a different one replaces the old one
+        CHECK(!index.insert(2, intervals[1].start, intervals[1].end));
+        CHECK(index.insert(2, QDate(1990, 1, 1), QDate(1990, 1, 2)));
+        CHECK(index.size() == 500);
+        const auto valid_before = index.valid_on(QDate(1990, 1, 2));
+        const auto valid_after = index.valid_on(origin.addDays(37));
+        CHECK(std::ranges::find(valid_before, 2u) != valid_before.end());
+        CHECK(std::ranges::find(valid_after, 2u) == valid_after.end());
+        CHECK(!index.is_known(1000));
+
+        index.clear();
+        CHECK(index.valid_on(origin).empty());
+    }
+
+    // an outdated region, the two that replaced it (overlapping its area), and one without dates that is covered partially by all of them
+    const auto square = [](glm::vec2 min, glm::vec2 max) { return std::vector<glm::vec2> { min, { max.x, min.y }, max, { min.x, max.y } }; };
+    nucleus::avalanche::RegionTile region_tile;
+    region_tile.first = radix::tile::Id { 0, { 0, 0 }, radix::tile::Scheme::SlippyMap };
+    region_tile.second.push_back({ "XX-00", std::nullopt, std::nullopt, std::nullopt, square({ 0.5f, 0.0f }, { 1.0f, 1.0f }) });
+    region_tile.second.push_back({ "XX-01", std::nullopt, std::nullopt, QDate(2021, 9, 30), square({ 0.0f, 0.0f }, { 0.75f, 1.0f }) });
+    region_tile.second.push_back({ "XX-02", std::nullopt, QDate(2021, 10, 1), std::nullopt, square({ 0.0f, 0.0f }, { 0.75f, 0.5f }) });
+    region_tile.second.push_back({ "XX-03", std::nullopt, QDate(2021, 10, 1), std::nullopt, square({ 0.0f, 0.5f }, { 0.75f, 1.0f }) });
+    const QDate old_date(2021, 1, 1);
+    const QDate new_date(2025, 7, 1);
+
+    SECTION("switching the date only changes the remap")
+    {
+        nucleus::avalanche::UIntIdManager id_manager;
+        radix::Raster<uint16_t> raster({ 64, 64 }, 0);
+        nucleus::avalanche::draw_regions(region_tile, id_manager, &raster, region_tile.first);
+        const auto id_of = [&](const char* region_id) { return id_manager.convert_region_id_to_internal_id(region_id); };
+
+        // the left half is covered by the outdated region and one of its replacements
+        const auto top_left = raster.pixel({ 10, 10 });
+        const auto bottom_left = raster.pixel({ 10, 50 });
+        const auto overlap = raster.pixel({ 40, 10 });
+        const auto right = raster.pixel({ 60, 10 });
+        CHECK(right == id_of("XX-00"));
+        CHECK(id_manager.regions_of(top_left) == std::vector<uint16_t> { uint16_t(id_of("XX-01")), uint16_t(id_of("XX-02")) });
+        CHECK(id_manager.regions_of(overlap) == std::vector<uint16_t> { uint16_t(id_of("XX-00")), uint16_t(id_of("XX-01")), uint16_t(id_of("XX-02")) });
+        CHECK(top_left != bottom_left);
+        CHECK(top_left > id_of("XX-03")); // stack ids are handed out from the top
+
+        CHECK(id_manager.resolve(top_left, old_date) == id_of("XX-01"));
+        CHECK(id_manager.resolve(bottom_left, old_date) == id_of("XX-01"));
+        CHECK(id_manager.resolve(overlap, old_date) == id_of("XX-01"));
+        CHECK(id_manager.resolve(right, old_date) == id_of("XX-00"));
+        CHECK(id_manager.resolve(top_left, new_date) == id_of("XX-02"));
+        CHECK(id_manager.resolve(bottom_left, new_date) == id_of("XX-03"));
+        CHECK(id_manager.resolve(overlap, new_date) == id_of("XX-02"));
+        CHECK(id_manager.resolve(right, new_date) == id_of("XX-00"));
+        CHECK(id_manager.resolve(0, new_date) == 0);
+
+        // before any region existed, only the one without dates remains
+        CHECK(id_manager.resolve(overlap, QDate(1900, 1, 1)) == id_of("XX-00"));
+        CHECK(id_manager.resolve(top_left, QDate(1900, 1, 1)) == 0);
+
+        // the remap is the lookup table of resolve
+        const auto revision = id_manager.revision();
+        for (const auto& date : { old_date, new_date }) {
+            const auto remap = id_manager.id_remap(date);
+            REQUIRE(remap.size() == glm::uvec2(nucleus::avalanche::UIntIdManager::id_remap_size));
+            for (const auto raster_id : { top_left, bottom_left, overlap, right, uint16_t(0) }) {
+                const auto size = nucleus::avalanche::UIntIdManager::id_remap_size;
+                CHECK(remap.pixel({ raster_id % size, raster_id / size }) == id_manager.resolve(raster_id, date));
+            }
+        }
+
+        // drawing the same regions again creates no new ids
+        radix::Raster<uint16_t> raster2({ 64, 64 }, 0);
+        nucleus::avalanche::draw_regions(region_tile, id_manager, &raster2, region_tile.first);
+        CHECK(std::ranges::equal(raster.buffer(), raster2.buffer()));
+        CHECK(id_manager.revision() == revision);
+    }
+
+    SECTION("neighbours are not stacked")
+    {
+        nucleus::avalanche::UIntIdManager id_manager;
+        nucleus::avalanche::RegionTile neighbours;
+        neighbours.first = region_tile.first;
+        neighbours.second.push_back({ "YY-01", std::nullopt, std::nullopt, std::nullopt, square({ 0.0f, 0.0f }, { 0.5f, 1.0f }) });
+        neighbours.second.push_back({ "YY-02", std::nullopt, std::nullopt, std::nullopt, square({ 0.5f, 0.0f }, { 1.0f, 1.0f }) });
+        // a sliver thinner than a pixel inside of YY-02 still shows up
+        neighbours.second.push_back({ "YY-03", std::nullopt, std::nullopt, std::nullopt, square({ 0.8f, 0.2f }, { 0.801f, 0.8f }) });
+        radix::Raster<uint16_t> raster({ 64, 64 }, 0);
+        nucleus::avalanche::draw_regions(neighbours, id_manager, &raster, neighbours.first);
+
+        unsigned n_stacked = 0;
+        for (const auto raster_id : raster.buffer()) {
+            const auto regions = id_manager.regions_of(raster_id);
+            if (regions.size() > 1) {
+                ++n_stacked;
+                CHECK(regions.back() == id_manager.convert_region_id_to_internal_id("YY-03"));
+            }
+        }
+        CHECK(n_stacked > 0);
+        CHECK(raster.pixel({ 10, 10 }) == id_manager.convert_region_id_to_internal_id("YY-01"));
+        CHECK(raster.pixel({ 40, 10 }) == id_manager.convert_region_id_to_internal_id("YY-02"));
+    }
+
+    SECTION("scheduler emits the remap for the reference date")
+    {
+        nucleus::avalanche::Scheduler scheduler(nucleus::tile::Scheduler::Settings {});
+        QSignalSpy spy(&scheduler, &nucleus::avalanche::Scheduler::id_remap_updated);
+        radix::Raster<uint16_t> raster({ 64, 64 }, 0);
+        nucleus::avalanche::draw_regions(region_tile, *scheduler.get_uint_id_manager(), &raster, region_tile.first);
+        const auto top_left = raster.pixel({ 10, 10 });
+        const auto size = nucleus::avalanche::UIntIdManager::id_remap_size;
+        const auto resolve_with_last_remap = [&]() {
+            REQUIRE(spy.count() > 0);
+            const auto remap = spy.takeLast().at(0).value<std::shared_ptr<const radix::Raster<glm::uint16>>>();
+            REQUIRE(remap);
+            return remap->pixel({ top_left % size, top_left / size });
+        };
+
+        scheduler.set_reference_date(old_date);
+        CHECK(resolve_with_last_remap() == scheduler.get_uint_id_manager()->convert_region_id_to_internal_id("XX-01"));
+        scheduler.set_reference_date(new_date);
+        CHECK(resolve_with_last_remap() == scheduler.get_uint_id_manager()->convert_region_id_to_internal_id("XX-02"));
+        scheduler.set_reference_date(new_date);
+        CHECK(spy.count() == 0);
+    }
+}
+
+namespace {
+// The previous implementation of convert_reports_to_ubo, probing -01, -02, .. for every -00 report. Used as a reference.
+nucleus::avalanche::UboEawsReports convert_reports_to_ubo_by_probing(
+    const std::vector<nucleus::avalanche::ReportTUWien>& reports, nucleus::avalanche::UIntIdManager& id_manager)
+{
+    nucleus::avalanche::UboEawsReports ubo;
+    std::fill(std::begin(ubo.reports), std::end(ubo.reports), glm::ivec4(-1, 0, 0, 0));
+    for (const auto& report : reports) {
+        std::vector<QString> new_region_ids;
+        if (report.region_id.endsWith("-00")) {
+            const QString parent_region_id = report.region_id.left(report.region_id.length() - 3);
+            uint i = 1;
+            QString new_region_id = parent_region_id + QString("-01");
+            while (id_manager.contains(new_region_id)) {
+                new_region_ids.push_back(new_region_id);
+                i++;
+                new_region_id = i < 10 ? parent_region_id + QString("-0") + QString::number(i) : parent_region_id + QString("-") + QString::number(i);
+            }
+            if (new_region_ids.empty())
+                new_region_ids.push_back(parent_region_id);
+        } else {
+            new_region_ids.push_back(report.region_id);
+        }
+        for (const QString& new_region_id : new_region_ids)
+            ubo.reports[id_manager.convert_region_id_to_internal_id(new_region_id)]
+                = glm::ivec4(report.unfavorable, report.border, report.rating_lo, report.rating_hi);
+    }
+    return ubo;
+}
+
+// 200 parent regions with 4 sub regions each (reported with -00) and 199 plain regions, i.e., 999 regions in total
+std::pair<std::shared_ptr<nucleus::avalanche::UIntIdManager>, std::vector<nucleus::avalanche::ReportTUWien>> synthetic_report()
+{
+    auto id_manager = std::make_shared<nucleus::avalanche::UIntIdManager>();
+    std::vector<nucleus::avalanche::Region> catalogue;
+    std::vector<nucleus::avalanche::ReportTUWien> reports;
+    for (int parent = 0; parent < 200; ++parent) {
+        const auto parent_id = QString("XX-%1").arg(parent, 3, 10, QChar('0'));
+        for (int sub = 1; sub <= 4; ++sub)
+            catalogue.push_back({ QString("%1-%2").arg(parent_id).arg(sub, 2, 10, QChar('0')) });
+        reports.push_back({ parent_id + "-00", "", "", 1000 + parent, 1 + parent % 5, 1 + parent % 4, parent % 256 });
+    }
+    for (int plain = 0; plain < 199; ++plain) {
+        const auto region_id = QString("YY-%1").arg(plain, 3, 10, QChar('0'));
+        catalogue.push_back({ region_id });
+        reports.push_back({ region_id, "", "", 2000 + plain, 1 + plain % 5, 1 + plain % 3, plain % 128 });
+    }
+    id_manager->register_regions(catalogue);
+    return { id_manager, reports };
+}
+} // namespace
+
+TEST_CASE("nucleus/avalanche/UIntIdManager")
+{
+    nucleus::avalanche::UIntIdManager id_manager;
+    const auto parent = id_manager.convert_region_id_to_internal_id("AT-02-02");
+    const auto sub_1 = id_manager.convert_region_id_to_internal_id("AT-02-02-01");
+    const auto sub_2 = id_manager.convert_region_id_to_internal_id("AT-02-02-02");
+    const auto sub_10 = id_manager.convert_region_id_to_internal_id("AT-02-02-10");
+    id_manager.convert_region_id_to_internal_id("AT-02-02-3"); // not the format of sub regions
+    id_manager.convert_region_id_to_internal_id("AT-02-02-00");
+    const auto other = id_manager.convert_region_id_to_internal_id("CH-1111");
+
+    SECTION("ids are dense and round trip")
+    {
+        CHECK(id_manager.n_internal_ids() == 8);
+        CHECK(id_manager.convert_region_id_to_internal_id("AT-02-02-01") == sub_1);
+        const auto all_ids = id_manager.get_all_registered_region_ids();
+        REQUIRE(all_ids.size() == 8);
+        for (uint i = 0; i < all_ids.size(); ++i) {
+            CHECK(id_manager.convert_internal_id_to_region_id(i) == all_ids[i]);
+            CHECK(id_manager.convert_color_to_internal_id(id_manager.convert_region_id_to_color(all_ids[i])) == i);
+            CHECK(id_manager.convert_color_to_region_id(id_manager.convert_region_id_to_color(all_ids[i])) == all_ids[i]);
+        }
+        CHECK(id_manager.convert_internal_id_to_region_id(1000) == "");
+        CHECK(id_manager.convert_color_to_internal_id(QColor::fromRgb(3, 0, 0)) == 0);
+    }
+
+    SECTION("sub region index")
+    {
+        const auto subs = id_manager.sub_regions_of("AT-02-02");
+        CHECK(std::vector<uint>(subs.begin(), subs.end()) == std::vector<uint> { sub_1, sub_2, sub_10 });
+        const auto subs_of_at02 = id_manager.sub_regions_of("AT-02");
+        CHECK(std::vector<uint>(subs_of_at02.begin(), subs_of_at02.end()) == std::vector<uint> { parent });
+        CHECK(id_manager.sub_regions_of("CH").empty()); // 4 digits are region numbers, not sub regions
+        CHECK(id_manager.sub_regions_of("AT-02-02-01").empty());
+        CHECK(other > 0);
+    }
+
+    SECTION("running out of stack ids keeps the pixel")
+    {
+        std::vector<uint> ids;
+        for (int i = 0; i < 300; ++i)
+            ids.push_back(id_manager.convert_region_id_to_internal_id(QString("XX-%1").arg(i + 1000)));
+        const auto max_internal_id = ids.back();
+
+        bool exhausted = false;
+        for (size_t a = 0; a < ids.size() && !exhausted; ++a) {
+            for (size_t b = 0; b < ids.size() && !exhausted; ++b) {
+                if (a == b)
+                    continue;
+                const auto stacked = id_manager.stack_region(uint16_t(ids[a]), ids[b]);
+                exhausted = stacked == ids[a];
+                if (!exhausted)
+                    REQUIRE(stacked > max_internal_id); // stack ids never collide with internal ids
+            }
+        }
+        CHECK(exhausted);
+        // known stacks are still found, internal ids are untouched
+        CHECK(id_manager.regions_of(id_manager.stack_region(uint16_t(ids[0]), ids[1])) == std::vector<uint16_t> { uint16_t(ids[0]), uint16_t(ids[1]) });
+        CHECK(id_manager.regions_of(uint16_t(max_internal_id)) == std::vector<uint16_t> { uint16_t(max_internal_id) });
+    }
+
+    SECTION("reports")
+    {
+        nucleus::avalanche::ReportTUWien parent_report { "AT-02-02-00", "", "", 2400, 2, 1, 225 };
+        nucleus::avalanche::ReportTUWien plain_report { "CH-1111", "", "", 1800, 3, 2, 7 };
+        nucleus::avalanche::ReportTUWien unknown_parent_report { "FR-64-00", "", "", 2000, 4, 3, 1 };
+        const auto ubo = nucleus::avalanche::convert_reports_to_ubo({ parent_report, plain_report, unknown_parent_report }, id_manager);
+        CHECK(ubo.reports[0].x == -1);
+        CHECK(ubo.reports[parent].x == -1);
+        for (const auto id : { sub_1, sub_2, sub_10 })
+            CHECK(ubo.reports[id] == glm::ivec4(225, 2400, 1, 2));
+        CHECK(ubo.reports[other] == glm::ivec4(7, 1800, 2, 3));
+        // reports for unknown parents go to the parent itself
+        CHECK(ubo.reports[id_manager.convert_region_id_to_internal_id("FR-64")] == glm::ivec4(1, 2000, 3, 4));
+    }
+
+    SECTION("synthetic report matches probing")
+    {
+        const auto [synthetic_id_manager, reports] = synthetic_report();
+        CHECK(synthetic_id_manager->n_internal_ids() == 1000);
+        const auto expected = convert_reports_to_ubo_by_probing(reports, *synthetic_id_manager);
+        const auto ubo = nucleus::avalanche::convert_reports_to_ubo(reports, *synthetic_id_manager);
+        CHECK(std::ranges::equal(ubo.reports, expected.reports));
+        CHECK(std::ranges::none_of(std::span(ubo.reports).subspan(1, 999), [](const glm::ivec4& r) { return r.x == -1; }));
+    }
+}
+
+TEST_CASE("nucleus/avalanche/convert_reports_to_ubo benchmarks")
+{
+    const auto [id_manager, reports] = synthetic_report();
+    BENCHMARK("1000 regions, probing sub regions (previous implementation)") { return convert_reports_to_ubo_by_probing(reports, *id_manager).reports[1]; };
+    BENCHMARK("1000 regions, sub region index") { return nucleus::avalanche::convert_reports_to_ubo(reports, *id_manager).reports[1]; };
+}
@@ -51,7 +51,7 @@ DataQuad example_tile_quad_for(const Id& id, float altitude)
     const auto altitude_tile = png_tile(64, altitude);
     for (unsigned i = 0; i < 4; ++i) {
         cpu_quad.tiles[i].id = children[i];
-        cpu_quad.tiles[i].data = std::make_shared<QByteArray>(altitude_tile);
+        cpu_quad.tiles[i].data = nucleus::utils::ByteBuffer(altitude_tile);
         cpu_quad.tiles[i].network_info.status = NetworkInfo::Status::Good;
         cpu_quad.tiles[i].network_info.timestamp = nucleus::utils::time_since_epoch();
     }
@@ -26,6 +26,7 @@
 #include <CDT.h>
 
 #include <algorithm>
+#include <cmath>
 #include <radix/raster.h>
 #include "nucleus/tile/conversion.h"
 #include "nucleus/utils/rasterizer.h"
@@ -168,6 +169,39 @@ QImage example_rasterizer_image(const QString& filename)
     REQUIRE(!QImage::fromData(image_bytes).isNull());
     return QImage::fromData(image_bytes);
 }
+
+/*
+ * reference for fill_polygon: tests every pixel centre against every edge
+ */
+radix::Raster<uint8_t> fill_polygon_reference(
+    const std::vector<std::vector<glm::vec2>>& rings, const glm::uvec2& size, nucleus::utils::rasterizer::FillRule fill_rule)
+{
+    radix::Raster<uint8_t> output(size, 0u);
+    for (unsigned y = 0; y < size.y; ++y) {
+        for (unsigned x = 0; x < size.x; ++x) {
+            const auto p = glm::vec2(x + 0.5f, y + 0.5f);
+            int crossings = 0;
+            int winding = 0;
+            for (const auto& ring : rings) {
+                for (size_t i = 0; i < ring.size(); ++i) {
+                    const auto a = ring[i];
+                    const auto b = ring[(i + 1) % ring.size()];
+                    if ((a.y <= p.y) == (b.y <= p.y))
+                        continue;
+                    const float x_at_y = a.x + (p.y - a.y) / (b.y - a.y) * (b.x - a.x);
+                    if (x_at_y <= p.x) {
+                        ++crossings;
+                        winding += (a.y < b.y) ? 1 : -1;
+                    }
+                }
+            }
+            const bool inside = (fill_rule == nucleus::utils::rasterizer::FillRule::EvenOdd) ? (crossings & 1) : (winding != 0);
+            if (inside)
+                output.pixel({ x, y }) = 255;
+        }
+    }
+    return output;
+}
 } // namespace
 
 TEST_CASE("nucleus/rasterizer")
@@ -981,7 +1015,62 @@ TEST_CASE("nucleus/rasterizer")
         image.save(QString("rasterizer_output_line_diagonal_enlarged.png"));
 #endif
     }
+
+    SECTION("fill polygon even-odd and non-zero")
+    {
+        using nucleus::utils::rasterizer::FillRule;
+        // pentagram: the inner pentagon is inside for non-zero, but outside for even-odd
+        std::vector<glm::vec2> star;
+        for (int i = 0; i < 5; ++i) {
+            const float angle = float(i) * 4.0f * 3.14159265f / 5.0f;
+            star.push_back(glm::vec2(32.3f + 28.1f * std::sin(angle), 32.7f - 28.1f * std::cos(angle)));
+        }
+        // donut, where the hole has the same orientation as the outline
+        const std::vector<std::vector<glm::vec2>> donut = { { glm::vec2(10.2, 10.3), glm::vec2(50.7, 10.4), glm::vec2(50.6, 50.9), glm::vec2(10.1, 50.8) },
+            { glm::vec2(20.2, 20.3), glm::vec2(40.7, 20.4), glm::vec2(40.6, 40.9), glm::vec2(20.1, 40.8) } };
+
+        for (const auto fill_rule : { FillRule::EvenOdd, FillRule::NonZero }) {
+            for (const auto& rings : { std::vector<std::vector<glm::vec2>> { star }, donut }) {
+                radix::Raster<uint8_t> output({ 64, 64 }, 0u);
+                const auto pixel_writer = [&output](glm::ivec2 pos) { output.pixel(pos) = 255; };
+                nucleus::utils::rasterizer::fill_polygon(pixel_writer, rings, { 64, 64 }, fill_rule);
+
+                const auto reference = fill_polygon_reference(rings, { 64, 64 }, fill_rule);
+                CHECK(std::ranges::equal(output.buffer(), reference.buffer()));
+            }
+        }
+
+        radix::Raster<uint8_t> even_odd({ 64, 64 }, 0u);
+        nucleus::utils::rasterizer::fill_polygon([&](glm::ivec2 pos) { even_odd.pixel(pos) = 255; }, donut, { 64, 64 }, FillRule::EvenOdd);
+        CHECK(even_odd.pixel({ 30, 30 }) == 0);
+        radix::Raster<uint8_t> non_zero({ 64, 64 }, 0u);
+        nucleus::utils::rasterizer::fill_polygon([&](glm::ivec2 pos) { non_zero.pixel(pos) = 255; }, donut, { 64, 64 }, FillRule::NonZero);
+        CHECK(non_zero.pixel({ 30, 30 }) == 255);
+        CHECK(non_zero.pixel({ 15, 15 }) == 255);
+        CHECK(non_zero.pixel({ 5, 5 }) == 0);
+    }
+
+    SECTION("fill polygon shared edges and clipping")
+    {
+        // two polygons sharing edges must cover every pixel exactly once, also when they extend beyond the raster
+        const std::vector<glm::vec2> left = { glm::vec2(-20, -10), glm::vec2(30.25, -10), glm::vec2(40.75, 80), glm::vec2(-20, 80) };
+        const std::vector<glm::vec2> right = { glm::vec2(30.25, -10), glm::vec2(90, -10), glm::vec2(90, 80), glm::vec2(40.75, 80) };
+        radix::Raster<uint8_t> output({ 64, 48 }, 0u);
+        const auto pixel_writer = [&output](glm::ivec2 pos, unsigned int data) {
+            REQUIRE(pos.x >= 0);
+            REQUIRE(pos.y >= 0);
+            REQUIRE(pos.x < 64);
+            REQUIRE(pos.y < 48);
+            output.pixel(pos) += uint8_t(data);
+        };
+        nucleus::utils::rasterizer::fill_polygon(pixel_writer, left, { 64, 48 }, nucleus::utils::rasterizer::FillRule::EvenOdd, 1);
+        nucleus::utils::rasterizer::fill_polygon(pixel_writer, right, { 64, 48 }, nucleus::utils::rasterizer::FillRule::EvenOdd, 2);
+        CHECK(std::ranges::all_of(output.buffer(), [](uint8_t v) { return v == 1 || v == 2; }));
+        CHECK(output.pixel({ 0, 0 }) == 1);
+        CHECK(output.pixel({ 63, 47 }) == 2);
+    }
 }
+
 TEST_CASE("nucleus/utils/rasterizer benchmarks")
 {
 
@@ -1050,4 +1139,18 @@ TEST_CASE("nucleus/utils/rasterizer benchmarks")
         const auto pixel_writer = [](glm::ivec2) { /*do nothing*/ };
         rasterize_triangle_sdf(pixel_writer, triangles, 5.0);
     };
+
+    BENCHMARK("Fill polygon")
+    {
+        std::vector<glm::vec2> polygon;
+        for (int i = 0; i < 500; ++i) {
+            const float angle = float(i) / 500.0f * 2.0f * 3.14159265f;
+            const float radius = 100.0f + 20.0f * std::sin(angle * 37.0f);
+            polygon.push_back(glm::vec2(128.0f + radius * std::cos(angle), 128.0f + radius * std::sin(angle)));
+        }
+        radix::Raster<uint16_t> output({ 256, 256 }, 0u);
+        const auto pixel_writer = [&output](glm::ivec2 pos, unsigned int id) { output.pixel(pos) = uint16_t(id); };
+        nucleus::utils::rasterizer::fill_polygon(pixel_writer, polygon, { 256, 256 }, nucleus::utils::rasterizer::FillRule::EvenOdd, 42);
+        return output.pixel({ 128, 128 });
+    };
 }
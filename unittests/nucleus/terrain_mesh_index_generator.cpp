@@ -19,6 +19,59 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "nucleus/utils/terrain_mesh_index_generator.h"
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <unordered_set>
+
+namespace {
+using namespace nucleus::utils::terrain_mesh_index_generator;
+
+enum class CacheType { Fifo, Lru };
+
+struct CacheStatistics {
+    double acmr = 0; // average cache miss ratio, vertex shader invocations per triangle (0.5 is optimal for large grids)
+    double atvr = 0; // average transformed vertex ratio, vertex shader invocations per vertex (1 is optimal)
+};
+
+// simulated post transform vertex cache. fifo is how most (also tile based mobile) gpus behave, lru is the upper bound.
+template <typename Index> CacheStatistics simulate_vertex_cache(const std::vector<Index>& indices, bool is_strip, CacheType type, unsigned cache_size)
+{
+    std::deque<Index> cache;
+    size_t n_misses = 0;
+    for (const auto index : indices) {
+        const auto it = std::find(cache.begin(), cache.end(), index);
+        if (it != cache.end()) {
+            if (type == CacheType::Lru) {
+                cache.erase(it);
+                cache.push_front(index);
+            }
+            continue;
+        }
+        n_misses++;
+        cache.push_front(index);
+        if (cache.size() > cache_size)
+            cache.pop_back();
+    }
+    const auto n_triangles = (is_strip ? strip_to_triangles(indices) : indices).size() / 3;
+    const auto n_vertices = std::unordered_set<Index>(indices.begin(), indices.end()).size();
+    return { double(n_misses) / double(n_triangles), double(n_misses) / double(n_vertices) };
+}
+
+// triangles rotated so that the smallest index comes first (keeps the winding) and sorted, for comparing lists in different orders
+template <typename Index> std::vector<std::array<Index, 3>> canonical(const std::vector<Index>& triangles)
+{
+    std::vector<std::array<Index, 3>> result;
+    for (size_t i = 0; i < triangles.size(); i += 3) {
+        std::array<Index, 3> t = { triangles[i], triangles[i + 1], triangles[i + 2] };
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+} // namespace
 
 TEST_CASE("nucleus/utils/terrain_mesh_index_generator")
 {
@@ -52,4 +105,124 @@ TEST_CASE("nucleus/utils/terrain_mesh_index_generator")
         CHECK(indices == std::vector({0, 3,  1, 4,  2, 5,  5, 3,  3, 6,  4, 7,  5, 8,  8, 9,
                                       5, 10, 2, 11, 1, 12, 0, 13, 3, 14, 6, 15, 7, 16, 8, 9}));
     }
+    SECTION("surface quads with stride")
+    {
+        // stride 2 on a 5x5 grid uses the corner and centre vertices, same strip as for a 3x3 grid
+        const auto indices = surface_quads<int>(5, 2);
+        CHECK(indices == std::vector({ 0, 10, 2, 12, 4, 14, 14, 10, 10, 20, 12, 22, 14, 24 }));
+        CHECK(surface_quads<int>(5, 4) == std::vector({ 0, 20, 4, 24 }));
+        CHECK(surface_quads<int>(5, 1) == surface_quads<int>(5));
+    }
+    SECTION("surface quads with curtains and stride")
+    {
+        // the curtain vertices are those of the full 5x5 grid (25 + 4 per edge), below the used edge vertices
+        const auto indices = surface_quads_with_curtains<int>(5, 2);
+        CHECK(indices == std::vector({ 0, 10, 2, 12, 4, 14, 14, 10, 10, 20, 12, 22, 14, 24, 24, 25,
+                                       14, 27, 4, 29, 2, 31, 0, 33, 10, 35, 20, 37, 22, 39, 24, 25 }));
+        CHECK(surface_quads_with_curtains<int>(65, 1) == surface_quads_with_curtains<int>(65));
+        for (const auto stride : { 2u, 4u, 8u }) {
+            CAPTURE(stride);
+            const auto coarse = surface_quads_with_curtains<uint16_t>(65, stride);
+            CHECK(coarse.size() < surface_quads_with_curtains<uint16_t>(65, stride / 2).size());
+            for (const auto index : coarse) {
+                CHECK(index < 65 * 65 + 4 * 64);
+                if (index < 65 * 65) {
+                    CHECK((index / 65) % stride == 0);
+                    CHECK((index % 65) % stride == 0);
+                }
+            }
+        }
+    }
+    SECTION("strip to triangles")
+    {
+        CHECK(strip_to_triangles(surface_quads<int>(2)) == std::vector({ 0, 2, 1, 1, 2, 3 }));
+        // degenerate triangles between the rows are dropped
+        CHECK(strip_to_triangles(surface_quads<int>(3)).size() == 8 * 3);
+    }
+    SECTION("surface triangles")
+    {
+        CHECK(surface_triangles<int>(2) == std::vector({ 0, 2, 1, 1, 2, 3 }));
+        CHECK(surface_triangles<int>(17) == strip_to_triangles(surface_quads<int>(17)));
+        CHECK(surface_triangles<int>(17, QuadOrder::RowMajor, 4) == strip_to_triangles(surface_quads<int>(17, 4)));
+        // same triangles and winding in every order, also if the grid size is not a power of two
+        for (const auto n : { 65u, 23u }) {
+            CAPTURE(n);
+            const auto reference = canonical(surface_triangles_with_curtains<uint16_t>(n));
+            CHECK(reference == canonical(strip_to_triangles(surface_quads_with_curtains<uint16_t>(n))));
+            CHECK(canonical(surface_triangles_with_curtains<uint16_t>(n, QuadOrder::Morton)) == reference);
+            CHECK(canonical(surface_triangles_with_curtains<uint16_t>(n, QuadOrder::Hilbert)) == reference);
+            CHECK(canonical(optimise_vertex_cache(surface_triangles_with_curtains<uint16_t>(n))) == reference);
+        }
+        // hilbert neighbours share an edge
+        const auto hilbert = surface_triangles<int>(9, QuadOrder::Hilbert);
+        for (size_t i = 6; i < hilbert.size(); i += 6) {
+            const auto previous_quad = std::unordered_set<int>(hilbert.begin() + std::ptrdiff_t(i) - 6, hilbert.begin() + std::ptrdiff_t(i));
+            const auto n_shared = std::count_if(hilbert.begin() + std::ptrdiff_t(i), hilbert.begin() + std::ptrdiff_t(i) + 3, [&](int v) { return previous_quad.contains(v); });
+            CHECK(n_shared >= 1);
+        }
+    }
+    SECTION("meshlets")
+    {
+        const auto triangles = surface_triangles_with_curtains<uint16_t>(65, QuadOrder::Hilbert);
+        const auto result = meshlets(triangles, 64, 124);
+        std::vector<uint16_t> reconstructed;
+        for (const auto& meshlet : result.meshlets) {
+            CHECK(meshlet.vertex_count <= 64);
+            CHECK(meshlet.triangle_count <= 124);
+            CHECK(meshlet.triangle_count > 0);
+            for (unsigned i = 0; i < meshlet.triangle_count * 3; i++) {
+                const auto local = result.triangles[(meshlet.triangle_offset * 3) + i];
+                REQUIRE(local < meshlet.vertex_count);
+                reconstructed.push_back(result.vertices[meshlet.vertex_offset + local]);
+            }
+        }
+        CHECK(reconstructed == triangles);
+        // hilbert order gives compact meshlets, with far fewer vertices than 3 per triangle
+        CHECK(double(result.vertices.size()) / double(triangles.size() / 3) < 0.8);
+    }
+}
+
+TEST_CASE("nucleus/utils/terrain_mesh_index_generator vertex cache")
+{
+    struct Generator {
+        QString name;
+        std::vector<uint16_t> indices;
+        bool is_strip = false;
+    };
+    std::vector<Generator> generators;
+    generators.push_back({ "strip", surface_quads_with_curtains<uint16_t>(65), true });
+    generators.push_back({ "row major list", surface_triangles_with_curtains<uint16_t>(65) });
+    generators.push_back({ "morton list", surface_triangles_with_curtains<uint16_t>(65, QuadOrder::Morton) });
+    generators.push_back({ "hilbert list", surface_triangles_with_curtains<uint16_t>(65, QuadOrder::Hilbert) });
+    generators.push_back({ "forsyth list", optimise_vertex_cache(surface_triangles_with_curtains<uint16_t>(65)) });
+    generators.push_back({ "forsyth list (16)", optimise_vertex_cache(surface_triangles_with_curtains<uint16_t>(65), 16) });
+
+    const auto stats = [&](const Generator& g, CacheType type, unsigned size) { return simulate_vertex_cache(g.indices, g.is_strip, type, size); };
+    for (const auto& g : generators) {
+        QString line = QString("%1:").arg(g.name, -20);
+        for (const auto size : { 16u, 32u }) {
+            const auto fifo = stats(g, CacheType::Fifo, size);
+            const auto lru = stats(g, CacheType::Lru, size);
+            line += QString(" fifo%1 acmr %2 atvr %3 | lru%1 acmr %4 atvr %5 |")
+                        .arg(size)
+                        .arg(fifo.acmr, 0, 'f', 3)
+                        .arg(fifo.atvr, 0, 'f', 3)
+                        .arg(lru.acmr, 0, 'f', 3)
+                        .arg(lru.atvr, 0, 'f', 3);
+            CHECK(fifo.atvr >= 1.0);
+            CHECK(lru.atvr >= 1.0);
+        }
+        qDebug().noquote() << line;
+    }
+    const auto& strip = generators[0];
+    const auto& row_major = generators[1];
+    const auto& hilbert = generators[3];
+    const auto& forsyth = generators[4];
+    // a 65 vertex row doesn't fit into the cache, every vertex is transformed twice
+    CHECK(stats(strip, CacheType::Fifo, 32).atvr > 1.9);
+    CHECK(stats(row_major, CacheType::Fifo, 32).atvr > 1.9);
+    CHECK(stats(hilbert, CacheType::Fifo, 32).acmr < stats(row_major, CacheType::Fifo, 32).acmr);
+    CHECK(stats(forsyth, CacheType::Fifo, 32).acmr < stats(strip, CacheType::Fifo, 32).acmr);
+    // the curves need a large cache, forsyth is almost as good with a small one
+    CHECK(stats(forsyth, CacheType::Fifo, 16).acmr < stats(hilbert, CacheType::Fifo, 16).acmr);
 }
@@ -352,6 +352,42 @@ TEST_CASE("nucleus/tile/cache")
         std::filesystem::remove_all(path);
     }
 
+    SECTION("data quads are read back from disk without copying the tiles")
+    {
+        const auto path = std::filesystem::path(QStandardPaths::writableLocation(QStandardPaths::CacheLocation).toStdString()) / "test_tile_cache";
+        std::filesystem::remove_all(path);
+        const auto id = Id { 3, { 2, 5 } };
+        DataQuad quad { id, 4, {} };
+        for (unsigned i = 0; i < 4; ++i) {
+            const auto child_id = id.children()[i];
+            quad.tiles[i] = { child_id, { NetworkInfo::Status::Good, 7 }, nucleus::utils::ByteBuffer(QByteArray(int(100 * i), char('a' + i))) };
+        }
+        {
+            MemoryCache cache;
+            cache.insert(quad);
+            REQUIRE(cache.write_to_disk(path).has_value());
+        }
+        {
+            MemoryCache cache;
+            REQUIRE(cache.read_from_disk(path).has_value());
+            REQUIRE(cache.contains(id));
+            const auto& read_quad = cache.peak_at(id);
+            CHECK(read_quad.n_tiles == 4);
+            for (unsigned i = 0; i < 4; ++i) {
+                CHECK(read_quad.tiles[i].id == quad.tiles[i].id);
+                CHECK(read_quad.tiles[i].network_info.status == NetworkInfo::Status::Good);
+                CHECK(read_quad.tiles[i].data == quad.tiles[i].data);
+                CHECK(read_quad.tiles[i].data.n_copied_bytes() == 0);
+            }
+            // the tiles are slices of the file buffer, only separated by the serialised ids and network infos
+            for (unsigned i = 2; i < 4; ++i) {
+                CHECK(read_quad.tiles[i].data.data() > read_quad.tiles[i - 1].data.end());
+                CHECK(read_quad.tiles[i].data.data() - read_quad.tiles[i - 1].data.end() < 64);
+            }
+        }
+        std::filesystem::remove_all(path);
+    }
+
     SECTION("write to disk and read back itteratively") {
         const auto path = std::filesystem::path(QStandardPaths::writableLocation(QStandardPaths::CacheLocation).toStdString()) / "test_tile_cache";
         std::filesystem::remove_all(path);
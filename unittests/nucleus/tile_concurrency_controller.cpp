@@ -0,0 +1,227 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <QSignalSpy>
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+
+#include "TestTileServer.h"
+#include "nucleus/tile/ConcurrencyController.h"
+#include "nucleus/tile/QuadAssembler.h"
+#include "nucleus/tile/RateLimiter.h"
+#include "nucleus/tile/SlotBudget.h"
+#include "nucleus/tile/SlotLimiter.h"
+#include "nucleus/tile/TextureScheduler.h"
+#include "nucleus/tile/TileLoadService.h"
+#include "nucleus/tile/pipeline.h"
+#include "test_helpers.h"
+
+using namespace nucleus::tile;
+
+namespace {
+// feeds one window of reports (one per slot) with the given latency
+void feed_window(ConcurrencyController* controller, unsigned latency_msecs, float failure_rate = 0)
+{
+    static uint64_t clock = 1'000'000;
+    const auto n = std::max(controller->settings().min_window_size, controller->state().slot_limit);
+    const auto n_failed = unsigned(float(n) * failure_rate);
+    for (unsigned i = 0; i < n; ++i) {
+        clock += 5;
+        controller->report({ .started_at = clock, .finished_at = clock + latency_msecs, .n_bytes = 10'000, .n_tiles = 1, .failed = i < n_failed });
+    }
+}
+} // namespace
+
+TEST_CASE("nucleus/tile/ConcurrencyController")
+{
+    SECTION("increases additively on a healthy link, up to the maximum")
+    {
+        ConcurrencyController controller;
+        QSignalSpy slot_spy(&controller, &ConcurrencyController::slot_limit_changed);
+        QSignalSpy rate_spy(&controller, &ConcurrencyController::rate_limit_changed);
+        QSignalSpy state_spy(&controller, &ConcurrencyController::state_changed);
+        const auto initial = controller.state();
+
+        feed_window(&controller, 30);
+        CHECK(state_spy.size() == 1);
+        REQUIRE(slot_spy.size() == 1);
+        CHECK(slot_spy[0][0].toUInt() == initial.slot_limit + controller.settings().slot_increase);
+        REQUIRE(rate_spy.size() == 1);
+        CHECK(rate_spy[0][0].toUInt() == initial.rate_limit + controller.settings().rate_increase);
+        CHECK(rate_spy[0][1].toUInt() == 1000);
+
+        for (int i = 0; i < 100; ++i)
+            feed_window(&controller, 30);
+        CHECK(controller.state().slot_limit == controller.settings().max_slots);
+        CHECK(controller.state().rate_limit == controller.settings().max_rate);
+        CHECK(controller.state().n_decreases == 0);
+        CHECK(controller.state().min_latency_msecs == 30);
+        CHECK(controller.state().latency_msecs == 30);
+        CHECK(controller.state().failure_rate == 0);
+        CHECK(controller.state().bytes_per_second > 0);
+    }
+
+    SECTION("decreases multiplicatively on failures, down to the minimum")
+    {
+        ConcurrencyController controller;
+        feed_window(&controller, 30);
+        const auto before = controller.state().slot_limit;
+        feed_window(&controller, 30, 0.5f);
+        CHECK(controller.state().slot_limit == unsigned(float(before) * controller.settings().decrease_factor));
+        CHECK(controller.state().failure_rate > 0.4f);
+
+        for (int i = 0; i < 20; ++i)
+            feed_window(&controller, 30, 0.5f);
+        CHECK(controller.state().slot_limit == controller.settings().min_slots);
+        CHECK(controller.state().rate_limit == controller.settings().min_rate);
+    }
+
+    SECTION("settles where the latency starts to grow (queuing)")
+    {
+        ConcurrencyController controller;
+        // the link is saturated beyond 20 slots, further requests queue up and increase the latency
+        const auto latency = [](unsigned slots) { return 30 + 10 * (std::max(slots, 20u) - 20); };
+        for (int i = 0; i < 200; ++i)
+            feed_window(&controller, latency(controller.state().slot_limit));
+
+        // 2 * 30ms + 20ms slack is reached at 25 slots
+        CHECK(controller.state().slot_limit >= 15);
+        CHECK(controller.state().slot_limit <= 30);
+        CHECK(controller.state().n_increases > 0);
+        CHECK(controller.state().n_decreases > 0);
+    }
+
+    SECTION("bounds are configurable")
+    {
+        ConcurrencyController controller;
+        QSignalSpy slot_spy(&controller, &ConcurrencyController::slot_limit_changed);
+        auto settings = controller.settings();
+        settings.min_slots = 2;
+        settings.max_slots = 8;
+        settings.max_rate = 50;
+        controller.set_settings(settings);
+        CHECK(controller.state().slot_limit == 8);
+        CHECK(controller.state().rate_limit == 50);
+        REQUIRE(slot_spy.size() == 1);
+        CHECK(slot_spy[0][0].toUInt() == 8);
+
+        for (int i = 0; i < 20; ++i)
+            feed_window(&controller, 30);
+        CHECK(controller.state().slot_limit == 8);
+        for (int i = 0; i < 20; ++i)
+            feed_window(&controller, 30, 1.0f);
+        CHECK(controller.state().slot_limit == 2);
+    }
+
+    SECTION("bounds reach the controllers of a pipeline")
+    {
+        auto budget_settings = SlotBudget::default_controller_settings();
+        budget_settings.max_slots = 10;
+        auto budget = std::make_shared<SlotBudget>(budget_settings);
+        CHECK(budget->limit() == 10);
+
+        TextureScheduler scheduler(Scheduler::Settings {});
+        TileLoadService service("http://127.0.0.1/", TileLoadService::UrlPattern::ZXY, ".png");
+        nucleus::tile::setup::build_pipeline(&scheduler, &service, nullptr, { budget, 1.0f, { .min_rate = 10, .max_rate = 50 } });
+        auto* controller = scheduler.findChild<ConcurrencyController*>();
+        REQUIRE(controller);
+        CHECK(controller->state().rate_limit == 50);
+        CHECK(scheduler.network_settings().max_rate == 50);
+
+        auto settings = scheduler.network_settings();
+        settings.max_rate = 30;
+        scheduler.set_network_settings(settings);
+        CHECK(controller->state().rate_limit == 30);
+
+        budget_settings.min_slots = 40;
+        budget_settings.max_slots = 64;
+        budget->set_controller_settings(budget_settings);
+        CHECK(budget->limit() == 40);
+
+        // joining the budget is queued
+        test_helpers::process_events_for(1);
+        CHECK(budget->n_layers() == 1);
+        CHECK(scheduler.statistics().network.slot_limit == 40);
+    }
+}
+
+namespace {
+struct Pipeline {
+    SlotLimiter sl;
+    RateLimiter rl;
+    QuadAssembler qa;
+    ConcurrencyController cc;
+    TileLoadService service;
+    unsigned n_quads_delivered = 0;
+
+    explicit Pipeline(const unittests::TestTileServer& server)
+        : service(server.tile_url(), TileLoadService::UrlPattern::ZXY, ".png")
+    {
+        QObject::connect(&sl, &SlotLimiter::quad_requested, &rl, &RateLimiter::request_quad);
+        QObject::connect(&rl, &RateLimiter::quad_requested, &qa, &QuadAssembler::load);
+        QObject::connect(&qa, &QuadAssembler::tile_requested, &service, &TileLoadService::load);
+        QObject::connect(&service, &TileLoadService::load_finished, &qa, &QuadAssembler::deliver_tile);
+        QObject::connect(&qa, &QuadAssembler::quad_loaded, &sl, &SlotLimiter::deliver_quad);
+        QObject::connect(&sl, &SlotLimiter::quad_delivered, [this]() { n_quads_delivered++; });
+        QObject::connect(&service, &TileLoadService::request_finished, &cc, &ConcurrencyController::report);
+        QObject::connect(&cc, &ConcurrencyController::slot_limit_changed, &sl, &SlotLimiter::set_limit);
+        QObject::connect(&cc, &ConcurrencyController::rate_limit_changed, &rl, &RateLimiter::set_limit);
+    }
+    void request(unsigned n_quads)
+    {
+        std::vector<Id> quads;
+        for (unsigned i = 0; i < n_quads; ++i)
+            quads.push_back(Id { 10, { 500 + i % 32, 300 + i / 32 } });
+        sl.request_quads(quads);
+    }
+};
+} // namespace
+
+TEST_CASE("nucleus/tile/ConcurrencyController with local server")
+{
+    SECTION("fast link")
+    {
+        unittests::TestTileServer server({ .tile_size = 10'000 });
+        Pipeline pipeline(server);
+        pipeline.request(256);
+        for (int i = 0; i < 100 && pipeline.n_quads_delivered < 256; ++i)
+            test_helpers::process_events_for(50);
+        CHECK(pipeline.n_quads_delivered == 256);
+        CHECK(pipeline.cc.state().n_increases > 0);
+        CHECK(pipeline.sl.limit() > 16);
+        CHECK(pipeline.rl.limit().first > 100);
+        CHECK(pipeline.sl.limit() <= pipeline.cc.settings().max_slots);
+    }
+
+    SECTION("congested link (injected latency and bandwidth cap)")
+    {
+        // 40ms per tile on the link, 64 tiles in flight initially => the last ones wait for more than 2 seconds
+        unittests::TestTileServer server({ .latency_ms = 20, .bandwidth = 100'000, .tile_size = 4'000 });
+        Pipeline pipeline(server);
+        QSignalSpy state_spy(&pipeline.cc, &ConcurrencyController::state_changed);
+        pipeline.request(64);
+        for (int i = 0; i < 100 && pipeline.cc.state().n_decreases == 0; ++i)
+            test_helpers::process_events_for(50);
+        CHECK(pipeline.cc.state().n_decreases > 0);
+        CHECK(pipeline.sl.limit() < 16);
+        CHECK(pipeline.sl.limit() >= pipeline.cc.settings().min_slots);
+        CHECK(pipeline.cc.state().latency_msecs > 2 * pipeline.cc.state().min_latency_msecs);
+        // the controller estimates roughly the capped bandwidth
+        CHECK(pipeline.cc.state().bytes_per_second < 200'000);
+    }
+}
@@ -18,6 +18,7 @@
 
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <nucleus/camera/PositionStorage.h>
 #include <nucleus/tile/drawing.h>
 #include <nucleus/tile/utils.h>
@@ -56,6 +57,72 @@ TEST_CASE("tile/drawing")
         }
     }
 
+    SECTION("screen coverage")
+    {
+        auto camera = nucleus::camera::PositionStorage::instance()->get("grossglockner");
+        camera.set_viewport_size({ 1920, 1080 });
+        const auto frustum = camera.frustum();
+        const auto list = drawing::cull(drawing::compute_bounds(drawing::limit(drawing::generate_list(camera, aabb_decorator, 20), 1024u), aabb_decorator), camera);
+        REQUIRE(!list.empty());
+        for (const auto& t : list) {
+            CAPTURE(t.id);
+            const auto coverage = drawing::screen_coverage(t, frustum, camera.position());
+            CHECK(coverage > 0);
+            // the tile of the next zoom level covering the same spot is smaller (or, when the camera is inside, equal)
+            const auto child = t.id.children().front();
+            CHECK(drawing::screen_coverage({ child, aabb_decorator->aabb(child) }, frustum, camera.position()) <= coverage * 1.0001);
+        }
+        // the camera looks along -z_axis
+        const auto behind = camera.position() + camera.z_axis() * 10000.0;
+        const auto behind_bounds = TileBounds { {}, { behind - glm::dvec3(100, 100, 100), behind + glm::dvec3(100, 100, 100) } };
+        const auto in_front = camera.position() - camera.z_axis() * 10000.0;
+        const auto in_front_bounds = TileBounds { {}, { in_front - glm::dvec3(100, 100, 100), in_front + glm::dvec3(100, 100, 100) } };
+        CHECK(drawing::screen_coverage(behind_bounds, frustum, camera.position()) < drawing::screen_coverage(in_front_bounds, frustum, camera.position()));
+    }
+
+    SECTION("mesh errors and variants")
+    {
+        radix::Raster<uint16_t> flat(glm::uvec2(65), uint16_t(8000));
+        const auto flat_errors = drawing::mesh_errors(flat);
+        for (const auto error : flat_errors)
+            CHECK(error == 0);
+
+        // a single spike is lost by all coarser meshes
+        auto spiky = flat;
+        spiky.pixel({ 31, 33 }) = 8000 + 800; // 100m
+        const auto spiky_errors = drawing::mesh_errors(spiky);
+        CHECK(spiky_errors[0] == 0);
+        CHECK(spiky_errors[1] == 100);
+        CHECK(spiky_errors[2] == 100);
+        CHECK(spiky_errors[3] == 100);
+
+        // a plane is represented exactly by all meshes
+        radix::Raster<uint16_t> slope(glm::uvec2(65));
+        for (unsigned row = 0; row < 65; ++row) {
+            for (unsigned col = 0; col < 65; ++col)
+                slope.pixel({ col, row }) = uint16_t(1000 + 3 * row + 7 * col);
+        }
+        for (const auto error : drawing::mesh_errors(slope))
+            CHECK(error == 0);
+
+        // strides that don't fit the raster are never chosen
+        const auto odd_errors = drawing::mesh_errors(radix::Raster<uint16_t>(glm::uvec2(7), uint16_t(0)));
+        CHECK(odd_errors[1] == 0);
+        CHECK(std::isinf(odd_errors[2]));
+        CHECK(std::isinf(odd_errors[3]));
+
+        auto camera = nucleus::camera::PositionStorage::instance()->get("grossglockner");
+        camera.set_viewport_size({ 1920, 1080 });
+        const auto list = drawing::cull(drawing::compute_bounds(drawing::limit(drawing::generate_list(camera, aabb_decorator, 20), 1024u), aabb_decorator), camera);
+        REQUIRE(!list.empty());
+        for (const auto& t : list) {
+            CAPTURE(t.id);
+            CHECK(drawing::mesh_variant(t, flat_errors, camera) == drawing::mesh_strides.size() - 1);
+            CHECK(drawing::mesh_variant(t, { 0, 100000, 100000, 100000 }, camera) == 0);
+            CHECK(drawing::mesh_variant(t, odd_errors, camera) == 1);
+        }
+    }
+
     BENCHMARK("generate list")
     {
         std::vector<std::vector<tile::Id>> tmp;
@@ -22,9 +22,12 @@
 
 #include <QRegularExpression>
 #include <QSignalSpy>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include "TestTileServer.h"
 #include "nucleus/tile/TileLoadService.h"
+#include "nucleus/tile/batch.h"
 #include <QImage>
 
 using namespace nucleus::tile;
@@ -143,7 +146,7 @@ TEST_CASE("nucleus/tile/TileLoadService")
             CHECK(tile.network_info.status == NetworkInfo::Status::Good);
             CHECK(time_since_epoch() - tile.network_info.timestamp < 10'000);
 
-            const auto image = QImage::fromData(*tile.data);
+            const auto image = QImage::fromData(tile.data.view());
             REQUIRE(image.sizeInBytes() > 0);
             // the image on the server is only almost white. this test will fail when the file changes.
             CHECK(std::accumulate(image.constBits(), image.constBits() + image.sizeInBytes(), 0LLu) == 66'503'928LLu);
@@ -161,7 +164,7 @@ TEST_CASE("nucleus/tile/TileLoadService")
             CHECK(tile.network_info.status == NetworkInfo::Status::Good);
             CHECK(time_since_epoch() - tile.network_info.timestamp < 10'000);
 
-            const auto image = QImage::fromData(*tile.data);
+            const auto image = QImage::fromData(tile.data.view());
             REQUIRE(image.sizeInBytes() > 0);
             // manually checked. comparing the sum should find regressions. this test will fail when the file changes.
 //            image.save("/home/madam/Documents/work/tuw/alpinemaps/"
@@ -189,7 +192,7 @@ TEST_CASE("nucleus/tile/TileLoadService")
         CHECK(tile.network_info.status == NetworkInfo::Status::NotFound);
         CHECK(time_since_epoch() - tile.network_info.timestamp < 10'000);
 
-        const auto image = QImage::fromData(*tile.data);
+        const auto image = QImage::fromData(tile.data.view());
         REQUIRE(image.sizeInBytes() == 0);
     }
 #endif
@@ -212,7 +215,7 @@ TEST_CASE("nucleus/tile/TileLoadService")
         CHECK(tile.network_info.status == NetworkInfo::Status::NetworkError);
         CHECK(time_since_epoch() - tile.network_info.timestamp < 10'000);
 
-        const auto image = QImage::fromData(*tile.data);
+        const auto image = QImage::fromData(tile.data.view());
         REQUIRE(image.sizeInBytes() == 0);
     }
 
@@ -236,7 +239,216 @@ TEST_CASE("nucleus/tile/TileLoadService")
         CHECK(tile.network_info.status == NetworkInfo::Status::NetworkError);
         CHECK(time_since_epoch() - tile.network_info.timestamp < 2000);
 
-        const auto image = QImage::fromData(*tile.data);
+        const auto image = QImage::fromData(tile.data.view());
         REQUIRE(image.sizeInBytes() == 0);
     }
 }
+
+namespace {
+std::vector<Data> wait_for_tiles(QSignalSpy* spy, size_t count, int timeout = 10000)
+{
+    while (size_t(spy->count()) < count && spy->wait(timeout)) { }
+    std::vector<Data> tiles;
+    for (const auto& arguments : *spy)
+        tiles.push_back(arguments.at(0).value<Data>());
+    return tiles;
+}
+
+// the test server answers with the address, that is "z/x/y" (tms) for UrlPattern::ZXY
+QByteArray address_of(const Id& id) { return QString("%1/%2/%3").arg(id.zoom_level).arg(id.coords.x).arg(id.coords.y).toUtf8(); }
+} // namespace
+
+TEST_CASE("nucleus/tile/TileLoadService with local server")
+{
+    unittests::TestTileServer server({ .max_zoom_level = 10 });
+    TileLoadService service(server.tile_url(), TileLoadService::UrlPattern::ZXY, ".png");
+    QSignalSpy spy(&service, &TileLoadService::load_finished);
+
+    SECTION("load")
+    {
+        const auto id = Id { 5, { 17, 11 } };
+        service.load(id);
+        const auto tiles = wait_for_tiles(&spy, 1);
+        REQUIRE(tiles.size() == 1);
+        CHECK(tiles[0].id == id);
+        CHECK(tiles[0].network_info.status == NetworkInfo::Status::Good);
+        CHECK(tiles[0].data.view() == address_of(id));
+        CHECK(tiles[0].data.n_copied_bytes() == 0);
+    }
+
+    SECTION("load not found")
+    {
+        service.load(Id { 11, { 17, 11 } });
+        const auto tiles = wait_for_tiles(&spy, 1);
+        REQUIRE(tiles.size() == 1);
+        CHECK(tiles[0].network_info.status == NetworkInfo::Status::NotFound);
+        CHECK(tiles[0].data.empty());
+    }
+
+    SECTION("load batch")
+    {
+        service.set_batch_url(server.batch_url());
+        const auto ids = std::vector<Id> { { 10, { 4, 5 } }, { 11, { 8, 10 } }, { 3, { 1, 2 } }, { 0, { 0, 0 } } };
+        service.load_batch(ids);
+        const auto tiles = wait_for_tiles(&spy, ids.size());
+        REQUIRE(tiles.size() == ids.size());
+        CHECK(server.n_requests() == 1);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            CHECK(tiles[i].id == ids[i]);
+            if (ids[i].zoom_level > 10) {
+                CHECK(tiles[i].network_info.status == NetworkInfo::Status::NotFound);
+                CHECK(tiles[i].data.empty());
+            } else {
+                CHECK(tiles[i].network_info.status == NetworkInfo::Status::Good);
+                CHECK(tiles[i].data.view() == address_of(ids[i]));
+            }
+        }
+    }
+
+    SECTION("load batch falls back to single requests without batch url")
+    {
+        const auto ids = std::vector<Id> { { 2, { 0, 0 } }, { 2, { 1, 0 } }, { 2, { 0, 1 } } };
+        service.load_batch(ids);
+        const auto tiles = wait_for_tiles(&spy, ids.size());
+        REQUIRE(tiles.size() == ids.size());
+        CHECK(server.n_requests() == 3);
+        for (const auto& tile : tiles) {
+            CHECK(tile.network_info.status == NetworkInfo::Status::Good);
+            CHECK(tile.data.view() == address_of(tile.id));
+        }
+    }
+
+    SECTION("batch url is load balanced like single loads")
+    {
+        // the only target is the test server itself
+        auto pattern = server.tile_url();
+        pattern.replace("127.0.0.1", "%1");
+        TileLoadService balanced_service(pattern, TileLoadService::UrlPattern::ZXY, ".png", { "127.0.0.1" });
+        auto batch_pattern = server.batch_url();
+        batch_pattern.replace("127.0.0.1", "%1");
+        balanced_service.set_batch_url(batch_pattern);
+        QSignalSpy balanced_spy(&balanced_service, &TileLoadService::load_finished);
+        const auto ids = std::vector<Id> { { 2, { 0, 0 } }, { 2, { 1, 0 } } };
+        balanced_service.load_batch(ids);
+        const auto tiles = wait_for_tiles(&balanced_spy, ids.size());
+        REQUIRE(tiles.size() == ids.size());
+        CHECK(server.n_requests() == 1);
+        for (const auto& tile : tiles) {
+            CHECK(tile.network_info.status == NetworkInfo::Status::Good);
+            CHECK(tile.data.view() == address_of(tile.id));
+        }
+    }
+
+    SECTION("failing batch request reports network errors")
+    {
+        service.set_batch_url(server.tile_url() + "not_a_batch_endpoint");
+        const auto ids = std::vector<Id> { { 2, { 0, 0 } }, { 2, { 1, 0 } } };
+        service.load_batch(ids);
+        const auto tiles = wait_for_tiles(&spy, ids.size());
+        REQUIRE(tiles.size() == ids.size());
+        for (const auto& tile : tiles)
+            CHECK(tile.network_info.status == NetworkInfo::Status::NetworkError);
+    }
+
+    SECTION("cancelled requests are aborted and not reported")
+    {
+        server.settings().latency_ms = 200;
+        service.load(Id { 5, { 1, 1 } });
+        service.load(Id { 5, { 1, 2 } });
+        service.cancel({ Id { 5, { 1, 1 } }, Id { 7, { 0, 0 } } });
+        const auto tiles = wait_for_tiles(&spy, 2, 1000);
+        REQUIRE(tiles.size() == 1);
+        CHECK(tiles[0].id == Id { 5, { 1, 2 } });
+        CHECK(tiles[0].network_info.status == NetworkInfo::Status::Good);
+    }
+
+    SECTION("cancelling a tile of a batch reports the other tiles as network error")
+    {
+        server.settings().latency_ms = 200;
+        service.set_batch_url(server.batch_url());
+        service.load_batch({ Id { 2, { 0, 0 } }, Id { 2, { 1, 0 } } });
+        service.cancel({ Id { 2, { 0, 0 } } });
+        const auto tiles = wait_for_tiles(&spy, 2, 1000);
+        REQUIRE(tiles.size() == 1);
+        CHECK(tiles[0].id == Id { 2, { 1, 0 } });
+        CHECK(tiles[0].network_info.status == NetworkInfo::Status::NetworkError);
+    }
+
+    SECTION("connections are reused")
+    {
+        for (unsigned i = 0; i < 64; ++i)
+            service.load(Id { 6, { i, 3 } });
+        const auto tiles = wait_for_tiles(&spy, 64);
+        CHECK(tiles.size() == 64);
+        CHECK(server.n_requests() == 64);
+        // qt opens at most 6 http/1.1 connections per host
+        CHECK(server.n_connections() <= 6);
+    }
+}
+
+TEST_CASE("nucleus/tile/batch container")
+{
+    using namespace nucleus::tile;
+    using nucleus::utils::ByteBuffer;
+    const std::vector<batch::Entry> entries = { { 200, ByteBuffer(QByteArray("abc")) }, { 404, {} }, { 200, ByteBuffer(QByteArray(1000, 'x')) } };
+    const auto container = batch::encode(entries);
+
+    SECTION("round trip")
+    {
+        const auto buffer = ByteBuffer(container);
+        const auto decoded = batch::decode(buffer);
+        REQUIRE(decoded.has_value());
+        REQUIRE(decoded->size() == entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            CHECK(decoded->at(i).http_status == entries[i].http_status);
+            CHECK(decoded->at(i).data == entries[i].data);
+            // slices of the container
+            CHECK(decoded->at(i).data.n_copied_bytes() == 0);
+            CHECK(decoded->at(i).data.data() >= buffer.data());
+            CHECK(decoded->at(i).data.end() <= buffer.end());
+        }
+        CHECK(batch::decode(ByteBuffer(batch::encode({}))).value().empty());
+    }
+
+    SECTION("malformed")
+    {
+        CHECK(!batch::decode({}).has_value());
+        CHECK(!batch::decode(ByteBuffer(QByteArray("not a container"))).has_value());
+        CHECK(!batch::decode(ByteBuffer(container.left(container.size() - 1))).has_value()); // truncated data
+        CHECK(!batch::decode(ByteBuffer(container.left(20))).has_value()); // truncated index
+        auto wrong_version = container;
+        wrong_version[4] = 2;
+        CHECK(!batch::decode(ByteBuffer(wrong_version)).has_value());
+    }
+}
+
+TEST_CASE("nucleus/tile/TileLoadService benchmarks", "[.][benchmark]")
+{
+    // cold start of 64 quads (256 tiles) over a link with 50ms latency
+    unittests::TestTileServer server({ .latency_ms = 50, .tile_size = 20'000 });
+    std::vector<Id> quads;
+    for (unsigned i = 0; i < 64; ++i)
+        quads.push_back(Id { 9, { 270 + i % 8, 170 + i / 8 } });
+
+    BENCHMARK("individual requests")
+    {
+        TileLoadService service(server.tile_url(), TileLoadService::UrlPattern::ZXY, ".png");
+        QSignalSpy spy(&service, &TileLoadService::load_finished);
+        for (const auto& quad : quads) {
+            for (const auto& child : quad.children())
+                service.load(child);
+        }
+        return wait_for_tiles(&spy, quads.size() * 4).size();
+    };
+    BENCHMARK("batched requests (one per quad)")
+    {
+        TileLoadService service(server.tile_url(), TileLoadService::UrlPattern::ZXY, ".png");
+        service.set_batch_url(server.batch_url());
+        QSignalSpy spy(&service, &TileLoadService::load_finished);
+        for (const auto& quad : quads) {
+            const auto children = quad.children();
+            service.load_batch(std::vector<Id>(children.begin(), children.end()));
+        }
+        return wait_for_tiles(&spy, quads.size() * 4).size();
+    };
+}
@@ -0,0 +1,229 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "catch2_helpers.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <nucleus/camera/Definition.h>
+#include <nucleus/tile/OcclusionBuffer.h>
+#include <nucleus/tile/drawing.h>
+
+using namespace nucleus::tile;
+
+namespace {
+SrsAndHeightBounds make_bounds(const glm::dvec3& min, const glm::dvec3& max) { return { .min = min, .max = max }; }
+
+// east-west ridge between y=2000 and y=2500, rising from 0 (south) to 1500 m (north half)
+radix::Raster<float> ridge_heights()
+{
+    radix::Raster<float> heights({ 9, 9 }, 1500.f);
+    for (unsigned col = 0; col < 9; ++col) {
+        heights.pixel({ col, 5 }) = 1125.f;
+        heights.pixel({ col, 6 }) = 750.f;
+        heights.pixel({ col, 7 }) = 375.f;
+        heights.pixel({ col, 8 }) = 0.f; // row 0 is north
+    }
+    return heights;
+}
+
+// north-south valley with a 500 m wide floor at 300 m. the flanks rise by 45° to ridges at x = ±1750 (1800 m) and fall behind them
+// to the floors of the neighbouring valleys. all kinks are on the 125 m grid of the occluder meshes, so these are exact.
+double valley_height(double x)
+{
+    const auto d = std::abs(x);
+    if (d <= 250)
+        return 300;
+    if (d <= 1750)
+        return 300 + (d - 250);
+    return std::max(300.0, 1800 - 0.5 * (d - 1750));
+}
+
+// 1 km tiles covering the valley and its neighbours
+std::vector<TileBounds> valley_tiles()
+{
+    std::vector<TileBounds> tiles;
+    for (unsigned row = 0; row < 32; ++row) {
+        for (unsigned col = 0; col < 16; ++col) {
+            const auto min_x = -8000.0 + col * 1000.0;
+            double min_z = valley_height(min_x);
+            double max_z = min_z;
+            for (unsigned i = 1; i <= 8; ++i) {
+                min_z = std::min(min_z, valley_height(min_x + i * 125.0));
+                max_z = std::max(max_z, valley_height(min_x + i * 125.0));
+            }
+            const auto min_y = -2000.0 + row * 1000.0;
+            tiles.push_back({ Id { 16, { col, row } }, make_bounds({ min_x, min_y, min_z }, { min_x + 1000, min_y + 1000, max_z }) });
+        }
+    }
+    return tiles;
+}
+
+radix::Raster<float> valley_occluder_heights(const SrsAndHeightBounds& bounds)
+{
+    radix::Raster<float> heights({ 9, 9 }, 0.f);
+    for (unsigned row = 0; row < 9; ++row) {
+        for (unsigned col = 0; col < 9; ++col)
+            heights.pixel({ col, row }) = float(valley_height(bounds.min.x + col * 125.0));
+    }
+    return heights;
+}
+
+// marches from the camera towards the point and checks whether the terrain is in between
+bool hidden_by_valley(const glm::dvec3& camera_position, const glm::dvec3& point)
+{
+    const auto distance = glm::length(point - camera_position);
+    const auto direction = (point - camera_position) / distance;
+    for (double t = 10; t < distance - 50; t += 10) {
+        const auto p = camera_position + direction * t;
+        if (p.z < valley_height(p.x))
+            return true;
+    }
+    return false;
+}
+} // namespace
+
+TEST_CASE("nucleus/tile/OcclusionBuffer")
+{
+    // standing in the valley south of the ridge, looking north
+    const auto camera = nucleus::camera::Definition({ 0, 0, 1000 }, { 0, 10000, 1000 });
+    const auto ridge_bounds = make_bounds({ -5000, 2000, 0 }, { 5000, 2500, 1500 });
+
+    SECTION("occluder heights are not above the surface")
+    {
+        radix::Raster<uint16_t> surface({ 65, 65 }, uint16_t(8000));
+        surface.pixel({ 10, 20 }) = 800;
+        const auto heights = OcclusionBuffer::occluder_heights(surface, 8);
+        REQUIRE(heights.width() == 9);
+        REQUIRE(heights.height() == 9);
+        // sample (10, 20) lies in cell (1, 2), the vertices (1..2, 2..3) touch it
+        for (unsigned y = 0; y < 9; ++y) {
+            for (unsigned x = 0; x < 9; ++x) {
+                CAPTURE(x, y);
+                const bool touches = x >= 1 && x <= 2 && y >= 2 && y <= 3;
+                CHECK(heights.pixel({ x, y }) == (touches ? 100.f : 1000.f));
+            }
+        }
+    }
+
+    SECTION("tiles behind the ridge are occluded")
+    {
+        OcclusionBuffer buffer;
+        buffer.reset(camera);
+        buffer.add_occluder(ridge_bounds, ridge_heights());
+        buffer.finalise();
+        REQUIRE(buffer.enabled());
+
+        CHECK(buffer.is_occluded(make_bounds({ -500, 8000, 0 }, { 500, 9000, 1200 })));
+        // peeks over the ridge
+        CHECK(!buffer.is_occluded(make_bounds({ -500, 8000, 0 }, { 500, 9000, 3000 })));
+        // in front of the ridge
+        CHECK(!buffer.is_occluded(make_bounds({ -500, 500, 0 }, { 500, 1000, 500 })));
+        // behind the camera
+        CHECK(!buffer.is_occluded(make_bounds({ -500, -2000, 0 }, { 500, -1000, 500 })));
+
+        const std::vector<TileBounds> list = { { Id { 10, { 0, 0 } }, make_bounds({ -500, 8000, 0 }, { 500, 9000, 1200 }) },
+            { Id { 10, { 1, 0 } }, make_bounds({ -500, 500, 0 }, { 500, 1000, 500 }) } };
+        const auto culled = buffer.cull(list);
+        REQUIRE(culled.size() == 1);
+        CHECK(culled.front().id == Id { 10, { 1, 0 } });
+    }
+
+    SECTION("occluders are skipped where the camera is not above them")
+    {
+        OcclusionBuffer buffer;
+        buffer.reset(camera);
+        // the tile reaches above the camera, but the surface beneath the camera is lower
+        auto valley = radix::Raster<float>({ 9, 9 }, 0.f);
+        valley.pixel({ 0, 0 }) = 1200.f;
+        buffer.add_occluder(make_bounds({ -100, -100, 0 }, { 100, 100, 1200 }), valley);
+        CHECK(buffer.n_occluders() == 1);
+        // the camera is in the terrain
+        buffer.add_occluder(make_bounds({ -100, -100, 0 }, { 100, 100, 1100 }), radix::Raster<float>({ 9, 9 }, 1100.f));
+        CHECK(buffer.n_occluders() == 1);
+        // the others are still used
+        buffer.add_occluder(ridge_bounds, ridge_heights());
+        CHECK(buffer.n_occluders() == 2);
+        buffer.finalise();
+        REQUIRE(buffer.enabled());
+        CHECK(buffer.is_occluded(make_bounds({ -500, 8000, 0 }, { 500, 9000, 1200 })));
+        CHECK(!buffer.is_occluded(make_bounds({ -500, 500, 0 }, { 500, 1000, 500 })));
+    }
+
+    SECTION("recorded valley path draws fewer tiles")
+    {
+        // keyframes of a flight up the valley, 200 m above the floor, looking ahead and towards the flanks
+        const std::vector<std::pair<glm::dvec3, glm::dvec3>> valley_path = {
+            { { 0, 0, 500 }, { 0, 10000, 500 } },
+            { { 0, 1000, 500 }, { 1000, 10000, 700 } },
+            { { 100, 2000, 500 }, { -1500, 10000, 600 } },
+            { { -100, 3000, 500 }, { 0, 10000, 500 } },
+            { { 0, 4000, 500 }, { 3000, 9000, 800 } },
+            { { 0, 5000, 500 }, { -3000, 9000, 800 } },
+            { { 0, 6000, 800 }, { 0, 14000, 600 } },
+        };
+        constexpr unsigned max_n_occluders = 48; // as in gl_engine::Window
+        const auto tiles = valley_tiles();
+
+        // drawn tiles with frustum culling only (before) and with occlusion culling (after). run with -s to see the counts.
+        size_t n_in_frustum = 0;
+        size_t n_drawn = 0;
+        for (const auto& [position, view_at] : valley_path) {
+            const auto path_camera = nucleus::camera::Definition(position, view_at);
+            const auto frustum_culled = nucleus::tile::drawing::sort(nucleus::tile::drawing::cull(tiles, path_camera), path_camera.position());
+
+            OcclusionBuffer buffer;
+            buffer.reset(path_camera);
+            for (const auto& tile : frustum_culled) {
+                if (buffer.n_occluders() >= max_n_occluders)
+                    break;
+                buffer.add_occluder(tile.bounds, valley_occluder_heights(tile.bounds));
+            }
+            buffer.finalise();
+            const auto drawn = buffer.cull(frustum_culled);
+
+            CAPTURE(position, frustum_culled.size(), drawn.size());
+            CHECK(drawn.size() < frustum_culled.size());
+            n_in_frustum += frustum_culled.size();
+            n_drawn += drawn.size();
+
+            // culled tiles must be hidden by the terrain
+            for (const auto& tile : frustum_culled) {
+                if (std::find_if(drawn.begin(), drawn.end(), [&](const auto& t) { return t.id == tile.id; }) != drawn.end())
+                    continue;
+                const auto& b = tile.bounds;
+                for (const auto& point : { glm::dvec3(b.min.x, b.min.y, b.max.z), glm::dvec3(b.max.x, b.min.y, b.max.z), glm::dvec3(b.min.x, b.max.y, b.max.z),
+                         glm::dvec3(b.max.x, b.max.y, b.max.z), glm::dvec3((b.min.x + b.max.x) / 2, (b.min.y + b.max.y) / 2, b.max.z) }) {
+                    CAPTURE(tile.id.coords, point);
+                    CHECK(hidden_by_valley(path_camera.position(), point));
+                }
+            }
+        }
+        CAPTURE(n_in_frustum, n_drawn);
+        // the ridges hide the neighbouring valleys, that's more than a quarter of the tiles in the frustum
+        CHECK(n_drawn * 4 < n_in_frustum * 3);
+    }
+
+    SECTION("nothing is occluded without occluders")
+    {
+        OcclusionBuffer buffer;
+        buffer.reset(camera);
+        buffer.finalise();
+        CHECK(!buffer.is_occluded(make_bounds({ -500, 8000, 0 }, { 500, 9000, 1200 })));
+    }
+}
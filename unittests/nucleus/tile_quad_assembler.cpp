@@ -19,13 +19,14 @@
 #include "nucleus/tile/QuadAssembler.h"
 
 #include <QSignalSpy>
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 
 using namespace nucleus::tile;
 
 namespace {
-Data good_tile(const Id& id, const char* bytes) { return { id, { NetworkInfo::Status::Good, nucleus::utils::time_since_epoch() }, std::make_shared<QByteArray>(bytes) }; }
-Data missing_tile(const Id& id) { return { id, { NetworkInfo::Status::NotFound, nucleus::utils::time_since_epoch() }, std::make_shared<QByteArray>() }; }
+Data good_tile(const Id& id, const char* bytes) { return { id, { NetworkInfo::Status::Good, nucleus::utils::time_since_epoch() }, nucleus::utils::ByteBuffer(QByteArray(bytes)) }; }
+Data missing_tile(const Id& id) { return { id, { NetworkInfo::Status::NotFound, nucleus::utils::time_since_epoch() }, {} }; }
 }
 
 TEST_CASE("nucleus/tile/quad assembler")
@@ -46,6 +47,56 @@ TEST_CASE("nucleus/tile/quad assembler")
         CHECK(spy_loaded.empty());
     }
 
+    SECTION("request children in one batch")
+    {
+        assembler.set_batch_requests(true);
+        QSignalSpy spy_requested(&assembler, &QuadAssembler::tile_requested);
+        QSignalSpy spy_batch_requested(&assembler, &QuadAssembler::tiles_requested);
+
+        assembler.load(Id { 0, { 0, 0 } });
+        CHECK(spy_requested.empty());
+        REQUIRE(spy_batch_requested.size() == 1);
+        const auto ids = spy_batch_requested.constFirst().constFirst().value<std::vector<Id>>();
+        REQUIRE(ids.size() == 4);
+        CHECK(ids[0] == Id { 1, { 0, 0 } }); // order should not matter.
+        CHECK(ids[1] == Id { 1, { 1, 0 } });
+        CHECK(ids[2] == Id { 1, { 0, 1 } });
+        CHECK(ids[3] == Id { 1, { 1, 1 } });
+        CHECK(assembler.n_items_in_flight() == 1);
+    }
+
+    SECTION("cancel")
+    {
+        QSignalSpy spy_cancelled(&assembler, &QuadAssembler::tiles_cancelled);
+        QSignalSpy spy_loaded(&assembler, &QuadAssembler::quad_loaded);
+        assembler.load(Id { 0, { 0, 0 } });
+        assembler.load(Id { 3, { 4, 5 } });
+        assembler.deliver_tile(good_tile({ 1, { 0, 0 } }, "dta 100"));
+
+        assembler.cancel_quads({ Id { 0, { 0, 0 } }, Id { 5, { 0, 0 } } });
+        CHECK(assembler.n_items_in_flight() == 1);
+        REQUIRE(spy_cancelled.size() == 1);
+        const auto cancelled = spy_cancelled[0][0].value<std::vector<Id>>();
+        REQUIRE(cancelled.size() == 3); // the delivered one is not cancelled
+        CHECK(std::find(cancelled.cbegin(), cancelled.cend(), Id { 1, { 0, 0 } }) == cancelled.cend());
+
+        // late tiles of cancelled quads are dropped
+        assembler.deliver_tile(good_tile({ 1, { 0, 1 } }, "dta 101"));
+        assembler.deliver_tile(good_tile({ 1, { 1, 0 } }, "dta 110"));
+        assembler.deliver_tile(good_tile({ 1, { 1, 1 } }, "dta 111"));
+        CHECK(spy_loaded.empty());
+        CHECK(assembler.n_items_in_flight() == 1);
+
+        // and tiles delivered twice are only counted once
+        assembler.deliver_tile(good_tile({ 4, { 8, 10 } }, "ortho 4810"));
+        assembler.deliver_tile(good_tile({ 4, { 8, 10 } }, "ortho 4810"));
+        assembler.deliver_tile(good_tile({ 4, { 8, 11 } }, "ortho 4811"));
+        assembler.deliver_tile(good_tile({ 4, { 9, 11 } }, "ortho 4911"));
+        CHECK(spy_loaded.empty());
+        assembler.deliver_tile(good_tile({ 4, { 9, 10 } }, "ortho 4910"));
+        CHECK(spy_loaded.size() == 1);
+    }
+
     SECTION("assemble 1")
     {
         CHECK(assembler.n_items_in_flight() == 0);
@@ -78,11 +129,11 @@ TEST_CASE("nucleus/tile/quad assembler")
         CHECK(loaded_tile.tiles[2].id == Id { 1, { 1, 0 } });
         CHECK(loaded_tile.tiles[3].id == Id { 1, { 1, 1 } });
         for (unsigned i = 0; i < 4; ++i) {
-            REQUIRE(loaded_tile.tiles[i].data);
+            REQUIRE(!loaded_tile.tiles[i].data.empty());
 
             const auto tile = loaded_tile.tiles[i];
             const auto number = std::to_string(tile.id.zoom_level) + std::to_string(tile.id.coords.x) + std::to_string(tile.id.coords.y);
-            CHECK(*tile.data == QByteArray((std::string("dta ") + number).c_str()));
+            CHECK(tile.data.view() == QByteArray((std::string("dta ") + number).c_str()));
         }
     }
 
@@ -114,11 +165,11 @@ TEST_CASE("nucleus/tile/quad assembler")
         CHECK(loaded_tile.tiles[2].id == Id { 4, { 9, 11 } });
         CHECK(loaded_tile.tiles[3].id == Id { 4, { 9, 10 } });
         for (unsigned i = 0; i < 4; ++i) {
-            REQUIRE(loaded_tile.tiles[i].data);
+            REQUIRE(!loaded_tile.tiles[i].data.empty());
 
             const auto tile = loaded_tile.tiles[i];
             const auto number = std::to_string(tile.id.zoom_level) + std::to_string(tile.id.coords.x) + std::to_string(tile.id.coords.y);
-            CHECK(*tile.data == QByteArray((std::string("ortho ") + number).c_str()));
+            CHECK(tile.data.view() == QByteArray((std::string("ortho ") + number).c_str()));
         }
     }
 
@@ -166,11 +217,11 @@ TEST_CASE("nucleus/tile/quad assembler")
             CHECK(loaded_tile.tiles[2].id == Id { 4, { 9, 11 } });
             CHECK(loaded_tile.tiles[3].id == Id { 4, { 9, 10 } });
             for (unsigned i = 0; i < 4; ++i) {
-                REQUIRE(loaded_tile.tiles[i].data);
+                REQUIRE(!loaded_tile.tiles[i].data.empty());
 
                 const auto tile = loaded_tile.tiles[i];
                 const auto number = std::to_string(tile.id.zoom_level) + std::to_string(tile.id.coords.x) + std::to_string(tile.id.coords.y);
-                CHECK(*tile.data == QByteArray((std::string("ortho ") + number).c_str()));
+                CHECK(tile.data.view() == QByteArray((std::string("ortho ") + number).c_str()));
             }
         }
 
@@ -183,11 +234,11 @@ TEST_CASE("nucleus/tile/quad assembler")
             CHECK(loaded_tile.tiles[2].id == Id { 1, { 0, 0 } });
             CHECK(loaded_tile.tiles[3].id == Id { 1, { 1, 1 } });
             for (unsigned i = 0; i < 4; ++i) {
-                REQUIRE(loaded_tile.tiles[i].data);
+                REQUIRE(!loaded_tile.tiles[i].data.empty());
 
                 const auto tile = loaded_tile.tiles[i];
                 const auto number = std::to_string(tile.id.zoom_level) + std::to_string(tile.id.coords.x) + std::to_string(tile.id.coords.y);
-                CHECK(*tile.data == QByteArray((std::string("ortho ") + number).c_str()));
+                CHECK(tile.data.view() == QByteArray((std::string("ortho ") + number).c_str()));
             }
         }
     }
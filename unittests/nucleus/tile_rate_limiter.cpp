@@ -69,6 +69,27 @@ TEST_CASE("nucleus/tile/rate limiter")
         CHECK(spy[1][0].value<Id>() == Id { 1, { 0, 0 } });
     }
 
+    SECTION("cancelling drops queued requests and forwards the others")
+    {
+        RateLimiter rl;
+        rl.set_limit(2, 100 * timing_multiplicator);
+        QSignalSpy spy(&rl, &RateLimiter::quad_requested);
+        QSignalSpy spy_cancelled(&rl, &RateLimiter::quads_cancelled);
+        rl.request_quad(Id { 0, { 0, 0 } });
+        rl.request_quad(Id { 1, { 0, 0 } });
+        rl.request_quad(Id { 2, { 0, 0 } });
+        rl.request_quad(Id { 3, { 0, 0 } });
+        REQUIRE(spy.size() == 2);
+        CHECK(rl.queue_size() == 2);
+
+        rl.cancel_quads({ Id { 1, { 0, 0 } }, Id { 2, { 0, 0 } } });
+        CHECK(rl.queue_size() == 1);
+        REQUIRE(spy_cancelled.size() == 1);
+        const auto forwarded = spy_cancelled[0][0].value<std::vector<Id>>();
+        REQUIRE(forwarded.size() == 1);
+        CHECK(forwarded[0] == Id { 1, { 0, 0 } });
+    }
+
     SECTION("slots are freed up after some time and request queue is processed")
     {
         RateLimiter rl;
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <deque>
 #include <unordered_set>
 
 #include "nucleus/utils/Stopwatch.h"
@@ -29,6 +30,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <nucleus/camera/PositionStorage.h>
 #include <nucleus/tile/SchedulerDirector.h>
+#include <nucleus/tile/SlotLimiter.h>
 #include <nucleus/tile/TextureScheduler.h>
 #include <nucleus/tile/conversion.h>
 #include <nucleus/tile/types.h>
@@ -124,7 +126,7 @@ nucleus::tile::DataQuad example_tile_quad_for(const Id& id, unsigned n_children
     static const auto example_data = example_tile_data();
     for (unsigned i = 0; i < n_children; ++i) {
         cpu_quad.tiles[i].id = children[i];
-        cpu_quad.tiles[i].data = std::make_shared<QByteArray>(example_data);
+        cpu_quad.tiles[i].data = nucleus::utils::ByteBuffer(example_data);
         cpu_quad.tiles[i].network_info.status = status;
         cpu_quad.tiles[i].network_info.timestamp = nucleus::utils::time_since_epoch();
     }
@@ -283,6 +285,68 @@ TEST_CASE("nucleus/tile/Scheduler")
         CHECK(std::find_if(quads.cbegin(), quads.cend(), [](const Id& id) { return id.zoom_level == 18; }) == quads.end());
     }
 
+    SECTION("quads are requested in order of their screen space error")
+    {
+        auto scheduler = scheduler_with_true_heights();
+        QSignalSpy spy(scheduler.get(), &Scheduler::quads_requested);
+        auto camera = nucleus::camera::stored_positions::grossglockner();
+        camera.set_viewport_size({ 1920, 1080 });
+        scheduler->update_camera(camera);
+        scheduler->send_quad_requests();
+        REQUIRE(spy.size() == 1);
+        const auto quads = spy.constFirst().constFirst().value<std::vector<Id>>();
+        REQUIRE(quads.size() >= 5);
+
+        const auto is_ancestor_or_self = [](const Id& ancestor, const Id& id) {
+            if (id.zoom_level < ancestor.zoom_level)
+                return false;
+            const auto shift = id.zoom_level - ancestor.zoom_level;
+            return glm::uvec2(id.coords.x >> shift, id.coords.y >> shift) == glm::uvec2(ancestor.coords);
+        };
+        const auto check_order = [&](const std::vector<Id>& quads) {
+            // the priority of a quad is the largest error of itself and its requested descendants
+            const auto screen_space_error = nucleus::tile::utils::screen_space_error_functor(camera, scheduler->aabb_decorator(), 256);
+            std::vector<float> priorities;
+            for (const auto& quad : quads) {
+                float priority = 0;
+                for (const auto& other : quads) {
+                    if (is_ancestor_or_self(quad, other))
+                        priority = std::max(priority, screen_space_error(other));
+                }
+                priorities.push_back(priority);
+            }
+            for (size_t i = 1; i < quads.size(); ++i)
+                CHECK(priorities[i - 1] >= priorities[i]);
+
+            // requested ancestors come before their descendants
+            unsigned n_descendants_first = 0;
+            for (size_t i = 0; i < quads.size(); ++i) {
+                for (size_t j = i + 1; j < quads.size(); ++j)
+                    n_descendants_first += is_ancestor_or_self(quads[j], quads[i]);
+            }
+            CHECK(n_descendants_first == 0);
+        };
+        check_order(quads);
+
+        // parents come before their children
+        for (size_t i = 0; i < quads.size(); ++i) {
+            if (quads[i].zoom_level == 0)
+                continue;
+            const auto parent = std::find(quads.cbegin(), quads.cend(), quads[i].parent());
+            REQUIRE(parent != quads.cend());
+            CHECK(size_t(parent - quads.cbegin()) < i);
+        }
+
+        // with some levels in the cache, the remaining ancestors still come first
+        for (const auto& quad : quads) {
+            if (quad.zoom_level == 8 || quad.zoom_level == 12)
+                scheduler->receive_quad(example_tile_quad_for(quad));
+        }
+        const auto missing = scheduler->missing_quads_for_current_camera();
+        REQUIRE(missing.size() < quads.size());
+        check_order(missing);
+    }
+
     SECTION("quads are not requested if there is no network")
     {
         auto scheduler = default_scheduler();
@@ -296,6 +360,22 @@ TEST_CASE("nucleus/tile/Scheduler")
         REQUIRE(spy.size() == 1);
     }
 
+    SECTION("network statistics")
+    {
+        auto scheduler = default_scheduler();
+        QSignalSpy spy(scheduler.get(), &Scheduler::statistics_updated);
+        QSignalSpy stats_spy(scheduler.get(), &Scheduler::stats_ready);
+        ConcurrencyController::State state;
+        state.slot_limit = 7;
+        state.rate_limit = 42;
+        scheduler->update_network_statistics(state);
+        CHECK(scheduler->statistics().network.slot_limit == 7);
+        CHECK(scheduler->statistics().network.rate_limit == 42);
+        CHECK(spy.size() == 1);
+        REQUIRE(stats_spy.size() == 1);
+        CHECK(stats_spy[0][1].toMap()["network_slot_limit"].toUInt() == 7);
+    }
+
     SECTION("delivered quads are not requested again")
     {
         auto scheduler = default_scheduler();
@@ -411,7 +491,7 @@ TEST_CASE("nucleus/tile/Scheduler")
         auto scheduler = default_scheduler();
         QSignalSpy spy(scheduler.get(), &TextureScheduler::gpu_tiles_updated);
         auto quad = example_tile_quad_for({ 0, { 0, 0 } }, 4);
-        quad.tiles[2].data->resize(0);
+        quad.tiles[2].data = {};
 
         scheduler->receive_quad(quad);
         scheduler->update_camera(nucleus::camera::stored_positions::stephansdom());
@@ -670,7 +750,7 @@ TEST_CASE("nucleus/tile/Scheduler")
         for (unsigned i = 0; i < 4; ++i) {
             const nucleus::tile::Data& child_tile = scheduler->ram_cache().peak_at(id).tiles[i];
             CHECK(child_tile.id == children[i]);
-            CHECK(*child_tile.data == *example_quad.tiles[i].data);
+            CHECK(child_tile.data == example_quad.tiles[i].data);
         }
     };
 
@@ -769,6 +849,135 @@ TEST_CASE("nucleus/tile/Scheduler")
     }
 }
 
+namespace {
+struct FlightResult {
+    unsigned n_quads_missing_on_arrival = 0;
+    Scheduler::Statistics statistics;
+};
+
+// offline simulation of a flight along path. the fake load service answers a limited number of quads per frame (i.e., bandwidth limited).
+// the scheduler knows the next few cameras of the path, as it would during an animation.
+FlightResult simulate_flight(const std::vector<nucleus::camera::Definition>& path, float prefetch_bandwidth_share)
+{
+    constexpr unsigned quads_per_frame = 32;
+    constexpr size_t known_path_length = 4;
+
+    auto scheduler = default_scheduler();
+    scheduler->set_prefetch_bandwidth_share(prefetch_bandwidth_share);
+    SlotLimiter sl;
+    sl.set_limit(64);
+    std::deque<Id> pending;
+    QObject::connect(scheduler.get(), &Scheduler::quads_requested, &sl, &SlotLimiter::request_quads);
+    QObject::connect(&sl, &SlotLimiter::quad_requested, [&](const Id& id) { pending.push_back(id); });
+    QObject::connect(&sl, &SlotLimiter::quads_cancelled, [&](const std::vector<Id>& ids) {
+        std::erase_if(pending, [&](const Id& id) { return std::find(ids.cbegin(), ids.cend(), id) != ids.cend(); });
+    });
+    QObject::connect(&sl, &SlotLimiter::quad_delivered, scheduler.get(), &Scheduler::receive_quad);
+    const auto round_trip = [&]() {
+        const auto n = std::min(size_t(quads_per_frame), pending.size());
+        for (size_t i = 0; i < n; ++i) {
+            const auto id = pending.front();
+            pending.pop_front();
+            sl.deliver_quad(example_tile_quad_for(id));
+        }
+    };
+
+    // start with a fully loaded view
+    scheduler->update_camera(path.front());
+    for (unsigned i = 0; i < 100 && !scheduler->missing_quads_for_current_camera().empty(); ++i) {
+        scheduler->send_quad_requests();
+        round_trip();
+    }
+    REQUIRE(scheduler->missing_quads_for_current_camera().empty());
+
+    FlightResult result;
+    for (size_t i = 1; i < path.size(); ++i) {
+        scheduler->update_camera(path[i]);
+        result.n_quads_missing_on_arrival += unsigned(scheduler->missing_quads_for_current_camera().size());
+        scheduler->update_camera_path({ path.begin() + long(i) + 1, path.begin() + long(std::min(i + 1 + known_path_length, path.size())) });
+        scheduler->send_quad_requests();
+        round_trip();
+    }
+    result.statistics = scheduler->statistics();
+    return result;
+}
+} // namespace
+
+TEST_CASE("nucleus/tile/Scheduler prefetching")
+{
+    SECTION("prefetching along a known camera path (simulation)")
+    {
+        // panning east over the alps
+        std::vector<nucleus::camera::Definition> path;
+        auto camera = nucleus::camera::stored_positions::grossglockner();
+        camera.set_viewport_size({ 1920, 1080 });
+        for (unsigned i = 0; i < 40; ++i) {
+            path.push_back(camera);
+            camera.move({ 300, 0, 0 });
+        }
+
+        const auto without_prefetch = simulate_flight(path, 0.0f);
+        const auto with_prefetch = simulate_flight(path, 0.5f);
+
+        CHECK(without_prefetch.statistics.n_prefetch_requested == 0);
+        CHECK(without_prefetch.statistics.n_prefetch_hits == 0);
+        CHECK(without_prefetch.n_quads_missing_on_arrival > 0);
+
+        CHECK(with_prefetch.statistics.n_prefetch_requested > 0);
+        CHECK(with_prefetch.statistics.n_prefetch_hits > 0);
+        CHECK(with_prefetch.n_quads_missing_on_arrival < without_prefetch.n_quads_missing_on_arrival);
+    }
+
+    SECTION("prefetched quads are requested after the visible ones, within the bandwidth share")
+    {
+        auto scheduler = default_scheduler();
+        scheduler->set_prefetch_bandwidth_share(0.5f);
+        QSignalSpy spy(scheduler.get(), &Scheduler::quads_requested);
+        auto camera = nucleus::camera::stored_positions::grossglockner();
+        auto future_camera = camera;
+        future_camera.move({ 20'000, 0, 0 });
+        scheduler->update_camera(camera);
+        scheduler->update_camera_path({ future_camera });
+        scheduler->send_quad_requests();
+        REQUIRE(spy.size() == 1);
+        const auto quads = spy.constFirst().constFirst().value<std::vector<Id>>();
+        const auto visible = scheduler->missing_quads_for_current_camera();
+        REQUIRE(quads.size() > visible.size());
+        CHECK(quads.size() - visible.size() <= 8); // 0.5 * default slot limit of 16
+        CHECK(std::equal(visible.cbegin(), visible.cend(), quads.cbegin()));
+        const std::unordered_set<Id, Id::Hasher> unique_quads(quads.cbegin(), quads.cend());
+        CHECK(unique_quads.size() == quads.size());
+
+        // path cleared, no motion -> no prefetching
+        scheduler->update_camera_path({});
+        QThread::msleep(300);
+        scheduler->send_quad_requests();
+        REQUIRE(spy.size() == 2);
+        CHECK(spy[1][0].value<std::vector<Id>>().size() == visible.size());
+    }
+
+    SECTION("camera motion is extrapolated if there is no path")
+    {
+        auto scheduler = default_scheduler();
+        scheduler->set_prefetch_bandwidth_share(0.5f);
+        QSignalSpy spy(scheduler.get(), &Scheduler::quads_requested);
+        auto camera = nucleus::camera::stored_positions::grossglockner();
+        scheduler->update_camera(camera);
+        QThread::msleep(20);
+        camera.move({ 1'000, 0, 0 });
+        scheduler->update_camera(camera);
+        scheduler->send_quad_requests();
+        REQUIRE(spy.size() == 1);
+        CHECK(spy[0][0].value<std::vector<Id>>().size() > scheduler->missing_quads_for_current_camera().size());
+
+        // the camera stopped
+        QThread::msleep(300);
+        scheduler->send_quad_requests();
+        REQUIRE(spy.size() == 2);
+        CHECK(spy[1][0].value<std::vector<Id>>().size() == scheduler->missing_quads_for_current_camera().size());
+    }
+}
+
 TEST_CASE("nucleus/tile/Scheduler benchmarks")
 {
     auto camera = nucleus::camera::stored_positions::grossglockner();
@@ -845,7 +1054,7 @@ TEST_CASE("nucleus/tile/TextureScheduler")
         for (const auto& c : quad.id.children()) {
             quad.tiles[idx].id = c;
             auto ba = test_helpers::load_test_file(QString("quad/%1_%2_%3.jpg").arg(c.zoom_level).arg(c.coords.x).arg(c.coords.y));
-            quad.tiles[idx].data = std::make_shared<QByteArray>(std::move(ba));
+            quad.tiles[idx].data = nucleus::utils::ByteBuffer(std::move(ba));
             quad.tiles[idx].network_info = { NetworkInfo::Status::Good, 12345 };
             idx = (idx + 1) % 4;
         }
@@ -0,0 +1,272 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <QSignalSpy>
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <deque>
+
+#include "nucleus/tile/ConcurrencyController.h"
+#include "nucleus/tile/QuadAssembler.h"
+#include "nucleus/tile/SlotBudget.h"
+#include "nucleus/tile/SlotLimiter.h"
+#include "nucleus/tile/types.h"
+#include "radix/tile.h"
+
+using namespace nucleus::tile;
+
+namespace {
+std::vector<Id> row(unsigned zoom_level, unsigned y, unsigned n)
+{
+    std::vector<Id> ids;
+    for (unsigned i = 0; i < n; ++i)
+        ids.push_back(Id { zoom_level, { i, y } });
+    return ids;
+}
+
+// stands in for the network connection shared by all TileLoadServices: tiles are answered in request order (no matter the layer),
+// a limited number per round trip (i.e., bandwidth limited)
+struct SharedLink {
+    std::deque<std::pair<QuadAssembler*, Id>> pending;
+    unsigned tiles_per_round_trip = 32;
+
+    void connect_to(QuadAssembler* qa)
+    {
+        QObject::connect(qa, &QuadAssembler::tile_requested, [this, qa](const Id& id) { pending.emplace_back(qa, id); });
+    }
+    void round_trip()
+    {
+        const auto n = std::min(size_t(tiles_per_round_trip), pending.size());
+        const std::vector<std::pair<QuadAssembler*, Id>> answered(pending.begin(), pending.begin() + long(n));
+        pending.erase(pending.begin(), pending.begin() + long(n));
+        for (const auto& [qa, id] : answered)
+            qa->deliver_tile({ id, { NetworkInfo::Status::Good, 0 }, nucleus::utils::ByteBuffer(QByteArray("tile")) });
+    }
+};
+
+struct Layer {
+    SlotLimiter sl;
+    QuadAssembler qa;
+    std::vector<Id> missing;
+
+    Layer(SharedLink* link, const std::vector<Id>& view)
+        : missing(view)
+    {
+        QObject::connect(&sl, &SlotLimiter::quad_requested, &qa, &QuadAssembler::load);
+        QObject::connect(&qa, &QuadAssembler::quad_loaded, &sl, &SlotLimiter::deliver_quad);
+        QObject::connect(&sl, &SlotLimiter::quad_delivered, [this](const DataQuad& quad) { std::erase(missing, quad.id); });
+        link->connect_to(&qa);
+    }
+};
+
+struct StartupResult {
+    unsigned round_trips_until_first_complete_frame = 0;
+    unsigned round_trips_until_everything_loaded = 0;
+};
+
+// geometry and ortho layer start up at the same time and share the link. a frame is complete, as soon as all the geometry is there
+// (textures are drawn from coarser tiles until the ortho quads arrive, but there is no fallback for missing geometry).
+StartupResult simulate_startup(const std::shared_ptr<SlotBudget>& budget)
+{
+    SharedLink link;
+    Layer geometry(&link, row(10, 0, 32));
+    Layer ortho(&link, row(12, 7, 64));
+    if (budget) {
+        geometry.sl.set_budget(budget, 4.0f);
+        ortho.sl.set_budget(budget, 1.0f);
+    }
+    geometry.sl.request_quads(row(10, 0, 32));
+    ortho.sl.request_quads(row(12, 7, 64));
+
+    StartupResult result;
+    unsigned round_trips = 0;
+    while ((!geometry.missing.empty() || !ortho.missing.empty()) && round_trips < 100) {
+        link.round_trip();
+        round_trips++;
+        if (geometry.missing.empty() && result.round_trips_until_first_complete_frame == 0)
+            result.round_trips_until_first_complete_frame = round_trips;
+    }
+    result.round_trips_until_everything_loaded = round_trips;
+    return result;
+}
+
+unsigned count_in(const QSignalSpy& spy, int begin, int end) { return unsigned(std::max(0, std::min(end, int(spy.size())) - begin)); }
+} // namespace
+
+TEST_CASE("nucleus/tile/slot budget")
+{
+    SECTION("slots are shared by weight")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        budget->set_limit(50);
+        SlotLimiter geometry;
+        SlotLimiter ortho;
+        geometry.set_budget(budget, 4.0f);
+        ortho.set_budget(budget, 1.0f);
+        CHECK(budget->n_layers() == 2);
+        CHECK(geometry.budget() == budget.get());
+
+        QSignalSpy geometry_spy(&geometry, &SlotLimiter::quad_requested);
+        QSignalSpy ortho_spy(&ortho, &SlotLimiter::quad_requested);
+        geometry.request_quads(row(10, 0, 100));
+        // the geometry layer is alone, it takes all slots
+        CHECK(geometry_spy.size() == 50);
+        CHECK(budget->slots_taken() == 50);
+        for (const auto& id : row(10, 0, 30))
+            geometry.deliver_quad(DataQuad { id });
+        CHECK(geometry_spy.size() == 80);
+
+        // both are waiting now, the freed slots are shared 4:1
+        ortho.request_quads(row(12, 0, 100));
+        CHECK(ortho_spy.size() == 0);
+        for (unsigned i = 30; i < 80; ++i)
+            geometry.deliver_quad(DataQuad { Id { 10, { i, 0 } } });
+        CHECK(budget->slots_taken() == 50);
+        CHECK(geometry.slots_taken() + ortho.slots_taken() == 50);
+        CHECK(count_in(geometry_spy, 80, 1000) == 40);
+        CHECK(ortho_spy.size() == 10);
+        // the priority order within the layer is kept
+        REQUIRE(ortho_spy.size() > 1);
+        CHECK(ortho_spy[0][0].value<Id>() == Id { 12, { 0, 0 } });
+        CHECK(ortho_spy[1][0].value<Id>() == Id { 12, { 1, 0 } });
+    }
+
+    SECTION("equal weights alternate")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        budget->set_limit(1);
+        SlotLimiter a;
+        SlotLimiter b;
+        a.set_budget(budget);
+        b.set_budget(budget);
+        std::vector<const SlotLimiter*> order;
+        QObject::connect(&a, &SlotLimiter::quad_requested, [&]() { order.push_back(&a); });
+        QObject::connect(&b, &SlotLimiter::quad_requested, [&]() { order.push_back(&b); });
+        a.request_quads(row(5, 0, 10));
+        b.request_quads(row(6, 0, 10));
+        REQUIRE(order.size() == 1);
+
+        for (unsigned i = 0; i < 5; ++i) {
+            a.deliver_quad(DataQuad { Id { 5, { i, 0 } } });
+            b.deliver_quad(DataQuad { Id { 6, { i, 0 } } });
+        }
+        REQUIRE(order.size() == 11);
+        for (size_t i = 0; i < order.size(); ++i)
+            CHECK(order[i] == ((i % 2 == 0) ? &a : &b));
+    }
+
+    SECTION("idle layers don't save up credit")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        budget->set_limit(1);
+        SlotLimiter a;
+        SlotLimiter b;
+        a.set_budget(budget);
+        b.set_budget(budget);
+        QSignalSpy a_spy(&a, &SlotLimiter::quad_requested);
+        QSignalSpy b_spy(&b, &SlotLimiter::quad_requested);
+
+        // a runs alone for a while
+        a.request_quads(row(5, 0, 40));
+        for (unsigned i = 0; i < 20; ++i)
+            a.deliver_quad(DataQuad { a_spy.last()[0].value<Id>() });
+        CHECK(a_spy.size() == 21);
+
+        // b doesn't get 20 slots in a row now
+        b.request_quads(row(6, 0, 40));
+        for (unsigned i = 0; i < 4; ++i) {
+            if (a.slots_taken())
+                a.deliver_quad(DataQuad { a_spy.last()[0].value<Id>() });
+            else
+                b.deliver_quad(DataQuad { b_spy.last()[0].value<Id>() });
+        }
+        CHECK(count_in(a_spy, 21, 1000) == 2);
+        CHECK(b_spy.size() == 2);
+    }
+
+    SECTION("the slots of a removed layer go to the others")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        budget->set_limit(4);
+        SlotLimiter a;
+        a.set_budget(budget);
+        QSignalSpy a_spy(&a, &SlotLimiter::quad_requested);
+        {
+            SlotLimiter b;
+            b.set_budget(budget);
+            b.request_quads(row(6, 0, 10));
+            a.request_quads(row(5, 0, 10));
+            CHECK(b.slots_taken() == 4);
+            CHECK(a_spy.size() == 0);
+        }
+        CHECK(budget->n_layers() == 1);
+        CHECK(a.slots_taken() == 4);
+        CHECK(a_spy.size() == 4);
+
+        // leaving the budget returns to the own limit
+        a.set_limit(6);
+        a.set_budget(nullptr);
+        CHECK(budget->n_layers() == 0);
+        CHECK(a.slots_taken() == 6);
+    }
+
+    SECTION("the limit follows the controller")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        REQUIRE(budget->controller());
+        CHECK(budget->limit() == budget->controller()->state().slot_limit);
+        emit budget->controller()->slot_limit_changed(42);
+        CHECK(budget->limit() == 42);
+    }
+
+    SECTION("share of the limit follows the weights")
+    {
+        auto budget = std::make_shared<SlotBudget>();
+        budget->set_limit(20);
+        SlotLimiter a;
+        SlotLimiter b;
+        SlotLimiter outside;
+        a.set_budget(budget, 4.0f);
+        b.set_budget(budget, 1.0f);
+        CHECK(budget->share_of(&a) == 16);
+        CHECK(budget->share_of(&b) == 4);
+        CHECK(budget->share_of(&outside) == 20);
+        budget->set_limit(2);
+        CHECK(budget->share_of(&b) == 1); // never 0
+        a.set_budget(nullptr);
+        b.set_budget(nullptr);
+    }
+}
+
+TEST_CASE("nucleus/tile/time to first complete frame (simulation)")
+{
+    // 32 tiles (8 quads) per round trip, 32 geometry quads and 64 ortho quads in view.
+    // every layer with its own 16 slots: geometry and ortho share the link about evenly, geometry is complete after 6 round trips.
+    // one budget of 32 slots, geometry weighted 4:1: geometry is complete after 4 round trips.
+    // both keep the link busy all the time, so everything is loaded after the same number of round trips.
+    const auto independent = simulate_startup({});
+    auto budget = std::make_shared<SlotBudget>();
+    budget->set_limit(32);
+    const auto shared = simulate_startup(budget);
+
+    CHECK(independent.round_trips_until_first_complete_frame == 6);
+    CHECK(shared.round_trips_until_first_complete_frame == 4);
+    CHECK(shared.round_trips_until_everything_loaded == independent.round_trips_until_everything_loaded);
+    CHECK(shared.round_trips_until_everything_loaded == 12);
+    CHECK(budget->n_layers() == 0);
+}
@@ -19,13 +19,85 @@
 #include <QSignalSpy>
 #include <QThread>
 #include <catch2/catch_test_macros.hpp>
+#include <deque>
 
+#include "nucleus/tile/QuadAssembler.h"
+#include "nucleus/tile/RateLimiter.h"
 #include "nucleus/tile/SlotLimiter.h"
 #include "nucleus/tile/types.h"
 #include "radix/tile.h"
 
 using namespace nucleus::tile;
 
+namespace {
+// stands in for TileLoadService: tiles are answered in request order, a limited number per round trip (i.e., bandwidth limited)
+struct FakeLoadService {
+    std::deque<Id> pending;
+    unsigned tiles_per_round_trip = 32;
+
+    void connect_to(QuadAssembler* qa, bool with_cancellation)
+    {
+        QObject::connect(qa, &QuadAssembler::tile_requested, [this](const Id& id) { pending.push_back(id); });
+        if (with_cancellation) {
+            QObject::connect(qa, &QuadAssembler::tiles_cancelled, [this](const std::vector<Id>& ids) {
+                std::erase_if(pending, [&](const Id& id) { return std::find(ids.cbegin(), ids.cend(), id) != ids.cend(); });
+            });
+        }
+    }
+    void round_trip(QuadAssembler* qa)
+    {
+        const auto n = std::min(size_t(tiles_per_round_trip), pending.size());
+        const std::vector<Id> answered(pending.begin(), pending.begin() + long(n));
+        pending.erase(pending.begin(), pending.begin() + long(n));
+        for (const auto& id : answered)
+            qa->deliver_tile({ id, { NetworkInfo::Status::Good, 0 }, nucleus::utils::ByteBuffer(QByteArray("tile")) });
+    }
+};
+
+struct SimulationResult {
+    unsigned round_trips_until_visible = 0;
+    unsigned stale_quads_delivered = 0;
+};
+
+// the camera looks at view_a and moves to view_b after the first round trip. how long until everything in view_b is loaded?
+SimulationResult simulate_camera_move(const std::vector<Id>& view_a, const std::vector<Id>& view_b, bool with_cancellation)
+{
+    SlotLimiter sl;
+    RateLimiter rl;
+    rl.set_limit(100'000, 1000);
+    QuadAssembler qa;
+    FakeLoadService service;
+    QObject::connect(&sl, &SlotLimiter::quad_requested, &rl, &RateLimiter::request_quad);
+    QObject::connect(&rl, &RateLimiter::quad_requested, &qa, &QuadAssembler::load);
+    QObject::connect(&qa, &QuadAssembler::quad_loaded, &sl, &SlotLimiter::deliver_quad);
+    if (with_cancellation) {
+        QObject::connect(&sl, &SlotLimiter::quads_cancelled, &rl, &RateLimiter::cancel_quads);
+        QObject::connect(&rl, &RateLimiter::quads_cancelled, &qa, &QuadAssembler::cancel_quads);
+    }
+    service.connect_to(&qa, with_cancellation);
+
+    bool moved = false;
+    SimulationResult result;
+    std::vector<Id> missing = view_b;
+    QObject::connect(&sl, &SlotLimiter::quad_delivered, [&](const DataQuad& quad) {
+        if (std::find(view_b.cbegin(), view_b.cend(), quad.id) != view_b.cend())
+            std::erase(missing, quad.id);
+        else if (moved)
+            result.stale_quads_delivered++;
+    });
+
+    sl.request_quads(view_a);
+    service.round_trip(&qa);
+    sl.request_quads(view_b);
+    moved = true;
+    while (!missing.empty() && result.round_trips_until_visible < 100) {
+        service.round_trip(&qa);
+        result.round_trips_until_visible++;
+    }
+    return result;
+}
+} // namespace
+
 TEST_CASE("nucleus/tile/slot limiter")
 {
     SECTION("doesn't move when requesting empty array")
@@ -58,11 +130,64 @@ TEST_CASE("nucleus/tile/slot limiter")
         CHECK(spy[0][0].value<Id>() == Id { 0, { 0, 0 } });
         CHECK(spy[1][0].value<Id>() == Id { 1, { 0, 0 } });
 
-        sl.request_quads({ Id { 1, { 1, 0 } } });
+        sl.request_quads({ Id { 0, { 0, 0 } }, Id { 1, { 0, 0 } }, Id { 1, { 1, 0 } } });
         CHECK(sl.slots_taken() == 2);
         CHECK(spy.size() == 2);
     }
 
+    SECTION("in flight quads that are not requested anymore are cancelled")
+    {
+        SlotLimiter sl;
+        sl.set_limit(2);
+        QSignalSpy spy(&sl, &SlotLimiter::quad_requested);
+        QSignalSpy spy_cancelled(&sl, &SlotLimiter::quads_cancelled);
+        sl.request_quads({ Id { 0, { 0, 0 } }, Id { 1, { 0, 0 } }, Id { 1, { 0, 1 } } });
+        REQUIRE(spy.size() == 2);
+        CHECK(spy_cancelled.empty());
+
+        sl.request_quads({ Id { 1, { 1, 0 } }, Id { 1, { 0, 0 } } });
+        REQUIRE(spy_cancelled.size() == 1);
+        const auto cancelled = spy_cancelled[0][0].value<std::vector<Id>>();
+        REQUIRE(cancelled.size() == 1);
+        CHECK(cancelled[0] == Id { 0, { 0, 0 } });
+        CHECK(sl.slots_taken() == 2);
+        REQUIRE(spy.size() == 3);
+        CHECK(spy[2][0].value<Id>() == Id { 1, { 1, 0 } });
+
+        // a cancelled quad that was already on its way is passed on, but doesn't free a slot
+        QSignalSpy spy_delivered(&sl, &SlotLimiter::quad_delivered);
+        sl.request_quads({ Id { 1, { 1, 0 } }, Id { 1, { 0, 0 } }, Id { 2, { 0, 0 } } });
+        CHECK(sl.queue_size() == 1);
+        sl.deliver_quad(DataQuad { Id { 0, { 0, 0 } } });
+        CHECK(spy_delivered.size() == 1);
+        CHECK(sl.slots_taken() == 2);
+        CHECK(sl.queue_size() == 1);
+        CHECK(spy.size() == 3);
+    }
+
+    SECTION("queue follows the priority order of the latest request")
+    {
+        SlotLimiter sl;
+        sl.set_limit(1);
+        QSignalSpy spy(&sl, &SlotLimiter::quad_requested);
+        sl.request_quads({ Id { 0, { 0, 0 } }, Id { 1, { 0, 0 } }, Id { 1, { 0, 1 } }, Id { 1, { 1, 0 } } });
+        REQUIRE(spy.size() == 1);
+        CHECK(sl.queue_size() == 3);
+
+        // camera moved, priorities changed
+        sl.request_quads({ Id { 0, { 0, 0 } }, Id { 1, { 1, 0 } }, Id { 1, { 0, 0 } } });
+        CHECK(sl.queue_size() == 2);
+        sl.deliver_quad(DataQuad { Id { 0, { 0, 0 } } });
+        REQUIRE(spy.size() == 2);
+        CHECK(spy[1][0].value<Id>() == Id { 1, { 1, 0 } });
+        sl.deliver_quad(DataQuad { Id { 1, { 1, 0 } } });
+        REQUIRE(spy.size() == 3);
+        CHECK(spy[2][0].value<Id>() == Id { 1, { 0, 0 } });
+        sl.deliver_quad(DataQuad { Id { 1, { 0, 0 } } });
+        CHECK(spy.size() == 3);
+        CHECK(sl.slots_taken() == 0);
+    }
+
     SECTION("receiving tiles frees up slots")
     {
         SlotLimiter sl;
@@ -193,3 +318,22 @@ TEST_CASE("nucleus/tile/slot limiter")
         CHECK(spy[1][0].value<DataQuad>().id == Id { 1, { 2, 3 } });
     }
 }
+
+TEST_CASE("nucleus/tile/request prioritisation (simulation)")
+{
+    std::vector<Id> view_a;
+    for (unsigned i = 0; i < 64; ++i)
+        view_a.push_back(Id { 10, { i, 0 } });
+    std::vector<Id> view_b;
+    for (unsigned i = 0; i < 32; ++i)
+        view_b.push_back(Id { 12, { i, 7 } });
+
+    // 16 slots, 32 tiles (8 quads) per round trip => 4 round trips for view_b.
+    // without cancellation the 16 stale quads in flight have to be downloaded first, which takes 2 more round trips.
+    const auto with_cancellation = simulate_camera_move(view_a, view_b, true);
+    const auto without_cancellation = simulate_camera_move(view_a, view_b, false);
+    CHECK(with_cancellation.round_trips_until_visible == 4);
+    CHECK(with_cancellation.stale_quads_delivered == 0);
+    CHECK(without_cancellation.round_trips_until_visible == 6);
+    CHECK(without_cancellation.stale_quads_delivered == 16);
+}
@@ -0,0 +1,124 @@
+/*****************************************************************************
+ * AlpineMaps.org
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "nucleus/tile/Cache.h"
+#include "nucleus/utils/ByteBuffer.h"
+
+using nucleus::utils::ByteBuffer;
+
+TEST_CASE("nucleus/utils/ByteBuffer")
+{
+    SECTION("takes over memory without copying")
+    {
+        QByteArray bytes("0123456789");
+        const char* memory = bytes.constData();
+        const auto buffer = ByteBuffer(std::move(bytes));
+        CHECK(buffer.data() == memory);
+        CHECK(buffer.size() == 10);
+        CHECK(buffer.view() == "0123456789");
+        CHECK(buffer.n_copied_bytes() == 0);
+
+        const auto copy = buffer;
+        CHECK(copy.data() == memory);
+        CHECK(copy == buffer);
+    }
+
+    SECTION("default is empty")
+    {
+        const auto buffer = ByteBuffer();
+        CHECK(buffer.empty());
+        CHECK(buffer.size() == 0);
+        CHECK(buffer.begin() == buffer.end());
+        CHECK(buffer == ByteBuffer(QByteArray()));
+    }
+
+    SECTION("slices share the memory and outlive the original")
+    {
+        ByteBuffer slice;
+        const char* memory = nullptr;
+        {
+            const auto buffer = ByteBuffer(QByteArray("0123456789"));
+            memory = buffer.data();
+            slice = buffer.sliced(2, 5);
+        }
+        CHECK(slice.data() == memory + 2);
+        CHECK(slice.string_view() == "23456");
+        CHECK(slice.sliced(1, 3).string_view() == "345");
+        CHECK(slice.sliced(5, 0).empty());
+        CHECK(slice.n_copied_bytes() == 0);
+    }
+
+    SECTION("copies are counted")
+    {
+        const auto buffer = ByteBuffer::copy_of("abcd");
+        CHECK(buffer.view() == "abcd");
+        CHECK(buffer.n_copied_bytes() == 4);
+        CHECK(buffer.sliced(1, 2).n_copied_bytes() == 2);
+    }
+
+    SECTION("slice_or_copy")
+    {
+        const auto buffer = ByteBuffer(QByteArray("0123456789"));
+        const auto inside = buffer.slice_or_copy(buffer.data() + 3, 7);
+        CHECK(inside.data() == buffer.data() + 3);
+        CHECK(inside.n_copied_bytes() == 0);
+
+        const auto overlapping = buffer.slice_or_copy(buffer.data() + 3, 8);
+        CHECK(overlapping.data() != buffer.data() + 3);
+        CHECK(overlapping.n_copied_bytes() == 8);
+
+        const char other[] = "other";
+        const auto outside = buffer.slice_or_copy(other, 5);
+        CHECK(outside.string_view() == "other");
+        CHECK(outside.n_copied_bytes() == 5);
+    }
+
+    SECTION("zppbits round trip")
+    {
+        const auto buffer = ByteBuffer(QByteArray("serialised bytes"));
+        std::vector<char> bytes;
+        zpp::bits::out out(bytes);
+        out(buffer, buffer.sliced(0, 10)).or_throw();
+
+        {
+            // without a source, the bytes are copied out of the archive
+            ByteBuffer a, b;
+            zpp::bits::in in(bytes);
+            in(a, b).or_throw();
+            CHECK(a == buffer);
+            CHECK(b.string_view() == "serialised");
+            CHECK(a.n_copied_bytes() == buffer.size());
+        }
+        {
+            const auto file = ByteBuffer(QByteArray(bytes.data(), qsizetype(bytes.size())));
+            ByteBuffer a, b;
+            zpp::bits::in in(std::span<const char>(file.data(), file.size()));
+            nucleus::tile::detail::deserialisation_source = &file;
+            in(a, b).or_throw();
+            nucleus::tile::detail::deserialisation_source = nullptr;
+            CHECK(a == buffer);
+            CHECK(b.string_view() == "serialised");
+            CHECK(a.n_copied_bytes() == 0);
+            CHECK(b.n_copied_bytes() == 0);
+            CHECK(a.data() >= file.data());
+            CHECK(b.end() <= file.end());
+        }
+    }
+}
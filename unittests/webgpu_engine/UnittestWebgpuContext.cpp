@@ -20,6 +20,7 @@
 #include "UnittestWebgpuContext.h"
 #include "webgpu/base/webgpu_interface.hpp"
 #include <QtAssert>
+#include <catch2/catch_test_macros.hpp>
 #include <iostream>
 #include <limits>
 #include <webgpu/base/RenderResourceRegistry.h>
@@ -136,3 +137,24 @@ UnittestWebgpuContext::UnittestWebgpuContext(bool use_default_limits, WGPULimits
     ctx.init(instance, device, adapter, nullptr, queue);
     ctx.resource_registry().recreate_all(device);
 }
+
+void UnittestWebgpuContext::wait_for_queue() const
+{
+    bool done = false;
+    WGPUQueueWorkDoneStatus work_done_status = WGPUQueueWorkDoneStatus_Success;
+    const auto on_work_done = []([[maybe_unused]] WGPUQueueWorkDoneStatus status, [[maybe_unused]] WGPUStringView message, void* userdata1, void* userdata2) {
+        *reinterpret_cast<WGPUQueueWorkDoneStatus*>(userdata2) = status;
+        *reinterpret_cast<bool*>(userdata1) = true;
+    };
+    WGPUQueueWorkDoneCallbackInfo callback_info {
+        .nextInChain = nullptr,
+        .mode = WGPUCallbackMode_AllowProcessEvents,
+        .callback = on_work_done,
+        .userdata1 = &done,
+        .userdata2 = &work_done_status,
+    };
+    WGPUFuture work_done_future = wgpuQueueOnSubmittedWorkDone(queue, callback_info);
+    WGPUFutureWaitInfo wait_info { .future = work_done_future, .completed = false };
+    REQUIRE(wgpuInstanceWaitAny(instance, 1, &wait_info, 1000 * 1000 * 1000) == WGPUWaitStatus_Success);
+    REQUIRE(work_done_status == WGPUQueueWorkDoneStatus_Success);
+}
@@ -27,6 +27,9 @@ struct UnittestWebgpuContext {
 
     UnittestWebgpuContext(bool use_default_limits = true, WGPULimits required_limits = {});
 
+    // blocks until all submitted work on queue is done (fails the test after a timeout of 1 s)
+    void wait_for_queue() const;
+
     WGPUInstanceDescriptor instance_desc;
 
     WGPUInstance instance = nullptr;
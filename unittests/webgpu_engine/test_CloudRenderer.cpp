@@ -0,0 +1,156 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "UnittestWebgpuContext.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <webgpu/base/RenderResourceRegistry.h>
+#include <webgpu/base/raii/base_types.h>
+#include <webgpu/engine/cloud/CloudRenderer.h>
+
+using webgpu_engine::CloudRenderer;
+
+TEST_CASE("webgpu_engine::CloudRenderer quality")
+{
+    SECTION("presets get cheaper towards low")
+    {
+        using Preset = CloudRenderer::QualityPreset;
+        const auto presets = { Preset::Low, Preset::Medium, Preset::High, Preset::Ultra };
+        CloudRenderer::QualitySettings previous {};
+        bool first = true;
+        for (const auto preset : presets) {
+            const auto quality = CloudRenderer::quality_preset(preset);
+            CHECK(quality.min_steps <= quality.max_steps);
+            CHECK((quality.update_interval == 1 || quality.update_interval == 2 || quality.update_interval == 4));
+            if (!first) {
+                CHECK(quality.max_steps >= previous.max_steps);
+                CHECK(quality.update_interval <= previous.update_interval);
+                CHECK(quality.transmittance_cutoff <= previous.transmittance_cutoff);
+            }
+            previous = quality;
+            first = false;
+        }
+        // the default keeps the previous behaviour
+        CHECK(CloudRenderer::quality_preset(Preset::High).max_steps == CloudRenderer {}.quality.max_steps);
+    }
+
+    SECTION("step count adapts to the frame budget")
+    {
+        auto quality = CloudRenderer::quality_preset(CloudRenderer::QualityPreset::Medium);
+        REQUIRE(quality.frame_budget_ms > 0);
+
+        // without a budget, or without a measurement, the maximum is used
+        auto unbudgeted = quality;
+        unbudgeted.frame_budget_ms = 0;
+        CHECK(CloudRenderer::adapt_step_count(40, 10.0f, unbudgeted) == quality.max_steps);
+        CHECK(CloudRenderer::adapt_step_count(40, 0.0f, quality) == quality.max_steps);
+
+        // within the dead band nothing changes
+        CHECK(CloudRenderer::adapt_step_count(40, quality.frame_budget_ms * 1.05f, quality) == 40);
+
+        // too slow: fewer steps, but never below the minimum
+        const auto fewer = CloudRenderer::adapt_step_count(quality.max_steps, quality.frame_budget_ms * 2, quality);
+        CHECK(fewer < quality.max_steps);
+        CHECK(CloudRenderer::adapt_step_count(quality.min_steps, quality.frame_budget_ms * 100, quality) == quality.min_steps);
+
+        // too fast: more steps, but never above the maximum
+        const auto more = CloudRenderer::adapt_step_count(quality.min_steps, quality.frame_budget_ms / 2, quality);
+        CHECK(more > quality.min_steps);
+        CHECK(CloudRenderer::adapt_step_count(quality.max_steps, quality.frame_budget_ms / 100, quality) == quality.max_steps);
+
+        // converges if the cost is proportional to the step count
+        const float ms_per_step = 0.1f;
+        uint32_t steps = quality.max_steps;
+        for (int i = 0; i < 20; ++i)
+            steps = CloudRenderer::adapt_step_count(steps, float(steps) * ms_per_step, quality);
+        const float measured = float(steps) * ms_per_step;
+        CHECK(measured > quality.frame_budget_ms * 0.85f);
+        CHECK(measured < quality.frame_budget_ms * 1.15f);
+    }
+
+    SECTION("interleaved updates cover every pixel once per interval")
+    {
+        UnittestWebgpuContext context;
+        const glm::uvec2 resolution = { 13, 7 };
+
+        const char* shader_code = R"(
+            ///use webgpu_engine::util/interleave
+
+            @group(0) @binding(0) var<storage, read_write> hits: array<u32>;
+            @group(0) @binding(1) var<storage, read> config: vec4u; // resolution, frame index, interval
+
+            @compute @workgroup_size(8, 8, 1)
+            fn computeMain(@builtin(global_invocation_id) id: vec3u) {
+                let pixel = interleaved_pixel(id.xy, config.z, config.w);
+                if pixel.x >= config.x || pixel.y >= config.y {
+                    return;
+                }
+                // every pixel is written by at most one invocation
+                let index = pixel.y * config.x + pixel.x;
+                if is_pixel_updated(pixel, config.z, config.w) {
+                    hits[index] += 1u;
+                } else {
+                    hits[index] += 1000u;
+                }
+            }
+        )";
+        const auto shader = context.ctx.resource_registry().compile_shader_from_code(context.device, shader_code, "interleave test shader");
+
+        WGPUBindGroupLayoutEntry hits_entry {};
+        hits_entry.binding = 0;
+        hits_entry.visibility = WGPUShaderStage_Compute;
+        hits_entry.buffer.type = WGPUBufferBindingType_Storage;
+        WGPUBindGroupLayoutEntry config_entry {};
+        config_entry.binding = 1;
+        config_entry.visibility = WGPUShaderStage_Compute;
+        config_entry.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+        const webgpu::raii::BindGroupLayout layout(context.device, std::vector<WGPUBindGroupLayoutEntry> { hits_entry, config_entry }, "interleave test layout");
+        webgpu::raii::CombinedComputePipeline pipeline(context.device, *shader, std::vector<const webgpu::raii::BindGroupLayout*> { &layout });
+
+        for (const uint32_t interval : { 1u, 2u, 4u }) {
+            webgpu::raii::RawBuffer<uint32_t> hits(
+                context.device, WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst | WGPUBufferUsage_CopySrc, resolution.x * resolution.y, "hits");
+            const std::vector<uint32_t> zeros(resolution.x * resolution.y, 0);
+            hits.write(context.queue, zeros.data(), zeros.size());
+            webgpu::raii::RawBuffer<glm::uvec4> config(context.device, WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst, 1, "config");
+            const webgpu::raii::BindGroup bind_group(
+                context.device, layout, std::vector<WGPUBindGroupEntry> { hits.create_bind_group_entry(0), config.create_bind_group_entry(1) }, "interleave test");
+
+            // start at an arbitrary frame, the pattern is periodic
+            for (uint32_t frame_index = 5; frame_index < 5 + interval; ++frame_index) {
+                const glm::uvec4 config_data = { resolution, frame_index, interval };
+                config.write(context.queue, &config_data, 1);
+
+                const webgpu::raii::CommandEncoder encoder(context.device, {});
+                const auto size = CloudRenderer::dispatch_size(resolution, interval);
+                pipeline.set_binding(0, bind_group);
+                pipeline.run(encoder, glm::uvec3((size.x + 7) / 8, (size.y + 7) / 8, 1));
+                WGPUCommandBufferDescriptor cmd_buffer_descriptor {};
+                WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder.handle(), &cmd_buffer_descriptor);
+                wgpuQueueSubmit(context.queue, 1, &command);
+                wgpuCommandBufferRelease(command);
+                context.wait_for_queue();
+            }
+
+            std::vector<uint32_t> result;
+            hits.read_back_sync(context.instance, context.device, result);
+            REQUIRE(result.size() == zeros.size());
+            CHECK(std::all_of(result.begin(), result.end(), [](uint32_t n) { return n == 1; }));
+        }
+    }
+}
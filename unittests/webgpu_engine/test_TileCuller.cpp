@@ -0,0 +1,224 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "UnittestWebgpuContext.h"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <nucleus/camera/Definition.h>
+#include <nucleus/srs.h>
+#include <nucleus/tile/utils.h>
+#include <webgpu/base/raii/base_types.h>
+#include <webgpu/engine/tile_mesh/TileCuller.h>
+
+using webgpu_engine::TileCuller;
+
+namespace {
+
+constexpr uint32_t n_slots = 128;
+constexpr unsigned finest_zoom_level = 16;
+
+// the tile containing the target at every zoom level, plus its siblings (geometry tiles are loaded in quads)
+std::vector<nucleus::tile::Id> resident_tile_ids(const glm::dvec2& target)
+{
+    std::vector<nucleus::tile::Id> ids = { nucleus::tile::Id { 0, { 0, 0 } } };
+    for (unsigned zoom_level = 1; zoom_level <= finest_zoom_level; ++zoom_level) {
+        const auto parent = nucleus::srs::world_xy_to_tile_id(target, zoom_level - 1);
+        for (const auto& child : parent.children())
+            ids.push_back(child);
+    }
+    return ids;
+}
+
+uint32_t slot_of(size_t index) { return uint32_t((index * 37) % n_slots); } // scattered, some slots stay empty
+
+bool is_ancestor(const nucleus::tile::Id& ancestor, const nucleus::tile::Id& id)
+{
+    if (ancestor.zoom_level >= id.zoom_level)
+        return false;
+    auto parent = id;
+    while (parent.zoom_level > ancestor.zoom_level)
+        parent = parent.parent();
+    return parent == ancestor;
+}
+
+struct Scene {
+    glm::dvec3 target = nucleus::srs::lat_long_alt_to_world({ 47.074, 12.695, 0 });
+    nucleus::camera::Definition camera;
+    std::vector<nucleus::tile::Id> ids;
+
+    Scene()
+        : camera(target + glm::dvec3(0, -6000, 8000), target)
+        , ids(resident_tile_ids(glm::dvec2(target)))
+    {
+        camera.set_viewport_size({ 1920, 1080 });
+        camera.set_pixel_error_threshold(1.0f);
+    }
+
+    nucleus::tile::Id id_of_slot(uint32_t slot) const
+    {
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (slot_of(i) == slot)
+                return ids[i];
+        }
+        return {};
+    }
+
+    void add_to(TileCuller& culler) const
+    {
+        for (size_t i = 0; i < ids.size(); ++i)
+            culler.add_tile(slot_of(i), ids[i], nucleus::tile::utils::make_bounds(ids[i], 0, 3000));
+    }
+};
+
+std::vector<uint32_t> run_on_gpu(UnittestWebgpuContext& context, TileCuller& culler, const nucleus::camera::Definition& camera, unsigned max_zoom_level)
+{
+    {
+        const webgpu::raii::CommandEncoder encoder(context.device, {});
+        culler.cull(encoder.handle(), camera, max_zoom_level, 42);
+
+        WGPUCommandBufferDescriptor cmd_buffer_descriptor {};
+        cmd_buffer_descriptor.label = WGPUStringView { .data = "tile culling test command buffer", .length = WGPU_STRLEN };
+        WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder.handle(), &cmd_buffer_descriptor);
+        wgpuQueueSubmit(context.queue, 1, &command);
+        wgpuCommandBufferRelease(command);
+    }
+    context.wait_for_queue();
+
+    std::vector<uint32_t> draw_args;
+    culler.indirect_buffer().read_back_sync(context.instance, context.device, draw_args);
+    REQUIRE(draw_args.size() == 5);
+    CHECK(draw_args[0] == 42);
+    CHECK(draw_args[2] == 0);
+    CHECK(draw_args[3] == 0);
+    CHECK(draw_args[4] == 0);
+
+    std::vector<uint32_t> visible;
+    culler.visible_instance_buffer().read_back_sync(context.instance, context.device, visible);
+    REQUIRE(draw_args[1] <= visible.size());
+    visible.resize(draw_args[1]);
+    std::sort(visible.begin(), visible.end());
+    return visible;
+}
+
+} // namespace
+
+TEST_CASE("webgpu_engine::TileCuller")
+{
+    UnittestWebgpuContext context;
+    const Scene scene;
+    TileCuller culler;
+    culler.init(context.ctx, n_slots);
+    scene.add_to(culler);
+    const auto origin = glm::dvec2(scene.camera.position());
+    culler.set_origin(origin);
+
+    SECTION("resident tiles are linked to their parents and children")
+    {
+        const auto& tiles = culler.resident_tiles();
+        for (size_t i = 0; i < scene.ids.size(); ++i) {
+            const auto& tile = tiles[slot_of(i)];
+            CHECK(tile.bounds_min.w == 1.0f);
+            CHECK(tile.zoom_level == scene.ids[i].zoom_level);
+            if (scene.ids[i].zoom_level == 0)
+                CHECK(tile.parent_slot == TileCuller::NO_SLOT);
+            else
+                CHECK(scene.id_of_slot(tile.parent_slot) == scene.ids[i].parent());
+            const bool on_path = scene.ids[i] == nucleus::srs::world_xy_to_tile_id(glm::dvec2(scene.target), scene.ids[i].zoom_level);
+            CHECK(tile.children_mask == ((on_path && scene.ids[i].zoom_level < finest_zoom_level) ? 0xFu : 0u));
+        }
+        CHECK(std::count_if(tiles.begin(), tiles.end(), [](const auto& t) { return t.bounds_min.w != 0.0f; }) == long(scene.ids.size()));
+    }
+
+    SECTION("cpu reference selects a non-overlapping set of visible tiles")
+    {
+        const auto config = TileCuller::make_config(scene.camera, origin, 18, n_slots);
+        const auto selected = TileCuller::select(culler.resident_tiles(), config);
+        REQUIRE(!selected.empty());
+        unsigned finest = 0;
+        for (const auto a : selected) {
+            CHECK(culler.resident_tiles()[a].bounds_min.w == 1.0f);
+            finest = std::max(finest, scene.id_of_slot(a).zoom_level);
+            for (const auto b : selected)
+                CHECK(!is_ancestor(scene.id_of_slot(a), scene.id_of_slot(b)));
+        }
+        CHECK(finest > 8); // camera is close to the ground
+    }
+
+    SECTION("cpu reference respects the pixel error threshold and max zoom level")
+    {
+        const auto finest_zoom_level_of = [&](const std::vector<uint32_t>& selected) {
+            unsigned finest = 0;
+            for (const auto slot : selected)
+                finest = std::max(finest, scene.id_of_slot(slot).zoom_level);
+            return finest;
+        };
+        const auto fine = TileCuller::select(culler.resident_tiles(), TileCuller::make_config(scene.camera, origin, 18, n_slots));
+        auto coarse_camera = scene.camera;
+        coarse_camera.set_pixel_error_threshold(1.0e9f); // only tiles containing the camera are split
+        const auto coarse = TileCuller::select(culler.resident_tiles(), TileCuller::make_config(coarse_camera, origin, 18, n_slots));
+        REQUIRE(!coarse.empty());
+        CHECK(finest_zoom_level_of(coarse) < finest_zoom_level_of(fine));
+
+        const auto capped = TileCuller::select(culler.resident_tiles(), TileCuller::make_config(scene.camera, origin, 5, n_slots));
+        REQUIRE(!capped.empty());
+        for (const auto slot : capped)
+            CHECK(scene.id_of_slot(slot).zoom_level <= 5);
+    }
+
+    SECTION("cpu reference culls tiles behind the camera")
+    {
+        const auto config = TileCuller::make_config(scene.camera, origin, 18, n_slots);
+        const auto tile_at = [&](const glm::dvec3& centre) {
+            TileCuller::ResidentTile tile;
+            tile.bounds_min = glm::vec4(centre - glm::dvec3(origin, 0) - glm::dvec3(100), 1);
+            tile.bounds_max = glm::vec4(centre - glm::dvec3(origin, 0) + glm::dvec3(100), 0);
+            return tile;
+        };
+        CHECK(TileCuller::is_visible(tile_at(scene.camera.position() - scene.camera.z_axis() * 5000.0), config));
+        CHECK(!TileCuller::is_visible(tile_at(scene.camera.position() + scene.camera.z_axis() * 5000.0), config));
+    }
+
+    SECTION("a parent with a missing child is drawn instead of its children")
+    {
+        const auto parent = nucleus::srs::world_xy_to_tile_id(glm::dvec2(scene.target), 10);
+        const auto config = TileCuller::make_config(scene.camera, origin, 18, n_slots);
+        const auto before = TileCuller::select(culler.resident_tiles(), config);
+        culler.remove_tile(parent.children()[0]);
+        const auto after = TileCuller::select(culler.resident_tiles(), config);
+        const auto parent_selected = [&](const std::vector<uint32_t>& selected) {
+            return std::any_of(selected.begin(), selected.end(), [&](uint32_t slot) { return scene.id_of_slot(slot) == parent; });
+        };
+        CHECK(!parent_selected(before));
+        CHECK(parent_selected(after));
+        for (const auto slot : after)
+            CHECK(!is_ancestor(parent, scene.id_of_slot(slot)));
+    }
+
+    SECTION("gpu selection matches the cpu reference")
+    {
+        for (const auto max_zoom_level : { 5u, 12u, 18u }) {
+            const auto expected = TileCuller::select(culler.resident_tiles(), TileCuller::make_config(scene.camera, origin, max_zoom_level, n_slots));
+            CHECK(run_on_gpu(context, culler, scene.camera, max_zoom_level) == expected);
+        }
+
+        // after moving the origin, everything is re-uploaded relative to the new one
+        culler.set_origin(origin + glm::dvec2(12'000, -7'000));
+        const auto expected = TileCuller::select(culler.resident_tiles(), TileCuller::make_config(scene.camera, origin + glm::dvec2(12'000, -7'000), 18, n_slots));
+        CHECK(run_on_gpu(context, culler, scene.camera, 18) == expected);
+    }
+}
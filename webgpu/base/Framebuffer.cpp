@@ -53,7 +53,10 @@ void Framebuffer::recreate_depth_texture()
     // TODO WGPUTextureUsage_TextureBinding currently only needed for line rendering
     //  maybe add parameters, so we dont need every depth texture to be able to be used as texture binding
     //  (to mitigate performance impact)
+    // CopySrc: position readback with the compact gbuffer (only valid for Depth32Float)
     texture_desc.usage = WGPUTextureUsage_RenderAttachment | WGPUTextureUsage_TextureBinding;
+    if (m_format.depth_format == WGPUTextureFormat_Depth32Float)
+        texture_desc.usage |= WGPUTextureUsage_CopySrc;
     texture_desc.viewFormatCount = 1;
     texture_desc.viewFormats = &m_format.depth_format;
     m_depth_texture = std::make_unique<raii::Texture>(m_device, texture_desc);
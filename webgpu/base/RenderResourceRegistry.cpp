@@ -99,6 +99,12 @@ void RenderResourceRegistry::recreate_all(WGPUDevice device)
     qDebug() << "RenderResourceRegistry::recreate_all took" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms";
 }
 
+void RenderResourceRegistry::define(const std::string& symbol) { m_preprocessor.define(symbol); }
+
+void RenderResourceRegistry::undefine(const std::string& symbol) { m_preprocessor.undefine(symbol); }
+
+bool RenderResourceRegistry::is_defined(const std::string& symbol) const { return m_preprocessor.is_defined(symbol); }
+
 std::string RenderResourceRegistry::read_shader_source(const std::string& source_path) const
 {
     // source_path is a logical shader name "target::relpath" (extension omitted).
@@ -54,6 +54,11 @@ public:
     // Recreate order: shaders -> layouts -> pipelines
     void recreate_all(WGPUDevice device);
 
+    // Global shader defines (///ifdef SYMBOL). They take effect with the next recreate_all().
+    void define(const std::string& symbol);
+    void undefine(const std::string& symbol);
+    [[nodiscard]] bool is_defined(const std::string& symbol) const;
+
     // Compile inline WGSL code (with #include preprocessing) without registering it.
     std::unique_ptr<raii::ShaderModule> compile_shader_from_code(WGPUDevice device, const std::string& code, const std::string& label);
 
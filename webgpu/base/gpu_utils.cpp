@@ -35,34 +35,82 @@
 
 namespace webgpu {
 
-namespace {
-    // Registers the mipmap-creation shader and bind group layout once (idempotent), so the
-    // utility is self-contained and does not depend on any higher-level target initialising it.
-    void ensure_mipmap_resources(RenderResourceRegistry& reg)
-    {
-        if (!reg.has_shader("mipmap_creation"))
-            reg.register_shader("mipmap_creation", "webgpu::mipmap");
-
-        if (!reg.has_bind_group_layout("mipmap_creation"))
-            reg.register_bind_group_layout("mipmap_creation", [](WGPUDevice device) {
-                WGPUBindGroupLayoutEntry input_entry {};
-                input_entry.binding = 0;
-                input_entry.visibility = WGPUShaderStage_Compute;
-                input_entry.texture.sampleType = WGPUTextureSampleType_Float;
-                input_entry.texture.viewDimension = WGPUTextureViewDimension_2D;
-
-                WGPUBindGroupLayoutEntry output_entry {};
-                output_entry.binding = 1;
-                output_entry.visibility = WGPUShaderStage_Compute;
-                output_entry.storageTexture.viewDimension = WGPUTextureViewDimension_2D;
-                output_entry.storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
-                output_entry.storageTexture.format = WGPUTextureFormat_RGBA8Unorm;
-
-                return std::make_unique<raii::BindGroupLayout>(
-                    device, std::vector<WGPUBindGroupLayoutEntry> { input_entry, output_entry }, "mipmap creation bind group layout");
-            });
+void register_mipmap_resources(RenderResourceRegistry& reg)
+{
+    if (!reg.has_shader("mipmap_creation"))
+        reg.register_shader("mipmap_creation", "webgpu::mipmap");
+
+    if (!reg.has_bind_group_layout("mipmap_creation"))
+        reg.register_bind_group_layout("mipmap_creation", [](WGPUDevice device) {
+            WGPUBindGroupLayoutEntry input_entry {};
+            input_entry.binding = 0;
+            input_entry.visibility = WGPUShaderStage_Compute;
+            input_entry.texture.sampleType = WGPUTextureSampleType_Float;
+            input_entry.texture.viewDimension = WGPUTextureViewDimension_2D;
+
+            WGPUBindGroupLayoutEntry output_entry {};
+            output_entry.binding = 1;
+            output_entry.visibility = WGPUShaderStage_Compute;
+            output_entry.storageTexture.viewDimension = WGPUTextureViewDimension_2D;
+            output_entry.storageTexture.access = WGPUStorageTextureAccess_WriteOnly;
+            output_entry.storageTexture.format = WGPUTextureFormat_RGBA8Unorm;
+
+            return std::make_unique<raii::BindGroupLayout>(
+                device, std::vector<WGPUBindGroupLayoutEntry> { input_entry, output_entry }, "mipmap creation bind group layout");
+        });
+}
+
+std::unique_ptr<raii::CombinedComputePipeline> create_mipmap_pipeline(WGPUDevice device, const RenderResourceRegistry& reg)
+{
+    return std::make_unique<raii::CombinedComputePipeline>(device,
+        reg.shader("mipmap_creation"),
+        std::vector<const raii::BindGroupLayout*> { &reg.bind_group_layout("mipmap_creation") },
+        "mipmap creation compute pipeline");
+}
+
+void encode_mipmaps_for_texture_layers(WGPUDevice device,
+    const RenderResourceRegistry& reg,
+    WGPUCommandEncoder encoder,
+    const raii::CombinedComputePipeline& pipeline,
+    const raii::Texture& texture,
+    const std::vector<uint32_t>& layers)
+{
+    constexpr glm::uvec3 SHADER_WORKGROUP_SIZE = { 8, 8, 1 };
+    const glm::uvec2 base_size = { texture.width(), texture.height() };
+    const uint32_t mip_level_count = texture.mip_level_count();
+    if (mip_level_count == 1 || layers.empty())
+        return;
+
+    for (const auto layer : layers) {
+        std::vector<std::unique_ptr<raii::TextureView>> mip_views;
+        for (uint32_t i = 0; i < mip_level_count; i++) {
+            WGPUTextureViewDescriptor view_desc {};
+            view_desc.dimension = WGPUTextureViewDimension::WGPUTextureViewDimension_2D;
+            view_desc.format = WGPUTextureFormat::WGPUTextureFormat_RGBA8Unorm;
+            view_desc.baseMipLevel = i;
+            view_desc.mipLevelCount = 1;
+            view_desc.baseArrayLayer = layer;
+            view_desc.arrayLayerCount = 1;
+            view_desc.aspect = WGPUTextureAspect::WGPUTextureAspect_All;
+            mip_views.push_back(std::make_unique<raii::TextureView>(texture.handle(), view_desc));
+        }
+
+        for (uint32_t i = 0; i < mip_level_count - 1; i++) {
+            raii::BindGroup bind_group(device,
+                reg.bind_group_layout("mipmap_creation"),
+                std::vector<WGPUBindGroupEntry> { mip_views[i]->create_bind_group_entry(0), mip_views[i + 1]->create_bind_group_entry(1) },
+                "mipmap creation bindgroup");
+
+            WGPUComputePassDescriptor compute_pass_desc {};
+            raii::ComputePassEncoder compute_pass(encoder, compute_pass_desc);
+
+            const glm::uvec2 next_size = glm::max(base_size >> (i + 1), glm::uvec2(1));
+            const glm::uvec3 workgroup_counts = glm::ceil(glm::vec3(next_size.x, next_size.y, 1) / glm::vec3(SHADER_WORKGROUP_SIZE));
+            wgpuComputePassEncoderSetBindGroup(compute_pass.handle(), 0, bind_group.handle(), 0, nullptr);
+            pipeline.run(compute_pass, workgroup_counts);
+        }
     }
-} // namespace
+}
 
 void compute_mipmaps_for_texture(Context& ctx, const raii::Texture* texture) { compute_mipmaps_for_texture(ctx, texture, {}); }
 
@@ -71,9 +119,8 @@ void compute_mipmaps_for_texture(Context& ctx, const raii::Texture* texture, WGP
     WGPUDevice device = ctx.device();
     WGPUQueue queue = ctx.queue();
     auto& reg = ctx.resource_registry();
-    ensure_mipmap_resources(reg);
+    register_mipmap_resources(reg);
 
-    glm::uvec2 baseSize = { texture->width(), texture->height() };
     uint32_t mipLevelCount = texture->mip_level_count();
 
     if (mipLevelCount == 1) {
@@ -83,52 +130,12 @@ void compute_mipmaps_for_texture(Context& ctx, const raii::Texture* texture, WGP
         qDebug() << "Computing" << mipLevelCount << "mipmaps for texture";
     }
 
-    raii::CombinedComputePipeline pipeline(device,
-        reg.shader("mipmap_creation"),
-        std::vector<const raii::BindGroupLayout*> { &reg.bind_group_layout("mipmap_creation") },
-        "mipmap creation compute pipeline");
-
-    std::vector<std::unique_ptr<raii::TextureView>> textureMipViews;
-    std::vector<WGPUExtent3D> mipSizes(mipLevelCount);
-
-    for (uint32_t i = 0; i < mipLevelCount; i++) {
-        WGPUTextureViewDescriptor viewDesc {};
-        viewDesc.dimension = WGPUTextureViewDimension::WGPUTextureViewDimension_2D;
-        viewDesc.format = WGPUTextureFormat::WGPUTextureFormat_RGBA8Unorm;
-        viewDesc.baseMipLevel = i;
-        viewDesc.mipLevelCount = 1;
-        viewDesc.baseArrayLayer = 0;
-        viewDesc.arrayLayerCount = 1;
-        viewDesc.aspect = WGPUTextureAspect::WGPUTextureAspect_All;
-        textureMipViews.push_back(std::make_unique<raii::TextureView>(texture->handle(), viewDesc));
-
-        mipSizes[i].width = std::max(1u, baseSize.x >> i);
-        mipSizes[i].height = std::max(1u, baseSize.y >> i);
-        mipSizes[i].depthOrArrayLayers = 1;
-    }
-
-    std::vector<std::unique_ptr<raii::BindGroup>> bindGroups;
-    for (uint32_t i = 0; i < mipLevelCount - 1; i++) {
-        std::vector<WGPUBindGroupEntry> bgEntries {
-            textureMipViews[i]->create_bind_group_entry(0),
-            textureMipViews[i + 1]->create_bind_group_entry(1),
-        };
-        bindGroups.push_back(std::make_unique<raii::BindGroup>(device, reg.bind_group_layout("mipmap_creation"), bgEntries, "mipmap creation bindgroup"));
-    }
-
-    constexpr glm::uvec3 SHADER_WORKGROUP_SIZE = { 8, 8, 1 };
+    const auto pipeline = create_mipmap_pipeline(device, reg);
     {
         WGPUCommandEncoderDescriptor descriptor {};
         raii::CommandEncoder encoder(device, descriptor);
 
-        for (uint32_t i = 0; i < mipLevelCount - 1; i++) {
-            WGPUComputePassDescriptor compute_pass_desc {};
-            raii::ComputePassEncoder compute_pass(encoder.handle(), compute_pass_desc);
-
-            glm::uvec3 workgroup_counts = glm::ceil(glm::vec3(mipSizes[i + 1].width, mipSizes[i + 1].height, 1) / glm::vec3(SHADER_WORKGROUP_SIZE));
-            wgpuComputePassEncoderSetBindGroup(compute_pass.handle(), 0, bindGroups[i]->handle(), 0, nullptr);
-            pipeline.run(compute_pass, workgroup_counts);
-        }
+        encode_mipmaps_for_texture_layers(device, reg, encoder.handle(), *pipeline, *texture, { 0u });
 
         WGPUCommandBufferDescriptor cmd_buffer_descriptor {};
         cmd_buffer_descriptor.label = WGPUStringView { .data = "MipMap command buffer", .length = WGPU_STRLEN };
@@ -19,13 +19,17 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
 #include <webgpu/webgpu.h>
 
 namespace webgpu {
 
 class Context;
+class RenderResourceRegistry;
 namespace raii {
     class Texture;
+    class CombinedComputePipeline;
 }
 
 // Computes the mipmap chain for the given RGBA8Unorm texture using a compute shader
@@ -34,4 +38,17 @@ void compute_mipmaps_for_texture(Context& ctx, const raii::Texture* texture);
 // Async overload: calls on_done after the mipmap work is submitted to the queue.
 void compute_mipmaps_for_texture(Context& ctx, const raii::Texture* texture, WGPUQueueWorkDoneCallbackInfo on_done);
 
+// Registers the mipmap shader and bind group layout (idempotent). Call before creating the pipeline below.
+void register_mipmap_resources(RenderResourceRegistry& reg);
+std::unique_ptr<raii::CombinedComputePipeline> create_mipmap_pipeline(WGPUDevice device, const RenderResourceRegistry& reg);
+
+// Records the downsampling passes for the given array layers of an RGBA8Unorm texture into encoder.
+// Mip level 0 of each layer must be filled already, the texture needs StorageBinding usage.
+void encode_mipmaps_for_texture_layers(WGPUDevice device,
+    const RenderResourceRegistry& reg,
+    WGPUCommandEncoder encoder,
+    const raii::CombinedComputePipeline& pipeline,
+    const raii::Texture& texture,
+    const std::vector<uint32_t>& layers);
+
 } // namespace webgpu
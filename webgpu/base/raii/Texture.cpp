@@ -54,6 +54,7 @@ uint8_t Texture::get_bytes_per_element(WGPUTextureFormat format)
     case WGPUTextureFormat_R32Uint:
     case WGPUTextureFormat_R32Sint:
     case WGPUTextureFormat_R32Float:
+    case WGPUTextureFormat_Depth32Float:
     case WGPUTextureFormat_RG16Uint:
     case WGPUTextureFormat_RG16Sint:
     case WGPUTextureFormat_RG16Float:
@@ -100,24 +101,74 @@ uint32_t Texture::max_mip_level_count(glm::uvec2 size)
     return std::max<uint32_t>(1u, std::bit_width(m));
 }
 
-void Texture::write(WGPUQueue queue, const nucleus::utils::ColourTexture& data, uint32_t layer)
+glm::uvec2 Texture::block_extent(WGPUTextureFormat format)
 {
-    Q_ASSERT(static_cast<uint32_t>(data.width()) == m_descriptor.size.width);
-    Q_ASSERT(static_cast<uint32_t>(data.height()) == m_descriptor.size.height);
-    Q_ASSERT(data.format() == nucleus::utils::ColourTexture::Format::Uncompressed_RGBA); // TODO compressed textures
+    switch (format) {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+    case WGPUTextureFormat_ETC2RGB8Unorm:
+    case WGPUTextureFormat_ETC2RGB8UnormSrgb:
+        return { 4, 4 };
+    default:
+        return { 1, 1 };
+    }
+}
+
+uint32_t Texture::block_size_in_bytes(WGPUTextureFormat format)
+{
+    switch (format) {
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+    case WGPUTextureFormat_ETC2RGB8Unorm:
+    case WGPUTextureFormat_ETC2RGB8UnormSrgb:
+        return 8;
+    default:
+        return get_bytes_per_element(format);
+    }
+}
+
+WGPUTextureFormat Texture::colour_texture_format(nucleus::utils::ColourTexture::Format format)
+{
+    switch (format) {
+    case nucleus::utils::ColourTexture::Format::Uncompressed_RGBA:
+        return WGPUTextureFormat_RGBA8Unorm;
+    case nucleus::utils::ColourTexture::Format::DXT1:
+        return WGPUTextureFormat_BC1RGBAUnorm;
+    case nucleus::utils::ColourTexture::Format::ETC1:
+        // ETC2 decoders are backwards compatible with ETC1 data
+        return WGPUTextureFormat_ETC2RGB8Unorm;
+    }
+    Q_ASSERT(false && "Unsupported colour texture format");
+    return WGPUTextureFormat_Undefined;
+}
+
+void Texture::write(WGPUQueue queue, const nucleus::utils::ColourTexture& data, uint32_t layer, uint32_t mip_level)
+{
+    Q_ASSERT(mip_level < m_descriptor.mipLevelCount);
+    Q_ASSERT(data.width() == std::max(1u, m_descriptor.size.width >> mip_level));
+    Q_ASSERT(data.height() == std::max(1u, m_descriptor.size.height >> mip_level));
+    Q_ASSERT(colour_texture_format(data.format()) == m_descriptor.format);
 
     WGPUTexelCopyTextureInfo image_copy_texture {};
     image_copy_texture.texture = m_handle;
     image_copy_texture.aspect = WGPUTextureAspect::WGPUTextureAspect_All;
-    image_copy_texture.mipLevel = 0;
+    image_copy_texture.mipLevel = mip_level;
     image_copy_texture.origin = WGPUOrigin3D { 0, 0, layer };
 
+    // compressed mip levels smaller than a block are still stored (and copied) as one full block
+    const auto block = block_extent(m_descriptor.format);
+    const auto n_blocks = (glm::uvec2(data.width(), data.height()) + block - 1u) / block;
+
     WGPUTexelCopyBufferLayout texture_data_layout {};
-    texture_data_layout.bytesPerRow = 4 * data.width(); // for uncompressed RGBA
-    texture_data_layout.rowsPerImage = data.height();
+    texture_data_layout.bytesPerRow = n_blocks.x * block_size_in_bytes(m_descriptor.format);
+    texture_data_layout.rowsPerImage = n_blocks.y;
     texture_data_layout.offset = 0;
 
-    WGPUExtent3D copy_extent { m_descriptor.size.width, m_descriptor.size.height, 1 };
+    WGPUExtent3D copy_extent { n_blocks.x * block.x, n_blocks.y * block.y, 1 };
 
     wgpuQueueWriteTexture(queue, &image_copy_texture, data.data(), data.n_bytes(), &texture_data_layout, &copy_extent);
 }
@@ -300,4 +351,19 @@ size_t Texture::bytes_per_row() const
 
 size_t Texture::single_layer_size_in_bytes() const { return bytes_per_row() * m_descriptor.size.height; }
 
+size_t Texture::allocated_size_in_bytes() const
+{
+    const bool is_3d = m_descriptor.dimension == WGPUTextureDimension_3D;
+    const auto block = block_extent(m_descriptor.format);
+    const auto size = glm::uvec2(m_descriptor.size.width, m_descriptor.size.height);
+    size_t n_bytes = 0;
+    for (uint32_t level = 0; level < m_descriptor.mipLevelCount; ++level) {
+        const auto n_blocks = (glm::max(size >> level, glm::uvec2(1)) + block - 1u) / block;
+        // array layers stay constant over the mip chain, 3d slices are halved like width and height
+        const auto n_slices = is_3d ? std::max(1u, m_descriptor.size.depthOrArrayLayers >> level) : m_descriptor.size.depthOrArrayLayers;
+        n_bytes += size_t(n_blocks.x) * n_blocks.y * n_slices * block_size_in_bytes(m_descriptor.format);
+    }
+    return n_bytes;
+}
+
 } // namespace webgpu::raii
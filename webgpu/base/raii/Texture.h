@@ -49,6 +49,13 @@ public:
     static uint8_t get_bytes_per_element(WGPUTextureFormat format);
     static uint32_t max_mip_level_count(glm::uvec2 size);
 
+    /// block extent (texels) and size (bytes) of a format. uncompressed formats have 1x1 blocks.
+    static glm::uvec2 block_extent(WGPUTextureFormat format);
+    static uint32_t block_size_in_bytes(WGPUTextureFormat format);
+
+    /// maps the compression of a ColourTexture to the matching (web)GPU format
+    static WGPUTextureFormat colour_texture_format(nucleus::utils::ColourTexture::Format format);
+
     static const uint16_t BYTES_PER_ROW_PADDING;
 
 public:
@@ -78,7 +85,7 @@ public:
         wgpuQueueWriteTexture(queue, &texel_copy_texture_info, data.bytes().data(), uint32_t(data.bytes().size()), &texture_data_layout_info, &copy_extent);
     }
 
-    void write(WGPUQueue queue, const nucleus::utils::ColourTexture& data, uint32_t layer = 0);
+    void write(WGPUQueue queue, const nucleus::utils::ColourTexture& data, uint32_t layer = 0, uint32_t mip_level = 0);
     void write(WGPUQueue queue, const nucleus::utils::ColourTexture3D& data, glm::uvec3 offset = glm::uvec3(0), uint32_t base_mip_level = 0);
 
     // submits to default queue of device
@@ -148,6 +155,8 @@ public:
     size_t size_in_bytes() const;
     size_t bytes_per_row() const;
     size_t single_layer_size_in_bytes() const;
+    /// gpu memory occupied by all layers and mip levels (without row padding), also for block compressed formats
+    size_t allocated_size_in_bytes() const;
 };
 
 } // namespace webgpu::raii
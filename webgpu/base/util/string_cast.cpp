@@ -38,4 +38,21 @@ const char* bufferMapAsyncStatusToString(WGPUMapAsyncStatus status)
     return "UnknownStatus";
 }
 
+const char* textureFormatToString(WGPUTextureFormat format)
+{
+    static const std::map<WGPUTextureFormat, const char*> formatToStringMap = {
+        { WGPUTextureFormat_R16Uint, "R16Uint" },
+        { WGPUTextureFormat_RGBA8Unorm, "RGBA8Unorm" },
+        { WGPUTextureFormat_BC1RGBAUnorm, "BC1RGBAUnorm" },
+        { WGPUTextureFormat_BC4RUnorm, "BC4RUnorm" },
+        { WGPUTextureFormat_ETC2RGB8Unorm, "ETC2RGB8Unorm" },
+    };
+
+    auto it = formatToStringMap.find(format);
+    if (it != formatToStringMap.end()) {
+        return it->second;
+    }
+    return "UnknownFormat";
+}
+
 } // namespace webgpu::util
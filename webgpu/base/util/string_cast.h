@@ -24,5 +24,6 @@
 namespace webgpu::util {
 
 const char* bufferMapAsyncStatusToString(WGPUMapAsyncStatus status);
+const char* textureFormatToString(WGPUTextureFormat format);
 
 } // namespace webgpu::util
@@ -86,7 +86,7 @@ void RequestTilesNode::on_single_tile_received(const nucleus::tile::Data& tile)
                    << (tile.network_info.status == nucleus::tile::NetworkInfo::Status::NotFound ? "Not found" : "Network error");
     } else {
         size_t found_index = found_it - m_requested_tile_ids.begin();
-        m_received_tile_textures[found_index] = *tile.data;
+        m_received_tile_textures[found_index] = tile.data.view().toByteArray();
     }
 
     check_progress_and_emit_signals();
@@ -169,8 +169,17 @@ void Window::paint(webgpu::Framebuffer* framebuffer, WGPUCommandEncoder command_
     // render atmosphere to color buffer
     m_context->atmosphere_renderer()->draw(command_encoder, m_camera_bind_group->handle());
 
+    // select tiles on the gpu
+    if (m_gpu_culling_enabled)
+        m_context->tile_mesh_renderer()->cull(command_encoder, m_camera, m_max_zoom_level);
+
     // render tiles to geometry buffers
-    {
+    if (m_gpu_culling_enabled) {
+        std::unique_ptr<webgpu::raii::RenderPassEncoder> render_pass = m_gbuffer->begin_render_pass(command_encoder);
+        wgpuRenderPassEncoderSetBindGroup(render_pass->handle(), 0, m_shared_config_bind_group->handle(), 0, nullptr);
+        wgpuRenderPassEncoderSetBindGroup(render_pass->handle(), 1, m_camera_bind_group->handle(), 0, nullptr);
+        m_context->tile_mesh_renderer()->draw_culled(render_pass->handle());
+    } else {
         std::unique_ptr<webgpu::raii::RenderPassEncoder> render_pass = m_gbuffer->begin_render_pass(command_encoder);
         wgpuRenderPassEncoderSetBindGroup(render_pass->handle(), 0, m_shared_config_bind_group->handle(), 0, nullptr);
         wgpuRenderPassEncoderSetBindGroup(render_pass->handle(), 1, m_camera_bind_group->handle(), 0, nullptr);
@@ -192,9 +201,9 @@ void Window::paint(webgpu::Framebuffer* framebuffer, WGPUCommandEncoder command_
 
     // render overlay textures (height lines, tile debug, etc.)
     m_context->overlay_renderer()->draw(command_encoder,
-        m_gbuffer->color_texture_view(1),
-        m_gbuffer->color_texture_view(2),
-        m_gbuffer->color_texture_view(3),
+        gbuffer_position_view(),
+        gbuffer_normal_view(),
+        gbuffer_overlay_view(),
         m_shared_config_bind_group->handle(),
         m_camera_bind_group->handle());
 
@@ -226,16 +235,37 @@ glm::vec4 Window::synchronous_position_readback(const glm::dvec2& ndc)
         // clamp device coordinates to the swapchain size
         device_coordinates = glm::clamp(device_coordinates, glm::uvec2(0), glm::uvec2(m_swapchain_size - glm::vec2(1.0)));
 
-        const auto& src_texture = m_gbuffer->color_texture(1);
-        // Need to read a multiple of 16 values to fit requirement for texture_to_buffer copy
-        src_texture.copy_to_buffer(
-            m_context->webgpu_ctx().device(), *m_position_readback_buffer.get(), glm::uvec3(device_coordinates.x, device_coordinates.y, 0), glm::uvec2(16, 1));
-
-        std::vector<glm::vec4> pos_buffer;
-        WGPUMapAsyncStatus result
-            = m_position_readback_buffer->read_back_sync(m_context->webgpu_ctx().instance(), m_context->webgpu_ctx().device(), pos_buffer);
-        if (result == WGPUMapAsyncStatus_Success) {
-            m_last_position_readback = pos_buffer[0];
+        if (is_gbuffer_compact()) {
+            m_gbuffer->depth_texture().copy_to_buffer(
+                m_context->webgpu_ctx().device(), *m_depth_readback_buffer.get(), glm::uvec3(device_coordinates.x, device_coordinates.y, 0), glm::uvec2(1, 1));
+
+            std::vector<float> depth_buffer;
+            WGPUMapAsyncStatus result
+                = m_depth_readback_buffer->read_back_sync(m_context->webgpu_ctx().instance(), m_context->webgpu_ctx().device(), depth_buffer);
+            if (result == WGPUMapAsyncStatus_Success) {
+                // same as gbuffer_load_position in util/gbuffer.wgsl (reverse z, cleared to 0), but in double precision
+                const double depth = depth_buffer[0];
+                m_last_position_readback = glm::vec4(0.0f);
+                if (depth > 0.0) {
+                    const auto view_pos = glm::inverse(m_camera.projection_matrix()) * glm::dvec4(ndc.x, ndc.y, depth, 1.0);
+                    const auto pos_cws = glm::dmat3(m_camera.model_matrix()) * (glm::dvec3(view_pos) / view_pos.w);
+                    m_last_position_readback = glm::vec4(pos_cws, glm::length(pos_cws));
+                }
+            }
+        } else {
+            const auto& src_texture = m_gbuffer->color_texture(1);
+            // Need to read a multiple of 16 values to fit requirement for texture_to_buffer copy
+            src_texture.copy_to_buffer(m_context->webgpu_ctx().device(),
+                *m_position_readback_buffer.get(),
+                glm::uvec3(device_coordinates.x, device_coordinates.y, 0),
+                glm::uvec2(16, 1));
+
+            std::vector<glm::vec4> pos_buffer;
+            WGPUMapAsyncStatus result
+                = m_position_readback_buffer->read_back_sync(m_context->webgpu_ctx().instance(), m_context->webgpu_ctx().device(), pos_buffer);
+            if (result == WGPUMapAsyncStatus_Success) {
+                m_last_position_readback = pos_buffer[0];
+            }
         }
     } // else qDebug() << "Dropped position readback request, buffer still mapping.";
 
@@ -245,6 +275,29 @@ glm::vec4 Window::synchronous_position_readback(const glm::dvec2& ndc)
 
 void Window::set_max_zoom_level(uint32_t max_zoom_level) { m_max_zoom_level = max_zoom_level; }
 
+void Window::set_gpu_culling_enabled(bool enabled)
+{
+    m_gpu_culling_enabled = enabled;
+    m_needs_redraw = true;
+}
+
+void Window::set_compact_gbuffer_enabled(bool enabled)
+{
+    auto& reg = m_context->webgpu_ctx().resource_registry();
+    if (enabled == reg.is_defined(TileMeshRenderer::COMPACT_GBUFFER_DEFINE))
+        return;
+    if (enabled)
+        reg.define(TileMeshRenderer::COMPACT_GBUFFER_DEFINE);
+    else
+        reg.undefine(TileMeshRenderer::COMPACT_GBUFFER_DEFINE);
+
+    // the tile pipeline decides on the gbuffer format, hence recompile first
+    reg.recreate_all(m_context->webgpu_ctx().device());
+    if (m_gbuffer)
+        resize_framebuffer(int(m_swapchain_size.x), int(m_swapchain_size.y));
+    request_redraw();
+}
+
 float Window::depth([[maybe_unused]] const glm::dvec2& normalised_device_coordinates)
 {
     auto position = synchronous_position_readback(normalised_device_coordinates);
@@ -309,6 +362,8 @@ void Window::create_buffers()
         = std::make_unique<webgpu::Buffer<uboCameraConfig>>(m_context->webgpu_ctx().device(), WGPUBufferUsage_CopyDst | WGPUBufferUsage_Uniform);
     m_position_readback_buffer = std::make_unique<webgpu::raii::RawBuffer<glm::vec4>>(
         m_context->webgpu_ctx().device(), WGPUBufferUsage_CopyDst | WGPUBufferUsage_MapRead, 256 / sizeof(glm::vec4), "position readback buffer");
+    m_depth_readback_buffer = std::make_unique<webgpu::raii::RawBuffer<float>>(
+        m_context->webgpu_ctx().device(), WGPUBufferUsage_CopyDst | WGPUBufferUsage_MapRead, 256 / sizeof(float), "depth readback buffer");
 }
 
 void Window::create_bind_groups()
@@ -328,11 +383,11 @@ void Window::recreate_compose_bind_group()
         m_compose_bind_groups[i] = std::make_unique<webgpu::raii::BindGroup>(m_context->webgpu_ctx().device(),
             m_context->webgpu_ctx().resource_registry().bind_group_layout("compose"),
             std::initializer_list<WGPUBindGroupEntry> {
-                m_gbuffer->color_texture_view(0).create_bind_group_entry(0), // albedo texture
-                m_gbuffer->color_texture_view(1).create_bind_group_entry(1), // position texture
-                m_gbuffer->color_texture_view(2).create_bind_group_entry(2), // normal texture
+                gbuffer_albedo_view().create_bind_group_entry(0), // albedo texture
+                gbuffer_position_view().create_bind_group_entry(1), // position texture
+                gbuffer_normal_view().create_bind_group_entry(2), // normal texture
                 m_context->atmosphere_renderer()->result_view()->create_bind_group_entry(3), // atmosphere texture
-                m_gbuffer->color_texture_view(3).create_bind_group_entry(4), // overlay texture
+                gbuffer_overlay_view().create_bind_group_entry(4), // overlay texture
                 m_context->cloud_renderer()->result_color_view(i)->create_bind_group_entry(5),
                 m_context->cloud_renderer()->result_depth_view()->create_bind_group_entry(6),
                 m_shadow_texture->texture_view().create_bind_group_entry(7),
@@ -344,6 +399,19 @@ void Window::recreate_compose_bind_group()
     }
 }
 
+bool Window::is_gbuffer_compact() const { return m_gbuffer_format.color_formats.size() == 2; }
+
+const webgpu::raii::TextureView& Window::gbuffer_albedo_view() { return m_gbuffer->color_texture_view(0); }
+
+const webgpu::raii::TextureView& Window::gbuffer_position_view()
+{
+    return is_gbuffer_compact() ? m_gbuffer->depth_texture_view() : m_gbuffer->color_texture_view(1);
+}
+
+const webgpu::raii::TextureView& Window::gbuffer_normal_view() { return m_gbuffer->color_texture_view(is_gbuffer_compact() ? 1 : 2); }
+
+const webgpu::raii::TextureView& Window::gbuffer_overlay_view() { return m_gbuffer->color_texture_view(is_gbuffer_compact() ? 0 : 3); }
+
 void Window::update_required_gpu_limits(WGPULimits& limits, const WGPULimits& supported_limits)
 {
     const uint32_t max_required_bind_groups = 4u;
@@ -58,6 +58,11 @@ public:
     void update_required_gpu_limits(WGPULimits& limits, const WGPULimits& supported_limits);
 
     void set_max_zoom_level(uint32_t max_zoom_level);
+    // selects the tiles on the gpu (TileMeshRenderer::cull) instead of nucleus::tile::drawing
+    void set_gpu_culling_enabled(bool enabled);
+    // 16 instead of 32 bytes per pixel: albedo and overlay share a texture, the position is reconstructed from depth.
+    // recompiles all shaders (see util/gbuffer.wgsl).
+    void set_compact_gbuffer_enabled(bool enabled);
 
 public slots:
     void update_camera(const nucleus::camera::Definition& new_definition) override;
@@ -73,17 +78,26 @@ signals:
 
 private:
     std::unique_ptr<webgpu::raii::RawBuffer<glm::vec4>> m_position_readback_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<float>> m_depth_readback_buffer;
     glm::vec4 m_last_position_readback;
 
     void create_buffers();
     void create_bind_groups();
     void recreate_compose_bind_group();
 
+    // geometry buffer views by content, the attachment indices depend on the layout
+    bool is_gbuffer_compact() const;
+    const webgpu::raii::TextureView& gbuffer_albedo_view();
+    const webgpu::raii::TextureView& gbuffer_position_view();
+    const webgpu::raii::TextureView& gbuffer_normal_view();
+    const webgpu::raii::TextureView& gbuffer_overlay_view();
+
     // A helper function for the depth and position method.
     // ATTENTION: This function is synchronous and will hold rendering. Use with caution!
     // Note: Depth aswell as the position is saved in the gbuffer. In contrast to the gl version
     // we can directly readback the content of the position buffer and don't need the readback depth
     // buffer anymore. May actually increase performance as we don't need to fill the seperate buffer.
+    // With the compact gbuffer, the depth buffer is read back and the position reconstructed on the cpu.
     glm::vec4 synchronous_position_readback(const glm::dvec2& normalised_device_coordinates);
 
     std::unique_ptr<webgpu::raii::TextureWithSampler> create_shadow_texture(uint32_t width, uint32_t height, uint32_t mip_levels);
@@ -101,6 +115,7 @@ private:
 
     nucleus::camera::Definition m_camera;
     uint32_t m_max_zoom_level = 18;
+    bool m_gpu_culling_enabled = false;
 
     webgpu::FramebufferFormat m_gbuffer_format;
     std::unique_ptr<webgpu::Framebuffer> m_gbuffer;
@@ -22,10 +22,14 @@
 #include "nucleus/camera/Definition.h"
 #include "nucleus/srs.h"
 #include "nucleus/utils/terrain_mesh_index_generator.h"
+#include <QDebug>
 #include <QtAssert>
+#include <algorithm>
+#include <cmath>
 
 #include <webgpu/base/RenderResourceRegistry.h>
 #include <webgpu/base/raii/BindGroupLayout.h>
+#include <webgpu/base/webgpu_interface.hpp>
 
 using namespace webgpu_engine::clouds;
 namespace webgpu_engine {
@@ -35,6 +39,48 @@ CloudRenderer::CloudRenderer()
 {
 }
 
+CloudRenderer::QualitySettings CloudRenderer::quality_preset(QualityPreset preset)
+{
+    switch (preset) {
+    case QualityPreset::Low:
+        return { .update_interval = 4, .min_steps = 24, .max_steps = 48, .transmittance_cutoff = 0.05f, .frame_budget_ms = 2.0f };
+    case QualityPreset::Medium:
+        return { .update_interval = 2, .min_steps = 32, .max_steps = 64, .transmittance_cutoff = 0.03f, .frame_budget_ms = 3.0f };
+    case QualityPreset::High:
+        return { .update_interval = 1, .min_steps = 48, .max_steps = 128, .transmittance_cutoff = 0.01f, .frame_budget_ms = 0.0f };
+    case QualityPreset::Ultra:
+        return { .update_interval = 1, .min_steps = 64, .max_steps = 192, .transmittance_cutoff = 0.005f, .frame_budget_ms = 0.0f };
+    }
+    return {};
+}
+
+uint32_t CloudRenderer::adapt_step_count(uint32_t step_count, float measured_ms, const QualitySettings& quality)
+{
+    if (quality.frame_budget_ms <= 0.0f || measured_ms <= 0.0f)
+        return quality.max_steps;
+
+    step_count = std::clamp(step_count, quality.min_steps, quality.max_steps);
+    const float ratio = quality.frame_budget_ms / measured_ms;
+    if (ratio > 0.9f && ratio < 1.1f)
+        return step_count; // dead band, avoids oscillation
+
+    // damped, only part of the time is spent marching
+    const float target = float(step_count) * std::sqrt(ratio);
+    return uint32_t(std::clamp(std::round(target), float(quality.min_steps), float(quality.max_steps)));
+}
+
+glm::uvec2 CloudRenderer::dispatch_size(const glm::uvec2& resolution, uint32_t update_interval)
+{
+    switch (update_interval) {
+    case 2:
+        return { (resolution.x + 1) / 2, resolution.y };
+    case 4:
+        return (resolution + 1u) / 2u;
+    default:
+        return resolution;
+    }
+}
+
 void CloudRenderer::init(webgpu::Context& ctx)
 {
     m_ctx = &ctx;
@@ -96,6 +142,13 @@ void CloudRenderer::init(webgpu::Context& ctx)
             .maxAnisotropy = 1,
         });
 
+    if (webgpu::isTimingSupported()) {
+        m_gpu_timer = std::make_shared<webgpu::timing::WebGpuTimer>(m_ctx->device(), 3, 120);
+        connect(m_gpu_timer.get(), &webgpu::timing::TimerInterface::tick, this, [this](float result) {
+            m_step_count = adapt_step_count(m_step_count, result * 1000.0f, quality);
+        });
+    }
+
     auto& reg = ctx.resource_registry();
     reg.register_shader("render_clouds", "webgpu_engine::render_clouds");
     reg.register_shader("upscale_clouds", "webgpu_engine::upscale_clouds");
@@ -378,6 +431,8 @@ void CloudRenderer::resize(int w, int h)
             m_clouds_hi_color_texture_view_a->create_bind_group_entry(5),
         },
         "upscale clouds bind group b");
+
+    m_full_update_pending = true;
 }
 
 void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
@@ -393,7 +448,8 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
     glm::mat4 inverse_view_matrix = glm::inverse(view_matrix);
 
     bool stable = glm::all(glm::equal(m_upscale_shader_params_ubo->data.previous_camera.view_matrix, view_matrix))
-        && glm::all(glm::equal(m_upscale_shader_params_ubo->data.previous_camera.proj_matrix, unjittered_projection));
+        && glm::all(glm::equal(m_upscale_shader_params_ubo->data.previous_camera.proj_matrix, unjittered_projection))
+        && m_previous_camera_position == camera.position();
 
     if (stable) {
         m_stable_frames++;
@@ -401,6 +457,25 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
         m_stable_frames = 0;
     }
 
+    uint32_t update_interval = quality.update_interval;
+    if (update_interval != 1 && update_interval != 2 && update_interval != 4) {
+        qWarning() << "CloudRenderer: unsupported update interval" << update_interval;
+        update_interval = 1;
+    }
+    if (m_full_update_pending) {
+        update_interval = 1;
+        m_full_update_pending = false;
+    }
+    if (quality.frame_budget_ms <= 0.0f || !m_gpu_timer)
+        m_step_count = quality.max_steps;
+    m_step_count = std::clamp(m_step_count, quality.min_steps, quality.max_steps);
+
+    // the previous frame was submitted in the meantime
+    if (m_gpu_timer) {
+        m_gpu_timer->resolve();
+        m_gpu_timer->start(command_encoder);
+    }
+
     {
         WGPUComputePassDescriptor compute_pass_desc {};
         compute_pass_desc.label = WGPUStringView { .data = "cloud render pass", .length = WGPU_STRLEN };
@@ -427,6 +502,9 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
         m_render_shader_params_ubo->data.shadow_extinction_scale = shader_params.shadow_extinction_scale;
         m_render_shader_params_ubo->data.fade_factor = shader_params.fade_factor;
         m_render_shader_params_ubo->data.powder_scale = shader_params.powder_scale;
+        m_render_shader_params_ubo->data.update_interval = update_interval;
+        m_render_shader_params_ubo->data.max_steps = m_step_count;
+        m_render_shader_params_ubo->data.transmittance_cutoff = quality.transmittance_cutoff;
         m_render_shader_params_ubo->update_gpu_data(m_ctx->queue());
 
         m_cloud_tile_info_buffer->write(m_ctx->queue(), m_tile_infos.data(), m_tile_infos.size());
@@ -436,7 +514,8 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
         wgpuComputePassEncoderSetBindGroup(compute_pass.handle(), 1, depth_texture_bind_group, 0, nullptr);
         wgpuComputePassEncoderSetBindGroup(compute_pass.handle(), 2, shared_config_bind_group, 0, nullptr);
 
-        wgpuComputePassEncoderDispatchWorkgroups(compute_pass.handle(), ceil_div(m_output_lo_resolution.x, 8u), ceil_div(m_output_lo_resolution.y, 8u), 1);
+        const auto size = dispatch_size(m_output_lo_resolution, update_interval);
+        wgpuComputePassEncoderDispatchWorkgroups(compute_pass.handle(), ceil_div(size.x, 8u), ceil_div(size.y, 8u), 1);
     }
 
     {
@@ -454,6 +533,11 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
         };
         m_upscale_shader_params_ubo->data.prev_jitter = m_upscale_shader_params_ubo->data.jitter;
         m_upscale_shader_params_ubo->data.jitter = jitter_offset;
+        m_upscale_shader_params_ubo->data.update_interval = update_interval;
+        m_upscale_shader_params_ubo->data.frame_index = frame_number;
+        // the view matrices are camera relative, the translation between the frames is applied separately (in double precision)
+        m_upscale_shader_params_ubo->data.camera_delta = glm::vec4(camera.position() - m_previous_camera_position, 0.0f);
+        m_previous_camera_position = camera.position();
         m_upscale_shader_params_ubo->update_gpu_data(m_ctx->queue());
 
         wgpuComputePassEncoderSetPipeline(compute_pass.handle(), m_upscale_clouds_pipeline->handle());
@@ -462,6 +546,9 @@ void CloudRenderer::draw(const WGPUCommandEncoder& command_encoder,
 
         wgpuComputePassEncoderDispatchWorkgroups(compute_pass.handle(), ceil_div(m_output_hi_resolution.x, 8u), ceil_div(m_output_hi_resolution.y, 8u), 1);
     }
+
+    if (m_gpu_timer)
+        m_gpu_timer->stop(command_encoder);
 }
 
 void CloudRenderer::set_tile_limit(unsigned int num_tiles) { m_loaded_cloud_textures.set_tile_limit(num_tiles); }
@@ -31,6 +31,7 @@
 #include <webgpu/base/raii/BindGroupLayout.h>
 #include <webgpu/base/raii/CombinedComputePipeline.h>
 #include <webgpu/base/raii/TextureWithSampler.h>
+#include <webgpu/base/timing/WebGpuTimer.h>
 #include <webgpu/webgpu.h>
 
 namespace nucleus::camera {
@@ -79,6 +80,31 @@ public:
 
     ShaderParameters shader_params = {};
 
+    enum class QualityPreset { Low, Medium, High, Ultra };
+
+    // Performance settings, independent of the look (ShaderParameters)
+    struct QualitySettings {
+        // 1: every low res pixel is raymarched in every frame, 2: checkerboard, 4: one pixel of every 2x2 block.
+        // the other pixels are reprojected from the previous frames.
+        uint32_t update_interval = 1;
+        // bounds of the adaptive step count
+        uint32_t min_steps = 48;
+        uint32_t max_steps = 128;
+        // rays are terminated once the transmittance drops below
+        float transmittance_cutoff = 0.01f;
+        // gpu time of the cloud passes in ms, the step count is adapted to meet it.
+        // 0 disables the adaptation, it also needs timestamp queries.
+        float frame_budget_ms = 0.0f;
+    };
+
+    static QualitySettings quality_preset(QualityPreset preset);
+    QualitySettings quality = quality_preset(QualityPreset::High);
+
+    // The cost is roughly proportional to the step count. Returns the step count for the next frame (damped, within bounds).
+    static uint32_t adapt_step_count(uint32_t step_count, float measured_ms, const QualitySettings& quality);
+    // size of the raymarching dispatch in pixels, only 1 in update_interval pixels is raymarched (see util/interleave.wgsl)
+    static glm::uvec2 dispatch_size(const glm::uvec2& resolution, uint32_t update_interval);
+
     explicit CloudRenderer();
 
     void init(webgpu::Context& ctx);
@@ -91,7 +117,12 @@ public:
         const nucleus::camera::Definition& camera,
         uint32_t frame_number);
 
-    [[nodiscard]] bool needs_redraw() const { return m_stable_frames <= static_cast<uint32_t>(shader_params.stable_frames_limit); }
+    // with interleaved updates, it takes update_interval frames until every pixel was raymarched with the current camera
+    [[nodiscard]] bool needs_redraw() const { return m_stable_frames <= static_cast<uint32_t>(shader_params.stable_frames_limit) + quality.update_interval; }
+
+    [[nodiscard]] uint32_t step_count() const { return m_step_count; }
+    // gpu time of the cloud passes, null if timestamp queries are not supported
+    [[nodiscard]] std::shared_ptr<webgpu::timing::WebGpuTimer> gpu_timer() const { return m_gpu_timer; }
 
     void set_tile_limit(unsigned new_limit);
 
@@ -141,7 +172,12 @@ private:
 
         glm::vec2 jitter;
         float powder_scale;
+        uint32_t update_interval;
+
+        uint32_t max_steps;
+        float transmittance_cutoff;
         float _padding0;
+        float _padding1;
     };
 
     struct alignas(16) ShaderParamsUpscale {
@@ -152,7 +188,9 @@ private:
         glm::vec2 low_res_texel_size;
         glm::vec2 high_res_texel_size;
         glm::vec2 resolution_scale;
-        glm::vec2 _padding0;
+        uint32_t update_interval;
+        uint32_t frame_index;
+        glm::vec4 camera_delta; // current minus previous camera position
     };
 
     struct TileInfo {
@@ -198,6 +236,11 @@ private:
     std::unique_ptr<webgpu::raii::CombinedComputePipeline> m_upscale_clouds_pipeline;
 
     uint32_t m_stable_frames = 0;
+    uint32_t m_step_count = quality.max_steps;
+    // the low res textures are uninitialised after resize(), all pixels must be raymarched once
+    bool m_full_update_pending = true;
+    glm::dvec3 m_previous_camera_position = glm::dvec3(0);
+    std::shared_ptr<webgpu::timing::WebGpuTimer> m_gpu_timer;
 
     std::mutex m_mutex = {};
 };
@@ -101,6 +101,17 @@ void TileDebugOverlay::update_settings()
         m_engine_ctx->shared_config().m_overlay_mode = static_cast<uint32_t>(settings.mode);
 }
 
+std::vector<TileDebugOverlay::TextureMemory> TileDebugOverlay::texture_memory() const
+{
+    if (!m_engine_ctx || !m_engine_ctx->tile_mesh_renderer())
+        return {};
+    const auto* tiles = m_engine_ctx->tile_mesh_renderer();
+    return {
+        { "height", tiles->height_texture_format(), tiles->height_texture_size_in_bytes() },
+        { "ortho", tiles->ortho_texture_format(), tiles->ortho_texture_size_in_bytes() },
+    };
+}
+
 void TileDebugOverlay::draw(const WGPUCommandEncoder& command_encoder,
     const webgpu::raii::TextureView& /*position_view*/,
     const webgpu::raii::TextureView& /*normal_view*/,
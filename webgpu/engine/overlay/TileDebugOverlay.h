@@ -21,6 +21,7 @@
 
 #include "Overlay.h"
 #include <memory>
+#include <vector>
 #include <webgpu/base/Buffer.h>
 #include <webgpu/base/raii/CombinedComputePipeline.h>
 #include <webgpu/base/raii/TextureWithSampler.h>
@@ -43,6 +44,12 @@ public:
         float strength = 1.0f;
     };
 
+    struct TextureMemory {
+        const char* name;
+        WGPUTextureFormat format;
+        size_t n_bytes;
+    };
+
     TileDebugOverlay();
     ~TileDebugOverlay() override;
 
@@ -50,6 +57,8 @@ public:
     // Pushes settings to the GPU and the selected debug mode into shared_config (consumed by the tile pass).
     // Call from the frontend whenever settings change.
     void update_settings();
+    // GPU memory of the tile texture arrays, per array and format
+    [[nodiscard]] std::vector<TextureMemory> texture_memory() const;
     void draw(const WGPUCommandEncoder& command_encoder,
         const webgpu::raii::TextureView& position_view,
         const webgpu::raii::TextureView& normal_view,
@@ -20,6 +20,7 @@
 
 ///use util/shared_config
 ///use util/camera_config
+///use util/gbuffer
 ///use util/atmosphere
 ///use webgpu::encoder
 ///use webgpu::general
@@ -128,8 +129,8 @@ fn get_cloud_shadow_occlusion(world_pos: vec3f) -> f32 {
 fn fragmentMain(vertex_out: VertexOut) -> @location(0) vec4f {
     let tci: vec2<u32> = vec2u(vertex_out.texcoords * camera.viewport_size);
 
-    var albedo: vec3f = unpack4x8unorm(textureLoad(albedo_texture, tci, 0).r).xyz;
-    let pos_dist = textureLoad(position_texture, tci, 0);
+    var albedo: vec3f = unpack4x8unorm(gbuffer_load_albedo(albedo_texture, tci)).xyz;
+    let pos_dist = gbuffer_load_position(position_texture, tci, camera);
     let encoded_normal = textureLoad(normal_texture, tci, 0).xy;
 
     let pos_cws = pos_dist.xyz;
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+// gpu version of TileCuller::select. keep both in sync.
+
+const NO_SLOT: u32 = 0xFFFFFFFFu;
+const MISSING_PARENT: u32 = 0xFFFFFFFEu;
+const TILE_SIZE: f32 = 256.0;
+const SQRT2: f32 = 1.414213562373095;
+
+// must match TileCuller::ResidentTile
+struct ResidentTile {
+    bounds_min: vec4f, // xyz relative to the origin, w: 1 if the slot holds a tile
+    bounds_max: vec4f,
+    zoom_level: u32,
+    parent_slot: u32, // or NO_SLOT, MISSING_PARENT
+    children_mask: u32,
+    padding: u32,
+}
+
+// must match TileCuller::CullingConfig
+struct CullingConfig {
+    frustum_planes: array<vec4f, 6>, // xyz: normal, w: distance
+    camera_position: vec4f,
+    screen_space_factor: f32,
+    pixel_error_threshold: f32,
+    max_zoom_level: u32,
+    n_slots: u32,
+}
+
+// layout of the arguments of drawIndexedIndirect
+struct DrawIndexedIndirectArgs {
+    index_count: u32,
+    instance_count: atomic<u32>,
+    first_index: u32,
+    base_vertex: i32,
+    first_instance: u32,
+}
+
+@group(0) @binding(0) var<uniform> config: CullingConfig;
+@group(0) @binding(1) var<storage, read> resident_tiles: array<ResidentTile>;
+@group(0) @binding(2) var<storage, read_write> visible_instances: array<u32>;
+@group(0) @binding(3) var<storage, read_write> draw_args: DrawIndexedIndirectArgs;
+
+fn is_visible(tile: ResidentTile) -> bool {
+    for (var i = 0u; i < 6u; i++) {
+        let plane = config.frustum_planes[i];
+        let corner = select(tile.bounds_min.xyz, tile.bounds_max.xyz, plane.xyz > vec3f(0.0));
+        if dot(plane.xyz, corner) + plane.w <= 0.0 {
+            return false;
+        }
+    }
+    return true;
+}
+
+fn is_split(tile: ResidentTile) -> bool {
+    if tile.children_mask != 0xFu || tile.zoom_level >= config.max_zoom_level {
+        return false;
+    }
+    if !is_visible(tile) {
+        return false;
+    }
+    let camera_position = config.camera_position.xyz;
+    let delta = max(max(tile.bounds_min.xyz - camera_position, camera_position - tile.bounds_max.xyz), vec3f(0.0));
+    let distance = length(delta);
+    let pixel_size = SQRT2 * (tile.bounds_max.x - tile.bounds_min.x) / TILE_SIZE;
+    return config.screen_space_factor * pixel_size >= config.pixel_error_threshold * distance;
+}
+
+@compute @workgroup_size(64)
+fn computeMain(@builtin(global_invocation_id) id: vec3<u32>) {
+    let slot = id.x;
+    if slot >= config.n_slots {
+        return;
+    }
+    let tile = resident_tiles[slot];
+    if tile.bounds_min.w == 0.0 || tile.parent_slot == MISSING_PARENT || !is_visible(tile) || is_split(tile) {
+        return;
+    }
+    if tile.parent_slot != NO_SLOT && !is_split(resident_tiles[tile.parent_slot]) {
+        return;
+    }
+    let index = atomicAdd(&draw_args.instance_count, 1u);
+    visible_instances[index] = slot;
+}
@@ -16,7 +16,9 @@
 * along with this program. If not, see <http : //www.gnu.org/licenses/>.
 *****************************************************************************/
 
-@group(0) @binding(0) var overlay_texture: texture_2d<u32>; //GBuffer slot 3 (packed RGBA via pack4x8unorm)
+///use util/gbuffer
+
+@group(0) @binding(0) var overlay_texture: texture_2d<u32>; //GBuffer overlay (packed RGBA via pack4x8unorm)
 @group(0) @binding(1) var<uniform> settings: TileDebugSettings;
 @group(0) @binding(2) var output_texture: texture_storage_2d<rgba8unorm, write>;
 @group(0) @binding(3) var prev_output: texture_2d<f32>;
@@ -34,7 +36,7 @@ fn computeMain(@builtin(global_invocation_id) id: vec3u) {
     let tci = id.xy;
 
     //render_tiles.wgsl writes alpha = 1 on geometry, 0 (transparent) on background.
-    let packed = textureLoad(overlay_texture, tci, 0).r;
+    let packed = gbuffer_load_overlay(overlay_texture, tci);
     var overlay_color = unpack4x8unorm(packed);
     overlay_color.a = overlay_color.a * settings.strength;
 
@@ -18,6 +18,7 @@
 
 ///use util/shared_config
 ///use util/camera_config
+///use util/gbuffer
 ///use webgpu::encoder
 ///use webgpu::tile_util
 
@@ -79,7 +80,7 @@ fn computeMain(@builtin(global_invocation_id) id: vec3u) {
     }
     let tci = id.xy;
 
-    let pos_dist = textureLoad(position_texture, tci, 0);
+    let pos_dist = gbuffer_load_position(position_texture, tci, camera);
     let encoded_normal = textureLoad(normal_texture, tci, 0).xy;
 
     let pos_cws = pos_dist.xyz;
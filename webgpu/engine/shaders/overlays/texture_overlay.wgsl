@@ -19,6 +19,7 @@
 
 ///use util/shared_config
 ///use util/camera_config
+///use util/gbuffer
 ///use webgpu::encoder
 ///use screen_pass_vert
 
@@ -42,7 +43,7 @@ struct TextureOverlaySettings {
 @fragment
 fn fragmentMain(in: VertexOut) -> @location(0) vec4f {
     let tci = vec2i(in.position.xy);
-    let pos_dist = textureLoad(position_texture, tci, 0);
+    let pos_dist = gbuffer_load_position(position_texture, vec2u(tci), camera);
     let pos_cws = pos_dist.xyz;
     let dist = length(pos_cws);
     let pos_ws = pos_cws + camera.position.xyz;
@@ -19,6 +19,7 @@
 ///use webgpu::tile_util
 ///use util/shared_config
 ///use util/atmosphere
+///use util/interleave
 
 struct tile_info {
     index: u32,
@@ -51,7 +52,11 @@ struct shader_params {
     shadow_extinction_scale: f32,
     jitter: vec2f,
     powder_scale: f32,
-    padding: f32,
+    update_interval: u32,
+    max_steps: u32,
+    transmittance_cutoff: f32,
+    padding0: f32,
+    padding1: f32,
 }
 
 struct ray_accumulator {
@@ -108,9 +113,7 @@ const HEIGHT_PER_TEXEL = 14000.0 / TILE_RESOLUTION_Z;
 const INV_HEIGHT_PER_TEXEL = 1.0 / HEIGHT_PER_TEXEL;
 const TEXTURE_VALUE_SCALE = 32.0; // Has to match generation script
 
-// Ray marching parameters
-const MAX_STEPS = 128;
-
+// Ray marching parameters (the step count and transmittance cutoff are in params)
 const MAX_LIGHT_STEPS = 8;
 
 fn unproject(normalised_device_coordinates: vec3f) -> vec3f {
@@ -468,7 +471,7 @@ fn step_fine(
 @compute @workgroup_size(8, 8, 1)
 fn computeMain(@builtin(global_invocation_id) global_id: vec3u) {
     let output_dims = textureDimensions(output_color);
-    let pixel_coord = global_id.xy;
+    let pixel_coord = interleaved_pixel(global_id.xy, params.frame_index, params.update_interval);
 
     if pixel_coord.x >= output_dims.x || pixel_coord.y >= output_dims.y {
         return;
@@ -517,7 +520,7 @@ fn computeMain(@builtin(global_invocation_id) global_id: vec3u) {
     let cos_angle = dot(ray_direction, sun_dir);
     let cloud_phase = cloud_phase_function(cos_angle);
 
-    while acc.transmittance > 0.01 && acc.t < t_far && acc.step_count < MAX_STEPS {
+    while acc.transmittance > params.transmittance_cutoff && acc.t < t_far && acc.step_count < i32(params.max_steps) {
         // Calculate Step Size
         var fine_step_size = get_step_size(acc.t, ray_direction, t_far - t_near);
         fine_step_size = min(fine_step_size, t_far - acc.t);
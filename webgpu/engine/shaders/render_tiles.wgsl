@@ -30,21 +30,32 @@
 
 @group(1) @binding(0) var<uniform> camera: camera_config;
 
-@group(2) @binding(0) var<uniform> n_edge_vertices: i32;
+// must match TileMeshRenderer::TileConfig
+struct TileConfig {
+    origin_offset: vec2f, // instance origin relative to the camera
+    n_edge_vertices: i32,
+    padding: i32,
+}
+
+// must match TileMeshRenderer::TileInstance
+struct TileInstance {
+    bounds: vec4f, // relative to the instance origin
+    tile_id: vec2<u32>,
+    height_zoomlevel: i32,
+    height_texture_layer: i32,
+    ortho_zoomlevel: i32,
+    ortho_texture_layer: i32,
+    tileset_id: i32,
+    padding: i32,
+}
+
+@group(2) @binding(0) var<uniform> tile_config: TileConfig;
 @group(2) @binding(1) var height_texture: texture_2d_array<u32>;
 @group(2) @binding(2) var height_sampler: sampler;
 @group(2) @binding(3) var ortho_texture: texture_2d_array<f32>;
 @group(2) @binding(4) var ortho_sampler: sampler;
-
-struct VertexIn {
-    @location(0) bounds: vec4f,
-    @location(1) height_texture_layer: i32,
-    @location(2) ortho_texture_layer: i32,
-    @location(3) tileset_id: i32,
-    @location(4) height_zoomlevel: i32,
-    @location(5) tile_id: vec2<u32>,
-    @location(6) ortho_zoomlevel: i32,
-}
+@group(2) @binding(5) var<storage, read> instances: array<TileInstance>;
+@group(2) @binding(6) var<storage, read> visible_instances: array<u32>;
 
 struct VertexOut {
     @builtin(position) position: vec4f,
@@ -58,11 +69,17 @@ struct VertexOut {
     @location(7) @interpolate(flat) ortho_zoomlevel: i32,
 }
 
+// see util/gbuffer.wgsl for the layouts
 struct FragOut {
+///ifdef COMPACT_GBUFFER
+    @location(0) albedo_overlay: vec2u,
+    @location(1) normal_enc: vec2u,
+///else
     @location(0) albedo: u32,
     @location(1) position: vec4f,
     @location(2) normal_enc: vec2u,
     @location(3) overlay: u32,
+///endif
 }
 
 fn compute_vertex(
@@ -77,6 +94,8 @@ fn compute_vertex(
     compute_normal: bool,
     normal: ptr<function, vec3f>
 ) {
+    let n_edge_vertices = tile_config.n_edge_vertices;
+
     //get tile id of desired height tile
     var height_tile_id: TileId;
     {
@@ -173,14 +192,16 @@ fn normal_by_fragment_position_interpolation(pos_cws: vec3<f32>) -> vec3<f32> {
 }
 
 @vertex
-fn vertexMain(@builtin(vertex_index) vertex_index: u32, vertex_in: VertexIn) -> VertexOut {
+fn vertexMain(@builtin(vertex_index) vertex_index: u32, @builtin(instance_index) instance_index: u32) -> VertexOut {
+    let vertex_in = instances[visible_instances[instance_index]];
     let render_tile_id = unpack_tile_id(vertex_in.tile_id);
+    let bounds = vertex_in.bounds + tile_config.origin_offset.xyxy;
 
     var position: vec3f;
     var uv: vec2f;
     var height_tile_id: TileId;
     var normal: vec3f;
-    compute_vertex(i32(vertex_index), render_tile_id, vertex_in.bounds, u32(vertex_in.height_zoomlevel), vertex_in.height_texture_layer,
+    compute_vertex(i32(vertex_index), render_tile_id, bounds, u32(vertex_in.height_zoomlevel), vertex_in.height_texture_layer,
         &position, &uv, &height_tile_id, true, &normal);
 
     let clip_pos: vec4f = camera.view_proj_matrix * vec4f(position, 1.0);
@@ -240,10 +261,14 @@ fn fragmentMain(vertex_out: VertexOut) -> FragOut {
         }
         //albedo = mix(albedo, overlay_color.xyz, config.overlay_strength * overlay_color.w);
     }
+///ifdef COMPACT_GBUFFER
+    frag_out.albedo_overlay = vec2u(pack4x8unorm(vec4f(albedo, 1.0)), pack4x8unorm(overlay_color));
+///else
     frag_out.overlay = pack4x8unorm(overlay_color);
     frag_out.albedo = pack4x8unorm(vec4f(albedo, 1.0));
 
     frag_out.position = vec4f(vertex_out.pos_cws, dist);
+///endif
 
     return frag_out;
 }
@@ -16,6 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+///use util/interleave
+
 struct camera_config {
     view_matrix: mat4x4f,
     proj_matrix: mat4x4f,
@@ -32,7 +34,9 @@ struct accumulation_params {
     low_res_texel_size: vec2f,
     high_res_texel_size: vec2f,
     resolution_scale: vec2f,
-    _padding0: vec2f,
+    update_interval: u32,
+    frame_index: u32,
+    camera_delta: vec4f, // current minus previous camera position
 }
 
 @group(0) @binding(0) var<uniform> params: accumulation_params;
@@ -141,9 +145,9 @@ fn computeMain(@builtin(global_invocation_id) global_id: vec3u) {
         params.curr_camera.inv_view_matrix
     );
 
-    // Reproject to previous frame (unjittered)
+    // Reproject to previous frame (unjittered). The view matrices are camera relative, hence move to the previous camera first
     let prev_position = reproject_position(
-        world_pos,
+        world_pos + params.camera_delta.xyz,
         params.prev_camera.view_matrix,
         params.prev_camera.proj_matrix
     );
@@ -227,6 +231,11 @@ fn computeMain(@builtin(global_invocation_id) global_id: vec3u) {
     var history_weight = 0.95;
     history_weight *= max(min(trans_clip_factor, scattered_clip_factor), 0.5);
 
+    // Interleaved updates: this low res texel was raymarched in an earlier frame (with an older camera), rely more on the history
+    if !is_pixel_updated(vec2u(jittered_coord), params.frame_index, params.update_interval) {
+        history_weight = mix(history_weight, 1.0, 0.5);
+    }
+
     // Special case: completely empty history
     if history_sample.a > 0.999 && current_sample.a < 0.95 {
         history_weight = 0.0;
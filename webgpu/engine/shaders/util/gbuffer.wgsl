@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+///use util/camera_config
+
+// Reading the geometry buffers written by render_tiles.wgsl. The layout depends on the global define COMPACT_GBUFFER:
+//   default: albedo R32Uint, position RGBA32Float (camera relative position, distance), normal RG16Uint, overlay R32Uint
+//   compact: albedo and overlay RG32Uint, normal RG16Uint. there is no position texture, the Depth32Float depth buffer
+//            is bound in its place and the position is reconstructed from it (16 instead of 32 bytes per pixel).
+// The bindings stay the same, in the compact layout the albedo/overlay texture is bound twice.
+
+fn gbuffer_load_albedo(albedo_texture: texture_2d<u32>, tci: vec2u) -> u32 {
+    return textureLoad(albedo_texture, tci, 0).x;
+}
+
+fn gbuffer_load_overlay(overlay_texture: texture_2d<u32>, tci: vec2u) -> u32 {
+///ifdef COMPACT_GBUFFER
+    return textureLoad(overlay_texture, tci, 0).y;
+///else
+    return textureLoad(overlay_texture, tci, 0).x;
+///endif
+}
+
+// camera relative position in xyz, distance to the camera in w. returns 0 where there is no geometry.
+fn gbuffer_load_position(position_texture: texture_2d<f32>, tci: vec2u, cam: camera_config) -> vec4f {
+///ifdef COMPACT_GBUFFER
+    // reverse z, cleared to 0
+    let depth = textureLoad(position_texture, tci, 0).x;
+    if depth <= 0.0 {
+        return vec4f(0.0);
+    }
+    let uv = (vec2f(tci) + 0.5) / vec2f(textureDimensions(position_texture));
+    let ndc = vec4f(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0);
+    let view_pos = cam.inv_proj_matrix * ndc;
+    // rotation only, the view matrix is camera relative already
+    let pos_cws = (cam.inv_view_matrix * vec4f(view_pos.xyz / view_pos.w, 0.0)).xyz;
+    return vec4f(pos_cws, length(pos_cws));
+///else
+    return textureLoad(position_texture, tci, 0);
+///endif
+}
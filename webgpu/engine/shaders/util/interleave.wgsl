@@ -0,0 +1,47 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+// Interleaved rendering: only 1 in interval pixels is updated per frame.
+// interval 2 is a checkerboard, interval 4 updates one pixel of every 2x2 block (diagonals first), 1 updates everything.
+// The dispatch covers only the updated pixels, see CloudRenderer::dispatch_size.
+
+fn interleave_offset_2x2(frame_index: u32) -> vec2u {
+    // (0, 0), (1, 1), (0, 1), (1, 0)
+    return vec2u(frame_index & 1u, ((frame_index >> 1u) ^ frame_index) & 1u);
+}
+
+// maps the invocation id of the reduced dispatch to the pixel that is updated in this frame
+fn interleaved_pixel(id: vec2u, frame_index: u32, interval: u32) -> vec2u {
+    if interval == 2u {
+        return vec2u(2u * id.x + ((id.y + frame_index) & 1u), id.y);
+    }
+    if interval == 4u {
+        return 2u * id + interleave_offset_2x2(frame_index);
+    }
+    return id;
+}
+
+fn is_pixel_updated(pixel: vec2u, frame_index: u32, interval: u32) -> bool {
+    if interval == 2u {
+        return ((pixel.x + pixel.y + frame_index) & 1u) == 0u;
+    }
+    if interval == 4u {
+        return all(pixel % 2u == interleave_offset_2x2(frame_index));
+    }
+    return true;
+}
@@ -0,0 +1,279 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "TileCuller.h"
+
+#include <optional>
+
+#include <QtAssert>
+#include <nucleus/camera/Definition.h>
+#include <webgpu/base/RenderResourceRegistry.h>
+#include <webgpu/base/raii/BindGroupLayout.h>
+
+namespace webgpu_engine {
+
+namespace {
+    glm::vec4 relative_to(const glm::dvec3& position, const glm::dvec2& origin) { return glm::vec4(position - glm::dvec3(origin, 0.0), 1.0); }
+
+    std::optional<uint32_t> child_index(const nucleus::tile::Id& id)
+    {
+        const auto siblings = id.parent().children();
+        for (uint32_t i = 0; i < siblings.size(); ++i) {
+            if (siblings[i] == id)
+                return i;
+        }
+        return {};
+    }
+
+    uint32_t unlinked_parent_slot(const nucleus::tile::Id& id) { return id.zoom_level <= 1 ? TileCuller::NO_SLOT : TileCuller::MISSING_PARENT; }
+} // namespace
+
+TileCuller::CullingConfig TileCuller::make_config(const nucleus::camera::Definition& camera, const glm::dvec2& origin, unsigned max_zoom_level, uint32_t n_slots)
+{
+    CullingConfig config {};
+    const auto frustum = camera.frustum();
+    const auto origin_3d = glm::dvec3(origin, 0.0);
+    for (size_t i = 0; i < frustum.clipping_planes.size(); ++i) {
+        const auto& plane = frustum.clipping_planes[i];
+        config.frustum_planes[i] = glm::vec4(glm::vec3(plane.normal), float(plane.distance + glm::dot(plane.normal, origin_3d)));
+    }
+    config.camera_position = relative_to(camera.position(), origin);
+    config.screen_space_factor = camera.to_screen_space(1.0f, 1.0f);
+    config.pixel_error_threshold = camera.pixel_error_threshold();
+    config.max_zoom_level = max_zoom_level;
+    config.n_slots = n_slots;
+    return config;
+}
+
+bool TileCuller::is_visible(const ResidentTile& tile, const CullingConfig& config)
+{
+    // conservative: only the planes are tested, not the separating axes of nucleus::tile::utils::camera_frustum_contains_tile
+    for (const auto& plane : config.frustum_planes) {
+        const auto normal = glm::vec3(plane);
+        const auto corner = glm::mix(glm::vec3(tile.bounds_min), glm::vec3(tile.bounds_max), glm::greaterThan(normal, glm::vec3(0)));
+        if (glm::dot(normal, corner) + plane.w <= 0.0f)
+            return false;
+    }
+    return true;
+}
+
+bool TileCuller::is_split(const ResidentTile& tile, const CullingConfig& config)
+{
+    if (tile.children_mask != 0xF || tile.zoom_level >= config.max_zoom_level)
+        return false;
+    if (!is_visible(tile, config))
+        return false;
+
+    constexpr auto sqrt2 = 1.414213562373095f;
+    const auto camera_position = glm::vec3(config.camera_position);
+    const auto delta = glm::max(glm::max(glm::vec3(tile.bounds_min) - camera_position, camera_position - glm::vec3(tile.bounds_max)), glm::vec3(0));
+    const auto distance = glm::length(delta);
+    const auto pixel_size = sqrt2 * (tile.bounds_max.x - tile.bounds_min.x) / TILE_SIZE;
+    return config.screen_space_factor * pixel_size >= config.pixel_error_threshold * distance;
+}
+
+std::vector<uint32_t> TileCuller::select(const std::vector<ResidentTile>& tiles, const CullingConfig& config)
+{
+    std::vector<uint32_t> selected;
+    for (uint32_t slot = 0; slot < std::min(uint32_t(tiles.size()), config.n_slots); ++slot) {
+        const auto& tile = tiles[slot];
+        if (tile.bounds_min.w == 0.0f || tile.parent_slot == MISSING_PARENT || !is_visible(tile, config) || is_split(tile, config))
+            continue;
+        if (tile.parent_slot != NO_SLOT && !is_split(tiles[tile.parent_slot], config))
+            continue;
+        selected.push_back(slot);
+    }
+    return selected;
+}
+
+void TileCuller::init(webgpu::Context& ctx, uint32_t n_slots)
+{
+    m_ctx = &ctx;
+    m_tiles.assign(n_slots, ResidentTile {});
+    m_bounds.assign(n_slots, nucleus::tile::SrsAndHeightBounds {});
+    m_dirty.assign(n_slots, 0);
+    m_slots.clear();
+
+    m_config_buffer = std::make_unique<webgpu::Buffer<CullingConfig>>(m_ctx->device(), WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst);
+    m_tile_buffer = std::make_unique<webgpu::raii::RawBuffer<ResidentTile>>(
+        m_ctx->device(), WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst, n_slots, "resident tile buffer");
+    m_visible_instance_buffer = std::make_unique<webgpu::raii::RawBuffer<uint32_t>>(
+        m_ctx->device(), WGPUBufferUsage_Storage | WGPUBufferUsage_CopySrc, n_slots, "culled tile instance buffer");
+    m_indirect_buffer = std::make_unique<webgpu::raii::RawBuffer<uint32_t>>(
+        m_ctx->device(), WGPUBufferUsage_Storage | WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst | WGPUBufferUsage_CopySrc, 5, "culled tile indirect buffer");
+
+    auto& reg = ctx.resource_registry();
+    reg.register_shader("cull_tiles", "webgpu_engine::cull_tiles");
+    reg.register_bind_group_layout("tile_culling", [](WGPUDevice device) {
+        WGPUBindGroupLayoutEntry config_entry {};
+        config_entry.binding = 0;
+        config_entry.visibility = WGPUShaderStage_Compute;
+        config_entry.buffer.type = WGPUBufferBindingType_Uniform;
+        config_entry.buffer.minBindingSize = 0;
+
+        WGPUBindGroupLayoutEntry resident_tiles_entry {};
+        resident_tiles_entry.binding = 1;
+        resident_tiles_entry.visibility = WGPUShaderStage_Compute;
+        resident_tiles_entry.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+        resident_tiles_entry.buffer.minBindingSize = 0;
+
+        WGPUBindGroupLayoutEntry visible_instances_entry {};
+        visible_instances_entry.binding = 2;
+        visible_instances_entry.visibility = WGPUShaderStage_Compute;
+        visible_instances_entry.buffer.type = WGPUBufferBindingType_Storage;
+        visible_instances_entry.buffer.minBindingSize = 0;
+
+        WGPUBindGroupLayoutEntry draw_args_entry {};
+        draw_args_entry.binding = 3;
+        draw_args_entry.visibility = WGPUShaderStage_Compute;
+        draw_args_entry.buffer.type = WGPUBufferBindingType_Storage;
+        draw_args_entry.buffer.minBindingSize = 0;
+
+        return std::make_unique<webgpu::raii::BindGroupLayout>(device,
+            std::vector<WGPUBindGroupLayoutEntry> { config_entry, resident_tiles_entry, visible_instances_entry, draw_args_entry },
+            "tile culling bind group layout");
+    });
+    reg.register_pipeline([this](WGPUDevice dev, const webgpu::RenderResourceRegistry& reg) {
+        m_pipeline = std::make_unique<webgpu::raii::CombinedComputePipeline>(
+            dev, reg.shader("cull_tiles"), std::vector<const webgpu::raii::BindGroupLayout*> { &reg.bind_group_layout("tile_culling") }, "tile culling pipeline");
+        m_bind_group = std::make_unique<webgpu::raii::BindGroup>(dev,
+            reg.bind_group_layout("tile_culling"),
+            std::initializer_list<WGPUBindGroupEntry> {
+                m_config_buffer->raw_buffer().create_bind_group_entry(0),
+                m_tile_buffer->create_bind_group_entry(1),
+                m_visible_instance_buffer->create_bind_group_entry(2),
+                m_indirect_buffer->create_bind_group_entry(3),
+            },
+            "tile culling bind group");
+    });
+}
+
+void TileCuller::add_tile(uint32_t slot, const nucleus::tile::Id& id, const nucleus::tile::SrsAndHeightBounds& bounds)
+{
+    Q_ASSERT(slot < m_tiles.size());
+    Q_ASSERT(m_tiles[slot].bounds_min.w == 0.0f);
+    m_slots[id] = slot;
+    m_bounds[slot] = bounds;
+
+    auto& tile = m_tiles[slot];
+    tile.bounds_min = relative_to(bounds.min, m_origin);
+    tile.bounds_max = relative_to(bounds.max, m_origin);
+    tile.zoom_level = id.zoom_level;
+    tile.parent_slot = unlinked_parent_slot(id);
+    tile.children_mask = 0;
+    m_dirty[slot] = 1;
+
+    if (id.zoom_level > 0) {
+        const auto parent = m_slots.find(id.parent());
+        if (parent != m_slots.end()) {
+            tile.parent_slot = parent->second;
+            m_tiles[parent->second].children_mask |= 1u << *child_index(id);
+            m_dirty[parent->second] = 1;
+        }
+    }
+    const auto children = id.children();
+    for (uint32_t i = 0; i < children.size(); ++i) {
+        const auto child = m_slots.find(children[i]);
+        if (child == m_slots.end())
+            continue;
+        tile.children_mask |= 1u << i;
+        m_tiles[child->second].parent_slot = slot;
+        m_dirty[child->second] = 1;
+    }
+}
+
+void TileCuller::remove_tile(const nucleus::tile::Id& id)
+{
+    const auto it = m_slots.find(id);
+    if (it == m_slots.end())
+        return;
+    const auto slot = it->second;
+    m_slots.erase(it);
+
+    const auto& tile = m_tiles[slot];
+    if (tile.parent_slot != NO_SLOT && tile.parent_slot != MISSING_PARENT) {
+        m_tiles[tile.parent_slot].children_mask &= ~(1u << *child_index(id));
+        m_dirty[tile.parent_slot] = 1;
+    }
+    for (const auto& child_id : id.children()) {
+        const auto child = m_slots.find(child_id);
+        if (child == m_slots.end())
+            continue;
+        m_tiles[child->second].parent_slot = unlinked_parent_slot(child_id);
+        m_dirty[child->second] = 1;
+    }
+    m_tiles[slot] = ResidentTile {};
+    m_dirty[slot] = 1;
+}
+
+void TileCuller::set_origin(const glm::dvec2& origin)
+{
+    m_origin = origin;
+    for (const auto& [id, slot] : m_slots) {
+        m_tiles[slot].bounds_min = relative_to(m_bounds[slot].min, m_origin);
+        m_tiles[slot].bounds_max = relative_to(m_bounds[slot].max, m_origin);
+        m_dirty[slot] = 1;
+    }
+}
+
+void TileCuller::cull(WGPUCommandEncoder encoder, const nucleus::camera::Definition& camera, unsigned max_zoom_level, uint32_t index_count)
+{
+    write_dirty_tiles();
+
+    const auto n_slots = uint32_t(m_tiles.size());
+    m_config_buffer->data = make_config(camera, m_origin, max_zoom_level, n_slots);
+    m_config_buffer->update_gpu_data(m_ctx->queue());
+
+    // the instance count is incremented by the shader
+    const std::array<uint32_t, 5> draw_args = { index_count, 0, 0, 0, 0 };
+    m_indirect_buffer->write(m_ctx->queue(), draw_args.data(), draw_args.size());
+
+    WGPUComputePassDescriptor compute_pass_desc {};
+    compute_pass_desc.label = WGPUStringView { .data = "tile culling compute pass", .length = WGPU_STRLEN };
+    webgpu::raii::ComputePassEncoder compute_pass(encoder, compute_pass_desc);
+    wgpuComputePassEncoderSetBindGroup(compute_pass.handle(), 0, m_bind_group->handle(), 0, nullptr);
+    m_pipeline->run(compute_pass, glm::uvec3((n_slots + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1));
+}
+
+const std::vector<TileCuller::ResidentTile>& TileCuller::resident_tiles() const { return m_tiles; }
+
+webgpu::raii::RawBuffer<uint32_t>& TileCuller::visible_instance_buffer() { return *m_visible_instance_buffer; }
+
+webgpu::raii::RawBuffer<uint32_t>& TileCuller::indirect_buffer() { return *m_indirect_buffer; }
+
+void TileCuller::write_dirty_tiles()
+{
+    // coalesce consecutive dirty slots into a single write
+    const auto n_slots = uint32_t(m_tiles.size());
+    uint32_t begin = 0;
+    while (begin < n_slots) {
+        if (!m_dirty[begin]) {
+            ++begin;
+            continue;
+        }
+        uint32_t end = begin;
+        while (end < n_slots && m_dirty[end]) {
+            m_dirty[end] = 0;
+            ++end;
+        }
+        m_tile_buffer->write(m_ctx->queue(), m_tiles.data() + begin, end - begin, begin);
+        begin = end;
+    }
+}
+
+} // namespace webgpu_engine
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * weBIGeo
+ * Copyright (C) 2026 Adam Celarek
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <nucleus/tile/types.h>
+#include <webgpu/base/Buffer.h>
+#include <webgpu/base/Context.h>
+#include <webgpu/base/raii/BindGroup.h>
+#include <webgpu/base/raii/CombinedComputePipeline.h>
+#include <webgpu/base/raii/RawBuffer.h>
+#include <webgpu/webgpu.h>
+
+namespace nucleus::camera {
+class Definition;
+}
+
+namespace webgpu_engine {
+
+/// Selects the terrain tiles to draw on the GPU (cull_tiles.wgsl).
+///
+/// Every resident geometry tile occupies a slot (its height texture layer). Each frame, one thread per slot tests the tile
+/// against the frustum and the screen space error criterion of nucleus::tile::utils::refineFunctor. A tile is drawn if it is
+/// visible, it is not split into resident children, and its parent is split. Selected slots are appended to a compacted list,
+/// and the instance count of the indirect draw arguments is incremented atomically. Nothing is read back.
+///
+/// Tiles whose parent is not resident are not drawn (the nearest resident ancestor covers them), except on zoom levels 0 and 1,
+/// which are the roots of the resident quad tree.
+class TileCuller {
+public:
+    static constexpr uint32_t NO_SLOT = uint32_t(-1);
+    static constexpr uint32_t MISSING_PARENT = uint32_t(-2);
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+    // same as in nucleus::tile::drawing::generate_list
+    static constexpr float TILE_SIZE = 256.0f;
+
+    // std430, must match ResidentTile in cull_tiles.wgsl
+    struct ResidentTile {
+        glm::vec4 bounds_min = glm::vec4(0); // xyz relative to the origin, w: 1 if the slot holds a tile
+        glm::vec4 bounds_max = glm::vec4(0); // xyz relative to the origin
+        uint32_t zoom_level = 0;
+        uint32_t parent_slot = NO_SLOT; // or MISSING_PARENT
+        uint32_t children_mask = 0; // bit i is set if child i is resident
+        uint32_t padding = 0;
+    };
+    static_assert(sizeof(ResidentTile) == 48);
+
+    // std140, must match CullingConfig in cull_tiles.wgsl
+    struct CullingConfig {
+        std::array<glm::vec4, 6> frustum_planes; // xyz: normal, w: distance, relative to the origin
+        glm::vec4 camera_position; // relative to the origin
+        float screen_space_factor; // screen space size of an object with unit size at unit distance
+        float pixel_error_threshold;
+        uint32_t max_zoom_level;
+        uint32_t n_slots;
+    };
+
+    // CPU reference of cull_tiles.wgsl, also used for validation. Returns the selected slots in ascending order.
+    static CullingConfig make_config(const nucleus::camera::Definition& camera, const glm::dvec2& origin, unsigned max_zoom_level, uint32_t n_slots);
+    static bool is_visible(const ResidentTile& tile, const CullingConfig& config);
+    static bool is_split(const ResidentTile& tile, const CullingConfig& config);
+    static std::vector<uint32_t> select(const std::vector<ResidentTile>& tiles, const CullingConfig& config);
+
+    void init(webgpu::Context& ctx, uint32_t n_slots);
+
+    void add_tile(uint32_t slot, const nucleus::tile::Id& id, const nucleus::tile::SrsAndHeightBounds& bounds);
+    void remove_tile(const nucleus::tile::Id& id);
+    // moves the origin of the bounds (float precision). all resident tiles are re-uploaded.
+    void set_origin(const glm::dvec2& origin);
+
+    // uploads changed slots, resets the draw arguments and records the culling pass.
+    // the selected slots end up in visible_instance_buffer(), the draw arguments in indirect_buffer().
+    void cull(WGPUCommandEncoder encoder, const nucleus::camera::Definition& camera, unsigned max_zoom_level, uint32_t index_count);
+
+    [[nodiscard]] const std::vector<ResidentTile>& resident_tiles() const;
+    [[nodiscard]] webgpu::raii::RawBuffer<uint32_t>& visible_instance_buffer();
+    [[nodiscard]] webgpu::raii::RawBuffer<uint32_t>& indirect_buffer();
+
+private:
+    void write_dirty_tiles();
+
+    webgpu::Context* m_ctx = nullptr;
+
+    glm::dvec2 m_origin = glm::dvec2(0);
+    std::vector<ResidentTile> m_tiles;
+    std::vector<nucleus::tile::SrsAndHeightBounds> m_bounds;
+    std::vector<uint8_t> m_dirty;
+    nucleus::tile::IdMap<uint32_t> m_slots;
+
+    std::unique_ptr<webgpu::Buffer<CullingConfig>> m_config_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<ResidentTile>> m_tile_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<uint32_t>> m_visible_instance_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<uint32_t>> m_indirect_buffer;
+    std::unique_ptr<webgpu::raii::BindGroup> m_bind_group;
+    std::unique_ptr<webgpu::raii::CombinedComputePipeline> m_pipeline;
+};
+
+} // namespace webgpu_engine
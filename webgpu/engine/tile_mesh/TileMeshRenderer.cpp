@@ -20,12 +20,16 @@
 
 #include "TileMeshRenderer.h"
 
+#include <algorithm>
+#include <array>
+
 #include "nucleus/camera/Definition.h"
 #include "nucleus/srs.h"
 #include "nucleus/utils/terrain_mesh_index_generator.h"
 #include <QDebug>
 #include <QtAssert>
 #include <webgpu/base/RenderResourceRegistry.h>
+#include <webgpu/base/gpu_utils.h>
 #include <webgpu/base/raii/BindGroupLayout.h>
 #include <webgpu/base/util/VertexBufferInfo.h>
 
@@ -37,6 +41,7 @@ TileMeshRenderer::TileMeshRenderer(uint32_t height_resolution, uint32_t ortho_re
     : QObject { nullptr }
     , m_height_resolution { height_resolution }
     , m_ortho_resolution { ortho_resolution }
+    , m_instance_timer { std::make_shared<webgpu::timing::CpuTimer>(120) }
 {
 }
 
@@ -54,23 +59,20 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
     m_index_buffer->write(m_ctx->queue(), indices.data(), indices.size());
     m_index_buffer_size = indices.size();
 
-    // create buffers for bounds, tile ids, zoom level, height and ortho texture buffers
-    m_bounds_buffer = std::make_unique<webgpu::raii::RawBuffer<glm::vec4>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_tileset_id_buffer = std::make_unique<webgpu::raii::RawBuffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_height_zoom_level_buffer
-        = std::make_unique<webgpu::raii::RawBuffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_height_texture_layer_buffer
-        = std::make_unique<webgpu::raii::RawBuffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_ortho_zoom_level_buffer
-        = std::make_unique<webgpu::raii::RawBuffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_ortho_texture_layer_buffer
-        = std::make_unique<webgpu::raii::RawBuffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-
-    m_tile_id_buffer
-        = std::make_unique<webgpu::raii::RawBuffer<glm::u32vec2>>(m_ctx->device(), WGPUBufferUsage_Vertex | WGPUBufferUsage_CopyDst, num_layers);
-    m_n_edge_vertices_buffer = std::make_unique<webgpu::Buffer<int32_t>>(m_ctx->device(), WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst);
-    m_n_edge_vertices_buffer->data = int(m_height_resolution);
-    m_n_edge_vertices_buffer->update_gpu_data(m_ctx->queue());
+    // instances are written when tiles or their texture layers change, visible instances and indirect args every frame
+    init_instance_storage(m_instances, INSTANCE_CAPACITY, "tile instance buffer");
+    init_instance_storage(m_resident_instances, uint32_t(num_layers), "resident tile instance buffer");
+    m_instance_last_drawn.assign(INSTANCE_CAPACITY, 0);
+    release_all_instance_slots();
+    m_visible_instance_buffer = std::make_unique<webgpu::raii::RawBuffer<uint32_t>>(
+        m_ctx->device(), WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst, INSTANCE_CAPACITY, "visible tile instance buffer");
+    m_indirect_buffer = std::make_unique<webgpu::raii::RawBuffer<uint32_t>>(
+        m_ctx->device(), WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst, 5, "tile draw indirect buffer");
+    m_tile_config_buffer = std::make_unique<webgpu::Buffer<TileConfig>>(m_ctx->device(), WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst);
+    m_tile_config_buffer->data.origin_offset = glm::vec2(0);
+    m_tile_config_buffer->data.n_edge_vertices = int(m_height_resolution);
+    m_tile_config_buffer->update_gpu_data(m_ctx->queue());
+    m_culler.init(ctx, uint32_t(num_layers));
 
     WGPUTextureDescriptor height_texture_desc {};
     height_texture_desc.label = WGPUStringView { .data = "height texture", .length = WGPU_STRLEN };
@@ -99,16 +101,20 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
 
     m_heightmap_textures = std::make_unique<webgpu::raii::TextureWithSampler>(m_ctx->device(), height_texture_desc, height_sampler_desc);
 
-    // TODO mipmaps and compression
+    m_ortho_compression = compression_algorithm(m_ctx->device());
+    const auto ortho_mip_level_count = webgpu::raii::Texture::max_mip_level_count(ortho_resolution);
+
     WGPUTextureDescriptor ortho_texture_desc {};
     ortho_texture_desc.label = WGPUStringView { .data = "ortho texture", .length = WGPU_STRLEN };
     ortho_texture_desc.dimension = WGPUTextureDimension::WGPUTextureDimension_2D;
     // TODO: array layers might become larger than allowed by graphics API
     ortho_texture_desc.size = { uint32_t(ortho_resolution.x), uint32_t(ortho_resolution.y), uint32_t(num_layers) };
-    ortho_texture_desc.mipLevelCount = 1;
+    ortho_texture_desc.mipLevelCount = ortho_mip_level_count;
     ortho_texture_desc.sampleCount = 1;
-    ortho_texture_desc.format = WGPUTextureFormat::WGPUTextureFormat_RGBA8Unorm;
+    ortho_texture_desc.format = webgpu::raii::Texture::colour_texture_format(m_ortho_compression);
     ortho_texture_desc.usage = WGPUTextureUsage_TextureBinding | WGPUTextureUsage_CopyDst;
+    if (m_ortho_compression == nucleus::utils::ColourTexture::Format::Uncompressed_RGBA)
+        ortho_texture_desc.usage |= WGPUTextureUsage_StorageBinding; // mip levels are written by the compute downsampler
 
     WGPUSamplerDescriptor ortho_sampler_desc {};
     ortho_sampler_desc.label = WGPUStringView { .data = "ortho sampler", .length = WGPU_STRLEN };
@@ -119,7 +125,7 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
     ortho_sampler_desc.minFilter = WGPUFilterMode::WGPUFilterMode_Linear;
     ortho_sampler_desc.mipmapFilter = WGPUMipmapFilterMode::WGPUMipmapFilterMode_Linear;
     ortho_sampler_desc.lodMinClamp = 0.0f;
-    ortho_sampler_desc.lodMaxClamp = 1.0f;
+    ortho_sampler_desc.lodMaxClamp = float(ortho_mip_level_count);
     ortho_sampler_desc.compare = WGPUCompareFunction::WGPUCompareFunction_Undefined;
     ortho_sampler_desc.maxAnisotropy = 1;
 
@@ -127,12 +133,16 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
 
     auto& reg = ctx.resource_registry();
     reg.register_shader("render_tiles", "webgpu_engine::render_tiles");
+    if (m_ortho_compression == nucleus::utils::ColourTexture::Format::Uncompressed_RGBA) {
+        webgpu::register_mipmap_resources(reg);
+        reg.register_pipeline([this](WGPUDevice dev, const webgpu::RenderResourceRegistry& reg) { m_mipmap_pipeline = webgpu::create_mipmap_pipeline(dev, reg); });
+    }
     reg.register_bind_group_layout("tile", [](WGPUDevice device) {
-        WGPUBindGroupLayoutEntry n_vertices_entry {};
-        n_vertices_entry.binding = 0;
-        n_vertices_entry.visibility = WGPUShaderStage_Vertex;
-        n_vertices_entry.buffer.type = WGPUBufferBindingType_Uniform;
-        n_vertices_entry.buffer.minBindingSize = 0;
+        WGPUBindGroupLayoutEntry tile_config_entry {};
+        tile_config_entry.binding = 0;
+        tile_config_entry.visibility = WGPUShaderStage_Vertex;
+        tile_config_entry.buffer.type = WGPUBufferBindingType_Uniform;
+        tile_config_entry.buffer.minBindingSize = 0;
 
         WGPUBindGroupLayoutEntry heightmap_texture_entry {};
         heightmap_texture_entry.binding = 1;
@@ -156,46 +166,48 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
         ortho_texture_sampler.visibility = WGPUShaderStage_Fragment;
         ortho_texture_sampler.sampler.type = WGPUSamplerBindingType_Filtering;
 
+        WGPUBindGroupLayoutEntry instances_entry {};
+        instances_entry.binding = 5;
+        instances_entry.visibility = WGPUShaderStage_Vertex;
+        instances_entry.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+        instances_entry.buffer.minBindingSize = 0;
+
+        WGPUBindGroupLayoutEntry visible_instances_entry {};
+        visible_instances_entry.binding = 6;
+        visible_instances_entry.visibility = WGPUShaderStage_Vertex;
+        visible_instances_entry.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+        visible_instances_entry.buffer.minBindingSize = 0;
+
         return std::make_unique<webgpu::raii::BindGroupLayout>(device,
-            std::vector<WGPUBindGroupLayoutEntry> {
-                n_vertices_entry, heightmap_texture_entry, heightmap_texture_sampler, ortho_texture_entry, ortho_texture_sampler },
+            std::vector<WGPUBindGroupLayoutEntry> { tile_config_entry,
+                heightmap_texture_entry,
+                heightmap_texture_sampler,
+                ortho_texture_entry,
+                ortho_texture_sampler,
+                instances_entry,
+                visible_instances_entry },
             "tile bind group");
     });
     reg.register_pipeline([this](WGPUDevice dev, const webgpu::RenderResourceRegistry& reg) {
-        webgpu::util::SingleVertexBufferInfo bounds_buffer_info(WGPUVertexStepMode_Instance);
-        bounds_buffer_info.add_attribute<float, 4>(0);
-        webgpu::util::SingleVertexBufferInfo texture_layer_buffer_info(WGPUVertexStepMode_Instance);
-        texture_layer_buffer_info.add_attribute<int32_t, 1>(1);
-        webgpu::util::SingleVertexBufferInfo ortho_texture_layer_buffer_info(WGPUVertexStepMode_Instance);
-        ortho_texture_layer_buffer_info.add_attribute<int32_t, 1>(2);
-        webgpu::util::SingleVertexBufferInfo tileset_id_buffer_info(WGPUVertexStepMode_Instance);
-        tileset_id_buffer_info.add_attribute<int32_t, 1>(3);
-        webgpu::util::SingleVertexBufferInfo height_zoomlevel_buffer_info(WGPUVertexStepMode_Instance);
-        height_zoomlevel_buffer_info.add_attribute<int32_t, 1>(4);
-        webgpu::util::SingleVertexBufferInfo tile_id_buffer_info(WGPUVertexStepMode_Instance);
-        tile_id_buffer_info.add_attribute<uint32_t, 2>(5);
-        webgpu::util::SingleVertexBufferInfo ortho_zoomlevel_buffer_info(WGPUVertexStepMode_Instance);
-        ortho_zoomlevel_buffer_info.add_attribute<int32_t, 1>(6);
-
+        // see util/gbuffer.wgsl
         webgpu::FramebufferFormat format {};
-        format.depth_format = WGPUTextureFormat_Depth24Plus;
-        format.color_formats.emplace_back(WGPUTextureFormat_R32Uint); // albedo
-        format.color_formats.emplace_back(WGPUTextureFormat_RGBA32Float); // position
-        format.color_formats.emplace_back(WGPUTextureFormat_RG16Uint); // normal
-        format.color_formats.emplace_back(WGPUTextureFormat_R32Uint); // overlay
-
+        if (reg.is_defined(COMPACT_GBUFFER_DEFINE)) {
+            format.depth_format = WGPUTextureFormat_Depth32Float; // position is reconstructed from depth
+            format.color_formats.emplace_back(WGPUTextureFormat_RG32Uint); // albedo, overlay
+            format.color_formats.emplace_back(WGPUTextureFormat_RG16Uint); // normal
+        } else {
+            format.depth_format = WGPUTextureFormat_Depth24Plus;
+            format.color_formats.emplace_back(WGPUTextureFormat_R32Uint); // albedo
+            format.color_formats.emplace_back(WGPUTextureFormat_RGBA32Float); // position
+            format.color_formats.emplace_back(WGPUTextureFormat_RG16Uint); // normal
+            format.color_formats.emplace_back(WGPUTextureFormat_R32Uint); // overlay
+        }
+
+        // per-tile data is read from the instance storage buffer, there are no vertex buffers
         m_pipeline = std::make_unique<webgpu::raii::GenericRenderPipeline>(dev,
             reg.shader("render_tiles"),
             reg.shader("render_tiles"),
-            std::vector<webgpu::util::SingleVertexBufferInfo> {
-                bounds_buffer_info,
-                texture_layer_buffer_info,
-                ortho_texture_layer_buffer_info,
-                tileset_id_buffer_info,
-                height_zoomlevel_buffer_info,
-                tile_id_buffer_info,
-                ortho_zoomlevel_buffer_info,
-            },
+            std::vector<webgpu::util::SingleVertexBufferInfo> {},
             format,
             std::vector<const webgpu::raii::BindGroupLayout*> {
                 &reg.bind_group_layout("shared_config"),
@@ -204,78 +216,190 @@ void TileMeshRenderer::init(webgpu::Context& ctx)
             });
 
         m_tile_bind_group = create_bind_group(m_ortho_textures->texture_view(), m_ortho_textures->sampler());
+        m_culled_tile_bind_group = create_bind_group(
+            m_ortho_textures->texture_view(), m_ortho_textures->sampler(), *m_resident_instances.buffer, m_culler.visible_instance_buffer());
     });
 }
 
 void TileMeshRenderer::draw(
-    WGPURenderPassEncoder render_pass, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_tiles) const
+    WGPURenderPassEncoder render_pass, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_tiles)
 {
-    std::vector<glm::vec4> bounds;
-    bounds.reserve(draw_tiles.size());
-
-    std::vector<int32_t> tileset_id;
-    tileset_id.reserve(draw_tiles.size());
+    m_instance_timer->start();
+    ++m_frame;
 
-    std::vector<int32_t> height_zoom_levels;
-    height_zoom_levels.reserve(draw_tiles.size());
-
-    std::vector<int32_t> height_texture_layer;
-    height_texture_layer.reserve(draw_tiles.size());
-
-    std::vector<int32_t> ortho_zoom_levels;
-    ortho_zoom_levels.reserve(draw_tiles.size());
-
-    std::vector<int32_t> ortho_texture_layers;
-    ortho_texture_layers.reserve(draw_tiles.size());
-
-    std::vector<glm::u32vec2> tile_ids;
-    tile_ids.reserve(draw_tiles.size());
+    update_instance_origin(camera);
+    update_all_instance_layers(m_instances);
 
+    Q_ASSERT(draw_tiles.size() <= INSTANCE_CAPACITY / 2);
+    std::vector<uint32_t> visible_instances;
+    visible_instances.reserve(draw_tiles.size());
     for (const auto& id_bounds : draw_tiles) {
+        if (visible_instances.size() == INSTANCE_CAPACITY / 2)
+            break; // otherwise slots of this frame would be evicted
         const auto& tile_id = id_bounds.id;
-        const auto& tile_bounds = id_bounds.bounds;
-        bounds.emplace_back(tile_bounds.min.x - camera.position().x,
-            tile_bounds.min.y - camera.position().y,
-            tile_bounds.max.x - camera.position().x,
-            tile_bounds.max.y - camera.position().y);
-        tileset_id.emplace_back(tile_id.coords[0] + tile_id.coords[1]);
-
-        const auto height_layer_info = m_loaded_height_textures.layer(tile_id);
-        height_zoom_levels.emplace_back(int(height_layer_info.id.zoom_level));
-        height_texture_layer.emplace_back(int(height_layer_info.index));
-
-        const auto ortho_layer_info = m_loaded_ortho_textures.layer(tile_id);
-        ortho_zoom_levels.emplace_back(int(ortho_layer_info.id.zoom_level));
-        ortho_texture_layers.emplace_back(int(ortho_layer_info.index));
-
-        tile_ids.emplace_back(nucleus::srs::pack(id_bounds.id));
+        auto slot_it = m_instance_slots.find(tile_id);
+        uint32_t slot = 0;
+        if (slot_it != m_instance_slots.end()) {
+            slot = slot_it->second;
+        } else {
+            slot = acquire_instance_slot(tile_id);
+            set_instance(m_instances, slot, tile_id, id_bounds.bounds);
+        }
+        m_instance_last_drawn[slot] = m_frame;
+        visible_instances.push_back(slot);
     }
 
-    // write updated vertex buffers
-    m_bounds_buffer->write(m_ctx->queue(), bounds.data(), bounds.size());
-    m_tileset_id_buffer->write(m_ctx->queue(), tileset_id.data(), tileset_id.size());
-    m_height_zoom_level_buffer->write(m_ctx->queue(), height_zoom_levels.data(), height_zoom_levels.size());
-    m_height_texture_layer_buffer->write(m_ctx->queue(), height_texture_layer.data(), height_texture_layer.size());
-    m_ortho_zoom_level_buffer->write(m_ctx->queue(), ortho_zoom_levels.data(), ortho_zoom_levels.size());
-    m_ortho_texture_layer_buffer->write(m_ctx->queue(), ortho_texture_layers.data(), ortho_texture_layers.size());
-    m_tile_id_buffer->write(m_ctx->queue(), tile_ids.data(), tile_ids.size());
+    write_dirty_instances(m_instances);
+    if (!visible_instances.empty())
+        m_visible_instance_buffer->write(m_ctx->queue(), visible_instances.data(), visible_instances.size());
+    const std::array<uint32_t, 5> indirect_args = { uint32_t(m_index_buffer_size), uint32_t(visible_instances.size()), 0, 0, 0 };
+    m_indirect_buffer->write(m_ctx->queue(), indirect_args.data(), indirect_args.size());
 
-    // set bind group for uniforms, textures and samplers
+    m_tile_config_buffer->data.origin_offset = glm::vec2(m_instance_origin - glm::dvec2(camera.position()));
+    m_tile_config_buffer->update_gpu_data(m_ctx->queue());
+    m_instance_timer->stop();
+
+    // set bind group for uniforms, textures, samplers and instances
     wgpuRenderPassEncoderSetBindGroup(render_pass, 2, m_tile_bind_group->handle(), 0, nullptr);
 
-    // set index buffer and vertex buffers
+    // set index buffer, pipeline and draw call
+    wgpuRenderPassEncoderSetIndexBuffer(render_pass, m_index_buffer->handle(), WGPUIndexFormat_Uint16, 0, m_index_buffer->size_in_byte());
+    wgpuRenderPassEncoderSetPipeline(render_pass, m_pipeline->pipeline().handle());
+    wgpuRenderPassEncoderDrawIndexedIndirect(render_pass, m_indirect_buffer->handle(), 0);
+}
+
+void TileMeshRenderer::cull(WGPUCommandEncoder encoder, const nucleus::camera::Definition& camera, unsigned max_zoom_level)
+{
+    m_instance_timer->start();
+    update_instance_origin(camera);
+    update_all_instance_layers(m_resident_instances);
+    write_dirty_instances(m_resident_instances);
+
+    m_tile_config_buffer->data.origin_offset = glm::vec2(m_instance_origin - glm::dvec2(camera.position()));
+    m_tile_config_buffer->update_gpu_data(m_ctx->queue());
+    m_culler.cull(encoder, camera, max_zoom_level, uint32_t(m_index_buffer_size));
+    m_instance_timer->stop();
+}
+
+void TileMeshRenderer::draw_culled(WGPURenderPassEncoder render_pass)
+{
+    wgpuRenderPassEncoderSetBindGroup(render_pass, 2, m_culled_tile_bind_group->handle(), 0, nullptr);
     wgpuRenderPassEncoderSetIndexBuffer(render_pass, m_index_buffer->handle(), WGPUIndexFormat_Uint16, 0, m_index_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 0, m_bounds_buffer->handle(), 0, m_bounds_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 1, m_height_texture_layer_buffer->handle(), 0, m_height_texture_layer_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 2, m_ortho_texture_layer_buffer->handle(), 0, m_ortho_texture_layer_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 3, m_tileset_id_buffer->handle(), 0, m_tileset_id_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 4, m_height_zoom_level_buffer->handle(), 0, m_height_zoom_level_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 5, m_tile_id_buffer->handle(), 0, m_tile_id_buffer->size_in_byte());
-    wgpuRenderPassEncoderSetVertexBuffer(render_pass, 6, m_ortho_zoom_level_buffer->handle(), 0, m_ortho_zoom_level_buffer->size_in_byte());
-
-    // set pipeline and draw call
     wgpuRenderPassEncoderSetPipeline(render_pass, m_pipeline->pipeline().handle());
-    wgpuRenderPassEncoderDrawIndexed(render_pass, uint32_t(m_index_buffer_size), uint32_t(draw_tiles.size()), 0, 0, 0);
+    wgpuRenderPassEncoderDrawIndexedIndirect(render_pass, m_culler.indirect_buffer().handle(), 0);
+}
+
+void TileMeshRenderer::init_instance_storage(InstanceStorage& storage, uint32_t n_slots, const std::string& label)
+{
+    storage.instances.assign(n_slots, TileInstance {});
+    storage.ids.assign(n_slots, nucleus::tile::Id { unsigned(-1), {} });
+    storage.bounds.assign(n_slots, nucleus::tile::SrsAndHeightBounds {});
+    storage.dirty.assign(n_slots, 0);
+    storage.layers_dirty = false;
+    storage.buffer = std::make_unique<webgpu::raii::RawBuffer<TileInstance>>(m_ctx->device(), WGPUBufferUsage_Storage | WGPUBufferUsage_CopyDst, n_slots, label);
+}
+
+void TileMeshRenderer::set_instance(InstanceStorage& storage, uint32_t slot, const nucleus::tile::Id& id, const nucleus::tile::SrsAndHeightBounds& bounds)
+{
+    storage.ids[slot] = id;
+    storage.bounds[slot] = bounds;
+    auto& instance = storage.instances[slot];
+    instance.bounds = glm::vec4(bounds.min.x - m_instance_origin.x,
+        bounds.min.y - m_instance_origin.y,
+        bounds.max.x - m_instance_origin.x,
+        bounds.max.y - m_instance_origin.y);
+    instance.tile_id = nucleus::srs::pack(id);
+    instance.tileset_id = int32_t(id.coords[0] + id.coords[1]);
+    update_instance_layers(storage, slot);
+    storage.dirty[slot] = 1;
+}
+
+bool TileMeshRenderer::update_instance_layers(InstanceStorage& storage, uint32_t slot)
+{
+    auto& instance = storage.instances[slot];
+    const auto height_layer_info = m_loaded_height_textures.layer(storage.ids[slot]);
+    const auto ortho_layer_info = m_loaded_ortho_textures.layer(storage.ids[slot]);
+    const auto old = instance;
+    instance.height_zoom_level = int32_t(height_layer_info.id.zoom_level);
+    instance.height_texture_layer = int32_t(height_layer_info.index);
+    instance.ortho_zoom_level = int32_t(ortho_layer_info.id.zoom_level);
+    instance.ortho_texture_layer = int32_t(ortho_layer_info.index);
+    return instance.height_zoom_level != old.height_zoom_level || instance.height_texture_layer != old.height_texture_layer
+        || instance.ortho_zoom_level != old.ortho_zoom_level || instance.ortho_texture_layer != old.ortho_texture_layer;
+}
+
+void TileMeshRenderer::update_all_instance_layers(InstanceStorage& storage)
+{
+    if (!storage.layers_dirty)
+        return;
+    for (uint32_t slot = 0; slot < storage.ids.size(); ++slot) {
+        if (storage.ids[slot].zoom_level != unsigned(-1) && update_instance_layers(storage, slot))
+            storage.dirty[slot] = 1;
+    }
+    storage.layers_dirty = false;
+}
+
+void TileMeshRenderer::write_dirty_instances(InstanceStorage& storage)
+{
+    // coalesce consecutive dirty slots into a single write
+    const auto n_slots = uint32_t(storage.instances.size());
+    uint32_t begin = 0;
+    while (begin < n_slots) {
+        if (!storage.dirty[begin]) {
+            ++begin;
+            continue;
+        }
+        uint32_t end = begin;
+        while (end < n_slots && storage.dirty[end]) {
+            storage.dirty[end] = 0;
+            ++end;
+        }
+        storage.buffer->write(m_ctx->queue(), storage.instances.data() + begin, end - begin, begin);
+        begin = end;
+    }
+}
+
+bool TileMeshRenderer::update_instance_origin(const nucleus::camera::Definition& camera)
+{
+    const auto camera_position = glm::dvec2(camera.position());
+    if (!glm::any(glm::greaterThan(glm::abs(camera_position - m_instance_origin), glm::dvec2(INSTANCE_ORIGIN_REBASE_DISTANCE))))
+        return false;
+
+    // bounds of all instances are relative to the old origin
+    m_instance_origin = camera_position;
+    release_all_instance_slots();
+    for (uint32_t slot = 0; slot < m_resident_instances.ids.size(); ++slot) {
+        if (m_resident_instances.ids[slot].zoom_level != unsigned(-1))
+            set_instance(m_resident_instances, slot, m_resident_instances.ids[slot], m_resident_instances.bounds[slot]);
+    }
+    m_culler.set_origin(m_instance_origin);
+    return true;
+}
+
+uint32_t TileMeshRenderer::acquire_instance_slot(const nucleus::tile::Id& id)
+{
+    if (m_free_instance_slots.empty()) {
+        const auto lru = std::min_element(m_instance_last_drawn.cbegin(), m_instance_last_drawn.cend());
+        const auto evicted = uint32_t(lru - m_instance_last_drawn.cbegin());
+        Q_ASSERT(m_instance_last_drawn[evicted] < m_frame);
+        m_instance_slots.erase(m_instances.ids[evicted]);
+        m_free_instance_slots.push_back(evicted);
+    }
+    const auto slot = m_free_instance_slots.back();
+    m_free_instance_slots.pop_back();
+    m_instance_slots[id] = slot;
+    return slot;
+}
+
+void TileMeshRenderer::release_all_instance_slots()
+{
+    m_instance_slots.clear();
+    m_free_instance_slots.resize(INSTANCE_CAPACITY);
+    // reversed, so that slots are handed out from the front of the buffer
+    for (uint32_t i = 0; i < INSTANCE_CAPACITY; ++i)
+        m_free_instance_slots[i] = INSTANCE_CAPACITY - 1 - i;
+    std::fill(m_instance_last_drawn.begin(), m_instance_last_drawn.end(), 0);
+    std::fill(m_instances.ids.begin(), m_instances.ids.end(), nucleus::tile::Id { unsigned(-1), {} });
 }
 
 void TileMeshRenderer::set_tile_limit(unsigned int num_tiles)
@@ -284,27 +408,63 @@ void TileMeshRenderer::set_tile_limit(unsigned int num_tiles)
     m_loaded_ortho_textures.set_tile_limit(num_tiles);
 }
 
+nucleus::utils::ColourTexture::Format TileMeshRenderer::compression_algorithm(WGPUDevice device)
+{
+    // DXT1 is BC1, ETC2 decoders read ETC1 data. there is no ASTC encoder in nucleus, so ASTC-only devices get the uncompressed path.
+    if (wgpuDeviceHasFeature(device, WGPUFeatureName_TextureCompressionBC))
+        return nucleus::utils::ColourTexture::Format::DXT1;
+    if (wgpuDeviceHasFeature(device, WGPUFeatureName_TextureCompressionETC2))
+        return nucleus::utils::ColourTexture::Format::ETC1;
+    return nucleus::utils::ColourTexture::Format::Uncompressed_RGBA;
+}
+
+WGPUTextureFormat TileMeshRenderer::height_texture_format() const { return m_heightmap_textures->texture().descriptor().format; }
+
+WGPUTextureFormat TileMeshRenderer::ortho_texture_format() const { return m_ortho_textures->texture().descriptor().format; }
+
+size_t TileMeshRenderer::height_texture_size_in_bytes() const { return m_heightmap_textures->texture().allocated_size_in_bytes(); }
+
+size_t TileMeshRenderer::ortho_texture_size_in_bytes() const { return m_ortho_textures->texture().allocated_size_in_bytes(); }
+
 std::unique_ptr<webgpu::raii::BindGroup> TileMeshRenderer::create_bind_group(const webgpu::raii::TextureView& view, const webgpu::raii::Sampler& sampler) const
+{
+    return create_bind_group(view, sampler, *m_instances.buffer, *m_visible_instance_buffer);
+}
+
+std::unique_ptr<webgpu::raii::BindGroup> TileMeshRenderer::create_bind_group(const webgpu::raii::TextureView& view,
+    const webgpu::raii::Sampler& sampler,
+    const webgpu::raii::RawBuffer<TileInstance>& instances,
+    const webgpu::raii::RawBuffer<uint32_t>& visible_instances) const
 {
     return std::make_unique<webgpu::raii::BindGroup>(m_ctx->device(),
         m_ctx->resource_registry().bind_group_layout("tile"),
         std::initializer_list<WGPUBindGroupEntry> {
-            m_n_edge_vertices_buffer->raw_buffer().create_bind_group_entry(0),
+            m_tile_config_buffer->raw_buffer().create_bind_group_entry(0),
             m_heightmap_textures->texture_view().create_bind_group_entry(1),
             m_heightmap_textures->sampler().create_bind_group_entry(2),
             view.create_bind_group_entry(3),
             sampler.create_bind_group_entry(4),
+            instances.create_bind_group_entry(5),
+            visible_instances.create_bind_group_entry(6),
         },
         "tile bind group");
 }
 
 const webgpu::raii::GenericRenderPipeline& TileMeshRenderer::render_tiles_pipeline() const { return *m_pipeline; }
 
+std::shared_ptr<webgpu::timing::CpuTimer> TileMeshRenderer::instance_timer() const { return m_instance_timer; }
+
 void TileMeshRenderer::update_gpu_tiles_height(const std::vector<radix::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuGeometryTile>& new_tiles)
 {
     for (const auto& id : deleted_tiles) {
+        if (m_loaded_height_textures.contains(id))
+            m_resident_instances.ids[m_loaded_height_textures.layer(id).index] = nucleus::tile::Id { unsigned(-1), {} };
         m_loaded_height_textures.remove_tile(id);
+        m_culler.remove_tile(id);
     }
+    const auto layers_changed = !deleted_tiles.empty() || !new_tiles.empty();
+    m_instances.layers_dirty |= layers_changed;
+    m_resident_instances.layers_dirty |= layers_changed;
 
     for (const auto& tile : new_tiles) {
         // test for validity
@@ -314,6 +474,8 @@ void TileMeshRenderer::update_gpu_tiles_height(const std::vector<radix::tile::Id
         // find empty spot and upload texture
         const uint32_t layer_index = m_loaded_height_textures.add_tile(tile.id);
         m_heightmap_textures->texture().write(m_ctx->queue(), *tile.surface, layer_index);
+        set_instance(m_resident_instances, layer_index, tile.id, tile.bounds);
+        m_culler.add_tile(layer_index, tile.id, tile.bounds);
     }
 }
 
@@ -322,15 +484,42 @@ void TileMeshRenderer::update_gpu_tiles_ortho(const std::vector<nucleus::tile::I
     for (const auto& id : deleted_tiles) {
         m_loaded_ortho_textures.remove_tile(id);
     }
+    const auto layers_changed = !deleted_tiles.empty() || !new_tiles.empty();
+    m_instances.layers_dirty |= layers_changed;
+    m_resident_instances.layers_dirty |= layers_changed;
+    std::vector<uint32_t> layers_without_mipmaps;
     for (const auto& tile : new_tiles) {
         // test for validity
         Q_ASSERT(tile.id.zoom_level < 100);
         Q_ASSERT(tile.texture);
+        Q_ASSERT(!tile.texture->empty());
+        Q_ASSERT(tile.texture->front().format() == m_ortho_compression);
 
         // find empty spot and upload texture
-        const auto layer_index = m_loaded_ortho_textures.add_tile(tile.id);
-        m_ortho_textures->texture().write(m_ctx->queue(), tile.texture->front(), uint32_t(layer_index));
+        const auto layer_index = uint32_t(m_loaded_ortho_textures.add_tile(tile.id));
+        auto& texture = m_ortho_textures->texture();
+        const auto n_levels = std::min(uint32_t(tile.texture->size()), texture.mip_level_count());
+        for (uint32_t level = 0; level < n_levels; ++level)
+            texture.write(m_ctx->queue(), (*tile.texture)[level], layer_index, level);
+        // the scheduler usually delivers the whole chain. only uncompressed levels can be computed on the gpu if some are missing.
+        if (n_levels < texture.mip_level_count() && m_ortho_compression == nucleus::utils::ColourTexture::Format::Uncompressed_RGBA)
+            layers_without_mipmaps.push_back(layer_index);
     }
+
+    if (layers_without_mipmaps.empty() || !m_mipmap_pipeline)
+        return;
+
+    WGPUCommandEncoderDescriptor encoder_desc {};
+    encoder_desc.label = WGPUStringView { .data = "ortho mipmap command encoder", .length = WGPU_STRLEN };
+    webgpu::raii::CommandEncoder encoder(m_ctx->device(), encoder_desc);
+    webgpu::encode_mipmaps_for_texture_layers(
+        m_ctx->device(), m_ctx->resource_registry(), encoder.handle(), *m_mipmap_pipeline, m_ortho_textures->texture(), layers_without_mipmaps);
+
+    WGPUCommandBufferDescriptor cmd_buffer_desc {};
+    cmd_buffer_desc.label = WGPUStringView { .data = "ortho mipmap command buffer", .length = WGPU_STRLEN };
+    WGPUCommandBuffer command = wgpuCommandEncoderFinish(encoder.handle(), &cmd_buffer_desc);
+    wgpuQueueSubmit(m_ctx->queue(), 1, &command);
+    wgpuCommandBufferRelease(command);
 }
 
 } // namespace webgpu_engine
@@ -22,6 +22,7 @@
 
 #include <memory>
 
+#include "TileCuller.h"
 #include <QObject>
 #include <nucleus/tile/GpuArrayHelper.h>
 #include <nucleus/tile/types.h>
@@ -29,8 +30,10 @@
 #include <webgpu/base/Context.h>
 #include <webgpu/base/raii/BindGroup.h>
 #include <webgpu/base/raii/BindGroupLayout.h>
+#include <webgpu/base/raii/CombinedComputePipeline.h>
 #include <webgpu/base/raii/Pipeline.h>
 #include <webgpu/base/raii/TextureWithSampler.h>
+#include <webgpu/base/timing/CpuTimer.h>
 #include <webgpu/webgpu.h>
 
 namespace nucleus::camera {
@@ -42,11 +45,43 @@ namespace webgpu_engine {
 class TileMeshRenderer : public QObject {
     Q_OBJECT
 public:
+    // std430, must match TileInstance in render_tiles.wgsl
+    struct TileInstance {
+        glm::vec4 bounds; // relative to the instance origin
+        glm::u32vec2 tile_id;
+        int32_t height_zoom_level;
+        int32_t height_texture_layer;
+        int32_t ortho_zoom_level;
+        int32_t ortho_texture_layer;
+        int32_t tileset_id;
+        int32_t padding = 0;
+    };
+    static_assert(sizeof(TileInstance) == 48);
+
+    // std140, must match TileConfig in render_tiles.wgsl
+    struct TileConfig {
+        glm::vec2 origin_offset; // instance origin relative to the camera
+        int32_t n_edge_vertices;
+        int32_t padding = 0;
+    };
+
+    // instance slots are kept alive beyond a single frame, hence more than the draw list limit
+    static constexpr uint32_t INSTANCE_CAPACITY = 2048;
+    // instance bounds are stored relative to an origin close to the camera (float precision). it is moved when the camera is further away.
+    static constexpr double INSTANCE_ORIGIN_REBASE_DISTANCE = 10'000.0;
+    // global shader define selecting the compact geometry buffer layout (util/gbuffer.wgsl)
+    static constexpr const char* COMPACT_GBUFFER_DEFINE = "COMPACT_GBUFFER";
+
     explicit TileMeshRenderer(uint32_t height_resolution, uint32_t ortho_resolution);
 
     void init(webgpu::Context& ctx);
 
-    void draw(WGPURenderPassEncoder render_pass, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_tiles) const;
+    void draw(WGPURenderPassEncoder render_pass, const nucleus::camera::Definition& camera, const std::vector<nucleus::tile::TileBounds>& draw_tiles);
+
+    // gpu driven alternative to draw(): cull() selects the tiles among all resident geometry tiles (see TileCuller),
+    // it must be recorded before the render pass in which draw_culled() is called.
+    void cull(WGPUCommandEncoder encoder, const nucleus::camera::Definition& camera, unsigned max_zoom_level);
+    void draw_culled(WGPURenderPassEncoder render_pass);
 
     std::unique_ptr<webgpu::raii::BindGroup> create_bind_group(const webgpu::raii::TextureView& view, const webgpu::raii::Sampler& sampler) const;
 
@@ -55,6 +90,18 @@ public:
     size_t capacity() const;
     void set_tile_limit(unsigned new_limit);
 
+    // Picks the ortho compression supported by the device (BC1, then ETC2). Falls back to uncompressed RGBA.
+    // The mip chain of the tiles is uploaded, for RGBA missing levels are computed on the GPU.
+    static nucleus::utils::ColourTexture::Format compression_algorithm(WGPUDevice device);
+
+    [[nodiscard]] WGPUTextureFormat height_texture_format() const;
+    [[nodiscard]] WGPUTextureFormat ortho_texture_format() const;
+    [[nodiscard]] size_t height_texture_size_in_bytes() const;
+    [[nodiscard]] size_t ortho_texture_size_in_bytes() const;
+
+    // cpu time spent on updating the instance and visibility buffers in draw()
+    [[nodiscard]] std::shared_ptr<webgpu::timing::CpuTimer> instance_timer() const;
+
 signals:
     void tiles_changed();
 
@@ -63,8 +110,33 @@ public slots:
     void update_gpu_tiles_ortho(const std::vector<nucleus::tile::Id>& deleted_tiles, const std::vector<nucleus::tile::GpuTextureTile>& new_tiles);
 
 private:
+    // cpu mirror of an instance buffer, indexed by slot
+    struct InstanceStorage {
+        std::vector<TileInstance> instances;
+        std::vector<nucleus::tile::Id> ids;
+        std::vector<nucleus::tile::SrsAndHeightBounds> bounds;
+        std::vector<uint8_t> dirty;
+        bool layers_dirty = false;
+        std::unique_ptr<webgpu::raii::RawBuffer<TileInstance>> buffer;
+    };
+
+    std::unique_ptr<webgpu::raii::BindGroup> create_bind_group(const webgpu::raii::TextureView& view,
+        const webgpu::raii::Sampler& sampler,
+        const webgpu::raii::RawBuffer<TileInstance>& instances,
+        const webgpu::raii::RawBuffer<uint32_t>& visible_instances) const;
+    void init_instance_storage(InstanceStorage& storage, uint32_t n_slots, const std::string& label);
+    void set_instance(InstanceStorage& storage, uint32_t slot, const nucleus::tile::Id& id, const nucleus::tile::SrsAndHeightBounds& bounds);
+    bool update_instance_layers(InstanceStorage& storage, uint32_t slot);
+    void update_all_instance_layers(InstanceStorage& storage);
+    void write_dirty_instances(InstanceStorage& storage);
+    // returns true if the origin moved
+    bool update_instance_origin(const nucleus::camera::Definition& camera);
+    uint32_t acquire_instance_slot(const nucleus::tile::Id& id);
+    void release_all_instance_slots();
+
     uint32_t m_height_resolution;
     uint32_t m_ortho_resolution;
+    nucleus::utils::ColourTexture::Format m_ortho_compression = nucleus::utils::ColourTexture::Format::Uncompressed_RGBA;
     size_t m_num_layers;
     nucleus::tile::GpuArrayHelper m_loaded_height_textures;
     nucleus::tile::GpuArrayHelper m_loaded_ortho_textures;
@@ -73,19 +145,32 @@ private:
 
     size_t m_index_buffer_size;
     std::unique_ptr<webgpu::raii::RawBuffer<uint16_t>> m_index_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<glm::vec4>> m_bounds_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<int32_t>> m_tileset_id_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<int32_t>> m_height_zoom_level_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<int32_t>> m_height_texture_layer_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<int32_t>> m_ortho_zoom_level_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<int32_t>> m_ortho_texture_layer_buffer;
-    std::unique_ptr<webgpu::Buffer<int32_t>> m_n_edge_vertices_buffer;
-    std::unique_ptr<webgpu::raii::RawBuffer<glm::u32vec2>> m_tile_id_buffer;
+    std::unique_ptr<webgpu::Buffer<TileConfig>> m_tile_config_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<uint32_t>> m_visible_instance_buffer;
+    std::unique_ptr<webgpu::raii::RawBuffer<uint32_t>> m_indirect_buffer;
+
+    // instance bounds are relative to this origin
+    glm::dvec2 m_instance_origin = glm::dvec2(0);
+
+    // draw(): a slot keeps its tile until it is evicted (least recently drawn first).
+    InstanceStorage m_instances;
+    std::vector<uint64_t> m_instance_last_drawn;
+    std::vector<uint32_t> m_free_instance_slots;
+    nucleus::tile::IdMap<uint32_t> m_instance_slots;
+    uint64_t m_frame = 0;
+
+    // cull() and draw_culled(): the slot is the height texture layer of a resident tile.
+    InstanceStorage m_resident_instances;
+    TileCuller m_culler;
+    std::unique_ptr<webgpu::raii::BindGroup> m_culled_tile_bind_group;
+
+    std::shared_ptr<webgpu::timing::CpuTimer> m_instance_timer;
 
     std::unique_ptr<webgpu::raii::TextureWithSampler> m_heightmap_textures;
     std::unique_ptr<webgpu::raii::TextureWithSampler> m_ortho_textures;
     std::unique_ptr<webgpu::raii::BindGroup> m_tile_bind_group;
     std::unique_ptr<webgpu::raii::GenericRenderPipeline> m_pipeline;
+    std::unique_ptr<webgpu::raii::CombinedComputePipeline> m_mipmap_pipeline;
 };
 
 } // namespace webgpu_engine